@@ -0,0 +1,233 @@
+/*
+________________________________________________________________
+
+	This file is part of BRAHMS
+	Copyright (C) 2007 Ben Mitchinson
+	URL: http://brahms.sourceforge.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+________________________________________________________________
+
+*/
+
+
+
+
+
+////////////////	COMPONENT INFO
+
+#define COMPONENT_CLASS_STRING "client/brahms/bench/pingpong"
+#define COMPONENT_CLASS_CPP client_brahms_bench_pingpong_0
+#define COMPONENT_FLAGS F_NOT_RATE_CHANGER
+
+//	include common header
+#include "components/process.h"
+
+#include <algorithm>
+
+#ifdef __WIN__
+#include "windows.h"
+#endif
+#ifdef __NIX__
+#include <time.h>
+#endif
+
+/*	DOCUMENTATION: PINGPONG_BENCHMARK
+
+	Measures inter-voice round-trip latency. Run two of these on
+	different voices, connected in a loop:
+
+		ping>out -> pong<in (lag 0)
+		pong>out -> ping<in (lag 1)
+
+	so that every sample of each waits for one message each way.
+	Listed in that order, with no affinity, round-robin scheduling
+	places them on voices 1 and 2. Each reports, at the end of the
+	run, the interval between its consecutive services, which is the
+	round trip time (the first "warmup" samples are discarded). Use
+	two voices at 127.0.0.1, or --loopback-2, and compare, say,
+	SocketsBusyPoll of 0 and 50.
+
+	State (all optional): "elements", the width of the DOUBLE
+	payload (default 1), and "warmup" (default 100).
+*/
+
+
+
+////////////////	CLOCK
+
+DOUBLE secondsNow()
+{
+#ifdef __WIN__
+	LARGE_INTEGER count, frequency;
+	QueryPerformanceCounter(&count);
+	QueryPerformanceFrequency(&frequency);
+	return ((DOUBLE)count.QuadPart) / ((DOUBLE)frequency.QuadPart);
+#endif
+#ifdef __NIX__
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((DOUBLE)ts.tv_sec) + ((DOUBLE)ts.tv_nsec) * 1e-9;
+#endif
+}
+
+
+
+////////////////	COMPONENT CLASS (DERIVES FROM Process)
+
+class COMPONENT_CLASS_CPP : public Process
+{
+
+public:
+
+	//	framework event function
+	Symbol event(Event* event);
+
+private:
+
+	//	pars
+	UINT32 elements;
+	UINT32 warmup;
+
+	//	state
+	DOUBLE lastService;
+	VDOUBLE intervals;
+
+	//	ports
+	numeric::Input input;
+	numeric::Output output;
+
+};
+
+
+
+////////////////	EVENT
+
+Symbol COMPONENT_CLASS_CPP::event(Event* event)
+{
+	switch(event->type)
+	{
+		case EVENT_STATE_SET:
+		{
+			//	extract DataML
+			EventStateSet* data = (EventStateSet*) event->data;
+			XMLNode xmlNode(data->state);
+			DataMLNode nodeState(&xmlNode);
+
+			//	get pars
+			elements = 1;
+			if (nodeState.hasField("elements"))
+				elements = nodeState.getField("elements").getUINT32();
+			if (!elements) berr << "elements must be at least 1";
+			warmup = 100;
+			if (nodeState.hasField("warmup"))
+				warmup = nodeState.getField("warmup").getUINT32();
+
+			//	init state
+			lastService = 0.0;
+			intervals.clear();
+
+			//	ok
+			return C_OK;
+		}
+
+		case EVENT_INIT_PRECONNECT:
+		{
+			//	validate connectivity
+			if (iif.getNumberOfPorts() != 1) berr << "expected 1 input";
+			return C_OK;
+		}
+
+		case EVENT_INIT_CONNECT:
+		{
+			//	on first call
+			if (event->flags & F_FIRST_CALL)
+			{
+				//	create output
+				output.setName("out");
+				output.create(hComponent);
+				output.setStructure(TYPE_DOUBLE | TYPE_REAL, Dims(elements).cdims());
+			}
+
+			//	on last call
+			if (event->flags & F_LAST_CALL)
+			{
+				//	validate input
+				input.attach(hComponent, 0);
+				input.validateStructure(TYPE_DOUBLE | TYPE_REAL, Dims(elements).cdims());
+			}
+
+			//	ok
+			return C_OK;
+		}
+
+		case EVENT_RUN_SERVICE:
+		{
+			//	time since last service is one round trip
+			DOUBLE now = secondsNow();
+			if (lastService != 0.0) intervals.push_back(now - lastService);
+			lastService = now;
+
+			//	return the ball, one further on
+			const DOUBLE* in = (const DOUBLE*) input.getContent();
+			DOUBLE* out = (DOUBLE*) output.getContent();
+			for (UINT32 e=0; e<elements; e++)
+				out[e] = in[e];
+			out[0] += 1.0;
+
+			//	ok
+			return C_OK;
+		}
+
+		case EVENT_RUN_STOP:
+		{
+			//	discard warmup
+			if (intervals.size() <= warmup)
+			{
+				bout << "too few samples to report round trip (" << intervals.size() << ")" << D_WARN;
+				return C_OK;
+			}
+			VDOUBLE t(intervals.begin() + warmup, intervals.end());
+
+			//	summarise (in microseconds)
+			DOUBLE sum = 0.0;
+			for (UINT32 i=0; i<t.size(); i++) sum += t[i];
+			std::sort(t.begin(), t.end());
+			bout << "round trip (" << t.size() << " samples of " << (elements * sizeof(DOUBLE)) << " bytes):" << D_INFO;
+			bout << "mean   " << (sum / t.size() * 1e6) << " us" << D_INFO;
+			bout << "min    " << (t.front() * 1e6) << " us" << D_INFO;
+			bout << "median " << (t[t.size() / 2] * 1e6) << " us" << D_INFO;
+			bout << "99%    " << (t[t.size() * 99 / 100] * 1e6) << " us" << D_INFO;
+			bout << "max    " << (t.back() * 1e6) << " us" << D_INFO;
+
+			//	ok
+			return C_OK;
+		}
+
+	}
+
+	//	if we service the event, we return C_OK
+	//	if we don't, we should return S_NULL to indicate that
+	return S_NULL;
+}
+
+
+
+
+
+
+
+//	include overlay (a second time)
+#include "brahms-1199.h"
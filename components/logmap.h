@@ -0,0 +1,332 @@
+/*
+________________________________________________________________
+
+	This file is part of BRAHMS
+	Copyright (C) 2007 Ben Mitchinson
+	URL: http://brahms.sourceforge.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+________________________________________________________________
+
+*/
+
+#ifndef _COMPONENTS_LOGMAP_H_
+#define _COMPONENTS_LOGMAP_H_
+
+#ifdef __WIN__
+#define WIN32_LEAN_AND_MEAN
+#include "windows.h"
+#endif
+
+#ifdef __NIX__
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <string>
+
+/*	LOG MAP
+
+	A log file written through a memory mapping, so that
+	logging a sample is a memcpy() into the page cache, and
+	the OS does the write-back.
+
+	If the size of the log is known at EVENT_LOG_INIT (as it
+	is for data/numeric), the file is created at that size and
+	mapped whole. If it is not (data/spikes), pass zero, and
+	the file is grown, and the mapping moved along it, in
+	steps of LOG_MAP_EXTENT. Either way, every LOG_MAP_ADVISE
+	bytes we start write-back of what has been written so far
+	and let go of those pages, so a long run doesn't hold its
+	whole log resident. At close(), the file is cut to the
+	bytes actually written.
+
+	open() returns false (leaving nothing open) if the file
+	cannot be created or mapped, or there is no room for it
+	on disk, in which case the caller can use a LogFile (see
+	logwriter.h) instead, which reports why.
+*/
+
+#define LOG_MAP_EXTENT (UINT64(16) << 20)
+#define LOG_MAP_ADVISE (UINT64(8) << 20)
+
+class LogMap
+{
+
+public:
+
+	LogMap();
+	~LogMap();
+
+	//	create file, and map it (bytesExpected zero if unknown)
+	bool open(const char* filename, UINT64 bytesExpected);
+
+	//	append
+	void write(const BYTE* data, UINT64 bytes);
+
+	//	unmap, cut file to length, and close
+	void close();
+
+	bool isOpen() const { return window != NULL; }
+
+private:
+
+	//	not copyable
+	LogMap(const LogMap&);
+	LogMap& operator=(const LogMap&);
+
+	//	map a window at the current position, with room for "bytes" more
+	bool remap(UINT64 bytes);
+	void unmap();
+
+	//	start write-back of complete pages up to "written", and let them go
+	void advise();
+
+	//	grow or cut file
+	bool resize(UINT64 bytes);
+
+	std::string filename;
+	UINT64 granularity;
+
+#ifdef __WIN__
+	HANDLE hFile;
+	HANDLE hMapping;
+#endif
+#ifdef __NIX__
+	int fd;
+#endif
+
+	//	mapped window, and where it sits in the file
+	BYTE* window;
+	UINT64 windowOffset;
+	UINT64 windowBytes;
+
+	UINT64 fileBytes;
+	UINT64 written;
+	UINT64 advised;
+};
+
+
+
+LogMap::LogMap()
+{
+#ifdef __WIN__
+	hFile = INVALID_HANDLE_VALUE;
+	hMapping = NULL;
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	granularity = info.dwAllocationGranularity;
+#endif
+#ifdef __NIX__
+	fd = -1;
+	granularity = sysconf(_SC_PAGESIZE);
+#endif
+
+	window = NULL;
+	windowOffset = 0;
+	windowBytes = 0;
+	fileBytes = 0;
+	written = 0;
+	advised = 0;
+}
+
+LogMap::~LogMap()
+{
+	//	errors can't be reported from here
+	if (window)
+	{
+		unmap();
+		resize(written);
+	}
+
+#ifdef __WIN__
+	if (hFile != INVALID_HANDLE_VALUE) CloseHandle(hFile);
+#endif
+#ifdef __NIX__
+	if (fd != -1) ::close(fd);
+#endif
+}
+
+bool LogMap::open(const char* p_filename, UINT64 bytesExpected)
+{
+	filename = p_filename;
+	written = 0;
+	advised = 0;
+	fileBytes = 0;
+
+#ifdef __WIN__
+	hFile = CreateFileA(p_filename, GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) return false;
+#endif
+#ifdef __NIX__
+	fd = ::open(p_filename, O_RDWR | O_CREAT | O_TRUNC, 0666);
+	if (fd == -1) return false;
+#endif
+
+	//	known size is mapped whole, unknown is mapped an extent at a time
+	if (remap(bytesExpected ? bytesExpected : LOG_MAP_EXTENT)) return true;
+
+	//	fall back (caller will reopen it)
+#ifdef __WIN__
+	CloseHandle(hFile);
+	hFile = INVALID_HANDLE_VALUE;
+#endif
+#ifdef __NIX__
+	::close(fd);
+	fd = -1;
+#endif
+	return false;
+}
+
+bool LogMap::resize(UINT64 bytes)
+{
+#ifdef __WIN__
+	LARGE_INTEGER size;
+	size.QuadPart = bytes;
+	if (!SetFilePointerEx(hFile, size, NULL, FILE_BEGIN) || !SetEndOfFile(hFile)) return false;
+#endif
+#ifdef __NIX__
+	//	growth is allocated, not just sized, since a store to a hole in
+	//	a MAP_SHARED mapping raises SIGBUS if the disk then turns out to
+	//	be full, where this fails instead (SetEndOfFile() allocates, on
+	//	Windows); anything allocated before it failed is cut at close()
+	if (bytes > fileBytes)
+	{
+		if (posix_fallocate(fd, fileBytes, bytes - fileBytes)) return false;
+	}
+	else if (ftruncate(fd, bytes)) return false;
+#endif
+
+	fileBytes = bytes;
+	return true;
+}
+
+bool LogMap::remap(UINT64 bytes)
+{
+	unmap();
+
+	//	window starts at the page we're part way through
+	windowOffset = written - (written % granularity);
+	UINT64 end = written + bytes;
+	if (end > fileBytes)
+	{
+		//	grow by at least an extent, so we don't remap often
+		if (fileBytes && end < fileBytes + LOG_MAP_EXTENT) end = fileBytes + LOG_MAP_EXTENT;
+		if (!resize(end)) return false;
+	}
+
+	//	and runs to the end of the file
+	end = fileBytes;
+	windowBytes = end - windowOffset;
+
+	//	address space for the mapping
+	if (windowBytes != (size_t)windowBytes) return false;
+
+#ifdef __WIN__
+	hMapping = CreateFileMapping(hFile, NULL, PAGE_READWRITE, (DWORD)(end >> 32), (DWORD)end, NULL);
+	if (!hMapping) return false;
+	window = (BYTE*) MapViewOfFile(hMapping, FILE_MAP_WRITE, (DWORD)(windowOffset >> 32), (DWORD)windowOffset, (SIZE_T)windowBytes);
+	if (!window)
+	{
+		CloseHandle(hMapping);
+		hMapping = NULL;
+		return false;
+	}
+#endif
+#ifdef __NIX__
+	void* p = mmap(NULL, windowBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, windowOffset);
+	if (p == MAP_FAILED) return false;
+	window = (BYTE*) p;
+#endif
+
+	return true;
+}
+
+void LogMap::unmap()
+{
+	if (!window) return;
+
+#ifdef __WIN__
+	UnmapViewOfFile(window);
+	CloseHandle(hMapping);
+	hMapping = NULL;
+#endif
+#ifdef __NIX__
+	munmap(window, windowBytes);
+#endif
+
+	window = NULL;
+}
+
+void LogMap::write(const BYTE* data, UINT64 bytes)
+{
+	if (written + bytes > windowOffset + windowBytes)
+	{
+		if (!remap(bytes))
+			berr << "failed to map file \"" << filename << "\"";
+	}
+
+	memcpy(window + (written - windowOffset), data, bytes);
+	written += bytes;
+
+	if (written - advised >= LOG_MAP_ADVISE) advise();
+}
+
+void LogMap::advise()
+{
+	//	whole pages, within the window, that are finished with
+	UINT64 first = advised > windowOffset ? advised : windowOffset;
+	first -= first % granularity;
+	UINT64 last = written - (written % granularity);
+	if (last <= first) return;
+
+	BYTE* p = window + (first - windowOffset);
+	size_t n = last - first;
+
+#ifdef __WIN__
+	FlushViewOfFile(p, n);
+#endif
+#ifdef __NIX__
+	msync(p, n, MS_ASYNC);
+	madvise(p, n, MADV_DONTNEED);
+#endif
+
+	advised = last;
+}
+
+void LogMap::close()
+{
+	if (!window) return;
+
+	unmap();
+	bool ok = resize(written);
+
+#ifdef __WIN__
+	if (!CloseHandle(hFile)) ok = false;
+	hFile = INVALID_HANDLE_VALUE;
+#endif
+#ifdef __NIX__
+	if (::close(fd)) ok = false;
+	fd = -1;
+#endif
+
+	if (!ok)
+		berr << "failed to write file \"" << filename << "\"";
+}
+
+#endif // _COMPONENTS_LOGMAP_H_
@@ -0,0 +1,676 @@
+/*
+________________________________________________________________
+
+	This file is part of BRAHMS
+	Copyright (C) 2007 Ben Mitchinson
+	URL: http://brahms.sourceforge.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+________________________________________________________________
+
+*/
+
+#ifndef _COMPONENTS_LOGWRITER_H_
+#define _COMPONENTS_LOGWRITER_H_
+
+#ifdef __WIN__
+#define WIN32_LEAN_AND_MEAN
+#include "windows.h"
+#endif
+
+#ifdef __NIX__
+#include <pthread.h>
+#endif
+
+#include <cstdio>
+#include <deque>
+#include <vector>
+
+#include "components/mutex.h"
+
+//	chunk format, and codec (lz.cpp is built into each module that uses this)
+#include "brahms-logfile.h"
+#include "lz.h"
+
+/*	LOG WRITER
+
+	EVENT_LOG_SERVICE is fired on the worker thread that is
+	releasing the output being logged, so a write() to disk
+	there stalls the simulation for as long as the disk
+	takes. Instead, each LogFile appends into a small ring of
+	fixed-size buffers, and a full buffer is handed to the
+	LogWriter, which owns one I/O thread for this module and
+	writes buffers out in the order they were handed over.
+	That is one thread per process, not per voice: voices run
+	in one process (--loopback-N) share the module, and so
+	share the writer, which is safe because its queue and its
+	users count are guarded, and each file has its own buffers.
+
+	The worker only blocks if every buffer of a file is still
+	waiting to be written, so the memory held per file is
+	bounded at LOG_BUFFER_COUNT * LOG_BUFFER_BYTES, and disk
+	time is overlapped with computation rather than added to
+	it. A write that fails on the I/O thread is reported on
+	the worker at the next write() or close().
+*/
+
+#define LOG_BUFFER_COUNT 3
+#define LOG_BUFFER_BYTES 65536
+
+//	size of a chunk, for chunked files (see LOG_CHUNKS in brahms-logfile.h)
+#define LOG_CHUNK_BYTES (UINT64(1) << 20)
+
+class LogWriter;
+
+////////////////	SYNC
+
+//	a mutex and a condition on it, which is all the I/O thread and its clients share
+struct LogWriterSync
+{
+	LogWriterSync();
+	~LogWriterSync() throw();
+
+	void lock();
+	void release();
+	void wait();
+	void broadcast();
+
+private:
+#ifdef __WIN__
+	CRITICAL_SECTION cs;
+	CONDITION_VARIABLE cv;
+#endif
+#ifdef __NIX__
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+#endif
+};
+
+#ifdef __WIN__
+LogWriterSync::LogWriterSync()
+{
+	InitializeCriticalSection(&cs);
+	InitializeConditionVariable(&cv);
+}
+
+LogWriterSync::~LogWriterSync() throw()
+{
+	DeleteCriticalSection(&cs);
+}
+
+void LogWriterSync::lock()
+{
+	EnterCriticalSection(&cs);
+}
+
+void LogWriterSync::release()
+{
+	LeaveCriticalSection(&cs);
+}
+
+void LogWriterSync::wait()
+{
+	SleepConditionVariableCS(&cv, &cs, INFINITE);
+}
+
+void LogWriterSync::broadcast()
+{
+	WakeAllConditionVariable(&cv);
+}
+#endif
+
+#ifdef __NIX__
+LogWriterSync::LogWriterSync()
+{
+	if (pthread_mutex_init(&mutex, NULL)) berr << "pthread_mutex_init() failed";
+	if (pthread_cond_init(&cond, NULL)) berr << "pthread_cond_init() failed";
+}
+
+LogWriterSync::~LogWriterSync() throw()
+{
+	pthread_cond_destroy(&cond);
+	pthread_mutex_destroy(&mutex);
+}
+
+void LogWriterSync::lock()
+{
+	if (pthread_mutex_lock(&mutex)) berr << "pthread_mutex_lock() failed";
+}
+
+void LogWriterSync::release()
+{
+	if (pthread_mutex_unlock(&mutex)) berr << "pthread_mutex_unlock() failed";
+}
+
+void LogWriterSync::wait()
+{
+	if (pthread_cond_wait(&cond, &mutex)) berr << "pthread_cond_wait() failed";
+}
+
+void LogWriterSync::broadcast()
+{
+	pthread_cond_broadcast(&cond);
+}
+#endif
+
+
+
+////////////////	LOG FILE
+
+class LogFile
+{
+	friend class LogWriter;
+
+public:
+
+	LogFile();
+	~LogFile();
+
+	//	open, sizing buffers for a file of (about) bytesExpected (zero if unknown)
+	void open(const char* filename, UINT64 bytesExpected);
+
+	//	open as chunked (see LOG_CHUNKS), elements being "width" bytes
+	void openChunked(const char* filename, UINT64 chunkBytes, UINT32 width, bool compress);
+
+	//	what is logged, for the file's info (chunked only, before close())
+	void describe(const char* className, const std::string& structure, TYPE type, UINT32 sampleBytes, SampleRate sampleRate);
+	void setSampleCount(UINT64 samples) { sampleCount = samples; }
+
+	//	append (returns once data is copied, not once it is on disk)
+	void write(const BYTE* data, UINT64 bytes);
+
+	//	append one log sample (chunked only; several calls may share a sample)
+	void writeSample(const BYTE* data, UINT64 bytes, UINT64 sample);
+
+	//	wait for everything to reach the file, and close it
+	void close();
+
+	bool isOpen() const { return fid != NULL; }
+
+private:
+
+	//	not copyable (buffers may be in the writer's queue)
+	LogFile(const LogFile&);
+	LogFile& operator=(const LogFile&);
+
+	struct Buffer
+	{
+		VBYTE data;
+		UINT32 used;
+		bool queued;
+
+		//	samples in buffer (chunked only)
+		UINT64 firstSample;
+		UINT64 lastSample;
+	};
+
+	//	hand over the current buffer, and wait for the next to be free
+	void flush();
+
+	//	wait for all buffers, and close (true if everything was written)
+	bool finish();
+
+	//	write index, info and trailer (chunked only)
+	bool writeFooter();
+
+	FILE* fid;
+	std::string filename;
+	Buffer buffers[LOG_BUFFER_COUNT];
+	UINT32 current;
+
+	//	chunked (see LOG_CHUNKS)
+	bool chunked;
+	bool compress;
+	UINT32 width;
+	UINT64 sampleCount;
+	brahms::logfile::Info info;
+	std::string className;
+	std::string structure;
+
+	//	where the I/O thread has got to in the file, and where it put the chunks
+	UINT64 offset;
+	std::vector<brahms::logfile::IndexEntry> index;
+
+	//	set on the I/O thread
+	bool failed;
+};
+
+
+
+////////////////	LOG WRITER
+
+class LogWriter
+{
+
+public:
+
+	//	the one per module
+	static LogWriter& instance()
+	{
+		static LogWriter writer;
+		return writer;
+	}
+
+	//	files register while open, and the thread runs while there are any
+	void attach();
+	void detach();
+
+	//	queue buffer for writing
+	void submit(LogFile* file, LogFile::Buffer* buffer);
+
+	//	wait until buffer is not queued (true if the file has not failed)
+	bool wait(LogFile* file, LogFile::Buffer* buffer);
+
+	LogWriterSync sync;
+
+private:
+
+	LogWriter()
+	{
+		users = 0;
+		stopping = false;
+	}
+
+	//	files that are never closed (because the run ended in an error) leave
+	//	the thread running, and it must stop before "sync" can be destroyed,
+	//	since pthread_cond_destroy() waits for waiters that will never leave
+	//	(there is nothing to wait for on Windows, where a CONDITION_VARIABLE
+	//	is not destroyed, and joining under the loader lock would deadlock)
+	~LogWriter()
+	{
+#ifdef __NIX__
+		sync.lock();
+		bool running = users != 0;
+		stopping = true;
+		sync.broadcast();
+		sync.release();
+
+		if (running) join();
+#endif
+	}
+
+	void run();
+	void join();
+
+	//	write buffer out (on the I/O thread)
+	bool write(LogFile* file, LogFile::Buffer* buffer);
+
+#ifdef __WIN__
+	static DWORD WINAPI entry(LPVOID arg)
+	{
+		((LogWriter*)arg)->run();
+		return 0;
+	}
+	HANDLE thread;
+#endif
+#ifdef __NIX__
+	static void* entry(void* arg)
+	{
+		((LogWriter*)arg)->run();
+		return NULL;
+	}
+	pthread_t thread;
+#endif
+
+	struct Item
+	{
+		LogFile* file;
+		LogFile::Buffer* buffer;
+	};
+
+	//	held across starting and stopping the thread, so they can't overlap
+	Mutex lifecycle;
+
+	std::deque<Item> queue;
+	UINT32 users;
+	bool stopping;
+
+	//	encoding buffers (I/O thread only)
+	VBYTE shuffled;
+	VBYTE encoded;
+};
+
+void LogWriter::attach()
+{
+	MutexLocker locker(lifecycle);
+
+	sync.lock();
+	bool start = !users++;
+	stopping = false;
+	sync.release();
+
+	if (start)
+	{
+#ifdef __WIN__
+		thread = CreateThread(NULL, 0, entry, this, 0, NULL);
+		if (!thread) berr << "failed to start log writer thread";
+#endif
+#ifdef __NIX__
+		if (pthread_create(&thread, NULL, entry, this)) berr << "failed to start log writer thread";
+#endif
+	}
+}
+
+void LogWriter::detach()
+{
+	MutexLocker locker(lifecycle);
+
+	sync.lock();
+	bool stop = !--users;
+	if (stop) stopping = true;
+	sync.broadcast();
+	sync.release();
+
+	//	the queue is empty by now, since files drain before they detach
+	if (stop) join();
+}
+
+void LogWriter::join()
+{
+#ifdef __WIN__
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+#endif
+#ifdef __NIX__
+	pthread_join(thread, NULL);
+#endif
+}
+
+void LogWriter::submit(LogFile* file, LogFile::Buffer* buffer)
+{
+	Item item;
+	item.file = file;
+	item.buffer = buffer;
+
+	sync.lock();
+	buffer->queued = true;
+	queue.push_back(item);
+	sync.broadcast();
+	sync.release();
+}
+
+bool LogWriter::wait(LogFile* file, LogFile::Buffer* buffer)
+{
+	sync.lock();
+	while (buffer->queued) sync.wait();
+	bool ok = !file->failed;
+	sync.release();
+	return ok;
+}
+
+void LogWriter::run()
+{
+	sync.lock();
+
+	while (true)
+	{
+		while (queue.empty() && !stopping) sync.wait();
+		if (queue.empty()) break;
+
+		Item item = queue.front();
+		queue.pop_front();
+
+		//	write without holding the lock, so clients can keep queueing
+		sync.release();
+		LogFile::Buffer* buffer = item.buffer;
+		bool ok = !item.file->failed && write(item.file, buffer);
+		sync.lock();
+
+		if (!ok) item.file->failed = true;
+		buffer->used = 0;
+		buffer->queued = false;
+		sync.broadcast();
+	}
+
+	sync.release();
+}
+
+
+
+bool LogWriter::write(LogFile* file, LogFile::Buffer* buffer)
+{
+	using namespace brahms::logfile;
+
+	if (!file->chunked)
+		return fwrite(&buffer->data[0], buffer->used, 1, file->fid) == 1;
+
+	ChunkHeader header;
+	header.magic = CHUNK_MAGIC;
+	header.codec = CODEC_STORED;
+	header.width = file->width;
+	header.reserved = 0;
+	header.rawBytes = buffer->used;
+	header.storedBytes = buffer->used;
+	header.firstSample = buffer->firstSample;
+	header.lastSample = buffer->lastSample;
+	const UINT8* payload = &buffer->data[0];
+
+	if (file->compress)
+	{
+		//	shuffle, if elements are a width it helps with
+		UINT8 codec = CODEC_LZ;
+		const UINT8* src = &buffer->data[0];
+		if (file->width == 4 || file->width == 8)
+		{
+			codec = file->width == 4 ? CODEC_SHUFFLE4_LZ : CODEC_SHUFFLE8_LZ;
+			if (shuffled.size() < buffer->used) shuffled.resize(buffer->used);
+			shuffle(src, buffer->used, file->width, &shuffled[0]);
+			src = &shuffled[0];
+		}
+
+		//	compress (or store, if that's no smaller)
+		UINT32 bound = lzBound(buffer->used);
+		if (encoded.size() < bound) encoded.resize(bound);
+		UINT32 storedBytes = lzCompress(src, buffer->used, &encoded[0]);
+		if (storedBytes < buffer->used)
+		{
+			header.codec = codec;
+			header.storedBytes = storedBytes;
+			payload = &encoded[0];
+		}
+	}
+
+	if (fwrite(&header, sizeof(header), 1, file->fid) != 1) return false;
+	if (fwrite(payload, header.storedBytes, 1, file->fid) != 1) return false;
+
+	//	index it
+	IndexEntry entry;
+	entry.offset = file->offset;
+	entry.firstSample = header.firstSample;
+	entry.lastSample = header.lastSample;
+	entry.rawBytes = header.rawBytes;
+	entry.storedBytes = header.storedBytes;
+	file->index.push_back(entry);
+	file->offset += sizeof(header) + header.storedBytes;
+
+	return true;
+}
+
+
+
+////////////////	LOG FILE
+
+LogFile::LogFile()
+{
+	fid = NULL;
+	current = 0;
+	chunked = false;
+	compress = false;
+	width = 0;
+	sampleCount = 0;
+	memset(&info, 0, sizeof(info));
+	offset = 0;
+	failed = false;
+	for (UINT32 b=0; b<LOG_BUFFER_COUNT; b++)
+	{
+		buffers[b].used = 0;
+		buffers[b].queued = false;
+	}
+}
+
+LogFile::~LogFile()
+{
+	//	errors can't be reported from here (we're being torn down anyway)
+	if (fid) finish();
+}
+
+void LogFile::open(const char* p_filename, UINT64 bytesExpected)
+{
+	filename = p_filename;
+	fid = fopen(p_filename, "wb");
+	if (!fid)
+		berr << "failed to open file \"" << filename << "\"";
+
+	//	no point holding more than the whole file (if we know how big it will be)
+	UINT64 bytes = LOG_BUFFER_BYTES;
+	if (bytesExpected && bytesExpected < bytes) bytes = bytesExpected;
+	for (UINT32 b=0; b<LOG_BUFFER_COUNT; b++)
+	{
+		buffers[b].data.resize(bytes);
+		buffers[b].used = 0;
+		buffers[b].queued = false;
+	}
+	current = 0;
+	chunked = false;
+	offset = 0;
+	index.clear();
+	failed = false;
+
+	LogWriter::instance().attach();
+}
+
+void LogFile::openChunked(const char* p_filename, UINT64 chunkBytes, UINT32 p_width, bool p_compress)
+{
+	open(p_filename, 0);
+	chunked = true;
+	compress = p_compress;
+	width = p_width;
+	sampleCount = 0;
+
+	for (UINT32 b=0; b<LOG_BUFFER_COUNT; b++)
+		buffers[b].data.resize(chunkBytes ? chunkBytes : 1);
+}
+
+void LogFile::describe(const char* p_className, const std::string& p_structure, TYPE type, UINT32 sampleBytes, SampleRate sampleRate)
+{
+	className = p_className;
+	structure = p_structure;
+	memset(&info, 0, sizeof(info));
+	info.sampleRate = sampleRate;
+	info.type = type;
+	info.sampleBytes = sampleBytes;
+	info.classBytes = (UINT16) className.length();
+	info.structureBytes = (UINT16) structure.length();
+}
+
+void LogFile::write(const BYTE* data, UINT64 bytes)
+{
+	while (bytes)
+	{
+		Buffer& buffer = buffers[current];
+		UINT64 space = buffer.data.size() - buffer.used;
+		UINT64 n = bytes < space ? bytes : space;
+		memcpy(&buffer.data[buffer.used], data, n);
+		buffer.used += n;
+		data += n;
+		bytes -= n;
+
+		if (buffer.used == buffer.data.size()) flush();
+	}
+}
+
+void LogFile::writeSample(const BYTE* data, UINT64 bytes, UINT64 sample)
+{
+	//	chunks end at a sample boundary
+	Buffer* buffer = &buffers[current];
+	if (buffer->used && buffer->lastSample != sample && buffer->used + bytes > buffer->data.size())
+	{
+		flush();
+		buffer = &buffers[current];
+	}
+
+	//	a sample bigger than a chunk gets a chunk to itself
+	if (buffer->used + bytes > buffer->data.size())
+		buffer->data.resize(buffer->used + bytes);
+
+	if (!buffer->used) buffer->firstSample = sample;
+	buffer->lastSample = sample;
+	memcpy(&buffer->data[buffer->used], data, bytes);
+	buffer->used += bytes;
+}
+
+void LogFile::flush()
+{
+	LogWriter& writer = LogWriter::instance();
+	writer.submit(this, &buffers[current]);
+	current = (current + 1) % LOG_BUFFER_COUNT;
+
+	//	backpressure: only blocks if the disk is LOG_BUFFER_COUNT buffers behind
+	if (!writer.wait(this, &buffers[current]))
+		berr << "failed to write file \"" << filename << "\"";
+}
+
+bool LogFile::finish()
+{
+	LogWriter& writer = LogWriter::instance();
+	if (buffers[current].used) writer.submit(this, &buffers[current]);
+
+	bool ok = true;
+	for (UINT32 b=0; b<LOG_BUFFER_COUNT; b++)
+		if (!writer.wait(this, &buffers[b])) ok = false;
+
+	writer.detach();
+
+	//	the I/O thread is done with the file, so we can finish it here
+	if (ok && chunked && !writeFooter()) ok = false;
+
+	if (fclose(fid)) ok = false;
+	fid = NULL;
+
+	//	release buffers
+	for (UINT32 b=0; b<LOG_BUFFER_COUNT; b++)
+		VBYTE().swap(buffers[b].data);
+	std::vector<brahms::logfile::IndexEntry>().swap(index);
+
+	return ok;
+}
+
+bool LogFile::writeFooter()
+{
+	using namespace brahms::logfile;
+
+	Trailer trailer;
+	trailer.indexOffset = offset;
+	trailer.sampleCount = sampleCount;
+	trailer.chunkCount = (UINT32) index.size();
+	trailer.infoBytes = sizeof(info) + info.classBytes + info.structureBytes;
+	trailer.version = FORMAT_VERSION;
+	trailer.magic = TRAILER_MAGIC;
+
+	if (index.size() && fwrite(&index[0], sizeof(IndexEntry) * index.size(), 1, fid) != 1) return false;
+	if (fwrite(&info, sizeof(info), 1, fid) != 1) return false;
+	if (className.length() && fwrite(className.c_str(), info.classBytes, 1, fid) != 1) return false;
+	if (structure.length() && fwrite(structure.c_str(), info.structureBytes, 1, fid) != 1) return false;
+	return fwrite(&trailer, sizeof(trailer), 1, fid) == 1;
+}
+
+void LogFile::close()
+{
+	if (!fid) return;
+	if (!finish())
+		berr << "failed to write file \"" << filename << "\"";
+}
+
+#endif // _COMPONENTS_LOGWRITER_H_
@@ -45,7 +45,10 @@ ________________________________________________________________
 // EVENT_DATA_STRUCTURE_GET appears in data_numeric.h.
 #include "components/data.h"
 
-#include "mutex.h"
+#include "components/mutex.h"
+#include "components/logwriter.h"
+#include "components/logmap.h"
+#include "logreduce.h"
 
 #include <iostream>
 using namespace std;
@@ -54,6 +57,10 @@ using namespace std;
 #include "data_numeric.h" // defines EVENT_DATA_STRUCTURE_GET
 namespace numeric = std_2009_data_numeric_0;
 
+//	logs smaller than this are held in memory even if over the budget, so that
+//	a small budget (OnlyDisk has none) doesn't leave every log holding a file
+#define LOG_SPILL_MIN_BYTES (UINT64(1) << 20)
+
 
 ////////////////	LAYOUT CONVERSION BUFFER
 
@@ -161,13 +168,19 @@ public:
 	TYPE complexityFromString(const string& complexityString);
 	Dims dimsFromString(string dims);
 
+	//	as EVENT_GENERIC_STRUCTURE_GET, leaving out complex format and ordering if they are in "omit"
+	string structureToString(TYPE omit);
+
 	void getReadBuffer(TYPE type, const void*& p_real, const void*& p_imag, UINT64& bytes);
 
 	void NullFile();
-	void OpenFile(const char* filename);
+	void OpenFile(const char* filename, UINT64 bytesExpected);
 	void CloseFile();
 	void WriteFile(const BYTE* buffer, UINT64 bytes);
 
+	//	log over the memory budget, written to file instead (see LOG_MEMORY_BUDGET)
+	bool OpenSpill(const char* filename, UINT64 bytesExpected);
+
 
 ////////////////	STATE
 
@@ -181,7 +194,9 @@ private:
 	//	state
 	UINT32 contentHeaderBytes;
 	void resizeState();
+	void homeState();
 	VBYTE						headerAndState;				//	real and imaginary alongside (imaginary is there only if we are complex)
+	bool						adopted;					//	true if p_state points into a stream adopted in EVENT_CONTENT_ADOPT, rather than at headerAndState
 
 	//	layout conversion buffers (interleaved/adjacent, column-major/row-major)
 	ConversionBuffers conversion;
@@ -201,6 +216,12 @@ private:
 	//	with real/imag as the leading dimension
 	VBYTE log1, log2;
 
+	//	if an encapsulated log doesn't fit what is left of the voice's memory
+	//	budget, it is "spilled": written to its file through outmap, as if it
+	//	were not encapsulated, and the report refers to the file rather than
+	//	holding the log
+	bool Spilled;
+
 
 
 	/*
@@ -220,6 +241,13 @@ private:
 		Yuh, works fine also on windows. I may as well change the data/spikes
 		class for the same reason I guess.
 
+		The C file is now written through a LogFile, so that the worker
+		thread only copies into a buffer and the writing happens on the
+		I/O thread (see logwriter.h). Since we know the size of the log
+		up front, we usually map it instead (see logmap.h), and keep the
+		LogFile for when the buffering policy favours disk, or mapping
+		fails.
+
 	*/
 
 //#define USE_CPP_FILE_IO
@@ -227,13 +255,20 @@ private:
 #ifdef USE_CPP_FILE_IO
 	ofstream					outfile;
 #else
-	FILE*						outfid;
+	LogMap						outmap;
+	LogFile						outlog;
 #endif
 
 	//	parameters
 	bool Encapsulated;
 	bool WouldHaveBeenUnencapsulated;
 	bool BufferToMemory;
+	bool Chunked;
+	bool Compressed;
+
+	//	decimation or aggregation of samples into the log (see logreduce.h), and samples logged
+	LogReducer logReducer;
+	UINT64 logCount;
 
 	//	temp
 	string outputFilename;
@@ -278,6 +313,9 @@ inline void COMPONENT_CLASS_CPP::setState(const void* q_real, const void* q_imag
 	//	if zero size, nothing to do
 	if (!structure.numberOfBytesTotal) return;
 
+	//	write to our own storage
+	homeState();
+
 	//	check size is correct, if supplied
 	if (bytes && (bytes != structure.numberOfBytesReal)) berr << "wrong number of bytes supplied";
 
@@ -363,6 +401,40 @@ Dims COMPONENT_CLASS_CPP::dimsFromString(string sdims)
 	return dims;
 }
 
+string COMPONENT_CLASS_CPP::structureToString(TYPE omit)
+{
+	//	format: <type>/<REAL|COMPLEX_ADJACENT|COMPLEX_INTERLEAVED>/<comma-separated-dims>
+	ostringstream ss;
+	ss << getElementTypeString(structure.type);
+	switch (structure.type & TYPE_COMPLEX_MASK)
+	{
+		case TYPE_REAL: ss << "/REAL/"; break;
+		case TYPE_COMPLEX: ss << "/COMPLEX/"; break;
+	}
+	if (!(omit & TYPE_CPXFMT_MASK))
+	{
+		switch (structure.type & TYPE_CPXFMT_MASK)
+		{
+			case TYPE_CPXFMT_ADJACENT: ss << "CPXFMT_ADJACENT/"; break;
+			case TYPE_CPXFMT_INTERLEAVED: ss << "CPXFMT_INTERLEAVED/"; break;
+		}
+	}
+	if (!(omit & TYPE_ORDER_MASK))
+	{
+		switch (structure.type & TYPE_ORDER_MASK)
+		{
+			case TYPE_ORDER_COLUMN_MAJOR: ss << "COLUMN_MAJOR/"; break;
+			case TYPE_ORDER_ROW_MAJOR: ss << "ROW_MAJOR/"; break;
+		}
+	}
+	for (UINT32 d=0; d<structure.dims.count; d++)
+	{
+		if (d) ss << ",";
+		ss << structure.dims.dims[d];
+	}
+	return ss.str();
+}
+
 
 void COMPONENT_CLASS_CPP::getReadBuffer(TYPE type, const void*& p_real, const void*& p_imag, UINT64& bytes)
 {
@@ -650,6 +722,7 @@ void COMPONENT_CLASS_CPP::getReadBuffer(TYPE type, const void*& p_real, const vo
 COMPONENT_CLASS_CPP::COMPONENT_CLASS_CPP()
 {
 	contentHeaderBytes = 0;
+	adopted = false;
 
 	____CLEAR(structure);
 	____CLEAR(p_state);
@@ -668,7 +741,10 @@ COMPONENT_CLASS_CPP::COMPONENT_CLASS_CPP()
 
 COMPONENT_CLASS_CPP::~COMPONENT_CLASS_CPP()
 {
+#ifdef USE_CPP_FILE_IO
 	CloseFile();
+#endif
+	//	(outmap and outlog close themselves, but can't report errors from here)
 }
 
 
@@ -679,6 +755,7 @@ COMPONENT_CLASS_CPP::COMPONENT_CLASS_CPP(const COMPONENT_CLASS_CPP& src) : Data(
 	//	our local state, not the src->state! note that "state = src.state" does not copy
 	//	state.capacity(), either. doesn't matter here, but be careful!
 	contentHeaderBytes = src.contentHeaderBytes;
+	adopted = false;
 
 	//	set structure does this quite safely!
 	setStructure(&src.structure);
@@ -705,12 +782,14 @@ void COMPONENT_CLASS_CPP::NullFile()
 #ifdef USE_CPP_FILE_IO
 	//	no action needed
 #else
-	//	null file descriptor
-	outfid = NULL;
+	//	no action needed (a LogFile starts closed)
 #endif
+
+	//	nor spilling
+	Spilled = false;
 }
 
-void COMPONENT_CLASS_CPP::OpenFile(const char* filename)
+void COMPONENT_CLASS_CPP::OpenFile(const char* filename, UINT64 bytesExpected)
 {
 	//	open file
 	outputFilename = filename;
@@ -719,26 +798,49 @@ void COMPONENT_CLASS_CPP::OpenFile(const char* filename)
 	if (!outfile.is_open())
 		berr << "failed to open file \"" << filename << "\"";
 #else
-	outfid = fopen(filename, "wb");
-	if (!outfid)
-		berr << "failed to open file \"" << filename << "\"";
+	//	chunks are built on the I/O thread, so they can't be mapped (see LOG_CHUNKS)
+	if (Chunked)
+	{
+		UINT64 samples = LOG_CHUNK_BYTES / structure.numberOfBytesTotal;
+		outlog.openChunked(filename, (samples ? samples : 1) * structure.numberOfBytesTotal, structure.bytesPerElement, Compressed);
+		SampleRate sampleRate = time->sampleRate;
+		sampleRate.den *= logReducer.getWindow();
+		outlog.describe(COMPONENT_CLASS_STRING, structureToString(TYPE_UNSPECIFIED), structure.type, structure.numberOfBytesTotal, sampleRate);
+		return;
+	}
+
+	//	mapping leaves it to the page cache, which only disk-favouring policies rule out
+	bool favourDisk = executionInfo->BufferingPolicy == C_BUFFERING_ONLY_DISK || executionInfo->BufferingPolicy == C_BUFFERING_FAVOUR_DISK;
+	if (bytesExpected && !favourDisk && outmap.open(filename, bytesExpected)) return;
+	outlog.open(filename, bytesExpected);
 #endif
 }
 
 void COMPONENT_CLASS_CPP::CloseFile()
 {
-	//	close file
+	//	close file (waits for the I/O thread to finish with it)
 #ifdef USE_CPP_FILE_IO
 	if (outfile.is_open()) outfile.close();
 #else
-	if (outfid)
-	{
-		fclose(outfid);
-		outfid = NULL;
-	}
+	outmap.close();
+	outlog.close();
 #endif
 }
 
+bool COMPONENT_CLASS_CPP::OpenSpill(const char* filename, UINT64 bytesExpected)
+{
+	//	only mapped, so it goes through the page cache, and is let go of as it
+	//	is written (if we can't, hold it in memory after all)
+	outputFilename = filename;
+	if (outmap.open(filename, bytesExpected)) return true;
+	remove(filename);
+
+	string name = "<unknown>";
+	if (componentData) name = componentData->name;
+	bout << "log of \"" << name << "\" is over the memory budget, but could not be spilled to \"" << filename << "\", so is held in memory" << D_WARN;
+	return false;
+}
+
 void COMPONENT_CLASS_CPP::WriteFile(const BYTE* buffer, UINT64 bytes)
 {
 	//	write file
@@ -747,8 +849,8 @@ void COMPONENT_CLASS_CPP::WriteFile(const BYTE* buffer, UINT64 bytes)
 	if (outfile.bad())
 		berr << "failed to write file \"" << outputFilename << "\"";
 #else
-	if (fwrite(buffer, bytes, 1, outfid) != 1)
-		berr << "failed to write file \"" << outputFilename << "\"";
+	if (outmap.isOpen()) outmap.write(buffer, bytes);
+	else outlog.write(buffer, bytes);
 #endif
 }
 
@@ -769,6 +871,8 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 			//	just read state array
 			if (structure.numberOfBytesTotal != ec->bytes)
 				berr << "stream length incorrect in EVENT_CONTENT_SET (" << ec->bytes << " instead of " << structure.numberOfBytesTotal << ")";
+			homeState();
+			conversion.invalidate();
 			if (structure.numberOfBytesTotal) // avoids taking &state[0] if state is an empty vector, which is a seg fault in CL14
 				memcpy((void*)p_state.real, ec->stream, ec->bytes);
 
@@ -776,12 +880,35 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 			return C_OK;
 		}
 
+		case EVENT_CONTENT_ADOPT:
+		{
+			EventContent* ec = (EventContent*) event->data;
+
+			//	read state array in place (it stays put until we are next written)
+			if (structure.numberOfBytesTotal != ec->bytes)
+				berr << "stream length incorrect in EVENT_CONTENT_ADOPT (" << ec->bytes << " instead of " << structure.numberOfBytesTotal << ")";
+			conversion.invalidate();
+			if (structure.numberOfBytesTotal)
+			{
+				p_state.real = ec->stream;
+				p_state.imag = (structure.type & TYPE_COMPLEX) ? (ec->stream + structure.numberOfBytesReal) : NULL;
+				adopted = true;
+			}
+
+			//	ok
+			return C_OK;
+		}
+
 
 
 		case EVENT_CONTENT_GET:
 		{
 			EventContent* ec = (EventContent*) event->data;
 
+			//	stream has to be our own storage, with its header space
+			if (adopted)
+				memcpy(&headerAndState[contentHeaderBytes], p_state.real, structure.numberOfBytesTotal);
+
 			ec->stream = &headerAndState[0];
 			ec->bytes = structure.numberOfBytesTotal;
 
@@ -797,6 +924,14 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 
 			//	cast input
 			COMPONENT_CLASS_CPP* src = (COMPONENT_CLASS_CPP*) el->source;
+			const BYTE* sample = (const BYTE*) src->p_state.real;
+
+			//	reduce, logging only when a window is complete
+			if (logReducer.getWindow() > 1)
+			{
+				if (!logReducer.add(sample)) return C_OK;
+				sample = logReducer.getResult();
+			}
 
 			//	to file
 			if (!BufferToMemory)
@@ -804,7 +939,11 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 				//	this interleaves real & complex, so we'll have to uninterleave them when we read them
 
 				//	write to output file
-				WriteFile((const BYTE*)src->p_state.real, structure.numberOfBytesTotal);
+#ifndef USE_CPP_FILE_IO
+				if (Chunked) outlog.writeSample(sample, structure.numberOfBytesTotal, logCount);
+				else
+#endif
+				WriteFile(sample, structure.numberOfBytesTotal);
 			}
 
 			//	to memory
@@ -819,7 +958,7 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 						{
 							UINT32 offset = log1.size();
 							log1.resize(offset + structure.numberOfBytesReal);
-							memcpy(&log1[offset], src->p_state.real, structure.numberOfBytesReal);
+							memcpy(&log1[offset], sample, structure.numberOfBytesReal);
 							break;
 						}
 
@@ -827,9 +966,9 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 						{
 							UINT32 offset = log1.size();
 							log1.resize(offset + structure.numberOfBytesReal);
-							memcpy(&log1[offset], src->p_state.real, structure.numberOfBytesReal);
+							memcpy(&log1[offset], sample, structure.numberOfBytesReal);
 							log2.resize(offset + structure.numberOfBytesReal);
-							memcpy(&log2[offset], src->p_state.imag, structure.numberOfBytesReal);
+							memcpy(&log2[offset], sample + structure.numberOfBytesReal, structure.numberOfBytesReal);
 							break;
 						}
 
@@ -837,7 +976,7 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 						{
 							UINT32 offset = log1.size();
 							log1.resize(offset + structure.numberOfBytesReal * 2);
-							memcpy(&log1[offset], src->p_state.real, structure.numberOfBytesReal * 2);
+							memcpy(&log1[offset], sample, structure.numberOfBytesReal * 2);
 							break;
 						}
 
@@ -847,6 +986,7 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 			}
 
 			//	ok
+			logCount++;
 			return C_OK;
 		}
 
@@ -861,36 +1001,7 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 		{
 			EventGenericStructure* eas = (EventGenericStructure*) event->data;
 
-			//	format: <type>/<REAL|COMPLEX_ADJACENT|COMPLEX_INTERLEAVED>/<comma-separated-dims>
-			ostringstream ss;
-			ss << getElementTypeString(structure.type);
-			switch (structure.type & TYPE_COMPLEX_MASK)
-			{
-				case TYPE_REAL: ss << "/REAL/"; break;
-				case TYPE_COMPLEX: ss << "/COMPLEX/"; break;
-			}
-			if (!(eas->type & TYPE_CPXFMT_MASK))
-			{
-				switch (structure.type & TYPE_CPXFMT_MASK)
-				{
-					case TYPE_CPXFMT_ADJACENT: ss << "CPXFMT_ADJACENT/"; break;
-					case TYPE_CPXFMT_INTERLEAVED: ss << "CPXFMT_INTERLEAVED/"; break;
-				}
-			}
-			if (!(eas->type & TYPE_ORDER_MASK))
-			{
-				switch (structure.type & TYPE_ORDER_MASK)
-				{
-					case TYPE_ORDER_COLUMN_MAJOR: ss << "COLUMN_MAJOR/"; break;
-					case TYPE_ORDER_ROW_MAJOR: ss << "ROW_MAJOR/"; break;
-				}
-			}
-			for (UINT32 d=0; d<structure.dims.count; d++)
-			{
-				if (d) ss << ",";
-				ss << structure.dims.dims[d];
-			}
-			eas_str = ss.str();
+			eas_str = structureToString(eas->type);
 
 			eas->structure = eas_str.c_str();
 
@@ -1026,15 +1137,16 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 				//	store
 				contentHeaderBytes = eic->contentHeaderBytes;
 
-				//	get pointer to old content
-				BYTE* old = (BYTE*) p_state.real;
+				//	take a copy of old content (resizing may move it)
+				const BYTE* src = (const BYTE*) p_state.real;
+				VBYTE old(src, src + structure.numberOfBytesTotal);
 
 				//	resize buffer
 				resizeState();
 
-				//	copy any spikes that may be present
+				//	copy back any content that may be present
 				if (structure.numberOfBytesTotal)
-					memmove((void*)p_state.real, old, structure.numberOfBytesTotal);
+					memcpy((void*)p_state.real, &old[0], structure.numberOfBytesTotal);
 
 				//	and zero the header
 				memset(&headerAndState[0], 0, contentHeaderBytes);
@@ -1067,6 +1179,14 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 			{
 				//	...mark that data has changed
 				conversion.invalidate();
+
+				//	...and bring it home to be written
+				if (adopted)
+				{
+					const void* src = p_state.real;
+					homeState();
+					memcpy((void*)p_state.real, src, structure.numberOfBytesTotal);
+				}
 			}
 
 			//	get pointer to block (convert if necessary)
@@ -1129,8 +1249,8 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 				rstructure.dims = temp.cdims();
 				setStructure(&rstructure);
 
-				//	get state
-				node.getRaw((BYTE*)p_state.real, (BYTE*)p_state.imag);
+				//	get state (interleaved data is all in the real block)
+				node.getRaw((BYTE*)p_state.real, (structure.type & TYPE_CPXFMT_INTERLEAVED) ? NULL : (BYTE*)p_state.imag);
 			}
 
 			//	ok
@@ -1151,8 +1271,8 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 			DataMLNode state(&xmlNode);
 			state.precision(esg->precision);
 
-			//	write it
-			state.setRaw(structure.dims, structure.type, p_state.real, p_state.imag);
+			//	write it (interleaved data is all in the real block)
+			state.setRaw(structure.dims, structure.type, p_state.real, (structure.type & TYPE_CPXFMT_INTERLEAVED) ? NULL : p_state.imag);
 
 			/*
 
@@ -1182,8 +1302,16 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 		{
 			EventLog* el = (EventLog*) event->data;
 
+			//	one sample logged per window (C_LOG_DECIMATE logs the first of a part window, too)
+			UINT64 elements = structure.bytesPerElement ? structure.numberOfBytesTotal / structure.bytesPerElement : 0;
+			logReducer.init(el->aggregate, el->decimate, structure.type, elements, structure.bytesPerElement);
+			logCount = 0;
+
 			//	calculate required storage
 			UINT64 numSamples = time->executionStop / time->samplePeriod;
+			UINT32 window = logReducer.getWindow();
+			if (logReducer.getAggregate() == C_LOG_DECIMATE) numSamples = (numSamples + window - 1) / window;
+			else numSamples /= window;
 			UINT64 storedElements = structure.numberOfElementsTotal * numSamples;
 			UINT64 bytesRequired = structure.numberOfBytesTotal * numSamples;
 
@@ -1201,15 +1329,36 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 			//	*or* if we're asked to buffer to memory and we're running !encap
 			BufferToMemory = BufferToMemory || Encapsulated;
 
+			//	chunk only what we write at run-time, and only if there's something to write
+#ifdef USE_CPP_FILE_IO
+			Chunked = false;
+#else
+			Chunked = !BufferToMemory && (el->flags & (F_CHUNKED | F_COMPRESSED)) && structure.numberOfBytesTotal;
+#endif
+			Compressed = Chunked && (el->flags & F_COMPRESSED);
+
 			//	if not encapsulated, open output file
 			if (!BufferToMemory)
 			{
-				OpenFile(el->filename);
+				OpenFile(el->filename, bytesRequired);
+			}
+
+			//	if buffering to memory, hold the log in memory if it fits what is left of
+			//	the voice's budget (or is too small to be worth a file), or else spill
+			//	it to its file, and go on as if it were not encapsulated (see
+			//	LOG_MEMORY_BUDGET)
+			Spilled = false;
+			if (BufferToMemory && bytesRequired > el->memoryBudget && bytesRequired >= LOG_SPILL_MIN_BYTES)
+			{
+				Spilled = OpenSpill(el->filename, bytesRequired);
+				if (Spilled) Encapsulated = BufferToMemory = false;
 			}
 
-			//	if buffering to memory, reserve memory
+			//	if holding in memory, take it from the budget, and reserve memory
 			if (BufferToMemory)
 			{
+				el->memoryBudget -= bytesRequired < el->memoryBudget ? bytesRequired : el->memoryBudget;
+
 				try
 				{
 					switch (structure.type & (TYPE_COMPLEX_MASK | TYPE_CPXFMT_MASK))
@@ -1282,7 +1431,7 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 
 			//	add log count as last dimension
 			Dims dims = structure.dims;
-			if (dims.size()) dims.push_back(el->count);
+			if (dims.size()) dims.push_back(logCount);
 
 			//	to file
 			if (!Encapsulated)
@@ -1290,12 +1439,12 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 				if (BufferToMemory)
 				{
 					//	must open & write the file now!
-					OpenFile(el->filename);
+					OpenFile(el->filename, logCount * structure.numberOfBytesTotal);
 
 					if (structure.numberOfBytesTotal)
 					{
 						//	check size is as expected
-						if (el->count * structure.numberOfBytesTotal != (log1.size() + log2.size()))
+						if (logCount * structure.numberOfBytesTotal != (log1.size() + log2.size()))
 							berr << "wrong byte count while storing";
 
 						//	get pointers to real and imag logs
@@ -1306,7 +1455,7 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 						UINT32 mult = (structure.type & TYPE_COMPLEX) ? 2 : 1;
 
 						//	it has to come out interleaved, like if we'd written at run-time
-						for (UINT32 s=0; s<el->count; s++)
+						for (UINT32 s=0; s<logCount; s++)
 						{
 							WriteFile(p_log1, structure.numberOfBytesReal * mult);
 							p_log1 += structure.numberOfBytesReal * mult;
@@ -1321,10 +1470,14 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 				}
 
 				//	already finished writing file
+#ifndef USE_CPP_FILE_IO
+				if (Chunked) outlog.setSampleCount(logCount);
+#endif
 				CloseFile();
 
 				//	lay it in to DataML node
-				nodeLog.setBinaryFile(dims, structure.type, el->filename);
+				if (Chunked) nodeLog.setChunkedFile(dims, structure.type, el->filename);
+				else nodeLog.setBinaryFile(dims, structure.type, el->filename);
 			}
 
 			//	to memory
@@ -1334,7 +1487,7 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 				if (WouldHaveBeenUnencapsulated) nodeLog.precision(PRECISION_NOT_SET);
 
 				//	check size is as expected
-				if (el->count * structure.numberOfBytesTotal != (log1.size() + log2.size()))
+				if (logCount * structure.numberOfBytesTotal != (log1.size() + log2.size()))
 					berr << "wrong byte count while storing";
 
 				//	get pointers to real and imag logs
@@ -1351,6 +1504,24 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 			//	write XML node
 			nodeLog.setRootTags();
 
+			//	mark spilled log (it was asked to be encapsulated, but is in a file)
+			if (Spilled)
+			{
+				el->spilled = logCount * structure.numberOfBytesTotal;
+				ostringstream ss;
+				ss << el->spilled;
+				xmlNode.setAttribute("Spilled", ss.str().c_str());
+			}
+
+			//	mark reduced log (its sample rate is that of the data over the window)
+			if (logReducer.getWindow() > 1)
+			{
+				ostringstream ss;
+				ss << logReducer.getWindow();
+				xmlNode.setAttribute("Decimate", ss.str().c_str());
+				xmlNode.setAttribute("Aggregate", aggregateToString(logReducer.getAggregate()));
+			}
+
 			//	ok
 			return C_OK;
 		}
@@ -1383,6 +1554,13 @@ void COMPONENT_CLASS_CPP::resizeState()
 		p_state.imag = NULL;
 	}
 	p_state.bytes = structure.numberOfBytesReal;
+	adopted = false;
+}
+
+void COMPONENT_CLASS_CPP::homeState()
+{
+	//	point state back at our own storage (it held content adopted from a stream)
+	if (adopted) resizeState();
 }
 
 void COMPONENT_CLASS_CPP::setStructure(const numeric::Structure* pstructure)
@@ -0,0 +1,254 @@
+/*
+________________________________________________________________
+
+	This file is part of BRAHMS
+	Copyright (C) 2007 Ben Mitchinson
+	URL: http://brahms.sourceforge.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+________________________________________________________________
+
+*/
+
+#ifndef _COMPONENTS_LOGREDUCE_H_
+#define _COMPONENTS_LOGREDUCE_H_
+
+#include <cmath>
+#include <limits>
+
+/*	LOG REDUCE
+
+	With Decimate="N" on a log, the data object logs one
+	sample for each N it is serviced with (EventLog::decimate),
+	made from those N as set by Aggregate (EventLog::aggregate):
+
+		C_LOG_DECIMATE	the first of them
+		C_LOG_MEAN		their mean
+		C_LOG_MIN		their minimum
+		C_LOG_MAX		their maximum
+		C_LOG_RMS		their root-mean-square
+
+	The reduction is element-wise, and keeps the type of the
+	data, so the log has the same structure it would have had,
+	with fewer samples. Complex data is reduced part by part
+	(so the mean is the complex mean, and min/max give an
+	envelope of each part); integer results are rounded half
+	away from zero. An element type that cannot be reduced
+	(CHAR16, say) is an error at EVENT_LOG_INIT. The windows
+	are counted in serviced samples, without regard to any
+	recording Window; a final window that is not full is not
+	logged, except that C_LOG_DECIMATE logs its first.
+
+	Everything is done incrementally, in one pass over the
+	sample as it is serviced, in loops over contiguous arrays
+	that the compiler can vectorise: min/max in the element
+	type, and mean/RMS into a DOUBLE accumulator.
+*/
+
+inline const char* aggregateToString(Symbol aggregate)
+{
+	switch (aggregate)
+	{
+		case C_LOG_MEAN: return "mean";
+		case C_LOG_MIN: return "min";
+		case C_LOG_MAX: return "max";
+		case C_LOG_RMS: return "rms";
+		default: return "first";
+	}
+}
+
+class LogReducer
+{
+
+public:
+
+	LogReducer()
+	{
+		aggregate = C_LOG_DECIMATE;
+		window = 1;
+		elementType = TYPE_UNSPECIFIED;
+		elements = 0;
+		added = 0;
+	}
+
+	//	"elements" counts real and imaginary parts (a window of zero or one logs every sample)
+	void init(Symbol p_aggregate, UINT32 p_window, TYPE type, UINT64 p_elements, UINT32 bytesPerElement)
+	{
+		aggregate = p_window > 1 ? p_aggregate : C_LOG_DECIMATE;
+		window = p_window > 1 ? p_window : 1;
+		elementType = type & TYPE_ELEMENT_MASK;
+		elements = p_elements;
+		added = 0;
+
+		switch (aggregate)
+		{
+			case C_LOG_DECIMATE:
+			case C_LOG_MIN:
+			case C_LOG_MAX:
+				break;
+
+			case C_LOG_MEAN:
+			case C_LOG_RMS:
+				accumulator.assign(elements, 0.0);
+				break;
+
+			default:
+				berr << "unrecognised log aggregate";
+		}
+
+		//	check the type here, rather than at the first sample
+		if (window > 1)
+		{
+			switch (elementType)
+			{
+				case TYPE_DOUBLE:
+				case TYPE_SINGLE:
+				case TYPE_INT8:
+				case TYPE_INT16:
+				case TYPE_INT32:
+				case TYPE_INT64:
+				case TYPE_UINT8:
+				case TYPE_UINT16:
+				case TYPE_UINT32:
+				case TYPE_UINT64:
+				case TYPE_BOOL8:
+					break;
+
+				default:
+					berr << "cannot reduce log of this element type";
+			}
+		}
+
+		result.resize(elements * bytesPerElement);
+	}
+
+	//	add a sample (true if that completes a window, the result of which is then at getResult())
+	bool add(const void* sample)
+	{
+		switch (elementType)
+		{
+			case TYPE_DOUBLE: return reduce((const DOUBLE*) sample);
+			case TYPE_SINGLE: return reduce((const SINGLE*) sample);
+			case TYPE_INT8: return reduce((const INT8*) sample);
+			case TYPE_INT16: return reduce((const INT16*) sample);
+			case TYPE_INT32: return reduce((const INT32*) sample);
+			case TYPE_INT64: return reduce((const INT64*) sample);
+			case TYPE_UINT8: return reduce((const UINT8*) sample);
+			case TYPE_UINT16: return reduce((const UINT16*) sample);
+			case TYPE_UINT32: return reduce((const UINT32*) sample);
+			case TYPE_UINT64: return reduce((const UINT64*) sample);
+			case TYPE_BOOL8: return reduce((const BOOL8*) sample);
+			default: berr << "cannot reduce log of this element type";
+		}
+
+		return false;
+	}
+
+	const BYTE* getResult() const
+	{
+		return result.size() ? &result[0] : NULL;
+	}
+
+	//	samples that go into one logged
+	UINT32 getWindow() const
+	{
+		return window;
+	}
+
+	Symbol getAggregate() const
+	{
+		return aggregate;
+	}
+
+private:
+
+	template <class T>
+	bool reduce(const T* x)
+	{
+		T* y = (T*) (result.size() ? &result[0] : NULL);
+		DOUBLE* a = accumulator.size() ? &accumulator[0] : NULL;
+		UINT64 N = elements;
+		bool first = !added;
+		bool last = ++added == window;
+		if (last) added = 0;
+
+		switch (aggregate)
+		{
+			case C_LOG_DECIMATE:
+			{
+				if (!first) return false;
+				for (UINT64 e=0; e<N; e++) y[e] = x[e];
+				return true;
+			}
+
+			case C_LOG_MIN:
+			{
+				if (first) for (UINT64 e=0; e<N; e++) y[e] = x[e];
+				else for (UINT64 e=0; e<N; e++) y[e] = x[e] < y[e] ? x[e] : y[e];
+				return last;
+			}
+
+			case C_LOG_MAX:
+			{
+				if (first) for (UINT64 e=0; e<N; e++) y[e] = x[e];
+				else for (UINT64 e=0; e<N; e++) y[e] = x[e] > y[e] ? x[e] : y[e];
+				return last;
+			}
+
+			case C_LOG_MEAN:
+			{
+				if (first) for (UINT64 e=0; e<N; e++) a[e] = (DOUBLE) x[e];
+				else for (UINT64 e=0; e<N; e++) a[e] += (DOUBLE) x[e];
+				if (!last) return false;
+
+				DOUBLE scale = 1.0 / window;
+				for (UINT64 e=0; e<N; e++) y[e] = fromDouble<T>(a[e] * scale);
+				return true;
+			}
+
+			case C_LOG_RMS:
+			{
+				if (first) for (UINT64 e=0; e<N; e++) a[e] = (DOUBLE) x[e] * (DOUBLE) x[e];
+				else for (UINT64 e=0; e<N; e++) a[e] += (DOUBLE) x[e] * (DOUBLE) x[e];
+				if (!last) return false;
+
+				DOUBLE scale = 1.0 / window;
+				for (UINT64 e=0; e<N; e++) y[e] = fromDouble<T>(sqrt(a[e] * scale));
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	template <class T>
+	static T fromDouble(DOUBLE v)
+	{
+		//	half away from zero, as MATLAB's integer casts do
+		if (std::numeric_limits<T>::is_integer) return (T) (v < 0.0 ? ceil(v - 0.5) : floor(v + 0.5));
+		return (T) v;
+	}
+
+	Symbol aggregate;
+	UINT32 window;
+	TYPE elementType;
+	UINT64 elements;
+	UINT32 added;
+
+	VDOUBLE accumulator;
+	VBYTE result;
+};
+
+#endif // _COMPONENTS_LOGREDUCE_H_
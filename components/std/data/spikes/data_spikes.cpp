@@ -31,10 +31,18 @@ ________________________________________________________________
 */
 
 /*
-  since spikes doesn't currently write to file at run-time, we've
-  disabled all the file writing, and it just always sends its ouput
-  encapsulated. this may be troublesome when large numbers of spikes
-  are generated, so we may have to fix this in a future release.
+  encapsulated, spikes are logged to memory and laid into the report
+  at the end. unencapsulated, they are written to file at run-time
+  (through a mapping that grows as they come in, since we can't know
+  in advance how many there will be), and the "ts" field of the log
+  refers to that file.
+
+  we can't know how much memory to set aside, either, so the memory
+  log is kept in two SpikeArena columns: one record of (sample,
+  count, bytes) per sample that had any spikes, and the spike set
+  of that sample in SPIKES_ENCODING. neither ever reallocates, so
+  logging costs the same at the end of a long run as at the start.
+  the file log is staged a page at a time in the same way.
 */
 
 ////////////////	COMPONENT INFO
@@ -51,6 +59,11 @@ ________________________________________________________________
 #include "data_spikes.h"
 namespace spikes = std_2009_data_spikes_0;
 
+//	log files (shared with data/numeric)
+#include "components/logwriter.h"
+#include "components/logmap.h"
+#include "spikearena.h"
+
 //	include
 #include <cstdlib> // atof() on linux
 #include <string>
@@ -58,6 +71,253 @@ using std::string;
 #include <sstream>
 using std::ostringstream;
 
+////////////////	COMPACT ENCODING
+
+/*	DOCUMENTATION: SPIKES_ENCODING
+
+	A spike set is sent (EVENT_CONTENT_GET/SET) and logged in whichever
+	of the following forms is smallest for that sample. Populations
+	usually fire sparsely, so DELTA is the common choice; BITMAP wins
+	when density is high, and RUNS when spiking units are contiguous.
+
+		RAW		tag, then the INT32 indices
+		DELTA	tag, varint count, then varint gaps between successive
+				indices (the first from -1), each less one
+		BITMAP	tag, then one bit per unit, LSB first (count is implied)
+		RUNS	tag, varint count, then varint pairs of (gap since end of
+				previous run, run length less one)
+
+	All but RAW require the indices to be strictly increasing and within
+	capacity. A set that is not (the writer is free to order its spikes
+	however it likes) is always sent RAW, so that readers see exactly the
+	indices, and order, that were written. The tag is a UINT32, so that a
+	RAW payload stays aligned for EVENT_CONTENT_ADOPT. An empty set is
+	zero bytes.
+*/
+
+const UINT32 SPIKES_FMT_RAW = 0;
+const UINT32 SPIKES_FMT_DELTA = 1;
+const UINT32 SPIKES_FMT_BITMAP = 2;
+const UINT32 SPIKES_FMT_RUNS = 3;
+
+UINT32 varintBytes(UINT32 v)
+{
+	UINT32 n = 1;
+	while (v >= 0x80)
+	{
+		v >>= 7;
+		n++;
+	}
+	return n;
+}
+
+BYTE* varintPut(BYTE* p, UINT32 v)
+{
+	while (v >= 0x80)
+	{
+		*p++ = (BYTE)(v | 0x80);
+		v >>= 7;
+	}
+	*p++ = (BYTE)v;
+	return p;
+}
+
+//	returns NULL if the varint runs past "end" or is too long
+const BYTE* varintGet(const BYTE* p, const BYTE* end, UINT32& v)
+{
+	v = 0;
+	for (UINT32 shift=0; p<end && shift<35; shift+=7)
+	{
+		BYTE b = *p++;
+		v |= ((UINT32)(b & 0x7F)) << shift;
+		if (!(b & 0x80)) return p;
+	}
+	return NULL;
+}
+
+//	maximum encoded size of a set of "count" spikes (RAW is always a candidate)
+UINT32 spikesEncodeBound(UINT32 count)
+{
+	return count ? sizeof(UINT32) + count * sizeof(INT32) : 0;
+}
+
+//	encode into "dst", which must have spikesEncodeBound(count) bytes; returns bytes written
+UINT32 spikesEncode(const INT32* spikes, UINT32 count, UINT32 capacity, BYTE* dst)
+{
+	if (!count) return 0;
+
+	//	measure each form in one pass, giving up on the ordered forms if not ordered
+	UINT32 raw = spikesEncodeBound(count);
+	UINT32 delta = sizeof(UINT32) + varintBytes(count);
+	UINT32 runs = delta;
+	UINT32 bitmap = sizeof(UINT32) + (capacity + 7) / 8;
+	bool ordered = true;
+	UINT32 next = 0, runLength = 0;
+	for (UINT32 i=0; i<count; i++)
+	{
+		INT32 s = spikes[i];
+		if (s < (INT32)next || (UINT32)s >= capacity)
+		{
+			ordered = false;
+			break;
+		}
+
+		UINT32 gap = s - next;
+		delta += varintBytes(gap);
+		if (i && !gap) runLength++;
+		else
+		{
+			if (i) runs += varintBytes(runLength - 1);
+			runs += varintBytes(gap);
+			runLength = 1;
+		}
+		next = s + 1;
+	}
+	runs += varintBytes(runLength - 1);
+
+	//	choose
+	UINT32 fmt = SPIKES_FMT_RAW, bytes = raw;
+	if (ordered)
+	{
+		if (delta < bytes) { fmt = SPIKES_FMT_DELTA; bytes = delta; }
+		if (runs < bytes) { fmt = SPIKES_FMT_RUNS; bytes = runs; }
+		if (bitmap < bytes) { fmt = SPIKES_FMT_BITMAP; bytes = bitmap; }
+	}
+
+	//	write
+	*((UINT32*)dst) = fmt;
+	BYTE* p = dst + sizeof(UINT32);
+	switch (fmt)
+	{
+		case SPIKES_FMT_RAW:
+		{
+			memcpy(p, spikes, count * sizeof(INT32));
+			break;
+		}
+
+		case SPIKES_FMT_DELTA:
+		{
+			p = varintPut(p, count);
+			next = 0;
+			for (UINT32 i=0; i<count; i++)
+			{
+				p = varintPut(p, spikes[i] - next);
+				next = spikes[i] + 1;
+			}
+			break;
+		}
+
+		case SPIKES_FMT_BITMAP:
+		{
+			memset(p, 0, bytes - sizeof(UINT32));
+			for (UINT32 i=0; i<count; i++)
+				p[spikes[i] >> 3] |= (BYTE)(1 << (spikes[i] & 7));
+			break;
+		}
+
+		case SPIKES_FMT_RUNS:
+		{
+			p = varintPut(p, count);
+			next = 0;
+			for (UINT32 i=0; i<count; )
+			{
+				UINT32 j = i + 1;
+				while (j < count && spikes[j] == spikes[j-1] + 1) j++;
+				p = varintPut(p, spikes[i] - next);
+				p = varintPut(p, j - i - 1);
+				next = spikes[j-1] + 1;
+				i = j;
+			}
+			break;
+		}
+	}
+
+	return bytes;
+}
+
+//	decode "bytes" bytes into "spikes", which has room for "capacity"; returns an error string, or NULL
+const char* spikesDecode(const BYTE* src, UINT32 bytes, UINT32 capacity, INT32* spikes, UINT32& count)
+{
+	count = 0;
+	if (!bytes) return NULL;
+	if (bytes < sizeof(UINT32)) return "truncated";
+
+	const BYTE* p = src + sizeof(UINT32);
+	const BYTE* end = src + bytes;
+	UINT32 n = 0, next = 0;
+	switch (*((const UINT32*)src))
+	{
+		case SPIKES_FMT_RAW:
+		{
+			n = (bytes - sizeof(UINT32)) / sizeof(INT32);
+			if (n * sizeof(INT32) != bytes - sizeof(UINT32)) return "length incorrect";
+			if (n > capacity) return "more spikes than capacity";
+			memcpy(spikes, p, n * sizeof(INT32));
+			count = n;
+			return NULL;
+		}
+
+		case SPIKES_FMT_DELTA:
+		{
+			if (!(p = varintGet(p, end, n))) return "truncated";
+			if (n > capacity) return "more spikes than capacity";
+			for (UINT32 i=0; i<n; i++)
+			{
+				UINT32 gap;
+				if (!(p = varintGet(p, end, gap))) return "truncated";
+				if (gap >= capacity - next) return "index out of range";
+				spikes[i] = next + gap;
+				next += gap + 1;
+			}
+			break;
+		}
+
+		case SPIKES_FMT_BITMAP:
+		{
+			if (bytes != sizeof(UINT32) + (capacity + 7) / 8) return "length incorrect";
+			for (UINT32 b=0; p+b<end; b++)
+			{
+				BYTE bits = p[b];
+				for (UINT32 i=0; bits; i++, bits >>= 1)
+				{
+					if (!(bits & 1)) continue;
+					UINT32 s = b * 8 + i;
+					if (s >= capacity) return "index out of range";
+					spikes[n++] = s;
+				}
+			}
+			p = end;
+			break;
+		}
+
+		case SPIKES_FMT_RUNS:
+		{
+			if (!(p = varintGet(p, end, n))) return "truncated";
+			if (n > capacity) return "more spikes than capacity";
+			UINT32 i = 0;
+			while (i < n)
+			{
+				UINT32 gap, length;
+				if (!(p = varintGet(p, end, gap))) return "truncated";
+				if (!(p = varintGet(p, end, length))) return "truncated";
+				length++;
+				if (length > n - i) return "run too long";
+				if (gap >= capacity - next || length > capacity - next - gap) return "index out of range";
+				next += gap;
+				for (UINT32 r=0; r<length; r++) spikes[i++] = next++;
+			}
+			break;
+		}
+
+		default:
+			return "unrecognised format";
+	}
+
+	if (p != end) return "length incorrect";
+	count = n;
+	return NULL;
+}
+
 ////////////////	COMPONENT CLASS
 class COMPONENT_CLASS_CPP : public Data
 {
@@ -99,14 +359,36 @@ private:
 
 #define CHRON_LOGGING
 #ifdef CHRON_LOGGING
-	//	log
-	VINT32 log;
+	//	log, as one LogRecord per sample that had spikes, and the
+	//	spike sets of those samples encoded as SPIKES_ENCODING
+	struct LogRecord
+	{
+		UINT32 sample;
+		UINT32 count;
+		UINT32 bytes;
+	};
+	SpikeArena logRecords;
+	SpikeArena logSets;
+	VBYTE logScratch;
 #else
 	//	log
 	VINT32 log_t;
 	VINT32 log_n;
 #endif
 
+	//	unencapsulated, the log goes to file at run-time as (sample, index)
+	//	pairs, which is the "ts" field laid out as a binary file, a page
+	//	at a time (a sample at a time, if chunked, so chunks end between
+	//	samples); the page is only allocated for the object doing the logging
+	bool logToFile;
+	bool logChunked;
+	UINT64 logSpikes;
+	LogMap logMap;
+	LogFile logFile;
+	VINT32 logPage;
+	UINT32 logPageUsed;
+	void logPageFlush(UINT64 sample);
+
 	//	structure set
 	void					setDimensions(Dimensions cdims);
 
@@ -114,6 +396,13 @@ private:
 	UINT32 contentHeaderBytes;
 	void resizeBuffer();
 
+	//	true if spikes.spikes points into a stream adopted in EVENT_CONTENT_ADOPT, rather than at headerAndState
+	bool adopted;
+	void homeBuffer();
+
+	//	encoded content returned from EVENT_CONTENT_GET, after header space
+	VBYTE wire;
+
 	/*
 
 		Am trialling the replacement of C++ output stream ofstream with an old
@@ -161,8 +450,6 @@ private:
 	}
 	eac;
 
-	BYTE* p_headerAndState;
-
 };
 
 
@@ -175,8 +462,16 @@ void COMPONENT_CLASS_CPP::resizeBuffer()
 	state.spikes.spikes = (INT32*) (state.capacity ? &state.headerAndState[contentHeaderBytes] : NULL);
 	state.spikes.count = 0;
 
-	//	prepare ec data
-	p_headerAndState = state.headerAndState.size() ? &state.headerAndState[0] : NULL; // point at beginning of header
+	//	not adopted
+	adopted = false;
+}
+
+void COMPONENT_CLASS_CPP::homeBuffer()
+{
+	//	point state back at our own storage (count is left for the caller to set)
+	if (!adopted) return;
+	state.spikes.spikes = (INT32*) (state.capacity ? &state.headerAndState[contentHeaderBytes] : NULL);
+	adopted = false;
 }
 
 void COMPONENT_CLASS_CPP::setDimensions(Dimensions cdims)
@@ -209,6 +504,18 @@ void COMPONENT_CLASS_CPP::setDimensions(Dimensions cdims)
 	eac.data.bytes = 0;
 }
 
+void COMPONENT_CLASS_CPP::logPageFlush(UINT64 sample)
+{
+	if (!logPageUsed) return;
+
+	const BYTE* p = (const BYTE*) &logPage[0];
+	UINT64 bytes = logPageUsed * sizeof(INT32);
+	if (logChunked) logFile.writeSample(p, bytes, sample);
+	else if (logMap.isOpen()) logMap.write(p, bytes);
+	else logFile.write(p, bytes);
+	logPageUsed = 0;
+}
+
 
 
 
@@ -236,6 +543,11 @@ COMPONENT_CLASS_CPP::COMPONENT_CLASS_CPP()
 	//	assume zero until we hear otherwise
 	contentHeaderBytes = 0;
 
+	logToFile = false;
+	logChunked = false;
+	logSpikes = 0;
+	logPageUsed = 0;
+
 	Dims dims;
 	dims.push_back(0);
 	setDimensions(dims.cdims());
@@ -272,6 +584,11 @@ COMPONENT_CLASS_CPP::COMPONENT_CLASS_CPP(const COMPONENT_CLASS_CPP& src) : Data(
 {
 	contentHeaderBytes = src.contentHeaderBytes;
 
+	logToFile = false;
+	logChunked = false;
+	logSpikes = 0;
+	logPageUsed = 0;
+
 	//	set dimensions from src to set up structure
 	setDimensions(src.state.dims.cdims());
 
@@ -307,8 +624,13 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 		{
 			EventContent* ec = (EventContent*) event->data;
 
-			ec->stream = p_headerAndState;
-			ec->bytes = state.spikes.count * sizeof(INT32);
+			//	encode after header space (if we are sent to several voices, this
+			//	is repeated for each, but the encoding is the same every time)
+			UINT32 bytes = contentHeaderBytes + spikesEncodeBound(state.capacity);
+			if (wire.size() < bytes) wire.resize(bytes);
+			BYTE* stream = wire.size() ? &wire[0] : NULL;
+			ec->bytes = spikesEncode(state.spikes.spikes, state.spikes.count, state.capacity, stream ? stream + contentHeaderBytes : NULL);
+			ec->stream = stream;
 
 			//	ok
 			return C_OK;
@@ -320,12 +642,39 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 		{
 			EventContent* ec = (EventContent*) event->data;
 
-			//	just read state array
-			state.spikes.count = ec->bytes / sizeof(INT32);
-			if ((state.spikes.count * 4 != ec->bytes) || (state.spikes.count > state.capacity))
-				berr << "stream length incorrect in EVENT_CONTENT_SET (" << ec->bytes << " when capacity was " << state.capacity << ")";
-			if (state.spikes.count)
-				memcpy((BYTE*)state.spikes.spikes, ec->stream, ec->bytes);
+			//	decode state array
+			homeBuffer();
+			const char* err = spikesDecode((const BYTE*)ec->stream, ec->bytes, state.capacity, state.spikes.spikes, state.spikes.count);
+			if (err)
+				berr << "invalid stream in EVENT_CONTENT_SET (" << err << ", " << ec->bytes << " bytes when capacity was " << state.capacity << ")";
+
+			//	ok
+			return C_OK;
+		}
+
+		case EVENT_CONTENT_ADOPT:
+		{
+			EventContent* ec = (EventContent*) event->data;
+
+			//	read a RAW state array in place (it stays put until we are next
+			//	written), but anything else has to be decoded into our own storage
+			if (ec->bytes >= sizeof(UINT32) && *((const UINT32*)ec->stream) == SPIKES_FMT_RAW)
+			{
+				UINT32 count = (ec->bytes - sizeof(UINT32)) / sizeof(INT32);
+				if ((count * sizeof(INT32) != ec->bytes - sizeof(UINT32)) || (count > state.capacity))
+					berr << "stream length incorrect in EVENT_CONTENT_ADOPT (" << ec->bytes << " when capacity was " << state.capacity << ")";
+				state.spikes.spikes = (INT32*) (((BYTE*)ec->stream) + sizeof(UINT32));
+				state.spikes.count = count;
+				adopted = true;
+			}
+
+			else
+			{
+				homeBuffer();
+				const char* err = spikesDecode((const BYTE*)ec->stream, ec->bytes, state.capacity, state.spikes.spikes, state.spikes.count);
+				if (err)
+					berr << "invalid stream in EVENT_CONTENT_ADOPT (" << err << ", " << ec->bytes << " bytes when capacity was " << state.capacity << ")";
+			}
 
 			//	ok
 			return C_OK;
@@ -340,45 +689,46 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 			//	cast input
 			COMPONENT_CLASS_CPP* src = (COMPONENT_CLASS_CPP*) el->source;
 
-#ifdef CHRON_LOGGING
-			//	to file
-			if (!(el->flags & F_ENCAPSULATED))
+			//	to file, at run-time
+			if (logToFile)
 			{
-				if (src->state.spikes.count)
+				UINT32 C = src->state.spikes.count;
+				if (C)
 				{
-					UINT32 C = src->state.spikes.count;
-					UINT32 N0 = log.size();
-					UINT32 N1 = N0 + C*2;
-					log.resize(N1);
-					if (src->state.spikes.count)
+					const INT32* spikes = src->state.spikes.spikes;
+					const UINT32 P = logPage.size();
+					for (UINT32 s=0; s<C; s++)
 					{
-						for (UINT32 s=0; s<C; s++)
-						{
-							log[N0+s*2] = el->count;
-							log[N0+s*2+1] = src->state.spikes.spikes[s];
-						}
+						if (logPageUsed == P) logPageFlush(el->count);
+						logPage[logPageUsed++] = el->count;
+						logPage[logPageUsed++] = spikes[s];
 					}
+
+					if (logChunked) logPageFlush(el->count);
+					logSpikes += C;
 				}
+
+				//	ok
+				return C_OK;
 			}
 
-			//	to memory
-			else
+#ifdef CHRON_LOGGING
+			//	to file and to memory are the same, since we don't write at run-time (see top)
+			if (src->state.spikes.count)
 			{
-				if (src->state.spikes.count)
-				{
-					UINT32 C = src->state.spikes.count;
-					UINT32 N0 = log.size();
-					UINT32 N1 = N0 + C*2;
-					log.resize(N1);
-					if (src->state.spikes.count)
-					{
-						for (UINT32 s=0; s<C; s++)
-						{
-							log[N0+s*2] = el->count;
-							log[N0+s*2+1] = src->state.spikes.spikes[s];
-						}
-					}
-				}
+				UINT32 C = src->state.spikes.count;
+				UINT32 bound = spikesEncodeBound(C);
+				if (logScratch.size() < bound) logScratch.resize(bound);
+				UINT32 bytes = spikesEncode(src->state.spikes.spikes, C, src->state.capacity, &logScratch[0]);
+
+				//	append record, and set
+				LogRecord record;
+				record.sample = el->count;
+				record.count = C;
+				record.bytes = bytes;
+				logRecords.append(&record, sizeof(record));
+				logSets.append(&logScratch[0], bytes);
+				logSpikes += C;
 			}
 #else
 			//	to file
@@ -496,6 +846,7 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 		{
 			EventGenericContent* egc = (EventGenericContent*) event->data;
 
+			eac.data.real = state.spikes.spikes;
 			eac.data.bytes = state.spikes.count * sizeof(INT32);
 
 			egc->real = eac.data.real;
@@ -512,6 +863,7 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 
 			//	udata should be byte count
 			//	pdata should be content bytes
+			homeBuffer();
 			state.spikes.count = eac->bytes / sizeof(INT32);
 			if ((state.spikes.count * sizeof(INT32)) != eac->bytes || (state.spikes.count > state.capacity))
 				berr << "invalid set state (" << eac->bytes << " bytes supplied)";
@@ -535,15 +887,15 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 				//	store
 				contentHeaderBytes = eic->contentHeaderBytes;
 
-				//	get pointer to old content
-				INT32* spikes = state.spikes.spikes;
+				//	take a copy of old content (resizing may move it)
+				VINT32 spikes(state.spikes.spikes, state.spikes.spikes + state.spikes.count);
 
 				//	resize buffer
 				resizeBuffer();
 
-				//	copy any spikes that may be present
+				//	copy back any spikes that may be present
 				if (state.spikes.count)
-					memmove(state.spikes.spikes, spikes, state.spikes.count * sizeof(INT32));
+					memcpy(state.spikes.spikes, &spikes[0], state.spikes.count * sizeof(INT32));
 
 				//	and zero the header
 				memset(&state.headerAndState[0], 0, contentHeaderBytes);
@@ -578,6 +930,7 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 			spikes::Spikes* spikes = (spikes::Spikes*) event->data;
 
 			if (spikes->count > state.capacity) berr << "too many spikes supplied (more than previously set capacity)";
+			homeBuffer();
 			state.spikes.count = spikes->count;
 			if (spikes->count)
 				memcpy((BYTE*)state.spikes.spikes, spikes->spikes, spikes->count * sizeof(INT32));
@@ -690,19 +1043,39 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 		{
 			EventLog* el = (EventLog*) event->data;
 
-			if (!(el->flags & F_ENCAPSULATED))
+			//	every spike counts, so there's no sense in which the log can be decimated
+			if (el->decimate > 1)
+				bout << "log of \"" << (componentData ? componentData->name : "<unknown>") << "\" cannot be decimated, and will be full rate" << D_WARN;
+
+			//	unencapsulated, write at run-time, unless asked to keep everything in memory
+			if (!(el->flags & F_ENCAPSULATED) && executionInfo->BufferingPolicy != C_BUFFERING_ONLY_MEMORY)
 			{
-				/*
-				//	open file
-				outfile.open(el->filename, ios::out | ios::binary);
-				if (!outfile.is_open()) berr << "failed to open file \"" + string(el->filename) + "\"";
-				*/
+				//	we don't know how much spiking will occur, so the mapping grows
+				//	as we go; disk-favouring policies use bounded buffers instead
+				bool favourDisk = executionInfo->BufferingPolicy == C_BUFFERING_ONLY_DISK || executionInfo->BufferingPolicy == C_BUFFERING_FAVOUR_DISK;
+				logChunked = (el->flags & (F_CHUNKED | F_COMPRESSED)) != 0;
+				if (logChunked)
+				{
+					//	each sample is (sample, index) pairs, as many as there were spikes
+					logFile.openChunked(el->filename, LOG_CHUNK_BYTES, sizeof(INT32), (el->flags & F_COMPRESSED) != 0);
+					TYPE type = TYPE_INT32 | TYPE_REAL | TYPE_CPXFMT_ADJACENT | TYPE_ORDER_COLUMN_MAJOR;
+					logFile.describe(COMPONENT_CLASS_STRING, "INT32/REAL/CPXFMT_ADJACENT/COLUMN_MAJOR/2,*", type, 0, time->sampleRate);
+				}
+				else if (favourDisk || !logMap.open(el->filename, 0))
+					logFile.open(el->filename, 0);
+				logPage.resize(SPIKE_ARENA_BLOCK_BYTES / sizeof(INT32));
+				logPageUsed = 0;
+				logToFile = true;
+				logSpikes = 0;
 			}
 
 			else
 			{
-				//	reserve memory for storage
-				//	how can we do this when we don't know how much spiking will occur?
+				//	we don't know how much spiking will occur, so the arenas
+				//	take memory a block at a time as it does
+				logRecords.clear();
+				logSets.clear();
+				logSpikes = 0;
 			}
 
 			//	ok
@@ -755,8 +1128,56 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 			v.push_back(state.capacity);
 			nodeLog.getField("s").setArray(Dims(1, 2), v);
 
-			//	store ts
-			nodeLog.getField("ts").setArray(Dims(2, log.size()/2), log);
+			//	ts is already on file
+			if (logToFile)
+			{
+				logPageFlush(el->count);
+				logMap.close();
+				if (logChunked) logFile.setSampleCount(el->count);
+				logFile.close();
+				VINT32().swap(logPage);
+				logToFile = false;
+
+				TYPE type = TYPE_INT32 | TYPE_REAL | TYPE_CPXFMT_ADJACENT | TYPE_ORDER_COLUMN_MAJOR;
+				if (logChunked) nodeLog.getField("ts").setChunkedFile(Dims(2, logSpikes), type, el->filename);
+				else nodeLog.getField("ts").setBinaryFile(Dims(2, logSpikes), type, el->filename);
+
+				//	write XML node
+				nodeLog.setRootTags();
+
+				//	ok
+				return C_OK;
+			}
+
+			//	store ts, decoded from the log (the written format is unchanged)
+			VINT32 ts(logSpikes * 2);
+			VINT32 decoded(state.capacity);
+			VBYTE set;
+			SpikeArena::Cursor records(logRecords);
+			SpikeArena::Cursor sets(logSets);
+			UINT64 n = 0;
+			LogRecord record;
+			while (records.read(&record, sizeof(record)))
+			{
+				if (set.size() < record.bytes) set.resize(record.bytes);
+				if (!sets.read(set.size() ? &set[0] : NULL, record.bytes)) berr << "log corrupt in EVENT_LOG_TERM";
+				UINT32 C;
+				const char* err = spikesDecode(set.size() ? &set[0] : NULL, record.bytes, state.capacity, decoded.size() ? &decoded[0] : NULL, C);
+				if (err) berr << "log corrupt in EVENT_LOG_TERM (" << err << ")";
+				if (C != record.count || n + C > logSpikes) berr << "log corrupt in EVENT_LOG_TERM";
+
+				for (UINT32 s=0; s<C; s++)
+				{
+					ts[n*2] = record.sample;
+					ts[n*2+1] = decoded[s];
+					n++;
+				}
+			}
+			if (n != logSpikes || !sets.atEnd()) berr << "log corrupt in EVENT_LOG_TERM";
+			logRecords.clear();
+			logSets.clear();
+
+			nodeLog.getField("ts").setArray(Dims(2, ts.size()/2), ts);
 
 			//	write XML node
 			nodeLog.setRootTags();
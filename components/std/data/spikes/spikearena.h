@@ -0,0 +1,150 @@
+/*
+________________________________________________________________
+
+	This file is part of BRAHMS
+	Copyright (C) 2007 Ben Mitchinson
+	URL: http://brahms.sourceforge.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+________________________________________________________________
+
+*/
+
+#ifndef _COMPONENTS_SPIKEARENA_H_
+#define _COMPONENTS_SPIKEARENA_H_
+
+#include <cstring>
+#include <vector>
+
+/*	SPIKE ARENA
+
+	An append-only store of bytes, kept in blocks of
+	SPIKE_ARENA_BLOCK_BYTES that are allocated as they are
+	needed and never moved, grown, or reallocated. Appending
+	is a memcpy() (and, once a block, an allocation of a page),
+	so its cost doesn't depend on how long the log already is,
+	and nothing in it is copied again until it is read back.
+	A record that doesn't fit in what is left of a block runs
+	on into the next; read records back in order with a Cursor.
+*/
+
+#define SPIKE_ARENA_BLOCK_BYTES 4096
+
+class SpikeArena
+{
+
+public:
+
+	SpikeArena()
+	{
+		used = SPIKE_ARENA_BLOCK_BYTES;
+		total = 0;
+	}
+
+	~SpikeArena()
+	{
+		clear();
+	}
+
+	void append(const void* data, UINT32 bytes)
+	{
+		const BYTE* src = (const BYTE*) data;
+		while (bytes)
+		{
+			if (used == SPIKE_ARENA_BLOCK_BYTES)
+			{
+				blocks.push_back(new BYTE[SPIKE_ARENA_BLOCK_BYTES]);
+				used = 0;
+			}
+
+			UINT32 n = SPIKE_ARENA_BLOCK_BYTES - used;
+			if (n > bytes) n = bytes;
+			memcpy(blocks.back() + used, src, n);
+			used += n;
+			total += n;
+			src += n;
+			bytes -= n;
+		}
+	}
+
+	//	bytes appended
+	UINT64 size() const
+	{
+		return total;
+	}
+
+	void clear()
+	{
+		for (UINT32 b=0; b<blocks.size(); b++)
+			delete [] blocks[b];
+		blocks.clear();
+		used = SPIKE_ARENA_BLOCK_BYTES;
+		total = 0;
+	}
+
+	class Cursor
+	{
+
+	public:
+
+		Cursor(const SpikeArena& p_arena) : arena(p_arena)
+		{
+			position = 0;
+		}
+
+		//	copy out the next "bytes" (false, copying nothing, if there aren't that many left)
+		bool read(void* data, UINT32 bytes)
+		{
+			if (bytes > arena.total - position) return false;
+
+			BYTE* dst = (BYTE*) data;
+			while (bytes)
+			{
+				UINT64 block = position / SPIKE_ARENA_BLOCK_BYTES;
+				UINT32 offset = (UINT32) (position % SPIKE_ARENA_BLOCK_BYTES);
+				UINT32 n = SPIKE_ARENA_BLOCK_BYTES - offset;
+				if (n > bytes) n = bytes;
+				memcpy(dst, arena.blocks[block] + offset, n);
+				position += n;
+				dst += n;
+				bytes -= n;
+			}
+
+			return true;
+		}
+
+		bool atEnd() const
+		{
+			return position == arena.total;
+		}
+
+	private:
+
+		const SpikeArena& arena;
+		UINT64 position;
+	};
+
+private:
+
+	//	not copyable (owns its blocks)
+	SpikeArena(const SpikeArena&);
+	SpikeArena& operator=(const SpikeArena&);
+
+	std::vector<BYTE*> blocks;
+	UINT32 used;
+	UINT64 total;
+};
+
+#endif // _COMPONENTS_SPIKEARENA_H_
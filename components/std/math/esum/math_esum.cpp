@@ -37,7 +37,7 @@ ________________________________________________________________
 //	component information
 #define COMPONENT_CLASS_STRING "std/2009/math/esum"
 #define COMPONENT_CLASS_CPP std_2009_math_esum_0
-#define COMPONENT_FLAGS F_NOT_RATE_CHANGER
+#define COMPONENT_FLAGS (F_NOT_RATE_CHANGER | F_OPTIMISTIC)
 
 //	include common header
 #include "components/process.h"
@@ -281,6 +281,10 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 		{
 			//	extract DataML
 			EventStateSet* data = (EventStateSet*) event->data;
+
+			//	checkpoint (F_OPTIMISTIC): no run-phase state
+			if (data->flags & F_CHECKPOINT) return C_OK;
+
 			XMLNode xmlNode(data->state);
 			DataMLNode nodeState(&xmlNode);
 
@@ -334,6 +338,9 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 		{
 			EventStateGet* esg = (EventStateGet*)event->data;
 
+			//	checkpoint (F_OPTIMISTIC): no run-phase state
+			if (esg->flags & F_CHECKPOINT) return C_OK;
+
 			//	get existing state node
 			XMLNode xmlNode(esg->state);
 
@@ -37,7 +37,7 @@ ________________________________________________________________
 //	component information
 #define COMPONENT_CLASS_STRING "std/2009/resample/spikes"
 #define COMPONENT_CLASS_CPP std_2009_resample_spikes_0
-#define COMPONENT_FLAGS (0)
+#define COMPONENT_FLAGS (F_OPTIMISTIC)
 
 //	include common header
 #include "components/process.h"
@@ -165,6 +165,52 @@ Symbol COMPONENT_CLASS_CPP::event(Event* event)
 			XMLNode xmlNode(data->state);
 			DataMLNode nodeState(&xmlNode);
 
+			//	checkpoint (F_OPTIMISTIC): restore spikes not yet passed on
+			if (data->flags & F_CHECKPOINT)
+			{
+				for (UINT32 s=0; s<streams.size(); s++)
+				{
+					for (UINT32 n=0; n<streams[s].capacity; n++)
+						streams[s].p_buffer[n] = 0;
+				}
+
+				//	stored as (stream, index) pairs
+				VINT32 pending = nodeState.getField("pending").getArrayINT32();
+				for (UINT32 n=0; n+1<pending.size(); n+=2)
+					streams[pending[n]].p_buffer[pending[n+1]] = 1;
+			}
+
+			//	ok
+			return C_OK;
+		}
+
+		case EVENT_STATE_GET:
+		{
+			EventStateGet* esg = (EventStateGet*)event->data;
+
+			//	only checkpoints carry run-phase state
+			if (!(esg->flags & F_CHECKPOINT)) return S_NULL;
+
+			//	get existing state node
+			XMLNode xmlNode(esg->state);
+			DataMLNode state(&xmlNode);
+
+			//	spikes not yet passed on, as (stream, index) pairs
+			VINT32 pending;
+			for (UINT32 s=0; s<streams.size(); s++)
+			{
+				for (UINT32 n=0; n<streams[s].capacity; n++)
+				{
+					if (streams[s].p_buffer[n])
+					{
+						pending.push_back(s);
+						pending.push_back(n);
+					}
+				}
+			}
+
+			state.addField("pending").setArray(Dims(1, pending.size()), pending);
+
 			//	ok
 			return C_OK;
 		}
@@ -107,12 +107,23 @@ if ~isempty(exe.logs)
 		if ~isempty(log.window)
 			line = [line ', window=''' log.window ''''];
 		end
+		if ~isempty(log.decimate)
+			line = [line ', decimate=' int2str(log.decimate)];
+			if ~isempty(log.aggregate)
+				line = [line ' (' log.aggregate ')'];
+			end
+		end
 		if log.encapsulated
 			line = [line ' (encapsulated)'];
 		end
 		if ~log.recurse
 			line = [line ' (no recursion)'];
 		end
+		if log.compressed
+			line = [line ' (compressed)'];
+		elseif log.chunked
+			line = [line ' (chunked)'];
+		end
 		disp(line)
 	end
 end
@@ -60,6 +60,10 @@ log.precision = [];
 log.encapsulated = [];
 log.window = [];
 log.recurse = [];
+log.compressed = [];
+log.chunked = [];
+log.decimate = [];
+log.aggregate = [];
 
 % interpret args
 while length(varargin)
@@ -132,6 +136,24 @@ while length(varargin)
 				end
 				log.recurse = val;
 				
+			case {'compressed' 'chunked'}
+				if ~isscalar(val) | ~islogical(val)
+					error(['invalid value for "' key '"']);
+				end
+				log.(key) = val;
+				
+			case {'decimate'}
+				if ~isscalar(val) | ~isnumeric(val) | ~isreal(val) | val ~= floor(val) | val < 1
+					error(['invalid value for "' key '"']);
+				end
+				log.decimate = val;
+				
+			case {'aggregate'}
+				if ~ischar(val) | ~any(strcmp(val, {'first' 'mean' 'min' 'max' 'rms'}))
+					error(['invalid value for "' key '"']);
+				end
+				log.aggregate = val;
+				
 			otherwise
 				error(['unrecognised argument "' key '"']);
 			
@@ -164,6 +186,9 @@ while length(varargin)
 			case {'norecurse'}
 				log.recurse = false;
 				
+			case {'compressed', 'chunked'}
+				log.(arg) = true;
+				
 			otherwise
 				error(['unrecognised argument "' arg '"']);
 			
@@ -110,6 +110,10 @@ for n = 1:length(exe.logs.specific)
 	if ~isempty(out.window) xml = [xml ' Window="' out.window '"']; end
 	if ~isempty(out.encapsulated) xml = [xml ' Encapsulated="' int2str(out.encapsulated) '"']; end
 	if ~isempty(out.recurse) xml = [xml ' Recurse="' int2str(out.recurse) '"']; end
+	if ~isempty(out.compressed) xml = [xml ' Compressed="' int2str(out.compressed) '"']; end
+	if ~isempty(out.chunked) xml = [xml ' Chunked="' int2str(out.chunked) '"']; end
+	if ~isempty(out.decimate) xml = [xml ' Decimate="' int2str(out.decimate) '"']; end
+	if ~isempty(out.aggregate) xml = [xml ' Aggregate="' out.aggregate '"']; end
 
 	% replace ">" with ">>>"
 	f = find(out.name == '>');
@@ -187,7 +187,7 @@ switch tag.attr.c
 		for e = 0:length(tag.children)-1
 			el = floor(e / nfields) + 1;
 			n = mod(e, nfields) + 1;
-			value(el).(fn{n}) = dataml2data(tag.children(e+1));
+			value(el).(fn{n}) = dataml2data(tag.children(e+1), suppath);
 		end
 
 	case 'y'
@@ -197,7 +197,7 @@ switch tag.attr.c
 		
 		% for each <cell> element
 		for n = 1:length(tag.children)
-			value{n} = dataml2data(tag.children(n), reader);
+			value{n} = dataml2data(tag.children(n), suppath);
 		end
 
 	otherwise
@@ -226,11 +226,11 @@ switch tag.attr.c
 		end
 
 		% check for binary storage format
-		if isfield(tag.attr, 's')
+		if isfield(tag.attr, 's') && ~strcmp(tag.attr.s, '64')
 
 			% validate
 			storage_protocol = tag.attr.s;
-			if ~ischar(storage_protocol) || ~isscalar(storage_protocol) || storage_protocol ~= 'b'
+			if ~ischar(storage_protocol) || ~isscalar(storage_protocol) || ~any(storage_protocol == 'bc')
 				error('cannot recognise storage protocol');
 			end
 
@@ -252,6 +252,7 @@ switch tag.attr.c
 			value.complex = cpx;
 			value.interleaved = interleaved;
 			value.bytesperelement = bytesperel(f);
+			value.chunked = storage_protocol == 'c';
 
 			% calculate expected file size
 			value.bytesinfile = value.bytesperelement * numels;
@@ -269,16 +270,29 @@ switch tag.attr.c
 				error(['file not found "' value.filename '"']);
 			end
 
-			% check file size
+			% data may be a blob within a larger file
+			value.offset = 0;
+			if isfield(tag.attr, 'o')
+				value.offset = str2double(tag.attr.o);
+			end
+
+			% check file size (a chunked file is checked as it is decoded)
 			d = dir(value.filename);
-			if value.bytesinfile ~= d.bytes
+			if ~value.chunked && value.bytesinfile ~= d.bytes && ~(isfield(tag.attr, 'o') && value.offset + value.bytesinfile <= d.bytes)
 				error(['file incorrect size "' value.filename '" (' int2str(d.bytes) ', expecting ' int2str(value.bytesinfile) ')']);
 			end
 			
 		else
 
-			% read data from tag content (not interleaved)
-			value = sscanf(tag.value, '%f');
+			% read data from tag content, as text or base64 (not interleaved)
+			if isfield(tag.attr, 's')
+				value = sml_xml('base642data', tag.value, cls);
+				if length(value) ~= numels * (1 + cpx)
+					error('base64 content is the wrong length');
+				end
+			else
+				value = sscanf(tag.value, '%f');
+			end
 			if isempty(value)
 				value = [];
 			end
@@ -124,14 +124,17 @@ d = dir(iface.filename);
 if isempty(d)
 	error(['file not found "' iface.filename '"']);
 end
-if d.bytes ~= iface.bytesinfile
-	error(['file wrong size "' iface.filename '"']);
-end
 
-% open file
-fid = fopen(iface.filename, 'rb');
-if fid == -1
-	error(['failed open "' iface.filename '"']);
+% open file (a chunked file is decoded by sml_xml instead)
+fid = -1;
+if ~iface.chunked
+	if d.bytes < iface.offset + iface.bytesinfile
+		error(['file wrong size "' iface.filename '"']);
+	end
+	fid = fopen(iface.filename, 'rb');
+	if fid == -1
+		error(['failed open "' iface.filename '"']);
+	end
 end
 
 % read file
@@ -141,7 +144,7 @@ if ischar(read_range) % 'all'
 
 	% read whole file
 	if length(sz) == 2 && ~iface.complex
-		out = fread(fid, sz, ['*' iface.matcls]);
+		out = reshape(readelements(iface, fid, 0, prod(sz)), sz);
 	else
 		if iface.complex
 			if iface.interleaved
@@ -153,7 +156,7 @@ if ischar(read_range) % 'all'
 		if length(sz) < 2
 			sz = [sz 1];
 		end
-		out = reshape(fread(fid, prod(sz), ['*' iface.matcls]), sz);
+		out = reshape(readelements(iface, fid, 0, prod(sz)), sz);
 		if iface.complex
 			adims = repmat({':'}, 1, ndims-1);
 			sz = iface.size;
@@ -184,13 +187,8 @@ else
 		complex_mult = 2;
 	end
 	
-	% seek first byte of contiguous block
+	% first byte of contiguous block
 	byte_start = element_start * iface.bytesperelement * complex_mult;
-	status = fseek(fid, byte_start, 'bof');
-	if status == -1
-		fclose(fid);
-		error(['failed seek in "' iface.filename '"']);
-	end
 	
 	% get dimensions of block to be read (source dimensions,
 	% but last is time-to-be-read rather than time-available)
@@ -208,14 +206,10 @@ else
 	end
 	
 	% do the read
-	if length(sz) == 2
-		out = fread(fid, sz, ['*' iface.matcls]);
-	else
-		if length(sz) < 2
-			sz = [sz 1];
-		end
-		out = reshape(fread(fid, prod(sz), ['*' iface.matcls]), sz);
+	if length(sz) < 2
+		sz = [sz 1];
 	end
+	out = reshape(readelements(iface, fid, byte_start, prod(sz)), sz);
 	
 	% if complex, de-interleave
 	if iface.complex
@@ -243,7 +237,9 @@ else
 end
 
 % close file
-fclose(fid);
+if fid ~= -1
+	fclose(fid);
+end
 
 % end
 if transpose_output_at_end
@@ -254,4 +250,21 @@ end
 
 
 
+function out = readelements(iface, fid, byte_start, count)
 
+% read "count" elements, from "byte_start" bytes into the data
+if iface.chunked
+	bytes = sml_xml('chunked2bytes', iface.filename, [byte_start count * iface.bytesperelement]);
+	switch iface.matcls
+		case 'logical', out = logical(bytes);
+		case 'char', out = char(bytes);
+		otherwise, out = typecast(bytes, iface.matcls);
+	end
+else
+	status = fseek(fid, iface.offset + byte_start, 'bof');
+	if status == -1
+		fclose(fid);
+		error(['failed seek in "' iface.filename '"']);
+	end
+	out = fread(fid, count, ['*' iface.matcls]);
+end
@@ -27,6 +27,10 @@
 % "scaling" measure how performance scales with the number
 %   of processes in the system.
 %
+% "spikelog" measure the cost of logging spikes, to memory
+%   and to file, from a population firing at realistic
+%   rates.
+%
 %
 %
 % Some arguments may be used with any of the benchmarks, as
@@ -136,6 +140,7 @@ elseif ischar(firstarg)
 				'overheadi'
 				'cache'
 				'scaling'
+				'spikelog'
 				}
 			brahms_bench_run(firstarg, varargin{:});
 
@@ -728,6 +733,114 @@ switch(benchmark)
 			end
 		end
 		safeclose(hw);
+
+
+
+%% SPIKELOG
+
+	case 'spikelog'
+
+		% measure the cost of logging a spike, as a population of
+		% U units fires at a range of realistic rates R (Hz),
+		% against the same system with nothing logged. spikes
+		% are logged to memory (encapsulated) or to file (not);
+		% either way, they are logged at run-time, so that is
+		% the phase we time (the memory log is laid into the
+		% report at termination, which is timed separately).
+
+		hiperf = false;
+
+		switch opt.length
+			case 0
+				reps = 1;
+				U = 1000;
+				R = [5 20];
+				T = 1;
+			case 1
+				reps = 1;
+				U = 10000;
+				R = [1 5 20];
+				T = 2;
+			case 2
+				reps = 3;
+				U = 100000;
+				R = [1 5 20 50];
+				T = 5;
+			case 3
+				hiperf = true;
+				reps = 5;
+				U = 100000;
+				R = [1 2 5 10 20 50 100];
+				T = 10;
+		end
+
+		fS = 1000;
+		modes = {'none', 'memory', 'file'};
+		Tr = NaN(length(R), length(modes), reps);
+		Tt = NaN(length(R), length(modes), reps);
+
+		% result
+		result.fS = fS;
+		result.U = U;
+		result.R = R;
+		result.T = T;
+		result.modes = modes;
+		result.reps = reps;
+
+		ci = 0;
+		cf = length(R) * length(modes) * reps;
+		hw = brahms_waitbar(0, 'Benchmarking...');
+		for ir = 1:reps
+			for ii = 1:length(R)
+
+				% population, each unit firing with exponential ISIs
+				% (after a refractory period of 2ms) at R Hz on average
+				sys = sml_system;
+				sys = sys.addprocess('src', 'std/2009/random/spikes', fS, [], ir);
+				sys.src.state.dist = 'exponential';
+				sys.src.state.streams = U;
+				sys.src.state.pars = [0.002 1/R(ii)-0.002];
+
+				for im = 1:length(modes)
+
+					exe = brahms_execution;
+					exe.name = 'brahms_bench';
+					exe.stop = T;
+					exe.execPars.ShowGUI = 0;
+					exe.execPars.Priority = 1;
+					exe.execPars.MaxThreadCount = 1;
+					switch modes{im}
+						case 'memory'
+							exe.all = true;
+							exe.encapsulated = true;
+						case 'file'
+							exe.all = true;
+							exe.encapsulated = false;
+					end
+
+					% run it
+					[out, rep] = brahms(sys, exe, opts{:});
+					Tr(ii, im, ir) = rep.Timing.caller.irt(2);
+					Tt(ii, im, ir) = rep.Timing.caller.irt(3);
+
+					% plot it
+					result.Tr = Tr;
+					result.Tt = Tt;
+					mark.result = result;
+
+					if ~hiperf
+						brahms_bench_report(mark, true);
+					end
+
+					% workbar
+					ci = ci + 1;
+					brahms_waitbar(ci/cf, hw);
+					drawnow
+
+				end
+			end
+		end
+		safeclose(hw);
 		
 		
 		
@@ -1211,6 +1324,52 @@ switch mark.benchmark
 
 
 
+%% PLOT SPIKELOG
+
+	case 'spikelog'
+
+		R = mark.result.R;
+		U = mark.result.U;
+		T = mark.result.T;
+
+		% spikes expected (mean ISI is 1/R)
+		S = U * R(:) * T;
+
+		% logging cost over the unlogged run, per spike (ns),
+		% taking the min over reps (NaNs, if the benchmark is
+		% in progress, are ignored)
+		Tr = min(mark.result.Tr, [], 3);
+		Tt = min(mark.result.Tt, [], 3);
+		ns = (Tr(:, 2:3) - Tr(:, [1 1])) ./ [S S] * 1e9;
+		nt = Tt(:, 2) ./ S * 1e9;
+
+		% plot
+		plot(R, ns(:, 1), 'b.-', R, ns(:, 2), 'r.-', R, nt, 'b.:')
+		xlabel('firing rate (Hz)')
+		ylabel('cost per spike (ns)')
+		legend('memory, run-time', 'file, run-time', 'memory, termination', 2)
+		title(['Spike Logging, ' int2str(U) ' units' elap])
+		v = axis;
+		v(3) = 0;
+		axis(v);
+
+		% report
+		if all(~isnan(ns(:))) && ~noprint
+			disp(['________________________________________________________________________________' 10])
+			disp(['    Rate  Spikes/s  Memory    File    Term']);
+			disp(['________________________________________________________________________________' 10])
+			for n = 1:length(R)
+				disp([dsp(R(n),8) dsp(round(S(n)/T),10) dsp(round(ns(n,1)),8) dsp(round(ns(n,2)),8) dsp(round(nt(n)),8)])
+			end
+			disp(['________________________________________________________________________________' 10])
+			disp(['Memory/File are run-time logging costs (in nanoseconds) per spike' elap])
+			disp(['________________________________________________________________________________' 10])
+		end
+
+		drawnow
+
+
+
 end
 
 % complete plot commands before returning to benchmark code
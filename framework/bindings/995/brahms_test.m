@@ -22,6 +22,9 @@
 %   precision - control output precision
 %   io - pass big data in and out efficiently
 %   window - window the output logs
+%   compressed - compress the output logs
+%   reduce - decimate and aggregate the output logs
+%   binary - pass data as base64 and as blobs in a file
 %
 % Test Systems (can multiprocess)
 %   std - standard library correctly installed
@@ -264,6 +267,9 @@ tests = {
 	'precision'
 	'io'
 	'window'
+	'compressed'
+	'reduce'
+	'binary'
 	'std'
 	'pair'
 	'loop'
@@ -1086,6 +1092,244 @@ switch(test)
 
 
 
+		%% COMPRESSED
+
+	case 'compressed'
+
+		% smooth, noisy, integer and complex data (which are
+		% compressed with different codecs, or stored), each
+		% long enough to span several chunks
+		fS = 1000;
+		t = (0:fS-1) / fS;
+		randn('seed', 1);
+		data = [];
+		data.smooth = [sin(2*pi*t); cos(2*pi*t)];
+		data.noisy = randn(3, fS);
+		data.int = int16(round(1000 * sin(6*pi*t)));
+		data.cpx = complex(sin(2*pi*t), cos(4*pi*t));
+
+		sys = sml_system;
+		f = fieldnames(data);
+		for n = 1:length(f)
+			state = [];
+			state.data = data.(f{n});
+			state.ndims = 1;
+			state.repeat = true;
+			sys = sys.addprocess(f{n}, 'std/2009/source/numeric', fS, state);
+		end
+
+		% log each to a compressed (chunked) file
+		exe = brahms_execution;
+		exe.name = test;
+		exe.stop = 100;
+		exe.encapsulated = false;
+		for n = 1:length(f)
+			exe = exe.log([f{n} '>out'], 'compressed');
+		end
+
+		% execute
+		[out, rep] = brahms(sys, exe, opt.opts{:});
+
+		% every sample must come back exactly, whether read
+		% whole or in part (across a chunk boundary)
+		N = exe.stop * fS;
+		for n = 1:length(f)
+			expected = repmat(data.(f{n}), 1, N / fS);
+			if ~isequal(out.(f{n}).out, expected)
+				error(['compressed log of "' f{n} '" does not match']);
+			end
+			part = 65000:70000;
+			if ~isequal(out.(f{n}).out(:, part), expected(:, part))
+				error(['compressed log of "' f{n} '" does not match (read in part)']);
+			end
+			if ~opt.suppressoutput
+				disp(['compressed log of "' f{n} '" matches'])
+			end
+		end
+
+
+
+		%% REDUCE
+
+	case 'reduce'
+
+		% log real, integer and complex data with each aggregate
+		% over windows of W samples; fS is not a multiple of W,
+		% so the last window is part full ("first" logs it, the
+		% others drop it), and the integer means include ties
+		% (x.5) of both signs, which must round as int16() does
+		fS = 50;
+		W = 4;
+		t = (0:fS-1) / fS;
+		data = [];
+		data.dbl = [sin(2*pi*t) + t; cos(6*pi*t)];
+		data.int = int16(mod((0:fS-1) * 37, 201) - 100);
+		data.cpx = complex(sin(4*pi*t), t - 0.5);
+		aggregates = {'first' 'mean' 'min' 'max' 'rms'};
+
+		sys = sml_system;
+		exe = brahms_execution;
+		exe.name = test;
+		exe.stop = 1;
+		f = fieldnames(data);
+		for n = 1:length(f)
+			for a = 1:length(aggregates)
+				name = [f{n} '_' aggregates{a}];
+				state = [];
+				state.data = data.(f{n});
+				state.ndims = 1;
+				state.repeat = true;
+				sys = sys.addprocess(name, 'std/2009/source/numeric', fS, state);
+				exe = exe.log([name '>out'], {'decimate' W}, {'aggregate' aggregates{a}});
+			end
+		end
+
+		% execute
+		[out, rep] = brahms(sys, exe, opt.opts{:});
+
+		% compare with the same reduction done here (complex
+		% data is reduced part by part)
+		for n = 1:length(f)
+			x = data.(f{n});
+			for a = 1:length(aggregates)
+				name = [f{n} '_' aggregates{a}];
+				if isreal(x)
+					expected = reduce(x, W, aggregates{a});
+				else
+					expected = complex(reduce(real(x), W, aggregates{a}), reduce(imag(x), W, aggregates{a}));
+				end
+
+				% mean and RMS of floating-point data may differ in
+				% the last place; everything else must be exact
+				if isinteger(x) || any(strcmp(aggregates{a}, {'first' 'min' 'max'}))
+					ok = isequal(out.(name).out, expected);
+				else
+					ok = similar(out.(name).out, expected);
+				end
+				if ~ok
+					error(['reduced log of "' name '" does not match']);
+				end
+				if ~opt.suppressoutput
+					disp(['reduced log of "' name '" matches'])
+				end
+			end
+		end
+
+
+
+		%% BINARY
+
+	case 'binary'
+
+		% pass real, integer and complex data (with the real and
+		% imaginary parts adjacent, "x", or interleaved, "y") in
+		% to source/numeric as base64, and as blobs at offsets in
+		% one binary file (see DATAML_BINARY); BRAHMS writes them
+		% back as base64 (output state and logs, being over the
+		% DataMLBinaryThreshold) and as binary files (logs, if
+		% not encapsulated), and sml_xml must read them all back
+		% as they were, as well as reading what it was given
+		% (the run is long enough that the logs can be files)
+		fS = 50;
+		t = (0:fS-1) / fS;
+		data = [];
+		data.dbl = [sin(2*pi*t); t];
+		data.int = int16(round(1000 * [cos(2*pi*t); sin(6*pi*t)]));
+		data.cpx = complex(sin(4*pi*t), t - 0.5);
+		data.cpy = complex([t; -t], [cos(2*pi*t); 1 - t]);
+		layout = struct('dbl', '', 'int', '', 'cpx', 'x', 'cpy', 'y');
+
+		% the blobs follow a short header, a byte apart
+		blobfile = [tempname '.bin'];
+		fid = fopen(blobfile, 'wb');
+		fwrite(fid, 'blobs', 'char');
+		f = fieldnames(data);
+		nodes = [];
+		for n = 1:length(f)
+			x = data.(f{n});
+			nodes.([f{n} '_64']) = datamlnode(x, layout.(f{n}), '64');
+			nodes.([f{n} '_b']) = datamlnode(x, layout.(f{n}), 'b', blobfile, ftell(fid));
+			fwrite(fid, dataml_elements(x, layout.(f{n}), 'b'), class(x));
+			fwrite(fid, 0, 'uint8');
+		end
+		fclose(fid);
+
+		sys = sml_system;
+		exe = brahms_execution;
+		exe.name = test;
+		exe.stop = 30;
+		exe.execPars.DataMLBinaryThreshold = 4;
+		p = fieldnames(nodes);
+		for n = 1:length(p)
+			sys = sys.addprocess(p{n}, 'std/2009/source/numeric', fS, numericstate(nodes.(p{n})));
+			exe = exe.log([p{n} '>out']);
+		end
+
+		% execute, with logs encapsulated and then in files
+		[out, rep, sysout] = brahms(sys, exe, opt.opts{:});
+		exe.encapsulated = false;
+		[outb, rep] = brahms(sys, exe, opt.opts{:});
+
+		for n = 1:length(p)
+			x = data.(strtok(p{n}, '_'));
+			if ~isequal(sml_xml('dataml2data', sml_xml('text2xml', nodes.(p{n}))), x)
+				error(['sml_xml did not read the data of "' p{n} '"']);
+			end
+			expected = repmat(x, 1, exe.stop);
+			if ~isequal(out.(p{n}).out, expected) || ~isequal(outb.(p{n}).out, expected)
+				error(['BRAHMS did not read the data of "' p{n} '"']);
+			end
+			if ~isequal(sysout.(p{n}).state.data, x)
+				error(['state of "' p{n} '" did not come back']);
+			end
+			state = sysout.(p{n}).output{1}.state;
+			if ~isfield(state.attr, 's') || ~strcmp(state.attr.s, '64') || ~isequal(sml_xml('dataml2data', state), x(:, end))
+				error(['output state of "' p{n} '" did not come back as base64']);
+			end
+			if ~opt.suppressoutput
+				disp(['data of "' p{n} '" matches'])
+			end
+		end
+
+		% base64 one element short or one over, and a blob that
+		% runs off the end of its file, must be refused by both
+		x = data.cpy;
+		v = dataml_elements(x, 'y', '64');
+		d = dir(blobfile);
+		bad = {
+			datamlnode(x, 'y', '64', v(1:end-1))
+			datamlnode(x, 'y', '64', [v; 0])
+			datamlnode(x, 'y', 'b', blobfile, d.bytes - length(v) * 8 + 1)
+			};
+		for n = 1:length(bad)
+			sys = sml_system;
+			sys = sys.addprocess('bad', 'std/2009/source/numeric', fS, numericstate(bad{n}));
+			exe = brahms_execution;
+			exe.name = test;
+			exe.stop = 1;
+			refused = false;
+			try
+				brahms(sys, exe, opt.opts{:});
+			catch
+				refused = true;
+			end
+			if ~refused
+				error(['BRAHMS read bad DataML "' bad{n}(1:min(end, 60)) '..."']);
+			end
+			refused = false;
+			try
+				sml_xml('dataml2data', sml_xml('text2xml', bad{n}));
+			catch
+				refused = true;
+			end
+			if ~refused
+				error(['sml_xml read bad DataML "' bad{n}(1:min(end, 60)) '..."']);
+			end
+		end
+		delete(blobfile);
+
+
+
 		%% SEQUENCE
 
 	case 'sequence'
@@ -2819,6 +3063,102 @@ end
 
 
 
+
+function y = reduce(x, W, aggregate)
+
+% reduce each row of x over windows of W columns, as the
+% data object does when a log has Decimate and Aggregate
+N = size(x, 2);
+if strcmp(aggregate, 'first')
+	y = x(:, 1:W:N);
+	return
+end
+
+K = floor(N / W);
+v = reshape(double(x(:, 1:K*W)), size(x, 1), W, K);
+switch aggregate
+	case 'mean'
+		v = sum(v, 2) / W;
+	case 'min'
+		v = min(v, [], 2);
+	case 'max'
+		v = max(v, [], 2);
+	case 'rms'
+		v = sqrt(sum(v .^ 2, 2) / W);
+end
+y = cast(reshape(v, size(x, 1), K), class(x));
+
+
+
+
+function v = dataml_elements(x, layout, storage)
+
+% the elements of x in the order DataML holds them, as
+% base64 ('64') or in a binary file ('b')
+if isreal(x)
+	v = x(:);
+elseif strcmp(layout, 'y')
+	v = [real(x(:)) imag(x(:))]';
+	v = v(:);
+elseif strcmp(storage, 'b')
+	x = reshape(x, [], size(x, ndims(x)));
+	v = [real(x); imag(x)];
+	v = v(:);
+else
+	v = [real(x(:)); imag(x(:))];
+end
+
+
+
+
+function node = datamlnode(x, layout, storage, varargin)
+
+% a DataML node for x: as base64 of its elements (or of
+% the elements given), or as a blob in a file at an offset
+switch class(x)
+	case 'double', c = 'd';
+	case 'int16', c = 'n';
+end
+attr = ['c="' c layout '" b="' sprintf('%d %d', size(x)) '" s="' storage '"'];
+if strcmp(storage, '64')
+	if isempty(varargin)
+		v = dataml_elements(x, layout, storage);
+	else
+		v = varargin{1};
+	end
+	node = ['<m ' attr '>' base64(typecast(v, 'uint8')) '</m>'];
+else
+	node = ['<m ' attr ' o="' int2str(varargin{2}) '">' varargin{1} '</m>'];
+end
+
+
+
+
+function s = base64(bytes)
+
+% standard base64 (RFC 4648), padded with "="
+alphabet = ['A':'Z' 'a':'z' '0':'9' '+/'];
+n = length(bytes);
+pad = mod(-n, 3);
+b = reshape(double([bytes(:); zeros(pad, 1)]), 3, []);
+w = b(1,:) * 65536 + b(2,:) * 256 + b(3,:);
+c = [floor(w / 262144); mod(floor(w / 4096), 64); mod(floor(w / 64), 64); mod(w, 64)];
+s = alphabet(c(:)' + 1);
+s(end-pad+1:end) = '=';
+
+
+
+
+function state = numericstate(node)
+
+% source/numeric state with "node" as its data, passed
+% to BRAHMS as it is
+state = sml_xml('text2xml', ['<State c="z" a="data;ndims;repeat;" Format="DataML" Version="5" AuthTool="brahms_test" AuthToolVersion="0">' ...
+	node '<m c="d">1</m><m c="l">1</m></State>']);
+state.stateml_write = 'raw';
+
+
+
 
 function s = similar(a, b)
 
@@ -90,7 +90,8 @@
 %   this is the basic data type. can be "y" (cell) or "z"
 %   (struct) or one of "fdvutsponmlc" (numeric - see below
 %   for details of what each means). numeric types can be
-%   suffixed with "x" (complex).
+%   suffixed with "x" (complex) or "y" (complex, with the
+%   real and imaginary parts of each element side by side).
 %
 % "b"
 %   dimensions, e.g. b="3 2". if the data is scalar, this
@@ -102,8 +103,15 @@
 %
 % "s"
 %   numeric storage format, either absent (stored directly
-%   in the tag) or s="b" (stored in a binary file, and the
-%   tag is the filename of that file).
+%   in the tag), s="64" (stored in the tag in base64),
+%   s="b" (stored in a binary file, and the tag is the
+%   filename of that file), or s="c" (as s="b", but the
+%   file is a chunked log file, which may be compressed;
+%   see LOG_CHUNKS in brahms-logfile.h).
+%
+% "o"
+%   for s="b", the offset (bytes) of the data in the binary
+%   file, if the file holds other data too.
 %
 % cell and struct tags then have child tags, all with the
 % tag name "m", which are each an element of the cell or
@@ -120,7 +128,10 @@
 % dimension, so that the data is stored in the file in
 % chonological order, assuming the last dimension of the
 % data is time. note that for non-binary storage, complex
-% data are not interleaved.
+% data are not interleaved. in either case, "y" complex
+% data are interleaved element by element instead. base64
+% storage holds the same elements as text storage, in the
+% same order, each one little-endian.
 
 %__________________________________________________________________________
 %
@@ -170,6 +181,16 @@ switch op
 	case 'xml2text'
 		out = xml2text(in);
 
+	case 'base642data'
+		out = base642data(in, extra);
+
+	case 'chunked2bytes'
+		if nargin < 3
+			out = chunked2bytes(in);
+		else
+			out = chunked2bytes(in, extra);
+		end
+
 	case 'dataml2data'
 		if nargin < 3
 			reader = [];
@@ -765,24 +786,27 @@ switch tag.attr.c
 
 	otherwise
 
-		% get numeric class (and complexity)
+		% get numeric class (and complexity, real/imag being the
+		% trailing dimension for "x" or the leading one for "y")
 		if length(tag.attr.c) == 2
-			if tag.attr.c(2) ~= 'x'
+			if ~any(tag.attr.c(2) == 'xy')
 				error('malformed DataML');
 			end
 			cls = tag.attr.c(1);
 			cpx = true;
+			interleaved = tag.attr.c(2) == 'y';
 		else
 			cls = tag.attr.c;
 			cpx = false;
+			interleaved = false;
 		end
 
 		% check for binary storage format
-		if isfield(tag.attr, 's')
+		if isfield(tag.attr, 's') && ~strcmp(tag.attr.s, '64')
 
 			% validate
 			storage_protocol = tag.attr.s;
-			if ~ischar(storage_protocol) || ~isscalar(storage_protocol) || storage_protocol ~= 'b'
+			if ~ischar(storage_protocol) || ~isscalar(storage_protocol) || ~any(storage_protocol == 'bc')
 				error('cannot recognise storage protocol');
 			end
 
@@ -810,35 +834,66 @@ switch tag.attr.c
 				filename = [reader.supplementaryFilePath '/' filename];
 			end
 			
-			% check file size
+			% check file exists
 			d = dir(filename);
 			if isempty(d)
 				error(['file not found "' filename '"']);
 			end
-			if expbytes ~= d.bytes
-				error('binary file incorrect size');
-			end
-			
-			% open file
-			fid = fopen(filename, 'rb');
-			if fid == -1
-				error(['failed open "' filename '"']);
-			end
 
-			% read and close file
-			try
-				[value, count] = fread(fid, Inf, ['*' matcls]);
-			catch
+			% chunked file decodes to what a binary file would hold
+			if storage_protocol == 'c'
+
+				value = chunked2bytes(filename);
+				if length(value) ~= expbytes
+					error('chunked file decodes to incorrect size');
+				end
+				switch matcls
+					case 'logical', value = logical(value);
+					case 'char', value = char(value);
+					otherwise, value = typecast(value, matcls);
+				end
+				count = numel(value);
+
+			else
+
+				% data may be a blob within a larger file
+				offset = 0;
+				if isfield(tag.attr, 'o')
+					offset = str2double(tag.attr.o);
+					if d.bytes < offset + expbytes
+						error('binary file too small');
+					end
+				elseif expbytes ~= d.bytes
+					error('binary file incorrect size');
+				end
+
+				% open file
+				fid = fopen(filename, 'rb');
+				if fid == -1
+					error(['failed open "' filename '"']);
+				end
+
+				% read and close file
+				try
+					fseek(fid, offset, 'bof');
+					[value, count] = fread(fid, expbytes / bytesperel, ['*' matcls]);
+				catch
+					fclose(fid);
+					rethrow(lasterror);
+				end
 				fclose(fid);
-				rethrow(lasterror);
+
 			end
-			fclose(fid);
 			
 			% complex?
 			if cpx
 				
-				% interleaved?
-				if length(sz) > 1
+				% interleaved by element?
+				if interleaved
+					value = complex(value(1:2:end), value(2:2:end));
+
+				% interleaved by last dimension?
+				elseif length(sz) > 1
 
 					% check sizes
 					szf = sz(end);
@@ -881,10 +936,21 @@ switch tag.attr.c
 			
 		else
 			
-			% read data from tag content (not interleaved)
-			value = sscanf(tag.value, '%f');
+			% read data from tag content, as text or base64
+			if isfield(tag.attr, 's')
+				value = base642data(tag.value, cls);
+				if length(value) ~= numels * (1 + cpx)
+					error('base64 content is the wrong length');
+				end
+			else
+				value = sscanf(tag.value, '%f');
+			end
 			if cpx
-				value = complex(value(1:end/2), value(end/2+1:end));
+				if interleaved
+					value = complex(value(1:2:end), value(2:2:end));
+				else
+					value = complex(value(1:end/2), value(end/2+1:end));
+				end
 			end
 			
 		end
@@ -935,6 +1001,296 @@ end
 
 
 
+function value = base642data(text, cls)
+
+% value (0 to 63) of each character, 64 if not in the alphabet
+alphabet = ['A':'Z' 'a':'z' '0':'9' '+/'];
+map = repmat(64, 1, 256);
+map(double(alphabet) + 1) = 0:63;
+
+% drop whitespace and padding
+text = text(~isspace(text) & text ~= '=');
+v = map(double(text) + 1);
+if any(v == 64)
+	error('malformed base64');
+end
+
+% four characters to three bytes
+n = length(v);
+v = reshape([v zeros(1, mod(-n, 4))], 4, []);
+w = v(1,:) * 262144 + v(2,:) * 4096 + v(3,:) * 64 + v(4,:);
+bytes = uint8([floor(w / 65536); mod(floor(w / 256), 256); mod(w, 256)]);
+bytes = bytes(1:floor(n * 3 / 4));
+
+% bytes to elements (every platform MATLAB runs on is little-endian)
+f = find('fdvutsponmlc' == cls);
+if isempty(f)
+	error(['unrecognised numeric type "' cls '"'])
+end
+matcls = {'single', 'double', 'uint64', 'uint32', 'uint16', 'uint8', 'int64', 'int32', 'int16', 'int8', 'uint8', 'uint16'};
+value = typecast(bytes(:), matcls{f});
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+%% %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% %%
+%% %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% %%
+%%         CHUNKED LOG FILE ==> BYTES
+%% %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% %%
+%% %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% %%
+
+function bytes = chunked2bytes(filename, range)
+
+% decode a chunked log file (see LOG_CHUNKS in brahms-logfile.h)
+% into the bytes that a binary (s="b") file would have held. if
+% "range" is supplied, as [first count], only those bytes are
+% returned, and only the chunks that hold them are decoded.
+%
+% the headers are in the byte order of the host that wrote the
+% file; every platform MATLAB runs on is little-endian, and a
+% file from a big-endian host fails the magic number checks.
+
+CHUNK_MAGIC = 1262701634; % "BLCK"
+TRAILER_MAGIC = 1413893186; % "BLFT"
+FORMAT_VERSION = 1;
+
+fid = fopen(filename, 'rb');
+if fid == -1
+	error(['failed open "' filename '"']);
+end
+
+try
+
+	% index from trailer (offset, first, last, raw, stored)
+	fseek(fid, 0, 'eof');
+	filebytes = ftell(fid);
+	index = zeros(0, 5);
+	trailer = [];
+	if filebytes >= 32
+		fseek(fid, filebytes - 32, 'bof');
+		trailer = fread(fid, 32, '*uint8');
+		if double(typecast(trailer(29:32), 'uint32')) ~= TRAILER_MAGIC
+			trailer = [];
+		end
+	end
+
+	if ~isempty(trailer)
+
+		if double(typecast(trailer(25:28), 'uint32')) ~= FORMAT_VERSION
+			error(['unsupported format version in "' filename '"']);
+		end
+		indexoffset = double(typecast(trailer(1:8), 'uint64'));
+		chunkcount = double(typecast(trailer(17:20), 'uint32'));
+		if indexoffset + chunkcount * 32 + 32 > filebytes
+			error(['trailer corrupt in "' filename '"']);
+		end
+		fseek(fid, indexoffset, 'bof');
+		e = reshape(fread(fid, chunkcount * 32, '*uint8'), 32, chunkcount);
+		index = [ ...
+			double(typecast(reshape(e(1:8, :), [], 1), 'uint64')) ...
+			double(typecast(reshape(e(9:16, :), [], 1), 'uint64')) ...
+			double(typecast(reshape(e(17:24, :), [], 1), 'uint64')) ...
+			double(typecast(reshape(e(25:28, :), [], 1), 'uint32')) ...
+			double(typecast(reshape(e(29:32, :), [], 1), 'uint32')) ...
+			];
+
+	else
+
+		% no trailer (the run did not finish), so hop from
+		% header to header, keeping the chunks written whole
+		offset = 0;
+		while offset + 32 <= filebytes
+			fseek(fid, offset, 'bof');
+			h = fread(fid, 32, '*uint8');
+			if double(typecast(h(1:4), 'uint32')) ~= CHUNK_MAGIC
+				break
+			end
+			entry = [offset ...
+				double(typecast(h(17:24), 'uint64')) ...
+				double(typecast(h(25:32), 'uint64')) ...
+				double(typecast(h(9:12), 'uint32')) ...
+				double(typecast(h(13:16), 'uint32'))];
+			if entry(3) < entry(2) || (size(index, 1) && entry(2) <= index(end, 3))
+				break
+			end
+			if entry(5) > filebytes - offset - 32
+				break
+			end
+			index(end+1, :) = entry;
+			offset = offset + 32 + entry(5);
+		end
+		if isempty(index) && filebytes
+			error(['not a chunked log file "' filename '"']);
+		end
+
+	end
+
+	% where each chunk's bytes start in the output
+	starts = [0; cumsum(index(:, 4))];
+	total = starts(end);
+	if nargin < 2
+		range = [0 total];
+	end
+	if range(1) < 0 || range(2) < 0 || range(1) + range(2) > total
+		error(['range out of bounds in "' filename '"']);
+	end
+
+	% decode the chunks that overlap the range
+	bytes = zeros(range(2), 1, 'uint8');
+	for c = 1:size(index, 1)
+
+		from = max(starts(c), range(1));
+		to = min(starts(c+1), range(1) + range(2));
+		if from >= to
+			continue
+		end
+
+		fseek(fid, index(c, 1), 'bof');
+		h = fread(fid, 32, '*uint8');
+		if double(typecast(h(1:4), 'uint32')) ~= CHUNK_MAGIC ...
+				|| double(typecast(h(9:12), 'uint32')) ~= index(c, 4) ...
+				|| double(typecast(h(13:16), 'uint32')) ~= index(c, 5)
+			error(['chunk header corrupt in "' filename '"']);
+		end
+		payload = fread(fid, index(c, 5), '*uint8');
+
+		switch double(h(5))
+			case 0
+				% CODEC_STORED
+				if index(c, 5) ~= index(c, 4)
+					error(['chunk header corrupt in "' filename '"']);
+				end
+				raw = payload;
+			case {3, 4, 5}
+				% CODEC_LZ, CODEC_SHUFFLE4_LZ, CODEC_SHUFFLE8_LZ
+				raw = lzdecode(payload, index(c, 4));
+				if h(5) ~= 3
+					width = 4 + 4 * (h(5) == 5);
+					n = floor(length(raw) / width) * width;
+					raw(1:n) = reshape(reshape(raw(1:n), [], width).', [], 1);
+				end
+			otherwise
+				error(['unrecognised codec in "' filename '"']);
+		end
+
+		bytes(from - range(1) + 1 : to - range(1)) = raw(from - starts(c) + 1 : to - starts(c));
+
+	end
+
+catch
+
+	fclose(fid);
+	rethrow(lasterror);
+
+end
+
+fclose(fid);
+
+
+
+function out = lzdecode(in, outbytes)
+
+% see COMPRESS_LZ in framework/compress/lz.h
+in = double(in);
+n = length(in);
+out = zeros(outbytes, 1, 'uint8');
+ip = 1;
+o = 0;
+
+while ip <= n
+
+	% token
+	token = in(ip);
+	ip = ip + 1;
+
+	% literals
+	len = floor(token / 16);
+	if len == 15
+		b = 255;
+		while b == 255
+			if ip > n
+				error('LZ stream truncated (literal length)');
+			end
+			b = in(ip);
+			ip = ip + 1;
+			len = len + b;
+		end
+	end
+	if ip + len - 1 > n
+		error('LZ stream truncated (literals)');
+	end
+	if o + len > outbytes
+		error('LZ output overflow (literals)');
+	end
+	out(o+1:o+len) = in(ip:ip+len-1);
+	ip = ip + len;
+	o = o + len;
+
+	% last run has no match
+	if ip > n
+		break
+	end
+
+	% match
+	if ip + 1 > n
+		error('LZ stream truncated (offset)');
+	end
+	offset = in(ip) + in(ip+1) * 256;
+	ip = ip + 2;
+	if ~offset || offset > o
+		error('LZ stream corrupt (offset)');
+	end
+	len = mod(token, 16);
+	if len == 15
+		b = 255;
+		while b == 255
+			if ip > n
+				error('LZ stream truncated (match length)');
+			end
+			b = in(ip);
+			ip = ip + 1;
+			len = len + b;
+		end
+	end
+	len = len + 4;
+	if o + len > outbytes
+		error('LZ output overflow (match)');
+	end
+
+	% a match may overlap its own output, repeating every "offset" bytes
+	out(o+1:o+len) = out(o - offset + 1 + mod(0:len-1, offset));
+	o = o + len;
+
+end
+
+if o ~= outbytes
+	error('chunk decoded to wrong length');
+end
+
+
+
+
+
+
+
+
+
+
+
+
+
+
 %% %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% %%
 %% %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% %%
 %%         DATA ==> DATAML
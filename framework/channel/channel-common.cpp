@@ -7,3 +7,53 @@ brahms::channel::ChannelSimplexData::ChannelSimplexData()
     compressed = 0;
     queue = 0;
 }
+
+brahms::channel::Histogram::Histogram()
+{
+    count = 0;
+    sum = 0;
+    max = 0;
+    for (UINT32 b=0; b<HISTOGRAM_BINS; b++)
+        bins[b] = 0;
+}
+
+void brahms::channel::Histogram::add(UINT64 value)
+{
+    // bin is number of significant bits, saturating
+    UINT32 b = 0;
+    UINT64 v = value;
+    while (v && b < HISTOGRAM_BINS - 1)
+    {
+        v >>= 1;
+        b++;
+    }
+
+    bins[b]++;
+    count++;
+    sum += value;
+    if (value > max) max = value;
+}
+
+void brahms::channel::Histogram::merge(const Histogram& h)
+{
+    for (UINT32 b=0; b<HISTOGRAM_BINS; b++)
+        bins[b] += h.bins[b];
+    count += h.count;
+    sum += h.sum;
+    if (h.max > max) max = h.max;
+}
+
+brahms::channel::LinkTelemetry::LinkTelemetry()
+{
+    backoffs = 0;
+}
+
+void brahms::channel::LinkTelemetry::merge(const LinkTelemetry& t)
+{
+    queueWait.merge(t.queueWait);
+    wireTime.merge(t.wireTime);
+    delivererWait.merge(t.delivererWait);
+    bytesRaw.merge(t.bytesRaw);
+    bytesWire.merge(t.bytesWire);
+    backoffs += t.backoffs;
+}
@@ -8,6 +8,8 @@
 #include "base/ipm.h" // ChannelPoolData
 #include <string>
 using std::string;
+#include <vector>
+using std::vector;
 
 namespace brahms
 {
@@ -23,7 +25,10 @@ namespace brahms
             // note, also, that they are |'d during the parsing process, so they
             // must be bit-exclusive (1, 2, 4, etc.)
             PROTOCOL_MPI = 1,
-            PROTOCOL_SOCKETS = 2
+            PROTOCOL_SOCKETS = 2,
+            // loopback is never read from the Execution File, but is forced
+            // on all channels when the engine is created with F_LOOPBACK
+            PROTOCOL_LOOPBACK = 4
         };
 
         // INITIALISATION DATA
@@ -65,11 +70,79 @@ namespace brahms
             brahms::base::ChannelPoolData pool;
         };
 
+        /*	DOCUMENTATION: COMMS_TELEMETRY
+
+            If CommsTelemetry is non-zero, each channel records, for every
+            message it sends, the time it waited in the send queue, the time
+            spent in send(), and its size before and after encoding and
+            compression; and for every PUSHDATA it delivers, the time it
+            waited in the deliverer queue. It also counts the times push()
+            held up a caller because the remote buffer for a link was full.
+            All of this is kept both for the channel as a whole and for each
+            link (msgStreamID), and is written to the <Comms> section of the
+            Report File. Times are in microseconds, sizes in bytes.
+
+            Values are collected into log2 histograms, so that recording is
+            a few adds per message and the report is small however long the
+            run. Each histogram is written as its count, mean and max, then
+            bin counts, where bin 0 holds zeros and bin b holds values from
+            2^(b-1) up to 2^b. A link that stalls shows up as a heavy tail
+            of QueueWait (sender backed up), WireTime (network backed up),
+            or DelivererWait (receiving process not keeping up), or as a
+            high Backoffs count.
+        */
+
+        // TELEMETRY DATA (see COMMS_TELEMETRY)
+
+        // log2 histogram; bin 0 counts zeros, bin b counts values
+        // in [2^(b-1), 2^b), and the last bin also counts anything larger
+        const UINT32 HISTOGRAM_BINS = 32;
+
+        struct Histogram
+        {
+            Histogram();
+            void add(UINT64 value);
+            void merge(const Histogram& h);
+            UINT64 count;
+            UINT64 sum;
+            UINT64 max;
+            UINT64 bins[HISTOGRAM_BINS];
+        };
+
+        // telemetry for one link, or aggregated over a channel
+        struct LinkTelemetry
+        {
+            LinkTelemetry();
+            void merge(const LinkTelemetry& t);
+            Histogram queueWait; // microseconds from push() to the sender thread
+            Histogram wireTime; // microseconds spent in send()
+            Histogram delivererWait; // microseconds from the receiver thread to the deliverer
+            Histogram bytesRaw; // message bytes before encoding and compression
+            Histogram bytesWire; // message bytes as sent
+            UINT64 backoffs; // number of times push() held the caller for congestion
+        };
+
+        // channel telemetry data
+        struct ChannelTelemetryData
+        {
+            // all traffic on the channel
+            LinkTelemetry channel;
+
+            // per link, indexed by msgStreamID (sent links are numbered
+            // by this voice, received links by the remote voice)
+            vector<LinkTelemetry> sent;
+            vector<LinkTelemetry> received;
+        };
+
         // use default timeout rather than anything specific
         const UINT32 COMMS_TIMEOUT_DEFAULT = 0x80000001;
 
-        // push data handler function prototype
-        typedef Symbol (*PushDataHandler)(void* arg, BYTE* stream, UINT32 count);
+        // push data handler function prototype - "count" bytes of content at
+        // "stream", carried in "msg"; return C_OK if done with msg, C_YES if
+        // msg has been adopted (the handler will release() it later), or
+        // C_CANCEL to stop delivery. once delivery has stopped, the handler
+        // is called once more with msg NULL, to release anything it adopted.
+        typedef Symbol (*PushDataHandler)(void* arg, BYTE* stream, UINT32 count, brahms::base::IPM* msg);
     }
 }
 
@@ -202,6 +202,9 @@ namespace brahms
 		//	just returns audit data for display in the GUI
 		bool					audit(ChannelAuditData& data);
 
+		//	returns telemetry data for the report
+		bool					telemetry(ChannelTelemetryData& data);
+
 
 
 	////////////////	DATA THAT NEEDS INITIALIZATION
@@ -242,6 +245,11 @@ namespace brahms
 		return true; // continue
 	}
 
+	bool DerivedChannel::telemetry(ChannelTelemetryData& data)
+	{
+		return protocolChannel.telemetry(data);
+	}
+
 	void DerivedChannel::addRoutingEntry(UINT32 msgStreamID, PushDataHandler pushDataHandler, void* pushDataHandlerArgument)
 	{
 		//	pass on to receiver
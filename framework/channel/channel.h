@@ -153,6 +153,10 @@ namespace brahms
 			//	audit the state of the channel, to give feedback to the user
 			//	return true if the data has been filled in for all channels
 			virtual bool audit(ChannelAuditData& data) = 0;
+
+			//	collect telemetry for the channel and each of its links, for the
+			//	report; return false if the channel does not record any
+			virtual bool telemetry(ChannelTelemetryData& data) = 0;
 		};
 
 		//	export prototypes
@@ -27,6 +27,9 @@ Deliverer::Deliverer (PushDataHandler p_pushDataHandler, void* p_pushDataHandler
     order = 0;		//	delivery order audit
     stop = false;	//	don't stop yet
 
+    //	time messages through our queue (see COMMS_TELEMETRY)
+    q.timed = core.execPars.getu("CommsTelemetry") != 0;
+
     //deliveryPeriod = 0.0;
     //deliveryPeriodCount = 0;
 }
@@ -43,6 +46,12 @@ Deliverer::push(IPM* msg)
     q.push(msg);
 }
 
+void
+Deliverer::spinBeforePark(DOUBLE secs)
+{
+    q.spin = secs;
+}
+
 QueueAuditData
 Deliverer::queueAudit()
 {
@@ -55,6 +64,13 @@ Deliverer::audit(ChannelAuditData& data)
     delivererIPMPool.audit(data.pool);
 }
 
+void
+Deliverer::telemetry(LinkTelemetry& link)
+{
+    //	only called once the thread has stopped
+    link.delivererWait.merge(waits);
+}
+
 void
 Deliverer::terminate(brahms::output::Source& fout)
 {
@@ -76,6 +92,9 @@ Deliverer::terminate(brahms::output::Source& fout)
     // wait for termination
     brahms::thread::Thread::terminate(fout);
     fout << "thread " << getThreadIdentifier() << " has now stopped" << D_VERB;
+
+    // hand back anything the handler adopted, whilst our pool still exists
+    pushDataHandler(pushDataHandlerArgument, NULL, 0, NULL);
 }
 
 IPM*
@@ -97,8 +116,9 @@ void Deliverer::ThreadProc()
         {
             //	pull message from queue (see WAIT STATES)
             IPM* msg = NULL;
+            DOUBLE waited = 0.0;
             REPORT_THREAD_WAIT_STATE_IN("pull()");
-            Symbol result = q.pull(msg);
+            Symbol result = q.pull(msg, &waited);
             REPORT_THREAD_WAIT_STATE_OUT("pull()");
 
             //	if stop is set, break loop and end thread
@@ -134,10 +154,14 @@ void Deliverer::ThreadProc()
             // else tout << "in order: " << header.order << "/" << order << ")" << D_INFO;
             order++;
 
+            //	telemetry
+            if (q.timed) waits.add((UINT64)(waited * 1e6));
+
             //	call message handler function (if C_CANCEL is returned, break loop, discarding all queued messages)
             UINT32 bytes = header.bytesAfterHeaderUncompressed;
             REPORT_THREAD_WAIT_STATE_IN("pushDataHandler()");
-            if (pushDataHandler(pushDataHandlerArgument, msg->body(), bytes) == C_CANCEL)
+            Symbol handled = pushDataHandler(pushDataHandlerArgument, msg->body(), bytes, msg);
+            if (handled == C_CANCEL)
             {
                 tout << "PushDataHandler() returned C_CANCEL, discarding remaining queue" << D_VERB;
 
@@ -181,8 +205,8 @@ t1 = 0.0;
                 PUSHDATA messages are put() back into whichever pool they came from, here.
             */
 
-            //	release message (return to pool)
-            msg->release();
+            //	release message (return to pool), unless the handler adopted it
+            if (handled != C_YES) msg->release();
         }
 
         //	flush q
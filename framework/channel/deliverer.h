@@ -70,7 +70,9 @@ struct Deliverer : public brahms::thread::Thread
     void start(UINT32 TimeoutThreadTerm);
     void push(IPM* msg);
     QueueAuditData queueAudit();
+    void spinBeforePark(DOUBLE secs);
     void audit(ChannelAuditData& data);
+    void telemetry(LinkTelemetry& link);
     void terminate(brahms::output::Source& fout);
     void ThreadProc();
     IPM* getIPMFromPool();
@@ -87,6 +89,9 @@ private:
 
     UINT32 order;
     bool stop;
+
+    //	time messages spent in q (see COMMS_TELEMETRY)
+    Histogram waits;
 };
 
 #endif // _CHANNEL_DELIVERER_H_
@@ -0,0 +1,213 @@
+/*
+________________________________________________________________
+
+	This file is part of BRAHMS
+	Copyright (C) 2007 Ben Mitchinson
+	URL: http://brahms.sourceforge.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+________________________________________________________________
+
+*/
+
+#include "encode.h"
+#include <cstring>
+
+////////////////	STREAM REFERENCE
+
+UINT8 streamEncode(StreamReference& ref, const BYTE* src, UINT32 bytes, UINT32 keyframeInterval, VUINT8& dst)
+{
+	//	keyframe if due, or if we have nothing compatible to XOR against
+	if (!bytes || ref.content.size() != bytes || (ref.framesSinceKeyframe + 1) >= keyframeInterval)
+	{
+		ref.content.assign(src, src + bytes);
+		ref.framesSinceKeyframe = 0;
+		return IPMFMT_KEYFRAME;
+	}
+
+	//	XOR against reference, and take new content as reference
+	if (dst.size() < bytes) dst.resize(bytes);
+	BYTE* d = &dst[0];
+	BYTE* r = &ref.content[0];
+	for (UINT32 b=0; b<bytes; b++)
+	{
+		d[b] = src[b] ^ r[b];
+		r[b] = src[b];
+	}
+	ref.framesSinceKeyframe++;
+	return IPMFMT_XOR;
+}
+
+const char* streamDecode(StreamReference& ref, UINT8 fmt, BYTE* content, UINT32 bytes)
+{
+	//	keyframe just becomes the reference
+	if (fmt & IPMFMT_KEYFRAME)
+	{
+		ref.content.assign(content, content + bytes);
+		ref.framesSinceKeyframe = 0;
+		return NULL;
+	}
+
+	//	XOR frame must match reference
+	if (ref.content.size() != bytes)
+		return "XOR frame does not match stream reference (missed keyframe?)";
+
+	BYTE* r = &ref.content[0];
+	for (UINT32 b=0; b<bytes; b++)
+	{
+		content[b] ^= r[b];
+		r[b] = content[b];
+	}
+	ref.framesSinceKeyframe++;
+	return NULL;
+}
+
+////////////////	ZERO-RUN-LENGTH CODER
+
+//	zero runs shorter than this are cheaper left in a literal run
+const UINT32 ZRLE_MIN_ZERO_RUN = 3;
+const UINT32 ZRLE_MAX_RUN = 128;
+
+UINT32 zrleBound(UINT32 srcBytes)
+{
+	return srcBytes + srcBytes / ZRLE_MAX_RUN + 1;
+}
+
+UINT32 zrleEncode(const BYTE* src, UINT32 srcBytes, BYTE* dst)
+{
+	UINT32 i = 0, o = 0;
+	while (i < srcBytes)
+	{
+		//	zero run
+		UINT32 z = 0;
+		while (i + z < srcBytes && z < ZRLE_MAX_RUN && !src[i + z]) z++;
+		if (z >= ZRLE_MIN_ZERO_RUN || (z && i + z == srcBytes))
+		{
+			dst[o++] = (BYTE)(0x80 | (z - 1));
+			i += z;
+			continue;
+		}
+
+		//	literal run, up to the next worthwhile zero run
+		UINT32 start = i;
+		while (i < srcBytes && i - start < ZRLE_MAX_RUN)
+		{
+			if (!src[i] && i + 2 < srcBytes && !src[i + 1] && !src[i + 2]) break;
+			i++;
+		}
+		UINT32 len = i - start;
+		dst[o++] = (BYTE)(len - 1);
+		memcpy(dst + o, src + start, len);
+		o += len;
+	}
+
+	return o;
+}
+
+const char* zrleDecode(const BYTE* src, UINT32 srcBytes, BYTE* dst, UINT32 dstBytes)
+{
+	UINT32 i = 0, o = 0;
+	while (i < srcBytes)
+	{
+		BYTE c = src[i++];
+		if (c & 0x80)
+		{
+			UINT32 len = (c & 0x7F) + 1;
+			if (o + len > dstBytes) return "zero-run-length decode overflow";
+			memset(dst + o, 0, len);
+			o += len;
+		}
+		else
+		{
+			UINT32 len = c + 1;
+			if (o + len > dstBytes) return "zero-run-length decode overflow";
+			if (i + len > srcBytes) return "zero-run-length decode truncated";
+			memcpy(dst + o, src + i, len);
+			o += len;
+			i += len;
+		}
+	}
+
+	if (o != dstBytes) return "zero-run-length decode size mismatch";
+	return NULL;
+}
+
+////////////////	CODEC SELECTION
+
+CodecSelector::CodecSelector()
+{
+	codec = IPMFMT_UNCOMPRESSED;
+	messagesSinceSample = CODEC_SAMPLE_INTERVAL;
+	for (UINT32 c=0; c<CODEC_CANDIDATES; c++)
+	{
+		sampled[c] = false;
+		ratio[c] = 1.0;
+		secsPerByte[c] = 0.0;
+	}
+}
+
+bool CodecSelector::due()
+{
+	if (messagesSinceSample < CODEC_SAMPLE_INTERVAL)
+	{
+		messagesSinceSample++;
+		return false;
+	}
+
+	messagesSinceSample = 0;
+	return true;
+}
+
+void CodecSelector::sample(UINT32 c, UINT32 srcBytes, UINT32 dstBytes, DOUBLE secs)
+{
+	if (!srcBytes) return;
+	DOUBLE r = ((DOUBLE)dstBytes) / ((DOUBLE)srcBytes);
+	DOUBLE t = secs / ((DOUBLE)srcBytes);
+
+	//	first sample is taken as is, later ones are smoothed
+	if (sampled[c])
+	{
+		ratio[c] = 0.5 * (ratio[c] + r);
+		secsPerByte[c] = 0.5 * (secsPerByte[c] + t);
+	}
+	else
+	{
+		ratio[c] = r;
+		secsPerByte[c] = t;
+		sampled[c] = true;
+	}
+}
+
+UINT8 CodecSelector::choose(DOUBLE bytesPerSec)
+{
+	if (bytesPerSec <= 0.0) bytesPerSec = CODEC_DEFAULT_THROUGHPUT;
+
+	//	cost of no compression is just the wire time
+	DOUBLE best = 1.0 / bytesPerSec;
+	codec = IPMFMT_UNCOMPRESSED;
+
+	for (UINT32 c=0; c<CODEC_CANDIDATES; c++)
+	{
+		if (!sampled[c]) continue;
+		DOUBLE cost = secsPerByte[c] + ratio[c] / bytesPerSec;
+		if (cost < best)
+		{
+			best = cost;
+			codec = CODEC_CANDIDATE_FORMATS[c];
+		}
+	}
+
+	return codec;
+}
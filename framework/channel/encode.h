@@ -0,0 +1,140 @@
+/*
+________________________________________________________________
+
+	This file is part of BRAHMS
+	Copyright (C) 2007 Ben Mitchinson
+	URL: http://brahms.sourceforge.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+________________________________________________________________
+
+*/
+
+#ifndef _CHANNEL_ENCODE_H_
+#define _CHANNEL_ENCODE_H_
+
+#include "brahms-client.h"
+#include "base/ipm.h"
+using namespace brahms::base;
+
+/*	DOCUMENTATION: STREAM_ENCODING
+
+	Many inter-voice links carry content that changes little from
+	one sample to the next. If IntervoiceEncoding is non-zero, the
+	sender XORs each PUSHDATA payload against the payload previously
+	sent on the same msgStreamID, so that unchanged bytes become
+	zero, and marks the header with IPMFMT_XOR. The result is then
+	passed through a codec: that set by IntervoiceCompression, if
+	any, else the zero-run-length coder below, which is very cheap
+	and does well on the mostly-zero output of the XOR stage.
+
+	Every IntervoiceEncoding messages (and whenever the payload size
+	changes) the sender instead sends a keyframe (IPMFMT_KEYFRAME),
+	which is the raw payload. Both ends keep one StreamReference per
+	msgStreamID per channel, updated in the sender and receiver
+	threads respectively; since a channel delivers in order, these
+	stay in step. The encoded message is built in the sender's own
+	buffer, so the IPM itself is untouched (see tag
+	PUSHDATA_IDENTICAL_TO_ALL_SENDERS).
+*/
+
+////////////////	STREAM REFERENCE
+
+struct StreamReference
+{
+	StreamReference()
+	{
+		framesSinceKeyframe = 0;
+	}
+
+	//	content of the last payload sent/received on this stream
+	VUINT8 content;
+
+	//	number of XOR frames since the last keyframe
+	UINT32 framesSinceKeyframe;
+};
+
+//	encode "src" against "ref", updating "ref"; returns IPMFMT_XOR if
+//	"dst" has been filled with the XOR frame, or IPMFMT_KEYFRAME if the
+//	payload should be sent as is
+UINT8 streamEncode(StreamReference& ref, const BYTE* src, UINT32 bytes, UINT32 keyframeInterval, VUINT8& dst);
+
+//	reconstruct "content" in place from the frame received, updating "ref"
+//	(fmt is the header fmt field; returns an error string, or NULL)
+const char* streamDecode(StreamReference& ref, UINT8 fmt, BYTE* content, UINT32 bytes);
+
+////////////////	ZERO-RUN-LENGTH CODER
+
+//	each run starts with a control byte; 0x00-0x7F is a literal run of
+//	(c+1) bytes, which follow, and 0x80-0xFF is a run of (c-0x7F) zeros
+
+//	maximum encoded size of "srcBytes" bytes
+UINT32 zrleBound(UINT32 srcBytes);
+
+//	encode into "dst", which must have zrleBound() bytes; returns bytes written
+UINT32 zrleEncode(const BYTE* src, UINT32 srcBytes, BYTE* dst);
+
+//	decode into "dst", which must be exactly "dstBytes" when decoded; returns an error string, or NULL
+const char* zrleDecode(const BYTE* src, UINT32 srcBytes, BYTE* dst, UINT32 dstBytes);
+
+////////////////	CODEC SELECTION
+
+/*	DOCUMENTATION: CODEC_SELECTION
+
+	If IntervoiceCompression is "auto", each link (msgStreamID) picks
+	its own codec. Every CODEC_SAMPLE_INTERVAL messages, the sender
+	compresses the payload with every candidate codec, timing each,
+	and keeps a smoothed estimate of ratio and seconds per byte for
+	each. In between, it uses the codec that minimises the estimated
+	time to get the message onto the wire, that is, time spent
+	compressing plus compressed size over link throughput. The sender
+	measures throughput from the time spent in send(), so that a link
+	that is keeping up chooses cheap codecs (or none), and a link that
+	is backing up chooses stronger ones.
+*/
+
+//	candidate codecs, in order of increasing cost (roughly)
+const UINT32 CODEC_CANDIDATES = 6;
+const UINT8 CODEC_CANDIDATE_FORMATS[CODEC_CANDIDATES] = {
+	IPMFMT_UNCOMPRESSED, IPMFMT_ZRLE, IPMFMT_LZ, IPMFMT_SHUFFLE4_LZ, IPMFMT_SHUFFLE8_LZ, IPMFMT_DEFLATE
+};
+
+//	messages between samples, per link
+const UINT32 CODEC_SAMPLE_INTERVAL = 64;
+
+//	link throughput assumed before any has been measured (bytes/sec)
+const DOUBLE CODEC_DEFAULT_THROUGHPUT = 100e6;
+
+struct CodecSelector
+{
+	CodecSelector();
+
+	//	true if this message should be used to sample candidates
+	bool due();
+
+	//	record result of compressing "srcBytes" to "dstBytes" in "secs" with candidate "c"
+	void sample(UINT32 c, UINT32 srcBytes, UINT32 dstBytes, DOUBLE secs);
+
+	//	choose codec for link of throughput "bytesPerSec"; returns IPMFMT_*
+	UINT8 choose(DOUBLE bytesPerSec);
+
+	UINT8 codec;
+	UINT32 messagesSinceSample;
+	bool sampled[CODEC_CANDIDATES];
+	DOUBLE ratio[CODEC_CANDIDATES];
+	DOUBLE secsPerByte[CODEC_CANDIDATES];
+};
+
+#endif // _CHANNEL_ENCODE_H_
@@ -53,6 +53,8 @@ struct IPM_FIFO
 	{
 		m_stop = stop ? stop : &FIFO_global_stop;
 		terminated = false;
+		timed = false;
+		spin = 0.0;
 		m_audit.clear();
 	}
 
@@ -76,6 +78,7 @@ struct IPM_FIFO
 		{
 			//	add to queue and set signal
 			q.push(t);
+			if (timed) stamps.push(clock.elapsed());
 			signal.set();
 		}
 	}
@@ -92,8 +95,13 @@ struct IPM_FIFO
 		return auditCopy;
 	}
 
-	Symbol pull(IPM*& t)
+	//	if "waited" is given, and the queue is timed, it receives
+	//	the time (seconds) the item spent in the queue
+	Symbol pull(IPM*& t, DOUBLE* waited = NULL)
 	{
+		//	spin for a push before parking, if asked (see SOCKETS_BUSY_POLL)
+		if (spin > 0.0) spinForPush();
+
 		//	return result of waitfor() unless it's C_OK (signal was set, now cleared)
 		Symbol result = signal.waitfor();
 
@@ -113,6 +121,11 @@ struct IPM_FIFO
 		//	return item at front of queue
 		t = q.front();
 		q.pop();
+		if (timed)
+		{
+			if (waited) *waited = clock.elapsed() - stamps.front();
+			stamps.pop();
+		}
 
 		//	mark bytes pulled
 		m_audit.bytes += t->size();
@@ -130,6 +143,28 @@ struct IPM_FIFO
 		return C_YES;
 	}
 
+	//	return when the queue is non-empty, stop is set, or "spin" seconds have passed
+	void spinForPush()
+	{
+		DOUBLE t0 = clock.elapsed();
+		while (!*m_stop)
+		{
+			{
+				brahms::os::MutexLocker locker(mutex);
+				if (q.size()) return;
+			}
+			if (clock.elapsed() - t0 >= spin) return;
+			brahms::os::yield();
+		}
+	}
+
+	//	tag of the item at the front of the queue (IPMTAG_UNDEFINED if empty)
+	UINT8 frontTag()
+	{
+		brahms::os::MutexLocker locker(mutex);
+		return q.size() ? q.front()->header().tag : brahms::base::IPMTAG_UNDEFINED;
+	}
+
 	UINT32 size()
 	{
 		brahms::os::MutexLocker locker(mutex);
@@ -150,6 +185,8 @@ struct IPM_FIFO
 			q.pop();
 			ipm->release();
 		}
+		while(stamps.size())
+			stamps.pop();
 
 		terminated = true;
 	}
@@ -159,6 +196,14 @@ struct IPM_FIFO
 	queue<IPM*> q;						//	the queue itself
 	bool terminated;					//	once true, the queue will accept no further messages
 
+	//	time stamps of queued items (set timed before first use; see COMMS_TELEMETRY)
+	bool timed;
+	brahms::os::Timer clock;
+	queue<DOUBLE> stamps;
+
+	//	seconds pull() spins waiting for a push before parking on the signal
+	DOUBLE spin;
+
 	//	keep this for checking for release() on stop, at termination
 	const bool* m_stop;
 
@@ -0,0 +1,201 @@
+/*
+________________________________________________________________
+
+	This file is part of BRAHMS
+	Copyright (C) 2007 Ben Mitchinson
+	URL: http://brahms.sourceforge.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+________________________________________________________________
+
+*/
+
+#include "loopback/loopback.h"
+#include <map>
+using std::map;
+using std::pair;
+using std::make_pair;
+#include <cstring>
+
+////////////////	PROCESS-WIDE STATE
+
+//	all pipes share one clock, so that due times compare between threads
+brahms::os::Timer loopbackClock;
+
+//	pipes by (from, to) voice index
+brahms::os::Mutex loopbackPipesMutex;
+map< pair<VoiceIndex, VoiceIndex>, LoopbackPipe* > loopbackPipes;
+
+LoopbackPipe* loopbackAttach(VoiceIndex from, VoiceIndex to, DOUBLE latency, DOUBLE bandwidth)
+{
+	brahms::os::MutexLocker locker(loopbackPipesMutex);
+
+	LoopbackPipe*& pipe = loopbackPipes[make_pair(from, to)];
+	if (!pipe) pipe = new LoopbackPipe(latency, bandwidth);
+	pipe->attached++;
+	return pipe;
+}
+
+void loopbackDetach(VoiceIndex from, VoiceIndex to)
+{
+	brahms::os::MutexLocker locker(loopbackPipesMutex);
+
+	map< pair<VoiceIndex, VoiceIndex>, LoopbackPipe* >::iterator i = loopbackPipes.find(make_pair(from, to));
+	if (i == loopbackPipes.end()) return;
+
+	//	either end going away closes the pipe to further sends
+	LoopbackPipe* pipe = i->second;
+	pipe->close();
+	if (--pipe->attached) return;
+
+	delete pipe;
+	loopbackPipes.erase(i);
+}
+
+////////////////	LOOPBACK PIPE
+
+LoopbackPipe::LoopbackPipe(DOUBLE p_latency, DOUBLE bandwidth)
+	:
+	signal(brahms::os::SIGNAL_WAIT_STEP, NULL)
+{
+	latency = p_latency;
+	secsPerByte = bandwidth > 0.0 ? 1.0 / bandwidth : 0.0;
+	wireFree = 0.0;
+	closed = false;
+	attached = 0;
+}
+
+LoopbackPipe::~LoopbackPipe()
+{
+	for (UINT32 c=0; c<chunks.size(); c++)
+		delete chunks[c].content;
+	for (UINT32 s=0; s<spare.size(); s++)
+		delete spare[s];
+}
+
+int LoopbackPipe::send(const BYTE* data, UINT32 bytes)
+{
+	{
+		brahms::os::MutexLocker locker(mutex);
+
+		//	messages queue for the wire, then take "latency" to arrive
+		DOUBLE now = loopbackClock.elapsed();
+		if (wireFree < now) wireFree = now;
+		wireFree += bytes * secsPerByte;
+
+		Chunk chunk;
+		chunk.due = wireFree + latency;
+		chunk.offset = 0;
+		if (spare.size())
+		{
+			chunk.content = spare.back();
+			spare.pop_back();
+		}
+		else chunk.content = new VUINT8;
+		chunk.content->assign(data, data + bytes);
+		chunks.push_back(chunk);
+	}
+
+	signal.set();
+	return bytes;
+}
+
+UINT32 LoopbackPipe::dueBytes(DOUBLE now)
+{
+	UINT32 bytes = 0;
+	for (UINT32 c=0; c<chunks.size() && chunks[c].due <= now; c++)
+		bytes += chunks[c].content->size() - chunks[c].offset;
+	return bytes;
+}
+
+UINT32 LoopbackPipe::take(BYTE* data, UINT32 bytes, bool peek, DOUBLE now)
+{
+	UINT32 copied = 0;
+	UINT32 c = 0;
+	while (copied < bytes && c < chunks.size() && chunks[c].due <= now)
+	{
+		Chunk& chunk = chunks[c];
+		UINT32 n = chunk.content->size() - chunk.offset;
+		if (n > bytes - copied) n = bytes - copied;
+		memcpy(data + copied, &chunk.content->at(chunk.offset), n);
+		copied += n;
+
+		if (peek)
+		{
+			c++;
+			continue;
+		}
+
+		chunk.offset += n;
+		if (chunk.offset == chunk.content->size())
+		{
+			spare.push_back(chunk.content);
+			chunks.pop_front();
+		}
+	}
+	return copied;
+}
+
+int LoopbackPipe::recv(BYTE* data, UINT32 bytes, bool peek)
+{
+	while(true)
+	{
+		DOUBLE wait = -1.0;
+
+		{
+			brahms::os::MutexLocker locker(mutex);
+
+			DOUBLE now = loopbackClock.elapsed();
+			UINT32 available = dueBytes(now);
+			if (available && (!peek || available >= bytes))
+				return take(data, bytes, peek, now);
+
+			//	drained
+			if (closed && !chunks.size()) return 0;
+
+			//	if the next chunk is in flight, wait for it to land
+			UINT32 c = 0;
+			while (c < chunks.size() && chunks[c].due <= now) c++;
+			if (c < chunks.size()) wait = chunks[c].due - now;
+		}
+
+		//	sleep out the latency (yield for the last millisecond), or wait for a send
+		if (wait >= 0.001) brahms::os::msleep((UINT32)(wait * 1000.0));
+		else if (wait >= 0.0) brahms::os::msleep(0);
+		else signal.waitfor();
+	}
+}
+
+int LoopbackPipe::tryRecv(BYTE* data, UINT32 bytes)
+{
+	brahms::os::MutexLocker locker(mutex);
+
+	DOUBLE now = loopbackClock.elapsed();
+	if (dueBytes(now)) return take(data, bytes, false, now);
+
+	//	drained, or nothing due yet
+	if (closed && !chunks.size()) return 0;
+	return -1;
+}
+
+void LoopbackPipe::close()
+{
+	{
+		brahms::os::MutexLocker locker(mutex);
+		closed = true;
+	}
+
+	signal.set();
+}
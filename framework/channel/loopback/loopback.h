@@ -0,0 +1,121 @@
+/*
+________________________________________________________________
+
+	This file is part of BRAHMS
+	Copyright (C) 2007 Ben Mitchinson
+	URL: http://brahms.sourceforge.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+________________________________________________________________
+
+*/
+
+#ifndef _CHANNEL_LOOPBACK_H_
+#define _CHANNEL_LOOPBACK_H_
+
+// Ensure __NIX__ and __WIN__ etc are set up
+#ifndef BRAHMS_BUILDING_ENGINE
+#define BRAHMS_BUILDING_ENGINE
+#endif
+#include "brahms-client.h"
+
+#include "base/os.h"
+#include "base/ipm.h"
+using namespace brahms::base;
+#include <deque>
+using std::deque;
+#include <vector>
+using std::vector;
+
+/*	DOCUMENTATION: LOOPBACK_CHANNEL
+
+	The loopback channel runs several voices as several engines in the
+	one process (see --loopback-N in brahms-execute), so that concerto
+	can be exercised and benchmarked on one machine without sockets.
+	It is the sockets channel, built with __LOOPBACK__, with each socket
+	replaced by a pair of LoopbackPipes, one in each direction, which
+	are found by voice index in a process-wide table. Everything above
+	send() and recv() (framing, compression, congestion control, and
+	so on) is therefore exactly the code that runs over sockets.
+
+	A pipe can simulate a network link. Each message sent becomes due
+	at the receiver LoopbackLatency microseconds after it has finished
+	going onto a wire of LoopbackBandwidth bytes per second (zero for
+	no limit); messages queue for the wire in order, as they would on
+	a real link. The sender never blocks, so that back-pressure comes
+	only from the PUSHDATA congestion control, as it does over sockets
+	once the socket buffers are full.
+*/
+
+////////////////	LOOPBACK PIPE
+
+struct LoopbackPipe
+{
+	LoopbackPipe(DOUBLE latency, DOUBLE bandwidth);
+	~LoopbackPipe();
+
+	//	append "bytes" bytes to the pipe; returns "bytes"
+	int send(const BYTE* data, UINT32 bytes);
+
+	//	block until "bytes" bytes (if peek) or at least one byte (if
+	//	not) are due, and copy them out (consuming them unless peek);
+	//	returns bytes copied, or 0 if the pipe is closed and drained
+	int recv(BYTE* data, UINT32 bytes, bool peek);
+
+	//	as recv(), not peeking, but return -1 at once if no bytes are due
+	int tryRecv(BYTE* data, UINT32 bytes);
+
+	//	no more bytes will be sent
+	void close();
+
+private:
+
+	struct Chunk
+	{
+		DOUBLE due;
+		UINT32 offset;
+		VUINT8* content;
+	};
+
+	//	bytes from the front of the queue that are due at "now"
+	UINT32 dueBytes(DOUBLE now);
+
+	//	copy out up to "bytes" due bytes, consuming them unless peek
+	UINT32 take(BYTE* data, UINT32 bytes, bool peek, DOUBLE now);
+
+	brahms::os::Mutex mutex;
+	brahms::os::Signal signal;
+	deque<Chunk> chunks;
+	vector<VUINT8*> spare;
+	DOUBLE latency;
+	DOUBLE secsPerByte;
+	DOUBLE wireFree;
+	bool closed;
+
+	//	held by sender and receiver; deleted when both have detached
+	UINT32 attached;
+
+	friend LoopbackPipe* loopbackAttach(VoiceIndex from, VoiceIndex to, DOUBLE latency, DOUBLE bandwidth);
+	friend void loopbackDetach(VoiceIndex from, VoiceIndex to);
+};
+
+//	get the pipe from voice "from" to voice "to", creating it if this is the
+//	first end to attach (latency in seconds, bandwidth in bytes/sec or zero)
+LoopbackPipe* loopbackAttach(VoiceIndex from, VoiceIndex to, DOUBLE latency, DOUBLE bandwidth);
+
+//	release one end of the pipe from "from" to "to"
+void loopbackDetach(VoiceIndex from, VoiceIndex to);
+
+#endif // _CHANNEL_LOOPBACK_H_
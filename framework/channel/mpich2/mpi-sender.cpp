@@ -105,7 +105,9 @@ void CommsLayer::SendProc()
         //////////////// HANDLE ESTIMATE OF REMOTE BUFFER CONGESTION
 
         // if it's IPMTAG_OUTPUTFOUND, we need to initialise a send auditor for that link
-        if (messageForDispatch_header->tag == IPMTAG_OUTPUTFOUND)
+        // (IPMTAG_OUTPUTSFOUND carries the highest msgStreamID in the batch, if any)
+        if (messageForDispatch_header->tag == IPMTAG_OUTPUTFOUND ||
+            (messageForDispatch_header->tag == IPMTAG_OUTPUTSFOUND && messageForDispatch_header->msgStreamID != IPM_UNDEFINED))
         {
             brahms::os::MutexLocker locker(channel->auditsMutex);
 
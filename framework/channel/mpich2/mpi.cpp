@@ -234,6 +234,24 @@ ProtocolChannel::audit(ChannelAuditData& data)
     }
 }
 
+bool
+ProtocolChannel::telemetry(ChannelTelemetryData& data)
+{
+    // the send queue is shared by all channels, so only the receive
+    // side is recorded per channel (see COMMS_TELEMETRY)
+    if (!core.execPars.getu("CommsTelemetry")) return false;
+
+    data.received.resize(deliverers.size());
+    for (UINT32 d=0; d<deliverers.size(); d++)
+    {
+        if (!deliverers[d]) continue;
+        deliverers[d]->telemetry(data.received[d]);
+        data.channel.delivererWait.merge(data.received[d].delivererWait);
+    }
+
+    return true;
+}
+
 //@}
 
 // CommsLayer implementation
@@ -61,6 +61,7 @@ struct ProtocolChannel
     Symbol pull(IPM*& ipm, brahms::output::Source& tout);
     UINT32 push(IPM* msg, brahms::output::Source* tout);
     void audit(ChannelAuditData& data);
+    bool telemetry(ChannelTelemetryData& data);
 
     //	add routing entry for PUSHDATA msgs
     void addRoutingEntry(UINT32 msgStreamID, PushDataHandler pushDataHandler, void* pushDataHandlerArgument);
@@ -72,12 +72,15 @@ void ProtocolChannel::MemberReceiverThreadProc()
 			//	recv() (see WAIT STATES)
 			REPORT_THREAD_WAIT_STATE_IN("recv()");
 
+			//	in low-latency mode, the header comes from the staging buffer
+			if (pars.SocketsBusyPoll) stageHeader(peekHeader);
+
 			//	a partial receive during peek cannot be "continued", like a partial receive during
 			//	not-peek, because the bytes aren't read. so if we get a partial receive, we just
 			//	sleep fleetingly, and try again...
-			while(true)
+			else while(true)
 			{
-				int result = recv(dataSocket, (char*)&peekHeader, sizeof(IPM_HEADER), MSG_PEEK);
+				int result = transportRecv((BYTE*)&peekHeader, sizeof(IPM_HEADER), true);
 				if (result == OS_SOCKET_ERROR)
 					ferr << E_COMMS << "failed at recv() (" << socketsErrorString(OS_LASTERROR) << ")";
 				if (result == sizeof(IPM_HEADER)) break;
@@ -167,10 +170,15 @@ void ProtocolChannel::MemberReceiverThreadProc()
 
 			//	want to receive "messageBytes"
 			UINT32 bytesReceivedIntoRecvBuffer = 0;
+			if (pars.SocketsBusyPoll)
+			{
+				stageMessage(messageBeingReceived.ipm()->stream(), totalBytesInMessageCompressed);
+				bytesReceivedIntoRecvBuffer = totalBytesInMessageCompressed;
+			}
 			while(bytesReceivedIntoRecvBuffer < totalBytesInMessageCompressed)
 			{
-				int result = recv(dataSocket, (char*) messageBeingReceived.ipm()->stream(bytesReceivedIntoRecvBuffer),
-					totalBytesInMessageCompressed-bytesReceivedIntoRecvBuffer, 0);
+				int result = transportRecv(messageBeingReceived.ipm()->stream(bytesReceivedIntoRecvBuffer),
+					totalBytesInMessageCompressed-bytesReceivedIntoRecvBuffer, false);
 				if (result == OS_SOCKET_ERROR)
 					ferr << E_COMMS << "failed at recv() (" << socketsErrorString(OS_LASTERROR) << ")";
 				bytesReceivedIntoRecvBuffer += result;
@@ -291,10 +299,12 @@ void ProtocolChannel::MemberReceiverThreadProc()
 					numPushDataMsgsRecv++;
 
 					//	if compressed
-					if (header.fmt == IPMFMT_DEFLATE)
+					UINT8 fmt = header.fmt;
+					UINT8 codec = fmt & IPMFMT_CODEC_MASK;
+					if (codec != IPMFMT_UNCOMPRESSED)
 					{
 						//	must have function
-						if (!compressFunction) ferr << "compression module did not load, but peer voice sent compressed message; cannot continue";
+						if (codec != IPMFMT_ZRLE && !compressFunction) ferr << "compression module did not load, but peer voice sent compressed message; cannot continue";
 
 						//	get another buffer from pool, to do the copy into
 						messageBeingUncompressed.ipm() = deliverer->getIPMFromPool();
@@ -312,13 +322,35 @@ void ProtocolChannel::MemberReceiverThreadProc()
 
 							//	inflate
 							UINT32 dstBytes = header.bytesAfterHeaderUncompressed;
-							const char* err = compressFunction(
-								data,
-								header.bytesAfterHeaderCompressed,
-								messageBeingUncompressed.ipm()->body(),
-								&dstBytes,
-								-1
-								);
+							const char* err = NULL;
+							switch (codec)
+							{
+								case IPMFMT_ZRLE:
+									err = zrleDecode(
+										data,
+										header.bytesAfterHeaderCompressed,
+										messageBeingUncompressed.ipm()->body(),
+										dstBytes
+										);
+									break;
+
+								case IPMFMT_DEFLATE:
+								case IPMFMT_LZ:
+								case IPMFMT_SHUFFLE4_LZ:
+								case IPMFMT_SHUFFLE8_LZ:
+									err = compressFunction(
+										codec,
+										data,
+										header.bytesAfterHeaderCompressed,
+										messageBeingUncompressed.ipm()->body(),
+										&dstBytes,
+										-1
+										);
+									break;
+
+								default:
+									ferr << E_COMMS << "unrecognised message format 0x" << hex << (UINT32)header.fmt;
+							}
 							if (err) ferr << E_INTERNAL << err;
 
 							//	assert
@@ -336,6 +368,18 @@ void ProtocolChannel::MemberReceiverThreadProc()
 						messageBeingUncompressed.release();
 					}
 
+					//	if stream-encoded, reconstruct against previous payload (see STREAM_ENCODING)
+					//	(header may now refer to the released buffer, so we use the one we've kept)
+					if (fmt & (IPMFMT_XOR | IPMFMT_KEYFRAME))
+					{
+						IPM_HEADER& decodedHeader = messageBeingReceived.ipm()->header();
+						UINT32 msgStreamID = decodedHeader.msgStreamID;
+						if (receiver.streams.size() <= msgStreamID) receiver.streams.resize(msgStreamID + 1);
+						const char* err = streamDecode(receiver.streams[msgStreamID], fmt,
+							messageBeingReceived.ipm()->body(), decodedHeader.bytesAfterHeaderUncompressed);
+						if (err) ferr << E_COMMS << err;
+					}
+
 					//	push (and audit deliverer queue only if the sender has asked for this)
 					deliverer->push(messageBeingReceived.retrieve());
 
@@ -402,4 +446,124 @@ void ProtocolChannel::MemberReceiverThreadProc()
 	tout << "numUsedDataMsgsSentAfterPush = " << numUsedDataMsgsSentAfterPush << D_VERB;
 	tout << "numUsedDataMsgsSentAfterQuery = " << numUsedDataMsgsSentAfterQuery << D_VERB;
 	tout << "numPartialReceiveOnPeek = " << numPartialReceiveOnPeek << D_VERB;
+	if (pars.SocketsBusyPoll)
+	{
+		tout << "numPolledReceives = " << receiver.numPolledReceives << D_VERB;
+		tout << "numParkedReceives = " << receiver.numParkedReceives << D_VERB;
+	}
+}
+
+
+
+////////////////	LOW-LATENCY RECEIVE
+
+/*	DOCUMENTATION: SOCKETS_BUSY_POLL
+
+	By default, the receiver peeks at each message header with a
+	blocking recv(), then receives the message with a second, and the
+	deliverer that handles a PUSHDATA sleeps on its queue until it is
+	woken. For tightly coupled systems, where every sample waits on a
+	peer, those two system calls and two thread wake-ups per message
+	are on the critical path.
+
+	If SocketsBusyPoll is non-zero, the receiver instead receives into
+	a staging buffer of SOCKETS_STAGE_BYTES, as many bytes as have
+	arrived, so that a small message (and often the next few too)
+	comes in with one call, and is copied from there into its pooled
+	IPM. A message that is larger than what was staged has the rest
+	received directly into the IPM. Each receive is first tried without
+	blocking, repeatedly, for up to SocketsBusyPoll microseconds, and
+	only then made blocking ("parks"). Deliverers likewise spin for up
+	to SocketsBusyPoll microseconds on their queue before parking on
+	its signal, so a message that arrives in that time is handed off
+	without a wake-up. Where the kernel supports it, SO_BUSY_POLL is
+	also set on the socket, with the same budget.
+
+	Spinning threads yield between polls, so that on a machine with no
+	cores to spare they still let the threads they are waiting on run,
+	but each may otherwise keep a core busy while it spins; the counts
+	of receives satisfied while polling and receives that parked are
+	reported at the end of the run (at verbose log level).
+*/
+
+UINT32 ProtocolChannel::receivePolled(BYTE* data, UINT32 bytes)
+{
+	//	poll
+	int result = transportRecvNow(data, bytes);
+	if (result == TRANSPORT_WOULD_BLOCK)
+	{
+		DOUBLE spin = ((DOUBLE)pars.SocketsBusyPoll) * 1e-6;
+		DOUBLE t0 = receiver.pollClock.elapsed();
+		while (result == TRANSPORT_WOULD_BLOCK && receiver.pollClock.elapsed() - t0 < spin)
+		{
+			brahms::os::yield();
+			result = transportRecvNow(data, bytes);
+		}
+	}
+
+	//	park
+	if (result == TRANSPORT_WOULD_BLOCK)
+	{
+		receiver.numParkedReceives++;
+		result = transportRecv(data, bytes, false);
+	}
+	else receiver.numPolledReceives++;
+
+	//	check
+	if (result == OS_SOCKET_ERROR)
+		ferr << E_COMMS << "failed at recv() (" << socketsErrorString(OS_LASTERROR) << ")";
+	if (result == 0)
+		ferr << E_COMMS << "channel dropped (socket returned 0 from recv())";
+	return result;
+}
+
+void ProtocolChannel::stageTopUp(UINT32 bytes)
+{
+	//	make room at the back
+	BYTE* stage = &receiver.stage[0];
+	if (receiver.stageBegin + bytes > SOCKETS_STAGE_BYTES)
+	{
+		memmove(stage, stage + receiver.stageBegin, receiver.stageEnd - receiver.stageBegin);
+		receiver.stageEnd -= receiver.stageBegin;
+		receiver.stageBegin = 0;
+	}
+
+	//	receive whatever has arrived, until we have enough
+	while (receiver.stageEnd - receiver.stageBegin < bytes)
+		receiver.stageEnd += receivePolled(stage + receiver.stageEnd, SOCKETS_STAGE_BYTES - receiver.stageEnd);
+}
+
+void ProtocolChannel::stageHeader(IPM_HEADER& header)
+{
+	//	header is left staged, as the start of the message
+	stageTopUp(sizeof(IPM_HEADER));
+	memcpy(&header, &receiver.stage[receiver.stageBegin], sizeof(IPM_HEADER));
+}
+
+void ProtocolChannel::stageMessage(BYTE* dst, UINT32 bytes)
+{
+	//	take what is staged
+	UINT32 staged = receiver.stageEnd - receiver.stageBegin;
+	UINT32 got = staged < bytes ? staged : bytes;
+	memcpy(dst, &receiver.stage[receiver.stageBegin], got);
+	receiver.stageBegin += got;
+	if (receiver.stageBegin == receiver.stageEnd)
+		receiver.stageBegin = receiver.stageEnd = 0;
+
+	//	a small remainder comes through the stage, so that what follows it
+	//	may come in with it, and a large one directly into the message
+	while (got < bytes)
+	{
+		UINT32 remainder = bytes - got;
+		if (remainder <= SOCKETS_STAGE_BYTES / 4)
+		{
+			stageTopUp(remainder);
+			memcpy(dst + got, &receiver.stage[receiver.stageBegin], remainder);
+			receiver.stageBegin += remainder;
+			if (receiver.stageBegin == receiver.stageEnd)
+				receiver.stageBegin = receiver.stageEnd = 0;
+			got = bytes;
+		}
+		else got += receivePolled(dst + got, remainder);
+	}
 }
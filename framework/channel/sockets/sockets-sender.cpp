@@ -51,6 +51,9 @@ void ProtocolChannel::MemberSenderThreadProc()
 		//	buffer for sending compressed messages
 		VUINT8 buffer;
 
+		//	buffer for XOR-encoded payloads, before compression
+		VUINT8 xorBuffer;
+
 		//	send() watchdog timer
 		brahms::os::Timer watchdog;
 
@@ -58,8 +61,9 @@ void ProtocolChannel::MemberSenderThreadProc()
 		while (true)
 		{
 			//	pull message from queue (see WAIT STATES)
+			DOUBLE queueWait = 0.0;
 			REPORT_THREAD_WAIT_STATE_IN("pull()");
-			Symbol result = sender.q.pull(messageForDispatch.ipm());
+			Symbol result = sender.q.pull(messageForDispatch.ipm(), &queueWait);
 			REPORT_THREAD_WAIT_STATE_OUT("pull()");
 
 			//	if timeout
@@ -111,12 +115,15 @@ void ProtocolChannel::MemberSenderThreadProc()
 	////////////////	HANDLE ESTIMATE OF REMOTE BUFFER CONGESTION
 
 			//	if it's IPMTAG_OUTPUTFOUND, we need to initialise a send auditor for that link
-			if (messageForDispatch_header->tag == IPMTAG_OUTPUTFOUND)
+			//	(IPMTAG_OUTPUTSFOUND carries the highest msgStreamID in the batch, if any)
+			if (messageForDispatch_header->tag == IPMTAG_OUTPUTFOUND ||
+				(messageForDispatch_header->tag == IPMTAG_OUTPUTSFOUND && messageForDispatch_header->msgStreamID != IPM_UNDEFINED))
 			{
 				brahms::os::MutexLocker locker(sender.auditsMutex);
 
 				UINT32 msgStreamID = messageForDispatch_header->msgStreamID;
 				if (sender.audits.size() <= msgStreamID) sender.audits.resize(msgStreamID + 1);
+				if (sender.CommsTelemetry && sender.links.size() <= msgStreamID) sender.links.resize(msgStreamID + 1);
 			}
 
 			//	if it's IPMTAG_PUSHDATA, we need to audit it
@@ -152,14 +159,35 @@ void ProtocolChannel::MemberSenderThreadProc()
 
 
 
-	////////////////	HANDLE COMPRESSION
+	////////////////	HANDLE ENCODING AND COMPRESSION
 
-			//	compress, if compression is on and message is PUSHDATA
-			if (sender.format == IPMFMT_DEFLATE && messageForDispatch_header->tag == IPMTAG_PUSHDATA)
+			//	encode and/or compress, if either is on and message is PUSHDATA
+			if ((sender.IntervoiceEncoding || sender.format != IPMFMT_UNCOMPRESSED) && messageForDispatch_header->tag == IPMTAG_PUSHDATA)
 			{
-				//	reserve space in buffer and point stream at it (this formula for maximum space required is defined by zlib)
-				UINT32 compressedSizeInBytes = (UINT32) (((DOUBLE)totalBytesToSend) * 1.01 + 64.0);
-				if (buffer.size() < compressedSizeInBytes) buffer.resize(compressedSizeInBytes);
+				//	source of payload
+				const BYTE* src = (const BYTE*)(messageForDispatch_header + 1);
+				UINT32 srcBytes = messageForDispatch_header->bytesAfterHeaderUncompressed;
+				UINT8 fmt = IPMFMT_UNCOMPRESSED;
+
+				//	XOR against previous payload on this stream (see STREAM_ENCODING)
+				if (sender.IntervoiceEncoding)
+				{
+					UINT32 msgStreamID = messageForDispatch_header->msgStreamID;
+					if (sender.streams.size() <= msgStreamID) sender.streams.resize(msgStreamID + 1);
+					fmt = streamEncode(sender.streams[msgStreamID], src, srcBytes, sender.IntervoiceEncoding, xorBuffer);
+					if (fmt == IPMFMT_XOR) src = &xorBuffer[0];
+				}
+
+				//	choose codec (if only encoding, use the cheap zero-run coder)
+				UINT8 codec = sender.format;
+				if (codec == SENDER_FORMAT_AUTO)
+					codec = selectCodec(messageForDispatch_header->msgStreamID, src, srcBytes, tout);
+				else if (codec == IPMFMT_UNCOMPRESSED)
+					codec = IPMFMT_ZRLE;
+
+				//	reserve space in buffer and point stream at it
+				UINT32 compressedSizeInBytes = max(COMPRESS_BOUND(srcBytes), zrleBound(srcBytes));
+				if (buffer.size() < sizeof(IPM_HEADER) + compressedSizeInBytes) buffer.resize(sizeof(IPM_HEADER) + compressedSizeInBytes);
 
 				//	get new pointers
 				IPM_HEADER* compressedHeader = (IPM_HEADER*)&buffer[0];
@@ -167,19 +195,19 @@ void ProtocolChannel::MemberSenderThreadProc()
 				//	copy over header
 				*compressedHeader = *messageForDispatch_header;
 
-				//	compress data
-				const char* err = compressFunction(
-						messageForDispatch_header + 1,
-						messageForDispatch_header->bytesAfterHeaderUncompressed,
-						compressedHeader + 1,
-						&compressedSizeInBytes,
-						sender.IntervoiceCompression
-					);
-				if (err) ferr << E_INTERNAL << err;
+				//	compress data, unless it doesn't help
+				compressedSizeInBytes = compressPayload(codec, src, srcBytes, (BYTE*)(compressedHeader + 1));
+				if (codec != IPMFMT_UNCOMPRESSED && compressedSizeInBytes < srcBytes)
+					fmt |= codec;
+				else
+				{
+					if (srcBytes) memcpy(compressedHeader + 1, src, srcBytes);
+					compressedSizeInBytes = srcBytes;
+				}
 				compressedHeader->bytesAfterHeaderCompressed = compressedSizeInBytes;
 
 				//	mark format into header (cannot rely on byte count being different, might be coincidentally identical)
-				compressedHeader->fmt = IPMFMT_DEFLATE;
+				compressedHeader->fmt = fmt;
 
 				//	retarget the send
 				messageForDispatch_header = compressedHeader;
@@ -223,11 +251,25 @@ void ProtocolChannel::MemberSenderThreadProc()
 /*	Differences in partial writes to TCP sockets (contributed by James Knight) retrieved from: http://itamarst.org/writings/win32sockets.html
 	In Unix, socket.send(buf) will buffer as much of buf as it has space for, and then return how much it accepted. This could be 0 or up to something around 128K. If you send some data and then some more, it will append to the previous buffer. In Windows, socket.send(buf) will either accept the entire buffer or raise ENOBUFS. Testing indicates that it will internally buffer any amount up to 50MB (this seems to be the total for either the process or the OS, I'm not sure). However, it will not incrementally accept more data to append to a socket's buffer until the big buffer has been completely emptied (seemingly down to the SO_SNDBUF length, which is 8192), but rather raises WSAEWOULDBLOCK instead. */
 
+			/*	DOCUMENTATION: SENDER_COALESCING
+
+				When a writer runs ahead of its peer (see LOOKAHEAD), messages
+				build up in the send queue. While there is another message
+				behind this one that will be sent, we send with MSG_MORE (where
+				available), so that the kernel packs the backlog into as few
+				segments as it can, rather than one or more per message, much
+				as if a window of PUSHDATA had been sent as one message. The
+				last message of a backlog is sent without, which pushes them
+				all out; a lone message is sent at once, as always.
+			*/
+			UINT8 nextTag = sender.q.frontTag();
+			bool more = nextTag != IPMTAG_UNDEFINED && nextTag != IPMTAG_FLUSH;
+
 			//	send message into sockets layer
 			BYTE* nextByteToSend = (BYTE*) messageForDispatch_header;
 			UINT32 remainingBytesToSend = totalBytesToSend;
 
-			//	send watchdog timer
+			//	send watchdog timer (also measures link throughput)
 			watchdog.reset();
 
 			//	send message
@@ -236,7 +278,7 @@ void ProtocolChannel::MemberSenderThreadProc()
 			{
 				//	call send()
 				REPORT_THREAD_WAIT_STATE_IN("send()");
-				int bytesSent = send(dataSocket, (const char*)nextByteToSend, remainingBytesToSend, 0);
+				int bytesSent = transportSend(nextByteToSend, remainingBytesToSend, more);
 				REPORT_THREAD_WAIT_STATE_OUT("send()");
 
 				//	check for error
@@ -274,6 +316,46 @@ void ProtocolChannel::MemberSenderThreadProc()
 				remainingBytesToSend -= bytesSent;
 			}
 
+			//	update link throughput estimate (see CODEC_SELECTION)
+			if (sender.format == SENDER_FORMAT_AUTO)
+			{
+				sender.throughputWindowBytes += totalBytesToSend;
+				sender.throughputWindowSecs += watchdog.elapsed();
+				if (sender.throughputWindowBytes >= SENDER_THROUGHPUT_WINDOW)
+				{
+					if (sender.throughputWindowSecs > 0.0)
+						sender.throughput = 0.5 * (sender.throughput + ((DOUBLE)sender.throughputWindowBytes) / sender.throughputWindowSecs);
+					sender.throughputWindowBytes = 0;
+					sender.throughputWindowSecs = 0.0;
+				}
+			}
+
+			//	telemetry (see COMMS_TELEMETRY)
+			if (sender.CommsTelemetry)
+			{
+				UINT64 usQueued = (UINT64)(queueWait * 1e6);
+				UINT64 usOnWire = (UINT64)(watchdog.elapsed() * 1e6);
+				UINT32 rawBytes = messageForDispatch.ipm()->uncompressedSize();
+
+				//	telemetry() reads these from another thread
+				brahms::os::MutexLocker locker(sender.auditsMutex);
+				sender.telemetry.queueWait.add(usQueued);
+				sender.telemetry.wireTime.add(usOnWire);
+				sender.telemetry.bytesRaw.add(rawBytes);
+				sender.telemetry.bytesWire.add(totalBytesToSend);
+
+				//	per link
+				UINT32 msgStreamID = messageForDispatch_header->msgStreamID;
+				if (messageForDispatch_header->tag == IPMTAG_PUSHDATA && msgStreamID < sender.links.size())
+				{
+					LinkTelemetry& link = sender.links[msgStreamID];
+					link.queueWait.add(usQueued);
+					link.wireTime.add(usOnWire);
+					link.bytesRaw.add(rawBytes);
+					link.bytesWire.add(totalBytesToSend);
+				}
+			}
+
 			//	check for goodbye
 			bool goodbye = messageForDispatch_header->tag == IPMTAG_GOODBYE;
 
@@ -308,3 +390,67 @@ void ProtocolChannel::MemberSenderThreadProc()
 		sender.thread.storeError(e, tout);
 	}
 }
+
+////////////////	COMPRESSION
+
+UINT32 ProtocolChannel::compressPayload(UINT8 codec, const BYTE* src, UINT32 srcBytes, BYTE* dst)
+{
+	//	dst must have max(COMPRESS_BOUND(), zrleBound()) bytes
+	switch (codec)
+	{
+		case IPMFMT_UNCOMPRESSED:
+			if (srcBytes) memcpy(dst, src, srcBytes);
+			return srcBytes;
+
+		case IPMFMT_ZRLE:
+			return zrleEncode(src, srcBytes, dst);
+
+		default:
+		{
+			UINT32 dstBytes = max(COMPRESS_BOUND(srcBytes), zrleBound(srcBytes));
+			const char* err = compressFunction(
+					codec,
+					(void*)src,
+					srcBytes,
+					dst,
+					&dstBytes,
+					sender.IntervoiceCompression
+				);
+			if (err) ferr << E_INTERNAL << err;
+			return dstBytes;
+		}
+	}
+}
+
+UINT8 ProtocolChannel::selectCodec(UINT32 msgStreamID, const BYTE* src, UINT32 srcBytes, brahms::output::Source& tout)
+{
+	if (sender.selectors.size() <= msgStreamID) sender.selectors.resize(msgStreamID + 1);
+	CodecSelector& selector = sender.selectors[msgStreamID];
+
+	//	sample all candidates on this payload, if due
+	if (selector.due() && srcBytes)
+	{
+		UINT32 bound = max(COMPRESS_BOUND(srcBytes), zrleBound(srcBytes));
+		if (sender.trialBuffer.size() < bound) sender.trialBuffer.resize(bound);
+
+		brahms::os::Timer timer;
+		for (UINT32 c=0; c<CODEC_CANDIDATES; c++)
+		{
+			UINT8 codec = CODEC_CANDIDATE_FORMATS[c];
+			if (codec == IPMFMT_UNCOMPRESSED) continue;
+			timer.reset();
+			UINT32 dstBytes = compressPayload(codec, src, srcBytes, &sender.trialBuffer[0]);
+			selector.sample(c, srcBytes, dstBytes, timer.elapsed());
+		}
+
+		//	report if choice changes
+		UINT8 previous = selector.codec;
+		if (selector.choose(sender.throughput) != previous)
+			tout << "link 0x" << hex << msgStreamID << dec << " now using codec " << (UINT32)selector.codec
+				<< " (throughput " << ((UINT32)(sender.throughput / 1024.0)) << "KB/s)" << D_VERB;
+		return selector.codec;
+	}
+
+	//	else, use current choice
+	return selector.codec;
+}
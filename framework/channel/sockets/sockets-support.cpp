@@ -81,6 +81,76 @@ void os_enablenagle(OS_SOCKET socket, bool enable)
         ferr << E_OS << "failed setsockopt()";
 }
 
+int os_recvnow(OS_SOCKET socket, char* data, int bytes)
+{
+    //	no MSG_DONTWAIT, so ask select() first
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(socket, &readable);
+    timeval now = {0, 0};
+    int result = select(0, &readable, NULL, NULL, &now);
+    if (result == OS_SOCKET_ERROR) return OS_SOCKET_ERROR;
+    if (!result)
+    {
+        WSASetLastError(WSAEWOULDBLOCK);
+        return OS_SOCKET_ERROR;
+    }
+    return recv(socket, data, bytes, 0);
+}
+
+bool os_busypoll(OS_SOCKET socket, UINT32 usecs)
+{
+    return false;
+}
+
+int os_waitsockets(const vector<OS_SOCKET>& sockets, const vector<bool>& listening, vector<bool>& ready, UINT32 msecs)
+{
+    //	select() with no sockets fails (WSAEINVAL), so just wait
+    UINT32 count = sockets.size();
+    ready.assign(count, false);
+    if (!count)
+    {
+        os_msleep(msecs);
+        return 0;
+    }
+
+    //	an fd_set holds only FD_SETSIZE sockets, so take them a set at a
+    //	time; all but the last set are only polled, so that one that comes
+    //	ready in the meantime is found, at worst, next time round
+    int total = 0;
+    for (UINT32 first=0; first<count; first+=FD_SETSIZE)
+    {
+        UINT32 last = first + FD_SETSIZE < count ? first + FD_SETSIZE : count;
+        fd_set readable, writable, failed;
+        FD_ZERO(&readable);
+        FD_ZERO(&writable);
+        FD_ZERO(&failed);
+        for (UINT32 i=first; i<last; i++)
+        {
+            if (listening[i]) FD_SET(sockets[i], &readable);
+            else
+            {
+                FD_SET(sockets[i], &writable);
+                FD_SET(sockets[i], &failed);
+            }
+        }
+
+        timeval tv;
+        tv.tv_sec = 0;
+        tv.tv_usec = (last == count && !total) ? msecs * 1000 : 0;
+        int result = select(0, &readable, &writable, &failed, &tv);
+        if (result == OS_SOCKET_ERROR) return OS_SOCKET_ERROR;
+
+        for (UINT32 i=first; i<last; i++)
+        {
+            ready[i] = FD_ISSET(sockets[i], &readable) || FD_ISSET(sockets[i], &writable) || FD_ISSET(sockets[i], &failed);
+            if (ready[i]) total++;
+        }
+    }
+
+    return total;
+}
+
 #endif // __WIN__
 
 #ifdef __NIX__
@@ -125,6 +195,43 @@ void os_enablenagle(OS_SOCKET socket, bool enable)
         ferr << E_OS << "failed setsockopt";
 }
 
+int os_recvnow(OS_SOCKET socket, char* data, int bytes)
+{
+    return recv(socket, data, bytes, MSG_DONTWAIT);
+}
+
+bool os_busypoll(OS_SOCKET socket, UINT32 usecs)
+{
+#ifdef SO_BUSY_POLL
+    int value = usecs;
+    return !setsockopt(socket, SOL_SOCKET, SO_BUSY_POLL, (const char*) &value, sizeof(int));
+#else
+    return false;
+#endif
+}
+
+int os_waitsockets(const vector<OS_SOCKET>& sockets, const vector<bool>& listening, vector<bool>& ready, UINT32 msecs)
+{
+    //	poll(), unlike select(), is not limited to sockets below FD_SETSIZE
+    UINT32 count = sockets.size();
+    ready.assign(count, false);
+    vector<pollfd> fds(count);
+    for (UINT32 i=0; i<count; i++)
+    {
+        fds[i].fd = sockets[i];
+        fds[i].events = listening[i] ? POLLIN : POLLOUT;
+        fds[i].revents = 0;
+    }
+
+    int result = poll(count ? &fds[0] : NULL, count, msecs);
+    if (result == OS_SOCKET_ERROR) return OS_SOCKET_ERROR;
+
+    //	POLLERR and POLLHUP are reported whether asked for or not
+    for (UINT32 i=0; i<count; i++)
+        ready[i] = fds[i].revents != 0;
+    return result;
+}
+
 #endif // __NIX__
 
 
@@ -190,4 +297,23 @@ CommsLayer::isinit()
 {
     return core != NULL;
 }
+
+void
+CommsLayer::attachChannel(ProtocolChannel* channel)
+{
+    unconnectedChannels.push_back(channel);
+}
+
+void
+CommsLayer::detachChannel(ProtocolChannel* channel)
+{
+    for (UINT32 c=0; c<unconnectedChannels.size(); c++)
+    {
+        if (unconnectedChannels[c] == channel)
+        {
+            unconnectedChannels.erase(unconnectedChannels.begin() + c);
+            return;
+        }
+    }
+}
 //@}
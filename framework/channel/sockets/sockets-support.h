@@ -43,6 +43,8 @@ ________________________________________________________________
 using std::string;
 #include <sstream>
 using std::stringstream;
+#include <vector>
+using std::vector;
 #include "base/brahms_error.h" // ferr
 #include "base/constants.h" // E_OS etc
 #include "base/text.h" // h2s
@@ -61,6 +63,7 @@ string h2s(UINT64 val, UINT32 width = 0);
 
 typedef SOCKET OS_SOCKET;
 typedef SOCKADDR OS_SOCKADDR;
+typedef int OS_SOCKLEN;
 
 # define OS_INVALID_SOCKET INVALID_SOCKET
 # define OS_SOCKET_ERROR SOCKET_ERROR
@@ -70,6 +73,7 @@ typedef SOCKADDR OS_SOCKADDR;
 # define OS_INPROGRESS WSAEINPROGRESS
 # define OS_ALREADY WSAEALREADY
 # define OS_ISCONN WSAEISCONN
+# define OS_MSG_MORE 0
 
 # define os_closesocket closesocket
 
@@ -86,9 +90,12 @@ typedef SOCKADDR OS_SOCKADDR;
 # include "fcntl.h"
 # include "netinet/tcp.h"
 # include "errno.h"
+# include "sys/select.h"
+# include "poll.h"
 
 typedef int OS_SOCKET;
 typedef const struct sockaddr OS_SOCKADDR;
+typedef socklen_t OS_SOCKLEN;
 
 # define OS_INVALID_SOCKET -1
 # define OS_SOCKET_ERROR -1
@@ -98,6 +105,11 @@ typedef const struct sockaddr OS_SOCKADDR;
 # define OS_INPROGRESS EINPROGRESS
 # define OS_ALREADY EALREADY
 # define OS_ISCONN EISCONN
+# ifdef MSG_MORE
+#  define OS_MSG_MORE MSG_MORE
+# else
+#  define OS_MSG_MORE 0
+# endif
 
 # define os_closesocket close
 
@@ -111,6 +123,20 @@ void os_nonblock(OS_SOCKET socket);
 void os_block(OS_SOCKET socket);
 void os_enablenagle(OS_SOCKET socket, bool enable);
 
+// recv() that does not block on a blocking socket; returns as recv(), or
+// OS_SOCKET_ERROR with OS_LASTERROR == OS_WOULDBLOCK if nothing is waiting
+int os_recvnow(OS_SOCKET socket, char* data, int bytes);
+
+// ask the kernel to busy-poll the device queue on blocking receives, where
+// supported (SO_BUSY_POLL); returns false if not supported or not permitted
+bool os_busypoll(OS_SOCKET socket, UINT32 usecs);
+
+// wait up to msecs for any of the sockets to be ready: a listening socket
+// to accept (listening[i]), or any other to complete (or fail) connect();
+// ready[i] is set for each that is. Returns as select(), or sleeps if no
+// sockets are given. There is no limit on the number or value of sockets.
+int os_waitsockets(const vector<OS_SOCKET>& sockets, const vector<bool>& listening, vector<bool>& ready, UINT32 msecs);
+
 ////////////////	GET LISTEN PORT NUMBER FROM SALIENT DATA
 UINT32 listenPort(UINT32 SocketsBasePort, UINT32 voiceCount, UINT32 serverIndex, UINT32 clientIndex);
 
@@ -120,6 +146,8 @@ UINT32 listenPort(UINT32 SocketsBasePort, UINT32 voiceCount, UINT32 serverIndex,
   One (global) comms layer object exists, which brings up and down the
   comms layer (sockets layer) at startup and shutdown.
 */
+struct ProtocolChannel;
+
 class CommsLayer
 {
 public:
@@ -130,6 +158,11 @@ public:
     //	is initialized?
     bool isinit();
 
+    //	channels created but not yet connected (see SOCKETS_MESH)
+    void attachChannel(ProtocolChannel* channel);
+    void detachChannel(ProtocolChannel* channel);
+    vector<ProtocolChannel*> unconnectedChannels;
+
     //	engine data (non-NULL indicates we've initialised)
     brahms::base::Core* core;
 };
@@ -16,6 +16,10 @@ ProtocolChannel::ProtocolChannel(ChannelInitData channelInitData, brahms::base::
     //	start with invalid sockets
     dataSocket = OS_INVALID_SOCKET;
     serverListenSocket = OS_INVALID_SOCKET;
+#ifdef __LOOPBACK__
+    sendPipe = NULL;
+    recvPipe = NULL;
+#endif
 
     //	are we server or client?
     server = core.getVoiceIndex() < channelInitData.remoteVoiceIndex;
@@ -26,6 +30,7 @@ ProtocolChannel::ProtocolChannel(ChannelInitData channelInitData, brahms::base::
     pars.PushDataMaxItems = core.execPars.getu("PushDataMaxItems");
     pars.PushDataMaxBytes = core.execPars.getu("PushDataMaxBytes");
     pars.PushDataWaitStep = core.execPars.getu("PushDataWaitStep");
+    pars.SocketsBusyPoll = core.execPars.getu("SocketsBusyPoll");
     pars.localVoiceIndex = core.getVoiceIndex();
 
     //	choose port numbers
@@ -35,6 +40,12 @@ ProtocolChannel::ProtocolChannel(ChannelInitData channelInitData, brahms::base::
 
     //	misc
     sender.flushed = false;
+    if (pars.SocketsBusyPoll) receiver.stage.resize(SOCKETS_STAGE_BYTES);
+
+#ifndef __LOOPBACK__
+    //	connected along with all the others, when the first is opened
+    commsLayer.attachChannel(this);
+#endif
 }
 
 void
@@ -53,12 +64,50 @@ ProtocolChannel::flush(brahms::output::Source& tout)
         os_msleep(1);
 }
 
+int
+ProtocolChannel::transportSend(const BYTE* data, UINT32 bytes, bool more)
+{
+#ifdef __LOOPBACK__
+    return sendPipe->send(data, bytes);
+#else
+    return send(dataSocket, (const char*)data, bytes, more ? OS_MSG_MORE : 0);
+#endif
+}
+
+int
+ProtocolChannel::transportRecv(BYTE* data, UINT32 bytes, bool peek)
+{
+#ifdef __LOOPBACK__
+    return recvPipe->recv(data, bytes, peek);
+#else
+    return recv(dataSocket, (char*)data, bytes, peek ? MSG_PEEK : 0);
+#endif
+}
+
+int
+ProtocolChannel::transportRecvNow(BYTE* data, UINT32 bytes)
+{
+#ifdef __LOOPBACK__
+    int result = recvPipe->tryRecv(data, bytes);
+    return result < 0 ? TRANSPORT_WOULD_BLOCK : result;
+#else
+    int result = os_recvnow(dataSocket, (char*)data, bytes);
+    if (result == OS_SOCKET_ERROR && OS_LASTERROR == OS_WOULDBLOCK) return TRANSPORT_WOULD_BLOCK;
+    return result;
+#endif
+}
+
 void
 ProtocolChannel::listen()
 {
     //	if not server, do nowt
     if (!server) return;
 
+#ifdef __LOOPBACK__
+    //	nothing to listen on
+    return;
+#endif
+
     //	fout
     core.caller.tout << "starting listen on channel to Voice " << unitIndex(channelInitData.remoteVoiceIndex) << D_FULL;
 
@@ -99,141 +148,243 @@ ProtocolChannel::listen()
 
 void
 ProtocolChannel::open(brahms::output::Source& fout)
+{
+#ifdef __LOOPBACK__
+    //	attach to the pipes to and from the remote voice, which is in this process
+    DOUBLE latency = ((DOUBLE)core.execPars.getu("LoopbackLatency")) * 1e-6;
+    DOUBLE bandwidth = core.execPars.getu("LoopbackBandwidth");
+    sendPipe = loopbackAttach(core.getVoiceIndex(), channelInitData.remoteVoiceIndex, latency, bandwidth);
+    recvPipe = loopbackAttach(channelInitData.remoteVoiceIndex, core.getVoiceIndex(), latency, bandwidth);
+    core.caller.tout << "attached loopback to voice " << unitIndex(channelInitData.remoteVoiceIndex) << D_VERB;
+
+    //	create threads
+    sender.thread.start(pars.TimeoutThreadTerm, SenderThreadProc, this);
+    receiver.thread.start(pars.TimeoutThreadTerm, ReceiverThreadProc, this);
+    return;
+#endif
+
+    //	the first channel opened connects them all (see SOCKETS_MESH)
+    if (dataSocket == OS_INVALID_SOCKET)
+        connectMesh(commsLayer.unconnectedChannels, fout);
+    if (dataSocket == OS_INVALID_SOCKET)
+        ferr << E_INTERNAL << "channel to Voice " << unitIndex(channelInitData.remoteVoiceIndex) << " was not connected";
+
+    //	for remainder of operation, socket will have send() and recv()
+    //	called on it from send/recv threads, so we can safely set it
+    //	to blocking mode, simplifying the logic of using it
+    os_block(dataSocket);
+
+    //	handle NAGLE algorithm
+    os_enablenagle(dataSocket, core.execPars.getu("SocketsUseNagle"));
+
+    //	let the kernel busy-poll too, if it will (see SOCKETS_BUSY_POLL)
+    if (pars.SocketsBusyPoll)
+    {
+        if (os_busypoll(dataSocket, pars.SocketsBusyPoll))
+            fout << "SO_BUSY_POLL set on channel to Voice " << unitIndex(channelInitData.remoteVoiceIndex) << D_VERB;
+        else
+            fout << "SO_BUSY_POLL not available on channel to Voice " << unitIndex(channelInitData.remoteVoiceIndex) << " (polling in user space only)" << D_VERB;
+    }
+
+    //	create threads
+    sender.thread.start(pars.TimeoutThreadTerm, SenderThreadProc, this);
+    receiver.thread.start(pars.TimeoutThreadTerm, ReceiverThreadProc, this);
+}
+
+bool
+ProtocolChannel::connectStart()
+{
+    //	open socket
+    if ((dataSocket = socket( AF_INET, SOCK_STREAM, IPPROTO_TCP )) == OS_INVALID_SOCKET )
+        ferr << E_COMMS << "failed to create socket (" + socketsErrorString(OS_LASTERROR) + ")";
+
+    //	address details
+    sockaddr_in con;
+    con.sin_family = AF_INET;
+    con.sin_addr.s_addr = inet_addr( channelInitData.remoteAddress.c_str() );
+    con.sin_port = htons( remotePort );
+
+    //	set push socket to non-blocking for connection phase
+    os_nonblock(dataSocket);
+
+    //	try to connect (asynchronously)
+    if ( ::connect( dataSocket, (OS_SOCKADDR*) &con, sizeof(con) ) != OS_SOCKET_ERROR )
+        return true;
+
+    UINT32 err = OS_LASTERROR;
+    switch(err)
+    {
+        //	already connected (connection operation has completed)
+    case OS_ISCONN:
+        return true;
+
+        //	most likely, the connection has been initiated but not yet completed
+    case OS_WOULDBLOCK:
+    case OS_INPROGRESS:
+    case OS_ALREADY:
+        return false;
+
+        //	if connection refused, server may not be ready, so caller will try again
+    case OS_CONNREFUSED:
+        ::os_closesocket(dataSocket);
+        dataSocket = OS_INVALID_SOCKET;
+        return false;
+
+        //	other error
+    default:
+        ::os_closesocket(dataSocket);
+        dataSocket = OS_INVALID_SOCKET;
+        ferr << E_COMMS << "failed at connect() to Voice " << unitIndex(channelInitData.remoteVoiceIndex) << " (" << err << " = " << socketsErrorString(err) << ")";
+    }
+
+    return false;
+}
+
+/*	DOCUMENTATION: SOCKETS_MESH
+
+    Every pair of voices is joined by one TCP connection: the lower
+    voice listens (on a port for that pair, see listenPort()) and the
+    higher voice connects. Rather than connect each channel in turn,
+    which makes startup take a round-trip (or, if the peer is not yet
+    listening, a CONNECTION_ATTEMPT_INTERVAL_MS retry) per peer, the
+    first channel opened connects all of them at once. All connect()s
+    are started non-blocking, and then one loop waits on every socket
+    at once (poll(), or select() a set at a time on Windows; see
+    os_waitsockets()), accepting on each listener and completing each
+    connect() as it is ready; a refused connect() is retried after
+    CONNECTION_ATTEMPT_INTERVAL_MS.
+    Mesh setup thus takes about as long as the slowest peer does to
+    start listening. SocketsTimeout applies to the mesh as a whole.
+*/
+
+void
+ProtocolChannel::connectMesh(vector<ProtocolChannel*>& channels, brahms::output::Source& fout)
 {
     //	connect() watchdog timer
     brahms::os::Timer watchdog;
+    UINT32 count = channels.size();
+    if (!count) return;
+    UINT32 timeout = channels[0]->pars.SocketsTimeout;
+    fout << "connecting " << count << " channels..." << D_VERB;
+
+    //	per channel, whether connected, and when (mS) a client is next due to try connect()
+    vector<bool> connected(count, false);
+    VUINT32 attemptDue(count, 0);
+    UINT32 pending = count;
 
-    //	server accepts a connection
-    if (server)
+    while (true)
     {
-        //	fout
-        UINT32 port = localPort;
-        stringstream ss;
-        ss << channelInitData.remoteAddress << ":" << port;
-        string addr = ss.str();
-        core.caller.tout << "expecting connection from " << addr << "..." << D_FULL;
-
-        //	accept pending connection from remote Voice
-        while(true)
+        //	start client connect()s that are due (these may complete at once)
+        UINT32 now = watchdog.elapsedMS();
+        for (UINT32 c=0; c<count; c++)
         {
-            //	accept incoming connection
-            if ((dataSocket = accept( serverListenSocket, NULL, NULL )) != OS_INVALID_SOCKET)
+            ProtocolChannel* channel = channels[c];
+            if (connected[c] || channel->server || channel->dataSocket != OS_INVALID_SOCKET || now < attemptDue[c])
+                continue;
+
+            if (channel->connectStart())
             {
-                core.caller.tout << " CONNECTED (in " << watchdog.elapsedMS() << "mS)" << D_FULL;
-                break;
+                fout << "connected to Voice " << unitIndex(channel->channelInitData.remoteVoiceIndex) << " (in " << now << "mS)" << D_VERB;
+                connected[c] = true;
+                pending--;
             }
-
-            //	otherwise, find out why
-            int err = OS_LASTERROR;
-            if (err != OS_WOULDBLOCK)
-                ferr << E_COMMS << "failed at accept() (" + socketsErrorString(err) + ")";
-
-            //	wait for remote Voice to try and connect
-            core.caller.tout << "."; // "." means "no connection yet"
-            os_msleep(CONNECTION_ATTEMPT_INTERVAL_MS);
-            if (watchdog.elapsedMS() >= pars.SocketsTimeout)
-                ferr << E_COMMS_TIMEOUT << "accepting connection from " << addr;
+            else if (channel->dataSocket == OS_INVALID_SOCKET)
+                attemptDue[c] = now + CONNECTION_ATTEMPT_INTERVAL_MS;
         }
-    }
 
-    //	client initiates a connection
-    else
-    {
-        //	fout
-        UINT32 port = remotePort;
-        stringstream ss;
-        ss << channelInitData.remoteAddress << ":" << port;
-        string addr = ss.str();
-        core.caller.tout << "attempting connection to " << addr << "..." << D_VERB;
-
-        //	open socket
-        if ((dataSocket = socket( AF_INET, SOCK_STREAM, IPPROTO_TCP )) == OS_INVALID_SOCKET )
-            ferr << E_COMMS << "failed to create socket (" + socketsErrorString(OS_LASTERROR) + ")";
-
-        //	address details
-        sockaddr_in con;
-        con.sin_family = AF_INET;
-        con.sin_addr.s_addr = inet_addr( channelInitData.remoteAddress.c_str() );
-        con.sin_port = htons( port );
-
-        //	set push socket to non-blocking for connection phase
-        os_nonblock(dataSocket);
-
-        //	connect socket
-        bool connected = false;
-
-        while(true)
+        //	done?
+        if (!pending) break;
+
+        //	timeout
+        if (now >= timeout)
         {
-            //	try to connect (asynchronously)
-            UINT32 err = 0;
-            if ( ::connect( dataSocket, (OS_SOCKADDR*) &con, sizeof(con) ) != OS_SOCKET_ERROR )
+            stringstream ss;
+            for (UINT32 c=0; c<count; c++)
             {
-                connected = true;
+                if (connected[c]) continue;
+                ss << " " << unitIndex(channels[c]->channelInitData.remoteVoiceIndex);
             }
-            else
+            ferr << E_COMMS_TIMEOUT << "connecting to Voices" << ss.str();
+        }
+
+        //	wait for connections to accept, or connect()s to complete
+        vector<OS_SOCKET> sockets;
+        vector<bool> listening;
+        VUINT32 waiting;
+        for (UINT32 c=0; c<count; c++)
+        {
+            ProtocolChannel* channel = channels[c];
+            if (connected[c]) continue;
+
+            OS_SOCKET s = channel->server ? channel->serverListenSocket : channel->dataSocket;
+            if (s == OS_INVALID_SOCKET) continue;
+            sockets.push_back(s);
+            listening.push_back(channel->server);
+            waiting.push_back(c);
+        }
+
+        //	(if every client is waiting to retry, this just sleeps)
+        vector<bool> ready;
+        if (os_waitsockets(sockets, listening, ready, CONNECTION_ATTEMPT_INTERVAL_MS) == OS_SOCKET_ERROR)
+        {
+            UINT32 err = OS_LASTERROR;
+#ifdef __NIX__
+            if (err == EINTR) continue;
+#endif
+            ferr << E_COMMS << "failed waiting for connections (" << socketsErrorString(err) << ")";
+        }
+
+        //	handle whatever is ready
+        now = watchdog.elapsedMS();
+        for (UINT32 w=0; w<waiting.size(); w++)
+        {
+            if (!ready[w]) continue;
+            UINT32 c = waiting[w];
+            ProtocolChannel* channel = channels[c];
+
+            //	server accepts a connection
+            if (channel->server)
             {
-                err = OS_LASTERROR;
-                if (err == OS_ISCONN)
+                if ((channel->dataSocket = accept( channel->serverListenSocket, NULL, NULL )) == OS_INVALID_SOCKET)
                 {
-                    //	already connected (connection operation has completed)
-                    connected = true;
+                    UINT32 err = OS_LASTERROR;
+                    if (err != OS_WOULDBLOCK)
+                        ferr << E_COMMS << "failed at accept() (" + socketsErrorString(err) + ")";
+                    continue;
                 }
             }
 
-            //	if connected, report and break infinite loop
-            if (connected)
-            {
-                core.caller.tout << " CONNECTED (in " << watchdog.elapsedMS() << "mS)" << D_VERB;
-                break;
-            }
-
-            //	otherwise, handle error
-            char status = '.'; // IN PROGRESS
-            switch(err)
+            //	client connect() completes, or fails
+            else
             {
-                //	if would block, server may not be ready
-                //	if connection refused, server may not be ready
-            case OS_WOULDBLOCK:
-            case OS_CONNREFUSED:
-
-                status = 'R'; // REFUSED
-                //	deliberate drop-through...
-
-                //	most likely, the result was OS_EINPROGRESS, meaning
-                //	the connection has been initiated but not yet completed
-            case OS_INPROGRESS:
-            case OS_ALREADY:
-
-                //	timeout
-                if (watchdog.elapsedMS() >= pars.SocketsTimeout)
-                    ferr << E_COMMS_TIMEOUT << "connecting to " << addr << " (" << socketsErrorString(err) << ")";
-
-                //	else, wait a bit and try again
-                core.caller.tout << status;
-                os_msleep(CONNECTION_ATTEMPT_INTERVAL_MS);
-                continue;
+                OS_SOCKET s = channel->dataSocket;
+                int err = 0;
+                OS_SOCKLEN len = sizeof(err);
+                if (getsockopt(s, SOL_SOCKET, SO_ERROR, (char*)&err, &len) == OS_SOCKET_ERROR)
+                    err = OS_LASTERROR;
 
-                //	other error
-            default:
-            {
-                core.caller.tout << " FAILED" << D_VERB;
-                ferr << E_COMMS << "failed at connect() (" << err << " = " << socketsErrorString(err) << ")";
-            }
+                if (err)
+                {
+                    ::os_closesocket(s);
+                    channel->dataSocket = OS_INVALID_SOCKET;
+
+                    //	if connection refused, server may not be ready
+                    if (((UINT32)err) != OS_CONNREFUSED)
+                        ferr << E_COMMS << "failed at connect() to Voice " << unitIndex(channel->channelInitData.remoteVoiceIndex) << " (" << err << " = " << socketsErrorString(err) << ")";
+                    attemptDue[c] = now + CONNECTION_ATTEMPT_INTERVAL_MS;
+                    continue;
+                }
             }
+
+            fout << "connected to Voice " << unitIndex(channel->channelInitData.remoteVoiceIndex) << " (in " << now << "mS)" << D_VERB;
+            connected[c] = true;
+            pending--;
         }
     }
 
-    //	for remainder of operation, socket will have send() and recv()
-    //	called on it from send/recv threads, so we can safely set it
-    //	to blocking mode, simplifying the logic of using it
-    os_block(dataSocket);
-
-    //	handle NAGLE algorithm
-    os_enablenagle(dataSocket, core.execPars.getu("SocketsUseNagle"));
-
-    //	create threads
-    sender.thread.start(pars.TimeoutThreadTerm, SenderThreadProc, this);
-    receiver.thread.start(pars.TimeoutThreadTerm, ReceiverThreadProc, this);
+    //	all connected
+    channels.clear();
+    fout << "all channels connected (in " << watchdog.elapsedMS() << "mS)" << D_VERB;
 }
 
 void
@@ -241,9 +392,22 @@ ProtocolChannel::terminate(brahms::output::Source& fout)
 {
     fout << "terminate() called on channel to Voice " << unitIndex(channelInitData.remoteVoiceIndex) << D_VERB;
 
+#ifndef __LOOPBACK__
+    //	in case we never got connected
+    commsLayer.detachChannel(this);
+#endif
+
     sender.terminate(fout);
     receiver.terminate(fout);
 
+#ifdef __LOOPBACK__
+    //	release pipes
+    if (sendPipe) loopbackDetach(core.getVoiceIndex(), channelInitData.remoteVoiceIndex);
+    if (recvPipe) loopbackDetach(channelInitData.remoteVoiceIndex, core.getVoiceIndex());
+    sendPipe = NULL;
+    recvPipe = NULL;
+#endif
+
     //	close socket
     if (dataSocket != OS_INVALID_SOCKET)
         ::os_closesocket(dataSocket);
@@ -269,6 +433,32 @@ ProtocolChannel::audit(ChannelAuditData& data)
     channelSlushPool.audit(data.pool);
 }
 
+bool
+ProtocolChannel::telemetry(ChannelTelemetryData& data)
+{
+    if (!sender.CommsTelemetry) return false;
+
+    //	sender side (the sender thread may still be sending KEEPALIVEs,
+    //	and records each under auditsMutex)
+    {
+        brahms::os::MutexLocker locker(sender.auditsMutex);
+        data.channel.merge(sender.telemetry);
+        data.sent = sender.links;
+    }
+
+    //	receiver side (deliverers have stopped by now)
+    data.received.resize(receiver.deliverers.size());
+    for (UINT32 d=0; d<receiver.deliverers.size(); d++)
+    {
+        // some may be NULL (it's a sparse routing table)
+        if (!receiver.deliverers[d]) continue;
+        receiver.deliverers[d]->telemetry(data.received[d]);
+        data.channel.delivererWait.merge(data.received[d].delivererWait);
+    }
+
+    return true;
+}
+
 // Implementation of nested Sender class
 //@{
 ProtocolChannel::Sender::Sender(INT32 remoteVoiceIndex, brahms::base::Core& core)
@@ -279,14 +469,31 @@ ProtocolChannel::Sender::Sender(INT32 remoteVoiceIndex, brahms::base::Core& core
     memset(&simplex, 0, sizeof(simplex));
 
     //	init sender
-    IntervoiceCompression = core.execPars.getu("IntervoiceCompression");
-    if (IntervoiceCompression > 9) {
-        ferr << E_EXECUTION_PARAMETERS << "invalid IntervoiceCompression";
+    string codec = core.execPars.gets("IntervoiceCompression");
+    IntervoiceCompression = 1; // deflate level, if deflate is chosen by "auto"
+    if (codec == "lz") format = IPMFMT_LZ;
+    else if (codec == "shuffle4") format = IPMFMT_SHUFFLE4_LZ;
+    else if (codec == "shuffle8") format = IPMFMT_SHUFFLE8_LZ;
+    else if (codec == "auto") format = SENDER_FORMAT_AUTO;
+    else
+    {
+        IntervoiceCompression = core.execPars.getu("IntervoiceCompression");
+        if (IntervoiceCompression > 9) {
+            ferr << E_EXECUTION_PARAMETERS << "invalid IntervoiceCompression";
+        }
+        format = IntervoiceCompression ? IPMFMT_DEFLATE : IPMFMT_UNCOMPRESSED;
     }
-    format = IntervoiceCompression ? IPMFMT_DEFLATE : IPMFMT_UNCOMPRESSED;
-    if (format == IPMFMT_DEFLATE && !compressFunction) {
+    if (format != IPMFMT_UNCOMPRESSED && !compressFunction) {
         ferr << "compression module did not load - must turn off IntervoiceCompression";
     }
+    throughput = CODEC_DEFAULT_THROUGHPUT;
+    throughputWindowBytes = 0;
+    throughputWindowSecs = 0.0;
+    IntervoiceEncoding = core.execPars.getu("IntervoiceEncoding");
+
+    //	telemetry (see COMMS_TELEMETRY)
+    CommsTelemetry = core.execPars.getu("CommsTelemetry") != 0;
+    q.timed = CommsTelemetry;
 }
 
 void
@@ -340,6 +547,13 @@ ProtocolChannel::push(IPM* ipm, brahms::output::Source* tout)
                 sender.q.push(ipms);
                 sender.audits[msgStreamID].queryBufferMsgsUnaccountedFor++;
 
+                //	telemetry
+                if (sender.CommsTelemetry)
+                {
+                    sender.telemetry.backoffs++;
+                    if (msgStreamID < sender.links.size()) sender.links[msgStreamID].backoffs++;
+                }
+
                 //	tell caller to wait a bit
                 return pars.PushDataWaitStep;
             }
@@ -362,6 +576,10 @@ ProtocolChannel::Receiver::Receiver(INT32 remoteVoiceIndex, brahms::base::Core&
             {
                 memset(&simplex, 0, sizeof(simplex));
                 messageReceived = false;
+                stageBegin = 0;
+                stageEnd = 0;
+                numPolledReceives = 0;
+                numParkedReceives = 0;
             }
 
 void
@@ -514,6 +732,9 @@ ProtocolChannel::addRoutingEntry(UINT32 msgStreamID, PushDataHandler pushDataHan
     }
     receiver.deliverers[msgStreamID] = deliverer;
 
+    //	in low-latency mode, deliverers spin before parking too (see SOCKETS_BUSY_POLL)
+    deliverer->spinBeforePark(((DOUBLE)pars.SocketsBusyPoll) * 1e-6);
+
     //	start new deliverer thread
     deliverer->start(pars.TimeoutThreadTerm);
 }
@@ -45,9 +45,13 @@ using std::string;
 #include <sstream>
 using std::stringstream;
 #include "deliverer.h"
+#include "encode.h"
 #include "base/brahms_math.h"
 using brahms::math::unitIndex;
 #include "compress.h"
+#ifdef __LOOPBACK__
+#include "loopback/loopback.h"
+#endif
 
 //////////////// THREAD PROCEDURE DECLARATIONS
 /*
@@ -76,6 +80,21 @@ struct ProtocolChannel
     UINT32 localPort;
     UINT32 remotePort;
 
+#ifdef __LOOPBACK__
+    // in-memory pipes standing in for dataSocket (see LOOPBACK_CHANNEL)
+    LoopbackPipe* sendPipe;
+    LoopbackPipe* recvPipe;
+#endif
+
+    // send() and recv() on dataSocket (or on the loopback pipes); "more"
+    // says that another send will follow at once (see SENDER_COALESCING)
+    int transportSend(const BYTE* data, UINT32 bytes, bool more);
+    int transportRecv(BYTE* data, UINT32 bytes, bool peek);
+
+    // as transportRecv(), not peeking, but returning TRANSPORT_WOULD_BLOCK
+    // at once if nothing has arrived (see SOCKETS_BUSY_POLL)
+    int transportRecvNow(BYTE* data, UINT32 bytes);
+
     // engine data
     brahms::base::Core& core;
     ChannelInitData channelInitData;
@@ -88,6 +107,7 @@ struct ProtocolChannel
         UINT32 PushDataMaxItems;
         UINT32 PushDataMaxBytes;
         UINT32 PushDataWaitStep;
+        UINT32 SocketsBusyPoll;
         INT32 localVoiceIndex;
     } pars;
 
@@ -99,15 +119,26 @@ struct ProtocolChannel
     void flush(brahms::output::Source& tout);
     void listen();
     void open(brahms::output::Source& fout);
+    bool connectStart();
+    static void connectMesh(vector<ProtocolChannel*>& channels, brahms::output::Source& fout);
     void terminate(brahms::output::Source& fout);
     void stopRouting(brahms::output::Source& fout);
     void audit(ChannelAuditData& data);
+    bool telemetry(ChannelTelemetryData& data);
 
     //////////////// SENDER
     void MemberSenderThreadProc();
+    UINT32 compressPayload(UINT8 codec, const BYTE* src, UINT32 srcBytes, BYTE* dst);
+    UINT8 selectCodec(UINT32 msgStreamID, const BYTE* src, UINT32 srcBytes, brahms::output::Source& tout);
 
 #define SocketsKeepAliveInterval 1000
 
+// sender format, meaning choose codec per link (see CODEC_SELECTION)
+#define SENDER_FORMAT_AUTO IPMFMT_CODEC_MASK
+
+// bytes sent between updates of the link throughput estimate
+#define SENDER_THROUGHPUT_WINDOW 1048576
+
     struct Sender
     {
         Sender(INT32 remoteVoiceIndex, brahms::base::Core& core);
@@ -126,8 +157,25 @@ struct ProtocolChannel
         // other data
         UINT8 format;
         UINT32 IntervoiceCompression;
+        UINT32 IntervoiceEncoding;
         bool flushed;
 
+        // stream encoding references for each link (see STREAM_ENCODING)
+        vector<StreamReference> streams;
+
+        // codec selection for each link, and link throughput (see CODEC_SELECTION)
+        vector<CodecSelector> selectors;
+        VUINT8 trialBuffer;
+        DOUBLE throughput;
+        UINT32 throughputWindowBytes;
+        DOUBLE throughputWindowSecs;
+
+        // telemetry for the channel, and for each link (see COMMS_TELEMETRY);
+        // all of it is updated (and links resized) under auditsMutex
+        bool CommsTelemetry;
+        LinkTelemetry telemetry;
+        vector<LinkTelemetry> links;
+
         // estimated contents of remote buffer for each link
         brahms::os::Mutex auditsMutex;
         vector<QueueAuditDataX> audits;
@@ -139,6 +187,17 @@ struct ProtocolChannel
     //////////////// RECEIVER
     void MemberReceiverThreadProc();
 
+    // low-latency receive (see SOCKETS_BUSY_POLL)
+    UINT32 receivePolled(BYTE* data, UINT32 bytes);
+    void stageTopUp(UINT32 bytes);
+    void stageHeader(IPM_HEADER& header);
+    void stageMessage(BYTE* dst, UINT32 bytes);
+
+#define TRANSPORT_WOULD_BLOCK (-2)
+
+// size of the low-latency receive staging buffer
+#define SOCKETS_STAGE_BYTES 65536
+
 #define SOCKETS_PULL_WAITSTEP 100 // have to come back every now and then to check for waited > SocketsTimeout; this is usually measured in seconds, so anything sub-second will do here since it only gets hit in an error condition so it's not a performance concern
 
 #define EXTRA_WAIT_FOR_RECEIVER 5000
@@ -167,8 +226,21 @@ struct ProtocolChannel
         // with a msgStreamID of n)
         vector<Deliverer*> deliverers;
 
+        // stream encoding references for each link (see STREAM_ENCODING)
+        vector<StreamReference> streams;
+
         // flag that a message has come in
         bool messageReceived;
+
+        // low-latency receive staging buffer, holding bytes [stageBegin, stageEnd)
+        // received but not yet consumed, and counts of receives satisfied while
+        // polling and of those that had to block (see SOCKETS_BUSY_POLL)
+        VUINT8 stage;
+        UINT32 stageBegin;
+        UINT32 stageEnd;
+        brahms::os::Timer pollClock;
+        UINT32 numPolledReceives;
+        UINT32 numParkedReceives;
     } receiver;
 
     Symbol pull(IPM*& ipm, brahms::output::Source& tout);
@@ -36,6 +36,8 @@ ________________________________________________________________
 //	includes
 #include "brahms-client.h"
 #include "compress.h"
+#include "lz.h"
+#include <vector>
 
 #ifdef __WIN__
 //	use version in this folder
@@ -51,7 +53,9 @@ ________________________________________________________________
 #error must link to zlib 1.2.1 or greater
 #endif
 
-BRAHMS_COMPRESS_VIS const char* Compress(void* src, UINT32 srcBytes, void* dst, UINT32* dstBytes, INT32 compress)
+////////////////	DEFLATE
+
+const char* Deflate(void* src, UINT32 srcBytes, void* dst, UINT32* dstBytes, INT32 compress)
 {
 	//	compress == -1 means decompress
 	//	compress == 1 to 9 means compress (at that level of compression)
@@ -156,3 +160,62 @@ BRAHMS_COMPRESS_VIS const char* Compress(void* src, UINT32 srcBytes, void* dst,
 	//	unrecognised
 	return "unrecognised compress level";
 }
+
+
+
+////////////////	LZ
+
+const char* LZ(void* src, UINT32 srcBytes, void* dst, UINT32* dstBytes, INT32 compress, UINT32 width)
+{
+	//	no shuffle
+	if (!width)
+	{
+		if (compress == -1)
+			return lzDecompress((const UINT8*)src, srcBytes, (UINT8*)dst, dstBytes);
+
+		if (*dstBytes < lzBound(srcBytes)) return "insufficient space for LZ compress";
+		*dstBytes = lzCompress((const UINT8*)src, srcBytes, (UINT8*)dst);
+		return 0;
+	}
+
+	//	shuffle, via an intermediate buffer
+	std::vector<UINT8> temp(srcBytes > *dstBytes ? srcBytes : *dstBytes);
+	if (temp.empty())
+	{
+		*dstBytes = 0;
+		return 0;
+	}
+
+	if (compress == -1)
+	{
+		UINT32 bytes = *dstBytes;
+		const char* err = lzDecompress((const UINT8*)src, srcBytes, &temp[0], &bytes);
+		if (err) return err;
+		unshuffle(&temp[0], bytes, width, (UINT8*)dst);
+		*dstBytes = bytes;
+		return 0;
+	}
+
+	if (*dstBytes < lzBound(srcBytes)) return "insufficient space for LZ compress";
+	shuffle((const UINT8*)src, srcBytes, width, &temp[0]);
+	*dstBytes = lzCompress(&temp[0], srcBytes, (UINT8*)dst);
+	return 0;
+}
+
+
+
+////////////////	EXPORT
+
+BRAHMS_COMPRESS_VIS const char* CompressCodec(UINT8 codec, void* src, UINT32 srcBytes, void* dst, UINT32* dstBytes, INT32 compress)
+{
+	switch (codec)
+	{
+		case COMPRESS_CODEC_DEFLATE: return Deflate(src, srcBytes, dst, dstBytes, compress);
+		case COMPRESS_CODEC_LZ: return LZ(src, srcBytes, dst, dstBytes, compress, 0);
+		case COMPRESS_CODEC_SHUFFLE4_LZ: return LZ(src, srcBytes, dst, dstBytes, compress, 4);
+		case COMPRESS_CODEC_SHUFFLE8_LZ: return LZ(src, srcBytes, dst, dstBytes, compress, 8);
+	}
+
+	//	unrecognised
+	return "unrecognised codec";
+}
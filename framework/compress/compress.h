@@ -41,10 +41,19 @@ ________________________________________________________________
 #define BRAHMS_COMPRESS_VIS BRAHMS_DLL_IMPORT
 #endif
 
-//	function prototypes
-typedef const char* (CompressFunction)(void* src, UINT32 srcBytes, void* dst, UINT32* dstBytes, INT32 compress);
+//	codecs (these are the values carried in the low nibble of IPM_HEADER::fmt, and must match IPMFMT_* in base/ipm.h)
+const UINT8 COMPRESS_CODEC_DEFLATE		= 0x01;			//	zlib deflate, level 1 to 9
+const UINT8 COMPRESS_CODEC_LZ			= 0x03;			//	fast LZ77 (LZ4-class), level ignored
+const UINT8 COMPRESS_CODEC_SHUFFLE4_LZ	= 0x04;			//	byte-shuffle of 4-byte elements, then LZ
+const UINT8 COMPRESS_CODEC_SHUFFLE8_LZ	= 0x05;			//	byte-shuffle of 8-byte elements, then LZ
+
+//	maximum compressed size of "srcBytes" bytes for any codec
+#define COMPRESS_BOUND(srcBytes) ((UINT32) (((DOUBLE)(srcBytes)) * 1.01 + 64.0))
+
+//	function prototypes (compress == -1 means decompress, else it is the compression level)
+typedef const char* (CompressFunction)(UINT8 codec, void* src, UINT32 srcBytes, void* dst, UINT32* dstBytes, INT32 compress);
 
 //	export declaration
-BRAHMS_COMPRESS_VIS const char* Compress(void* src, UINT32 srcBytes, void* dst, UINT32* dstBytes, INT32 compress);
+BRAHMS_COMPRESS_VIS const char* CompressCodec(UINT8 codec, void* src, UINT32 srcBytes, void* dst, UINT32* dstBytes, INT32 compress);
 
 #endif // INCLUDED_BRAHMS_COMPRESS
@@ -0,0 +1,210 @@
+/*
+________________________________________________________________
+
+	This file is part of BRAHMS
+	Copyright (C) 2007 Ben Mitchinson
+	URL: http://brahms.sourceforge.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+________________________________________________________________
+
+*/
+
+#include "brahms-client.h"
+#include "lz.h"
+#include <cstring>
+
+////////////////	CONSTANTS
+
+const UINT32 LZ_MIN_MATCH = 4;
+const UINT32 LZ_MAX_OFFSET = 0xFFFF;
+const UINT32 LZ_HASH_BITS = 12;
+
+inline UINT32 lzRead32(const UINT8* p)
+{
+	UINT32 v;
+	memcpy(&v, p, 4);
+	return v;
+}
+
+inline UINT32 lzHash(UINT32 v)
+{
+	return (v * 2654435761U) >> (32 - LZ_HASH_BITS);
+}
+
+inline UINT8* lzWriteLength(UINT8* o, UINT32 len)
+{
+	//	extension bytes, after a nibble of 15
+	while (len >= 255)
+	{
+		*o++ = 255;
+		len -= 255;
+	}
+	*o++ = (UINT8)len;
+	return o;
+}
+
+////////////////	COMPRESS
+
+UINT32 lzBound(UINT32 srcBytes)
+{
+	return srcBytes + srcBytes / 255 + 16;
+}
+
+UINT32 lzCompress(const UINT8* src, UINT32 srcBytes, UINT8* dst)
+{
+	//	positions of last occurrence of each hashed 4-byte sequence
+	UINT32 table[1 << LZ_HASH_BITS];
+	memset(table, 0, sizeof(table));
+
+	const UINT8* ip = src;
+	const UINT8* anchor = src;
+	const UINT8* end = src + srcBytes;
+	UINT8* o = dst;
+
+	//	need at least LZ_MIN_MATCH bytes to look for a match
+	const UINT8* limit = srcBytes > LZ_MIN_MATCH ? end - LZ_MIN_MATCH : src;
+
+	UINT32 misses = 0;
+	while (ip < limit)
+	{
+		UINT32 v = lzRead32(ip);
+		UINT32 h = lzHash(v);
+		const UINT8* ref = src + table[h];
+		table[h] = (UINT32)(ip - src);
+
+		//	no match, skip ahead (faster the longer we go without a match)
+		if (ref >= ip || (UINT32)(ip - ref) > LZ_MAX_OFFSET || lzRead32(ref) != v)
+		{
+			ip += 1 + (misses++ >> 5);
+			continue;
+		}
+		misses = 0;
+
+		//	extend match
+		UINT32 matchLen = LZ_MIN_MATCH;
+		while (ip + matchLen < end && ip[matchLen] == ref[matchLen]) matchLen++;
+
+		//	emit token, literals, offset, match length
+		UINT32 litLen = (UINT32)(ip - anchor);
+		UINT8* token = o++;
+		*token = (UINT8)(((litLen >= 15 ? 15 : litLen) << 4) | ((matchLen - LZ_MIN_MATCH) >= 15 ? 15 : (matchLen - LZ_MIN_MATCH)));
+		if (litLen >= 15) o = lzWriteLength(o, litLen - 15);
+		memcpy(o, anchor, litLen);
+		o += litLen;
+		UINT32 offset = (UINT32)(ip - ref);
+		*o++ = (UINT8)(offset & 0xFF);
+		*o++ = (UINT8)(offset >> 8);
+		if (matchLen - LZ_MIN_MATCH >= 15) o = lzWriteLength(o, matchLen - LZ_MIN_MATCH - 15);
+
+		ip += matchLen;
+		anchor = ip;
+	}
+
+	//	last run, literals only
+	UINT32 litLen = (UINT32)(end - anchor);
+	*o++ = (UINT8)((litLen >= 15 ? 15 : litLen) << 4);
+	if (litLen >= 15) o = lzWriteLength(o, litLen - 15);
+	memcpy(o, anchor, litLen);
+	o += litLen;
+
+	return (UINT32)(o - dst);
+}
+
+////////////////	DECOMPRESS
+
+const char* lzDecompress(const UINT8* src, UINT32 srcBytes, UINT8* dst, UINT32* dstBytes)
+{
+	const UINT8* ip = src;
+	const UINT8* end = src + srcBytes;
+	UINT8* o = dst;
+	UINT8* oend = dst + *dstBytes;
+
+	while (ip < end)
+	{
+		//	token
+		UINT8 token = *ip++;
+
+		//	literals
+		UINT32 litLen = token >> 4;
+		if (litLen == 15)
+		{
+			UINT8 b;
+			do
+			{
+				if (ip >= end) return "LZ stream truncated (literal length)";
+				b = *ip++;
+				litLen += b;
+			}
+			while (b == 255);
+		}
+		if ((UINT32)(end - ip) < litLen) return "LZ stream truncated (literals)";
+		if ((UINT32)(oend - o) < litLen) return "LZ output overflow (literals)";
+		memcpy(o, ip, litLen);
+		ip += litLen;
+		o += litLen;
+
+		//	last run has no match
+		if (ip == end) break;
+
+		//	match
+		if (end - ip < 2) return "LZ stream truncated (offset)";
+		UINT32 offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if (!offset || offset > (UINT32)(o - dst)) return "LZ stream corrupt (offset)";
+		UINT32 matchLen = token & 0x0F;
+		if (matchLen == 15)
+		{
+			UINT8 b;
+			do
+			{
+				if (ip >= end) return "LZ stream truncated (match length)";
+				b = *ip++;
+				matchLen += b;
+			}
+			while (b == 255);
+		}
+		matchLen += LZ_MIN_MATCH;
+		if ((UINT32)(oend - o) < matchLen) return "LZ output overflow (match)";
+
+		//	byte-wise, since match may overlap output
+		const UINT8* ref = o - offset;
+		for (UINT32 i=0; i<matchLen; i++) o[i] = ref[i];
+		o += matchLen;
+	}
+
+	*dstBytes = (UINT32)(o - dst);
+	return 0;
+}
+
+////////////////	SHUFFLE
+
+void shuffle(const UINT8* src, UINT32 bytes, UINT32 width, UINT8* dst)
+{
+	UINT32 count = bytes / width;
+	for (UINT32 b=0; b<width; b++)
+		for (UINT32 e=0; e<count; e++)
+			dst[b * count + e] = src[e * width + b];
+	memcpy(dst + count * width, src + count * width, bytes - count * width);
+}
+
+void unshuffle(const UINT8* src, UINT32 bytes, UINT32 width, UINT8* dst)
+{
+	UINT32 count = bytes / width;
+	for (UINT32 b=0; b<width; b++)
+		for (UINT32 e=0; e<count; e++)
+			dst[e * width + b] = src[b * count + e];
+	memcpy(dst + count * width, src + count * width, bytes - count * width);
+}
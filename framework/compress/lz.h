@@ -0,0 +1,60 @@
+/*
+________________________________________________________________
+
+	This file is part of BRAHMS
+	Copyright (C) 2007 Ben Mitchinson
+	URL: http://brahms.sourceforge.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+________________________________________________________________
+
+*/
+
+////////////////	FAST LZ77 CODER (INTERNAL TO COMPRESS MODULE)
+
+#ifndef INCLUDED_BRAHMS_COMPRESS_LZ
+#define INCLUDED_BRAHMS_COMPRESS_LZ
+
+/*	DOCUMENTATION: COMPRESS_LZ
+
+	A byte-oriented LZ77 coder in the style of LZ4, trading ratio for
+	speed so that it can keep up with a local network link where
+	deflate cannot. The stream is a sequence of runs, each being a
+	token byte (high nibble literal count, low nibble match length
+	minus 4; 15 in either means extension bytes follow, 255 meaning
+	"add and continue"), the literals, then a 16-bit little-endian
+	back-reference offset and any match length extension bytes. The
+	last run has literals only.
+
+	The shuffle variants first transpose an array of 4- or 8-byte
+	elements so that byte n of every element is contiguous. For
+	arrays of floating-point numbers, this groups the sign/exponent
+	bytes (which vary little) together, which LZ then picks up.
+*/
+
+//	maximum size of output from lzCompress() for "srcBytes" input
+UINT32 lzBound(UINT32 srcBytes);
+
+//	compress, returning bytes written to "dst" (which must have lzBound() bytes)
+UINT32 lzCompress(const UINT8* src, UINT32 srcBytes, UINT8* dst);
+
+//	decompress into "dst" of capacity "*dstBytes", returning error string or NULL (*dstBytes is set to bytes written)
+const char* lzDecompress(const UINT8* src, UINT32 srcBytes, UINT8* dst, UINT32* dstBytes);
+
+//	transpose "bytes" bytes of "width"-byte elements (any remainder is copied as is), or invert that
+void shuffle(const UINT8* src, UINT32 bytes, UINT32 width, UINT8* dst);
+void unshuffle(const UINT8* src, UINT32 bytes, UINT32 width, UINT8* dst);
+
+#endif // INCLUDED_BRAHMS_COMPRESS_LZ
@@ -51,6 +51,9 @@ ________________________________________________________________
 #include <iostream>
 #include <deque>
 #include <fstream>
+#include <algorithm>
+#include <map>
+#include <set>
 using namespace std;
 
 //	include C headers (memset, memcpy, maths, etc.)
@@ -169,6 +169,7 @@ namespace brahms
 
 				CASE(EVENT_CONTENT_SET)
 				CASE(EVENT_CONTENT_GET)
+				CASE(EVENT_CONTENT_ADOPT)
 
 				CASE(EVENT_GENERIC_STRUCTURE_GET)
 				CASE(EVENT_GENERIC_STRUCTURE_SET)
@@ -54,8 +54,12 @@ namespace brahms
 				case IPMTAG_OUTPUTFOUND: return "IPMTAG_OUTPUTFOUND";
 				case IPMTAG_OUTPUTNOTFOUND: return "IPMTAG_OUTPUTNOTFOUND";
 				case IPMTAG_ENDPHASE: return "IPMTAG_ENDPHASE";
+				case IPMTAG_FINDOUTPUTS: return "IPMTAG_FINDOUTPUTS";
+				case IPMTAG_OUTPUTSFOUND: return "IPMTAG_OUTPUTSFOUND";
+				case IPMTAG_OUTPUTRELAYED: return "IPMTAG_OUTPUTRELAYED";
 				case IPMTAG_PUSHRATES: return "IPMTAG_PUSHRATES";
 				case IPMTAG_PUSHBASERATE: return "IPMTAG_PUSHBASERATE";
+				case IPMTAG_PUSHPARTITION: return "IPMTAG_PUSHPARTITION";
 				case IPMTAG_PUSHDATA: return "IPMTAG_PUSHDATA";
 				case IPMTAG_USEDDATA: return "IPMTAG_USEDDATA";
 				case IPMTAG_QUERYBUFFER: return "IPMTAG_QUERYBUFFER";
@@ -63,10 +63,14 @@ namespace brahms
 			/* NOTE! now that we send IPMTAG_ANNOUNCEOUTPUT, peers know what each other has available, so
 				IPMTAG_OUTPUTNOTFOUND should *never* get sent! */
 		const UINT8 IPMTAG_ENDPHASE			= 0x25;			//	used to advise all remote voices that we are finished with our inlet requests for this pass
+		const UINT8 IPMTAG_FINDOUTPUTS		= 0x26;			//	batched IPMTAG_FINDOUTPUT (data is a sequence of NULL-terminated SystemML identifiers)
+		const UINT8 IPMTAG_OUTPUTSFOUND		= 0x27;			//	batched answer to IPMTAG_FINDOUTPUTS (data is, per request, msgStreamID then serialized data object)
+		const UINT8 IPMTAG_OUTPUTRELAYED	= 0x28;			//	answer that the output is to be asked for from a voice that relays it (data is index of that voice, as text)
 
 		//	messages used during baserate negotiation
 		const UINT8 IPMTAG_PUSHRATES		= 0x31;			//	push all of our requested sample rates to the master (zeroth) voice
 		const UINT8 IPMTAG_PUSHBASERATE		= 0x32;			//	push back the calculated system-wide baserate from the master voice to the other voices
+		const UINT8 IPMTAG_PUSHPARTITION	= 0x33;			//	push the traffic-aware process placement from the master voice to the other voices
 
 		//	reporting limit
 		const UINT8 IPMTAG_MAX_D_VERB		= 0x40;
@@ -80,10 +84,18 @@ namespace brahms
 		const UINT8 IPMTAG_UNDEFINED		= 0xFF;			//	undefined tag marker
 		const UINT16 IPMVOICE_UNDEFINED		= 0xFFFF;
 		const UINT32 IPM_UNDEFINED			= 0xFFFFFFFF;
+		const UINT32 IPM_RELAYED			= 0xFFFFFFFE;		//	msgStreamID in IPMTAG_OUTPUTSFOUND of an output to be asked for from a relay (serial is index of relay voice)
 
 		//	formats
 		const UINT8	IPMFMT_UNCOMPRESSED		= 0x00;
 		const UINT8	IPMFMT_DEFLATE			= 0x01;
+		const UINT8	IPMFMT_ZRLE				= 0x02;			//	zero-run-length coding (see encode.h)
+		const UINT8	IPMFMT_LZ				= 0x03;			//	fast LZ77 (see compress.h, values of codecs must match)
+		const UINT8	IPMFMT_SHUFFLE4_LZ		= 0x04;			//	byte-shuffle of 4-byte elements, then LZ
+		const UINT8	IPMFMT_SHUFFLE8_LZ		= 0x05;			//	byte-shuffle of 8-byte elements, then LZ
+		const UINT8	IPMFMT_CODEC_MASK		= 0x0F;			//	low nibble is codec, high nibble is stream encoding flags
+		const UINT8	IPMFMT_XOR				= 0x10;			//	payload is XOR against previous payload on this msgStreamID
+		const UINT8	IPMFMT_KEYFRAME			= 0x20;			//	payload is raw, and is the reference for subsequent IPMFMT_XOR payloads
 
 		string TranslateIPMTAG(UINT8 tag);
 
@@ -38,6 +38,7 @@ ________________________________________________________________
 #include <sys/time.h>
 #include <errno.h>
 #include <unistd.h>
+#include <sched.h>
 
 #endif
 
@@ -400,6 +401,37 @@ namespace brahms
 
 
 
+		bool Signal::test()
+		{
+
+		#ifdef __WIN__
+
+			//	auto-reset, so this unsets it if it was set
+			return WaitForSingleObject(hSignal, 0) == WAIT_OBJECT_0;
+
+		#endif
+
+		#ifdef __NIX__
+
+			//	acquire exclusive access to state
+			if (pthread_mutex_lock(&mutex)) ferr << E_OS << "failed to test signal (lock mutex)";
+
+			//	take signal if set
+			bool wasSet = state;
+			state = false;
+
+			//	release exclusive access to state
+			if (pthread_mutex_unlock(&mutex)) ferr << E_OS << "failed to test signal (unlock mutex)";
+
+			//	ok
+			return wasSet;
+
+		#endif
+
+		}
+
+
+
 ////////////////	TIMER
 
 		/*	DOCUMENTATION: TIMER
@@ -536,6 +568,19 @@ namespace brahms
 
 		}
 
+		void yield()
+		{
+
+		#ifdef __WIN__
+			SwitchToThread();
+		#endif
+
+		#ifdef __NIX__
+			sched_yield();
+		#endif
+
+		}
+
 
 
 ////////////////	NAMESPACE
@@ -115,6 +115,7 @@ namespace brahms
 			//	interface
 			void set();
 			Symbol waitfor();
+			bool test(); // as waitfor(), but return false at once if not set
 
 		private:
 
@@ -154,6 +155,7 @@ namespace brahms
 
             // Additional functions
             void msleep(UINT32 msec);
+            void yield();
 	}
 }
 
@@ -113,6 +113,14 @@ namespace brahms
 			return ret;
 		}
 
+		string u2s(UINT64 val)
+		{
+			//	unlike n2s(), exact for large values
+			stringstream ss;
+			ss << val;
+			return ss.str();
+		}
+
 		string h2s(UINT64 val, UINT32 width)
 		{
 			stringstream ss;
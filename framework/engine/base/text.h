@@ -81,6 +81,7 @@ namespace brahms
 		string sampleRateToString(SampleRate& sr);
 		string n2s(DOUBLE val, UINT32 width = 0);
 		string h2s(UINT64 val, UINT32 width = 0);
+		string u2s(UINT64 val);
 		const DOUBLE S2N_FAILED = 1.23456789e308;
 		DOUBLE s2n(const string &s);
 	}
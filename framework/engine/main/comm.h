@@ -96,8 +96,8 @@ namespace brahms
 			//	map compress function
 			if (module)
 			{
-				compressFunction = (CompressFunction*) module->map("Compress");
-				if (!compressFunction) ferr << E_INTERNAL << "module \"" << path << "\" did not export \"compressFunction()\"";
+				compressFunction = (CompressFunction*) module->map("CompressCodec");
+				if (!compressFunction) ferr << E_INTERNAL << "module \"" << path << "\" did not export \"CompressCodec()\"";
 			}
 
 			//	map channel module
@@ -116,6 +116,7 @@ namespace brahms
 			{
 				case brahms::channel::PROTOCOL_MPI: brahms::text::grep(path, "((PROTOCOL))", "mpich2"); break;
 				case brahms::channel::PROTOCOL_SOCKETS: brahms::text::grep(path, "((PROTOCOL))", "sockets"); break;
+				case brahms::channel::PROTOCOL_LOOPBACK: brahms::text::grep(path, "((PROTOCOL))", "loopback"); break;
 				default: ferr << E_INTERNAL << "protocol unrecognised";
 			}
 			module = engineData.loader.loadModule(path.c_str(), engineData.core.caller.tout, &engineData.systemInfo, NULL, 0);
@@ -161,7 +162,9 @@ namespace brahms
 				}
 
 				//	init channel module
+				brahms::channel::CommsInitFunc* commsInitFunc = NULL;
 				brahms::channel::CreateChannelFunc* createChannelFunc = NULL;
+				initChannelModule(engineData, voice.protocol, commsInitFunc, createChannelFunc);
 
 				//	have comms module create the channel
 				brahms::channel::ChannelInitData initData;
@@ -447,43 +450,54 @@ namespace brahms
 		{
 			tout << "synchronizing with peers..." << D_VERB;
 
-			//	send SYNC to all peers
-			for (INT32 remoteVoiceIndex=0; remoteVoiceIndex<((INT32)channels.size()); remoteVoiceIndex++)
+			/*	DOCUMENTATION: DISSEMINATION_BARRIER
+
+				In round r, we send SYNC to the voice 2^r ahead of us (modulo
+				the voice count) and wait for SYNC from the voice 2^r behind
+				us. After ceil(log2(V)) rounds, every voice has heard, directly
+				or through others, from every other voice, so the barrier costs
+				V log V messages in log V rounds, rather than V^2 messages. The
+				distances 2^r are all different and all less than V, so each
+				round uses a different channel, and the round number, carried in
+				"order", lets us check that nothing has arrived out of turn.
+			*/
+
+			VoiceIndex voiceCount = channels.size();
+			VoiceIndex voiceIndex = engineData.core.getVoiceIndex();
+			UINT32 round = 0;
+			for (VoiceIndex distance=1; distance<voiceCount; distance*=2, round++)
 			{
-				//	except ourselves
-				if (!channels[remoteVoiceIndex]) continue;
+				VoiceIndex to = (voiceIndex + distance) % voiceCount;
+				VoiceIndex from = (voiceIndex + voiceCount - distance) % voiceCount;
 
 				//	send signal
-				brahms::base::IPM* ipms = engineData.pool.get(brahms::base::IPMTAG_SYNC, remoteVoiceIndex);
-				channels[remoteVoiceIndex]->push(ipms, &tout);
-			}
-
-			//	recv SYNC from all peers
-			for (VoiceIndex remoteVoiceIndex=0; remoteVoiceIndex<channels.size(); remoteVoiceIndex++)
-			{
-				//	except ourselves
-				if (!channels[remoteVoiceIndex]) continue;
+				brahms::base::IPM* ipms = engineData.pool.get(brahms::base::IPMTAG_SYNC, to);
+				ipms->header().order = round;
+				channels[to]->push(ipms, &tout);
 
 				//	receive message
 				brahms::base::IPM* ipmr;
-				while (channels[remoteVoiceIndex]->pull(ipmr, brahms::base::IPMTAG_UNDEFINED, fout, brahms::channel::COMMS_TIMEOUT_DEFAULT) != C_OK)
+				while (channels[from]->pull(ipmr, brahms::base::IPMTAG_UNDEFINED, fout, brahms::channel::COMMS_TIMEOUT_DEFAULT) != C_OK)
 				{
 					//	call again, until we get a message of some sort
 					brahms::os::msleep(1);
 				}
 
-				//	get tag
+				//	get tag and round
 				UINT8 tag = ipmr->header().tag;
+				UINT32 order = ipmr->header().order;
 
 				//	discard message
 				ipmr->release();
 
 				//	check
 				if (tag != brahms::base::IPMTAG_SYNC)
-					ferr << E_COMMS << "invalid sync response from peer " << unitIndex(remoteVoiceIndex) << " (" << brahms::base::TranslateIPMTAG(tag) << ")";
+					ferr << E_COMMS << "invalid sync response from peer " << unitIndex(from) << " (" << brahms::base::TranslateIPMTAG(tag) << ")";
+				if (order != round)
+					ferr << E_COMMS << "sync from peer " << unitIndex(from) << " was for round " << order << " (expected " << round << ")";
 
 				//	ok
-				tout << "received IPMTAG_SYNC from  voice " << unitIndex(remoteVoiceIndex) << D_FULL;
+				tout << "received IPMTAG_SYNC from  voice " << unitIndex(from) << " (round " << round << ")" << D_FULL;
 			}
 		}
 
@@ -279,9 +279,11 @@ void Engine::close()
 				//Event moduleEvent = createEvent(EVENT_LOG_TERM, 0, wrappers[p]->hProcess, &pevent);
 				process->logEvent.type = EVENT_LOG_TERM;
 				process->logEvent.tout = &fout;
+				pevent.spilled = 0;
 
 				//	have thread fire it
 				workers.fireSingleEvent(process->logEvent);
+				engineData.logMemory.spilled += pevent.spilled;
 
 				//	might have returned an XML node (or might have nothing to contribute)
 				if (pevent.result)
@@ -324,10 +326,12 @@ void Engine::close()
 					//	set from initialisation.
 					port->logEvent.type = EVENT_LOG_TERM;
 					port->logEventData.source = NULL;
+					port->logEventData.spilled = 0;
 					port->logEvent.tout = &fout;
 
 					//	fire event from caller thread
 					port->logEvent.fire();
+					engineData.logMemory.spilled += port->logEventData.spilled;
 
 					//	should have returned an XML node
 					if (!port->logEventData.result)
@@ -474,6 +478,20 @@ void Engine::close()
 		XMLNode* nodeTiming = nodePerformance->appendChild(new XMLNode("Timing"));
 		nodeTiming->appendChild(new XMLNode("TimeRunPhase", engineData.environment.gets("TimeRunPhase").c_str()));
 
+		//	memory held by logs, and what did not fit (see LOG_MEMORY_BUDGET)
+		XMLNode* nodeLogMemory = nodePerformance->appendChild(new XMLNode("LogMemory"));
+		bool unlimited = engineData.logMemory.budget == ~UINT64(0);
+		nodeLogMemory->appendChild(new XMLNode("Budget", unlimited ? "unlimited" : brahms::text::u2s(engineData.logMemory.budget).c_str()));
+		nodeLogMemory->appendChild(new XMLNode("Held", brahms::text::u2s(engineData.logMemory.held).c_str()));
+		nodeLogMemory->appendChild(new XMLNode("Spilled", brahms::text::u2s(engineData.logMemory.spilled).c_str()));
+
+		//	output data sizes, for VoicePartition in later runs
+		system.reportTraffic(nodePerformance->appendChild(new XMLNode("Traffic")));
+
+		//	per-channel and per-link comms telemetry (concerto only)
+		if (engineData.core.getVoiceCount() > 1)
+			system.reportComms(nodePerformance->appendChild(new XMLNode("Comms")));
+
 
 
 ////////////////	ADD TIMING TO OUTPUT
@@ -509,6 +527,10 @@ void Engine::close()
 				string tdata = n2s(irt->init) + " " + n2s(irt->run) + " " + n2s(irt->term);
 
 				/*XMLNode* nodeIRT = */nodeProcess->appendChild(new XMLNode("IRT", tdata.c_str()));
+
+				//	rollback statistics (see OPTIMISTIC_EXECUTION)
+				if (process->speculation)
+					process->speculation->report(nodeProcess);
 			}
 		}
 
@@ -606,11 +628,26 @@ void Engine::close()
 		{
 			//	write system state file
 			fout << "writing system file..." << D_VERB;
-			ofstream fileSysOut(engineData.execution.fileSysOut.c_str());
-			if (!fileSysOut) ferr << E_OS << "error opening system out file \"" << engineData.execution.fileSysOut << "\"";
+
+			//	state not yet parsed is copied from the System File as it is written, which
+			//	may be the same file, so write alongside and move into place when done
+			string pathSysOut = engineData.execution.fileSysOut;
+			string pathSysOutTemp = pathSysOut + ".tmp";
+			ofstream fileSysOut(pathSysOutTemp.c_str());
+			if (!fileSysOut) ferr << E_OS << "error opening system out file \"" << pathSysOutTemp << "\"";
 			fileSysOut << "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?>\n";
 			system.nodeSystem.serialize(fileSysOut, indent);
 			fileSysOut.close();
+			if (!fileSysOut) ferr << E_OS << "error writing system out file \"" << pathSysOutTemp << "\"";
+
+			//	unmap the System File (see XML_DEFERRED_CONTENT) so it can be replaced
+			system.nodeSystem.releaseSources();
+#ifdef __WIN__
+			if (!MoveFileExA(pathSysOutTemp.c_str(), pathSysOut.c_str(), MOVEFILE_REPLACE_EXISTING))
+#else
+			if (rename(pathSysOutTemp.c_str(), pathSysOut.c_str()))
+#endif
+				ferr << E_OS << "error moving \"" << pathSysOutTemp << "\" to \"" << pathSysOut << "\"";
 		}
 		else fout << "not writing system file (not requested)" << D_VERB;
 
@@ -198,6 +198,18 @@ namespace brahms
                     engineData.core.setVoiceCount(voiceCount); // TODO: wtf? might be changed by call to execution.load() but it's a bit weird, this
                     engineData.core.setVoiceIndex(voiceIndex); // TODO: wtf?
 
+                    //	if all voices are in this process, they talk over loopback, whatever the file says
+                    if (engineData.core.createEngine.engineFlags & F_LOOPBACK)
+                    {
+                        for (VoiceIndex v=0; v<engineData.execution.voices.size(); v++)
+                        {
+                            if (v == voiceIndex) continue;
+                            engineData.execution.voices[v].protocol = brahms::channel::PROTOCOL_LOOPBACK;
+                            engineData.execution.voices[v].address = "loopback";
+                            fout << "channel to voice " << unitIndex(v) << ": LOOPBACK" << D_VERB;
+                        }
+                    }
+
                     //	set SupplementaryFilePath to System File (in) path to start with
                     //	this will be changed later during log collection to the appropriate
                     //	path (either System File (out) path during EVENT_STATE_GET or
@@ -262,6 +274,8 @@ namespace brahms
                 engineData.execParsComponent.appendChild(new XMLNode("VoiceID", engineData.environment.gets("VoiceID").c_str()));
                 engineData.execParsComponent.appendChild(new XMLNode("WorkingDirectory",
                                                                      engineData.environment.gets("WorkingDirectory").c_str()));
+                engineData.execParsComponent.appendChild(new XMLNode("DataMLBinaryThreshold",
+                                                                     engineData.environment.gets("DataMLBinaryThreshold").c_str()));
 
                 //engineData.WorkingDirectory = engineData.environment.gets("WorkingDirectory");
                 //engineData.SupplementaryFilePath = engineData.environment.gets("SupplementaryFilePath");
@@ -278,6 +292,55 @@ namespace brahms
                 else if (bp == "OnlyMemory") engineData.systemInfo.BufferingPolicy = C_BUFFERING_ONLY_MEMORY;
                 else ferr << "invalid value of BufferingPolicy, \"" << bp << "\"";
 
+                /*	DOCUMENTATION: LOG_MEMORY_BUDGET
+
+                	Encapsulated logs are held in memory until they are laid
+                	into the Report File, so a long run can hold more than
+                	the machine has. Each voice therefore has a budget for
+                	them. At EVENT_LOG_INIT, a data object that knows how
+                	much it will hold takes that from what is left of the
+                	budget (EventLog::memoryBudget); if it does not fit, it
+                	"spills" the log, writing it to the file it would have
+                	had if it were not encapsulated, and the Report File
+                	refers to that file (s="b") rather than holding the log.
+                	Logs under 1MB are never spilled, so that they don't
+                	each hold a file open for the run. The Report File
+                	gives the budget, and what was held and spilled.
+
+                	The budget is LogMemoryBudget (MB), or if that is zero,
+                	a share of physical memory set by BufferingPolicy:
+
+                		OnlyDisk		nothing (every such log of 1MB or more spills)
+                		FavourDisk		one eighth
+                		Balanced		one quarter
+                		FavourMemory	one half
+                		OnlyMemory		no limit (nothing spills)
+
+                	OnlyDisk and OnlyMemory ignore LogMemoryBudget. The
+                	policy also governs unencapsulated logs: the disk
+                	policies write through bounded buffers rather than the
+                	page cache, and OnlyMemory holds them in memory until
+                	EVENT_LOG_TERM.
+                */
+
+                UINT64 physical = brahms::os::getphysicalmemory();
+                UINT64 budget = UINT64(engineData.environment.getu("LogMemoryBudget")) << 20;
+                switch (engineData.systemInfo.BufferingPolicy)
+                {
+                    case C_BUFFERING_ONLY_DISK: budget = 0; break;
+                    case C_BUFFERING_FAVOUR_DISK: if (!budget) budget = physical / 8; break;
+                    case C_BUFFERING_BALANCED: if (!budget) budget = physical / 4; break;
+                    case C_BUFFERING_FAVOUR_MEMORY: if (!budget) budget = physical / 2; break;
+                    case C_BUFFERING_ONLY_MEMORY: budget = ~UINT64(0); break;
+                }
+
+                //	unknown physical memory is no limit
+                if (!physical && engineData.systemInfo.BufferingPolicy != C_BUFFERING_ONLY_DISK && !engineData.environment.getu("LogMemoryBudget"))
+                    budget = ~UINT64(0);
+
+                engineData.logMemory.budget = budget;
+                fout << "log memory budget is " << (budget == ~UINT64(0) ? string("unlimited") : brahms::text::u2s(budget >> 20) + "MB") << D_VERB;
+
             }
 
             { FOUT_SECTION("Initialise Monitor")
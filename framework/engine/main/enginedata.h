@@ -75,6 +75,10 @@ namespace brahms
 			flag_allowCreatePort = false;
 
 			systemInfo.engineVersion = VERSION_ENGINE;
+
+			logMemory.budget = 0;
+			logMemory.held = 0;
+			logMemory.spilled = 0;
 		}
 
 		//	flags
@@ -83,6 +87,15 @@ namespace brahms
 		//	engine-global system information object
 		ExecutionInfo systemInfo;
 
+		//	memory for logs held in memory, in bytes (see LOG_MEMORY_BUDGET)
+		struct
+		{
+			UINT64 budget;
+			UINT64 held;
+			UINT64 spilled;
+		}
+		logMemory;
+
 		//	timer - NOTE this is for the exclusive use
 		//	of the caller thread (the thread making
 		//	calls on the engine)
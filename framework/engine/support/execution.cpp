@@ -232,6 +232,26 @@ namespace brahms
 			return origins;
 		}
 
+		UINT32 translateDecimate(const char* cdecimate)
+		{
+			DOUBLE decimate = s2n(cdecimate);
+			if (decimate == S2N_FAILED || decimate < 1.0 || decimate != (DOUBLE)(UINT32)decimate)
+				ferr << "invalid value for \"decimate\" (\"" << cdecimate << "\" is not a positive integer)";
+			return (UINT32) decimate;
+		}
+
+		Symbol translateAggregate(const char* caggregate)
+		{
+			string aggregate = caggregate;
+			if (aggregate == "first") return C_LOG_DECIMATE;
+			if (aggregate == "mean") return C_LOG_MEAN;
+			if (aggregate == "min") return C_LOG_MIN;
+			if (aggregate == "max") return C_LOG_MAX;
+			if (aggregate == "rms") return C_LOG_RMS;
+			ferr << "invalid value for \"aggregate\" (\"" << aggregate << "\" should be first, mean, min, max or rms)";
+			return S_NULL;
+		}
+
 
 
 	////////////////	EXECUTION
@@ -246,6 +266,9 @@ namespace brahms
 				case brahms::channel::PROTOCOL_SOCKETS:
 					return "SOCKETS";
 
+				case brahms::channel::PROTOCOL_LOOPBACK:
+					return "LOOPBACK";
+
 				default:
 					return "<unknown protocol>";
 			}
@@ -267,16 +290,12 @@ namespace brahms
 
 		////////////////	PARSE XML
 
-			ifstream fileExecution(path.c_str());
-			if (!fileExecution) ferr << E_OS << "error opening \"" << path << "\"";
 			try
 			{
-				nodeExecution.parse(fileExecution);
+				nodeExecution.parseFile(path.c_str());
 			}
 			CATCH_TRACE_RETHROW("parsing \"" + string(path) + "\"")
 
-			fileExecution.close();
-
 		////////////////	VOICES
 
 			/*
@@ -294,9 +313,9 @@ namespace brahms
 			UINT32 fileVoiceCount = nodesVoice->size();
 			if (*voiceCount)
 			{
-				//	already set (by MPI) - check it tallies with that specified in file
+				//	already set (by MPI, or by --loopback) - check it tallies with that specified in file
 				if (*voiceCount != fileVoiceCount)
-					ferr << E_INVOCATION << "Execution File specified " << fileVoiceCount  << " voices, but " << *voiceCount << " were started by MPI";
+					ferr << E_INVOCATION << "Execution File specified " << fileVoiceCount  << " voices, but " << *voiceCount << " were started";
 			}
 			else
 			{
@@ -427,7 +446,8 @@ namespace brahms
 			if (fileReport.find("/") == string::npos && fileReport.find("\\") == string::npos)
 				fileReport = workingDirectory + "/" + fileReport;
 
-			//	fix ((VOICE)) token in report file
+			//	fix ((VOICE)) token in report file (keeping the form, so other voices' reports can be found)
+			fileReportForm = fileReport;
 			ostringstream idxString;
 			idxString << unitIndex(*voiceIndex);
 			brahms::text::grep(fileReport, "((VOICE))", idxString.str());
@@ -511,6 +531,34 @@ namespace brahms
 					defaultLogMode.encapsulated = (bool) atof(nodeLogs->getAttribute("Encapsulated"));
 				}
 
+				//	get attribute compressed
+				if (nodeLogs->hasAttribute("Compressed"))
+				{
+					//	also acts as the default compressed
+					defaultLogMode.compressed = (bool) atof(nodeLogs->getAttribute("Compressed"));
+				}
+
+				//	get attribute chunked
+				if (nodeLogs->hasAttribute("Chunked"))
+				{
+					//	also acts as the default chunked
+					defaultLogMode.chunked = (bool) atof(nodeLogs->getAttribute("Chunked"));
+				}
+
+				//	get attribute decimate
+				if (nodeLogs->hasAttribute("Decimate"))
+				{
+					//	also acts as the default decimate
+					defaultLogMode.decimate = translateDecimate(nodeLogs->getAttribute("Decimate"));
+				}
+
+				//	get attribute aggregate
+				if (nodeLogs->hasAttribute("Aggregate"))
+				{
+					//	also acts as the default aggregate
+					defaultLogMode.aggregate = translateAggregate(nodeLogs->getAttribute("Aggregate"));
+				}
+
 				//	get attribute recurse
 				if (nodeLogs->hasAttribute("Recurse"))
 				{
@@ -536,13 +584,25 @@ namespace brahms
 					bool encapsulated = defaultLogMode.encapsulated;
 					if (nodeLog->hasAttribute("Encapsulated"))
 						encapsulated = (bool) atof(nodeLog->getAttribute("Encapsulated"));
+					bool compressed = defaultLogMode.compressed;
+					if (nodeLog->hasAttribute("Compressed"))
+						compressed = (bool) atof(nodeLog->getAttribute("Compressed"));
+					bool chunked = defaultLogMode.chunked;
+					if (nodeLog->hasAttribute("Chunked"))
+						chunked = (bool) atof(nodeLog->getAttribute("Chunked"));
+					UINT32 decimate = defaultLogMode.decimate;
+					if (nodeLog->hasAttribute("Decimate"))
+						decimate = translateDecimate(nodeLog->getAttribute("Decimate"));
+					Symbol aggregate = defaultLogMode.aggregate;
+					if (nodeLog->hasAttribute("Aggregate"))
+						aggregate = translateAggregate(nodeLog->getAttribute("Aggregate"));
 					vector<LogOriginSeconds> origins = defaultLogMode.origins;
 					if (nodeLog->hasAttribute("Window"))
 						origins = translateWindow(nodeLog->getAttribute("Window"));
 					bool recurse = defaultLogMode.recurse;
 					if (nodeLog->hasAttribute("Recurse"))
 						recurse = (bool) atof(nodeLog->getAttribute("Recurse"));
-					logRules.push_back(LogRule(nodeLog->nodeText(), precision, encapsulated, recurse, origins));
+					logRules.push_back(LogRule(nodeLog->nodeText(), precision, encapsulated, compressed, chunked, decimate, aggregate, recurse, origins));
 				}
 			}
 		}
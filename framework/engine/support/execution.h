@@ -141,19 +141,31 @@ namespace brahms
 			{
 				precision = PRECISION_DO_NOT_LOG;
 				encapsulated = false;
+				compressed = false;
+				chunked = false;
+				decimate = 1;
+				aggregate = C_LOG_DECIMATE;
 				recurse = true;
 			}
 
-			LogMode(INT32 p_precision, bool p_encapsulated, bool p_recurse, vector<LogOriginSeconds>& p_origins)
+			LogMode(INT32 p_precision, bool p_encapsulated, bool p_compressed, bool p_chunked, UINT32 p_decimate, Symbol p_aggregate, bool p_recurse, vector<LogOriginSeconds>& p_origins)
 			{
 				precision = p_precision;
 				encapsulated = p_encapsulated;
+				compressed = p_compressed;
+				chunked = p_chunked;
+				decimate = p_decimate;
+				aggregate = p_aggregate;
 				recurse = p_recurse;
 				origins = p_origins;
 			}
 
 			INT32 precision;
 			bool encapsulated;
+			bool compressed;
+			bool chunked;
+			UINT32 decimate;		//	log one sample per "decimate" serviced
+			Symbol aggregate;		//	how those are reduced to one (C_LOG_*)
 			bool recurse;
 			vector<LogOriginSeconds> origins;
 		};
@@ -168,10 +180,10 @@ namespace brahms
 			{
 			}
 
-			LogRule(string p_name, INT32 p_precision, bool p_encapsulated, bool p_recurse, vector<LogOriginSeconds>& p_origins)
+			LogRule(string p_name, INT32 p_precision, bool p_encapsulated, bool p_compressed, bool p_chunked, UINT32 p_decimate, Symbol p_aggregate, bool p_recurse, vector<LogOriginSeconds>& p_origins)
 			{
 				name = p_name;
-				mode = LogMode(p_precision, p_encapsulated, p_recurse, p_origins);
+				mode = LogMode(p_precision, p_encapsulated, p_compressed, p_chunked, p_decimate, p_aggregate, p_recurse, p_origins);
 			}
 
 			string name;
@@ -204,6 +216,7 @@ namespace brahms
 			string					fileSysIn;
 			string					fileSysOut;
 			string					fileReport;			//	name of output file (ReportML)
+			string					fileReportForm;		//	name of output file, before ((VOICE)) is replaced
 			string					workingDirectory;
 			vector<Group>			groups;
 			vector<Voice>			voices;
@@ -509,6 +509,42 @@ namespace brahms
 
 		}
 
+		UINT64 getphysicalmemory()
+		{
+
+			//	if unknown, return 0
+			UINT64 ret = 0;
+
+		#ifdef __WIN__
+
+			MEMORYSTATUSEX status;
+			status.dwLength = sizeof(status);
+			if (GlobalMemoryStatusEx(&status))
+				ret = status.ullTotalPhys;
+
+		#endif
+
+		#ifdef __GLN__
+
+			long pages = sysconf(_SC_PHYS_PAGES);
+			long pageSize = sysconf(_SC_PAGESIZE);
+			if (pages > 0 && pageSize > 0)
+				ret = (UINT64) pages * (UINT64) pageSize;
+
+		#endif
+
+		#ifdef __OSX__
+
+			size_t size = sizeof(UINT64);
+			if (sysctlbyname("hw.memsize", &ret, &size, NULL, 0))
+				ret = 0; // unknown
+
+		#endif
+
+			return ret;
+
+		}
+
 		string getspecialfolder(string id)
 		{
 			if (id == "appdata.user")
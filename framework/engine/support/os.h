@@ -138,6 +138,7 @@ namespace brahms
 		string filenamepath(string filename);
 		void setprocesspriority(INT32 p);
 		UINT32 getnumprocessors();
+		UINT64 getphysicalmemory();
 		string getspecialfolder(string id);
 		bool mkdir(string path);
 		void msgbox(const char* msg);
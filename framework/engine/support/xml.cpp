@@ -34,6 +34,19 @@ ________________________________________________________________
 
 #include "support.h"
 
+#ifdef __WIN__
+#define WIN32_LEAN_AND_MEAN
+#include "windows.h"
+#endif
+
+#ifdef __NIX__
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 
 
 
@@ -90,7 +103,7 @@ namespace brahms
 			if (!text.length()) ferr << E_XML_PARSE << "stream was empty";
 		}
 
-		string parseat(const char* text, const char* next)
+		string parseat(const char* text, const char* next, const char* end)
 		{
 			//	assume this character was the first of the line
 			const char* begin = next;
@@ -128,29 +141,29 @@ namespace brahms
 			}
 
 			//	wind forward to end of line or N characters, whichever comes first
-			const char* end = next;
+			const char* stop = next;
 			while(true)
 			{
-				if (!*end) break; // EOF
-				if (*end == '\n') break; // EOL
-				if ((end - next) == N)
+				if (stop == end || !*stop) break; // EOF
+				if (*stop == '\n') break; // EOL
+				if ((stop - next) == N)
 				{
-					end -= 3;
+					stop -= 3;
 					break;
 				}
-				end++;
+				stop++;
 			}
 
 			//	add context
 			string context;
-			context.append(begin, end-begin);
+			context.append(begin, stop-begin);
 			for (string::iterator i=context.begin(); i!=context.end(); i++)
 				if (*i == '\t') *i = ' ';
 			at << context;
 
 			//	add termination
 			before++;
-			if (*end && *end != '\n') at << "...";
+			if (stop != end && *stop && *stop != '\n') at << "...";
 			at << "\"";
 			//if (*end == 0) at << " (end of file)"; // don't think we need this because the err msg always mentions EOF if it is relevant
 			at << "\n";
@@ -163,14 +176,282 @@ namespace brahms
 			return at.str();
 		}
 
-		void xmlparse(XMLNode* node, const char* text, const char*& next)
+
+
+	////////////////	DOCUMENT SOURCE
+
+		/*	DOCUMENTATION: XML_DEFERRED_CONTENT
+
+			A document read with parseFile() is mapped into memory
+			rather than read, and parsed in place. If a node name is
+			passed, the content of every element of that name below
+			the root is not parsed: the element gets its name and
+			attributes, and the parser skips to its close tag,
+			looking only at tag boundaries. The element keeps the
+			byte range of its content, and the mapping stays in
+			place while any element does.
+
+			The content is parsed the first time it is asked for
+			(its children or its text), and is then an ordinary
+			part of the document. A deferred element that is never
+			asked for is serialized by copying its bytes.
+
+			collapse() returns an element that was deferred, and has
+			since been parsed, to its byte range, discarding what
+			was parsed (including any changes to it). The engine
+			uses it after EVENT_STATE_SET, so that only one State
+			is parsed at a time.
+
+			The engine reads the System File this way, deferring
+			<State>, so that processes and links are built in one
+			pass over the file, and the (bulk of it) state data is
+			parsed only when EVENT_STATE_SET needs it, and freed
+			again after. A malformed State is therefore reported at
+			EVENT_STATE_SET rather than at load; the error still
+			gives the line and column in the file.
+
+			releaseSources() unmaps the file once the document has
+			been written, discarding any content still unparsed. The
+			engine calls it before moving the new System File into
+			place, which may be over the one that was read (on
+			Windows, a mapped file cannot be replaced).
+		*/
+
+		class XMLSource
+		{
+
+		public:
+
+			XMLSource(const char* path)
+			{
+				references = 1;
+				base = NULL;
+				bytes = 0;
+#ifdef __WIN__
+				hFile = INVALID_HANDLE_VALUE;
+				hMapping = NULL;
+#endif
+#ifdef __NIX__
+				fd = -1;
+#endif
+
+				const char* err = map(path);
+				if (err)
+				{
+					unmap();
+					ferr << E_OS << err << " \"" << path << "\"";
+				}
+
+				//	empty file is an error
+				if (!bytes)
+				{
+					unmap();
+					ferr << E_XML_PARSE << "stream was empty";
+				}
+			}
+
+			const char* begin() const
+			{
+				return base;
+			}
+
+			const char* end() const
+			{
+				return base + bytes;
+			}
+
+			void acquire()
+			{
+				brahms::os::MutexLocker locker(mutex);
+				references++;
+			}
+
+			void release()
+			{
+				bool last;
+				{
+					brahms::os::MutexLocker locker(mutex);
+					last = !--references;
+				}
+				if (last) delete this;
+			}
+
+		private:
+
+			~XMLSource()
+			{
+				unmap();
+			}
+
+			const char* map(const char* path)
+			{
+#ifdef __WIN__
+				hFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+				if (hFile == INVALID_HANDLE_VALUE) return "error opening";
+				LARGE_INTEGER size;
+				if (!GetFileSizeEx(hFile, &size)) return "error getting size of";
+				bytes = size.QuadPart;
+				if (!bytes) return NULL;
+				hMapping = CreateFileMapping(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+				if (!hMapping) return "error mapping";
+				base = (const char*) MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+				if (!base) return "error mapping";
+#endif
+#ifdef __NIX__
+				fd = ::open(path, O_RDONLY);
+				if (fd == -1) return "error opening";
+				struct stat st;
+				if (fstat(fd, &st)) return "error getting size of";
+				bytes = st.st_size;
+				if (bytes != (size_t)st.st_size) return "file too large to map";
+				if (!bytes) return NULL;
+				void* p = mmap(NULL, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (p == MAP_FAILED) return "error mapping";
+				base = (const char*) p;
+#endif
+				return NULL;
+			}
+
+			void unmap()
+			{
+#ifdef __WIN__
+				if (base) UnmapViewOfFile(base);
+				if (hMapping) CloseHandle(hMapping);
+				if (hFile != INVALID_HANDLE_VALUE) CloseHandle(hFile);
+#endif
+#ifdef __NIX__
+				if (base) munmap((void*)base, bytes);
+				if (fd != -1) ::close(fd);
+#endif
+				base = NULL;
+			}
+
+			//	not copyable (owns the mapping)
+			XMLSource(const XMLSource&);
+			XMLSource& operator=(const XMLSource&);
+
+			brahms::os::Mutex mutex;
+			UINT32 references;
+			const char* base;
+			size_t bytes;
+#ifdef __WIN__
+			HANDLE hFile;
+			HANDLE hMapping;
+#endif
+#ifdef __NIX__
+			int fd;
+#endif
+		};
+
+
+
+	////////////////	PARSER
+
+		struct ParseContext
+		{
+			const char* text;			//	start of document (for error positions)
+			const char* end;			//	end of document
+			XMLSource* source;			//	if not NULL, elements named...
+			const char* deferredName;	//	...this, below the root, are deferred
+		};
+
+		inline bool isxmlspace(char c)
+		{
+			return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+		}
+
+		//	first occurrence of "pattern" (of "length") in [p, end), or NULL
+		const char* findText(const char* p, const char* end, const char* pattern, size_t length)
+		{
+			while (end - p >= (ptrdiff_t)length)
+			{
+				p = (const char*) memchr(p, pattern[0], end - p - length + 1);
+				if (!p) return NULL;
+				if (!memcmp(p, pattern, length)) return p;
+				p++;
+			}
+			return NULL;
+		}
+
+		//	attach a parsed child (not a change to the document, so never read-only)
+		void adopt(XMLNode* node, XMLNode* child)
+		{
+			child->parent = node;
+			child->control = node->control;
+			node->element.children.push_back(child);
+		}
+
+		//	from just after the open tag of an element, the end of its close
+		//	tag, looking at nothing but tag boundaries (see XML_DEFERRED_CONTENT)
+		const char* skipElement(const ParseContext& ctx, const char* next)
+		{
+			const char* end = ctx.end;
+			UINT32 depth = 0;
+
+			while (true)
+			{
+				next = (const char*) memchr(next, '<', end - next);
+				if (!next) ferr << E_XML_PARSE << "unexpected end of file whilst tag open" << parseat(ctx.text, end, end);
+				next++;
+				if (next == end) ferr << E_XML_PARSE << "unexpected end of file in tag" << parseat(ctx.text, next, end);
+
+				//	command
+				if (*next == '?')
+				{
+					next = findText(next, end, "?>", 2);
+					if (!next) ferr << E_XML_PARSE << "unexpected end of file in command" << parseat(ctx.text, end, end);
+					next += 2;
+					continue;
+				}
+
+				//	comment
+				if (*next == '!')
+				{
+					next = findText(next + 1, end, "-->", 3);
+					if (!next) ferr << E_XML_PARSE << "unexpected end of file in comment" << parseat(ctx.text, end, end);
+					next += 3;
+					continue;
+				}
+
+				//	close tag
+				if (*next == '/')
+				{
+					next = (const char*) memchr(next, '>', end - next);
+					if (!next) ferr << E_XML_PARSE << "unexpected end of file in tag" << parseat(ctx.text, end, end);
+					next++;
+					if (!depth) return next;
+					depth--;
+					continue;
+				}
+
+				//	open tag (attribute values may hold '>')
+				while (next < end && *next != '>')
+				{
+					if (*next == '\"')
+					{
+						next = (const char*) memchr(next + 1, '\"', end - next - 1);
+						if (!next) ferr << E_XML_PARSE << "unexpected end of file in attribute value" << parseat(ctx.text, end, end);
+					}
+					next++;
+				}
+				if (next == end) ferr << E_XML_PARSE << "unexpected end of file in tag" << parseat(ctx.text, next, end);
+				if (*(next-1) != '/') depth++;
+				next++;
+			}
+		}
+
+		void xmlparse(XMLNode* node, const ParseContext& ctx, const char*& next)
 		{
 			//	text remainder
 			string parsedText;
 			bool nonWhitespaceTextContent = false;
 
+			//	document
+			const char* text = ctx.text;
+			const char* end = ctx.end;
+
 			//	parse
-			while(*next)
+			while(next < end)
 			{
 
 				//	switch on character type
@@ -184,24 +465,15 @@ namespace brahms
 						next++;
 
 						//	EOF?
-						if (!*next) ferr << E_XML_PARSE << "unexpected end of file in tag" << parseat(text, next);
+						if (next == end) ferr << E_XML_PARSE << "unexpected end of file in tag" << parseat(text, next, end);
 
 						//	could be a command tag <?
 						if (*next == '?')
 						{
 							//	advance until we see ?> and then continue
-							while(true)
-							{
-								next++;
-
-								if (!*next) ferr << E_XML_PARSE << "unexpected end of file in command" << parseat(text, next);
-								if (*next == '>' && *(next-1) == '?')
-								{
-									next++;
-
-									break;
-								}
-							}
+							next = findText(next, end, "?>", 2);
+							if (!next) ferr << E_XML_PARSE << "unexpected end of file in command" << parseat(text, end, end);
+							next += 2;
 							continue;
 						}
 
@@ -209,18 +481,9 @@ namespace brahms
 						if (*next == '!')
 						{
 							//	advance until we see --> and then continue
-							while(true)
-							{
-								next++;
-
-								if (!*next) ferr << E_XML_PARSE << "unexpected end of file in comment" << parseat(text, next);
-								if (*next == '>' && *(next-1) == '-' && *(next-2) == '-')
-								{
-									next++;
-
-									break;
-								}
-							}
+							next = findText(next + 1, end, "-->", 3);
+							if (!next) ferr << E_XML_PARSE << "unexpected end of file in comment" << parseat(text, end, end);
+							next += 3;
 							continue;
 						}
 
@@ -241,71 +504,57 @@ namespace brahms
 						if (open && nonWhitespaceTextContent)
 						{
 							next--; // retire to '<' character (we've moved on to first char of tag name)
-							ferr << E_XML_PARSE << "mixed content not handled by this parser" << parseat(text, next);
+							ferr << E_XML_PARSE << "mixed content not handled by this parser" << parseat(text, next, end);
 						}
 
 						//	must be a normal tag
-						if (!brahms::istokenstart(*next))
-							ferr << E_XML_PARSE << "not tag name start character" << parseat(text, next);
+						if (next == end || !brahms::istokenstart(*next))
+							ferr << E_XML_PARSE << "not tag name start character" << parseat(text, next, end);
 
-						//	start collecting tag name with that first character
-						string parsedTagName;
-						parsedTagName += *next;
-						next++;
-
-						//	get rest of tag name
-						while(brahms::istokencontinue(*next))
-						{
-							parsedTagName += *next;
+						//	tag name
+						const char* name = next++;
+						while(next < end && brahms::istokencontinue(*next))
 							next++;
-						}
+						string parsedTagName(name, next - name);
 
 						//	close tag must end there
-						if (close && (*next != '>'))
-							ferr << E_XML_PARSE << "expected '>'" << parseat(text, next);
+						if (close && (next == end || *next != '>'))
+							ferr << E_XML_PARSE << "expected '>'" << parseat(text, next, end);
 
 						//	now look for attributes
-						vector<XMLAttr> parsedAttributes;
+						XMLAttrList parsedAttributes;
 						while(true)
 						{
+							if (next == end)
+								ferr << E_XML_PARSE << "unexpected character whilst parsing tag" << parseat(text, next, end);
+
 							//	after tagName we can have whitespace...
 							if (*next == ' ')
 							{
 								//	suck up whitespace
-								while(*next == ' ') next++;
+								while(next < end && *next == ' ') next++;
 
 								//	get attribute name
-								if (!brahms::istokenstart(*next))
-									ferr << E_XML_PARSE << "not attribute name start character" << parseat(text, next);
-
-								//	get rest of attr name
-								string attrkey;
-								while(brahms::istokencontinue(*next))
-								{
-									attrkey += *next;
+								if (next == end || !brahms::istokenstart(*next))
+									ferr << E_XML_PARSE << "not attribute name start character" << parseat(text, next, end);
+								const char* key = next;
+								while(next < end && brahms::istokencontinue(*next))
 									next++;
-									continue;
-								}
+								const char* keyEnd = next;
 
 								//	get attr value
-								if (*next != '=') ferr << E_XML_PARSE << "expected '='" << parseat(text, next);
+								if (next == end || *next != '=') ferr << E_XML_PARSE << "expected '='" << parseat(text, next, end);
 								next++;
-								if (*next != '\"') ferr << E_XML_PARSE << "expected '\"'" << parseat(text, next);
-								next++;
-								string attrvalue;
-								while(true)
-								{
-									if (!*next) ferr << E_XML_PARSE << "unexpected end of file in attribute value" << parseat(text, next);
-									if (*next == '\"') break;
-									attrvalue += *next;
-									next++;
-								}
+								if (next == end || *next != '\"') ferr << E_XML_PARSE << "expected '\"'" << parseat(text, next, end);
 								next++;
+								const char* value = next;
+								next = (const char*) memchr(next, '\"', end - next);
+								if (!next) ferr << E_XML_PARSE << "unexpected end of file in attribute value" << parseat(text, end, end);
 
-								XMLAttr attr;
-								attr.name = attrkey;
-								attr.value = attrvalue;
-								parsedAttributes.push_back(attr);
+								parsedAttributes.push_back(XMLAttr());
+								parsedAttributes.back().name.assign(key, keyEnd - key);
+								parsedAttributes.back().value.assign(value, next - value);
+								next++;
 								continue;
 							}
 
@@ -317,7 +566,7 @@ namespace brahms
 							}
 
 							//	or end of tag with closure...
-							if (*next == '/' && *(next+1) == '>')
+							if (*next == '/' && next + 1 < end && *(next+1) == '>')
 							{
 								close = true; // now "open" _and_ "close" are both true!
 								next += 2;
@@ -325,7 +574,7 @@ namespace brahms
 							}
 
 							//	anything else is an error
-							ferr << E_XML_PARSE << "unexpected character whilst parsing tag" << parseat(text, next);
+							ferr << E_XML_PARSE << "unexpected character whilst parsing tag" << parseat(text, next, end);
 						}
 
 						//	if we don't have a tagName yet, we are the root parsing node, and
@@ -333,11 +582,11 @@ namespace brahms
 						if (!node->getObjectName().length())
 						{
 							//	it must be an open tag
-							if (!open) ferr << E_XML_PARSE << "document invalid (bad root tag)" << parseat(text, next);
+							if (!open) ferr << E_XML_PARSE << "document invalid (bad root tag)" << parseat(text, next, end);
 
 							//	take its name and attributes to ourselves
 							node->setObjectName(parsedTagName);
-							node->element.attributes = parsedAttributes;
+							node->element.attributes.swap(parsedAttributes);
 
 							//	if we were also closed, that's the end of the document right there!
 							if (close) return;
@@ -350,21 +599,39 @@ namespace brahms
 						if (open)
 						{
 							//	create child using tag name and attributes
-							XMLNode* child = node->appendChild(new XMLNode(parsedTagName.c_str()));
-							child->element.attributes = parsedAttributes;
+							XMLNode* child = new XMLNode(parsedTagName.c_str());
+							adopt(node, child);
+							child->element.attributes.swap(parsedAttributes);
 
 							//	if it was also closed, we can carry straight on parsing
 							if (close) continue;
 
-							//	otherwise, we get the new child to continue the parse until its close tag...
-							xmlparse(child, text, next);
+							//	if it is to be deferred, we just skip to its close tag (if it has content)...
+							if (ctx.source && parsedTagName == ctx.deferredName)
+							{
+								const char* begin = next;
+								next = skipElement(ctx, next);
+								if ((size_t)(next - begin) > parsedTagName.length() + 3)
+								{
+									ctx.source->acquire();
+									child->deferred.source = ctx.source;
+									child->deferred.begin = begin;
+									child->deferred.end = next;
+									child->deferred.expanded = false;
+									continue;
+								}
+								next = begin;
+							}
+
+							//	...otherwise, we get the new child to continue the parse until its close tag...
+							xmlparse(child, ctx, next);
 
 							//	...and _then_ we carry straight on
 							continue;
 						}
 
 						//	otherwise, it _must_ be a close tag!
-						if (!close) ferr << E_INTERNAL << "XML parser internal error (how can this not be a close tag?)" << parseat(text, next);
+						if (!close) ferr << E_INTERNAL << "XML parser internal error (how can this not be a close tag?)" << parseat(text, next, end);
 
 						//	mixed content illegal
 						if (parsedText.length())
@@ -377,17 +644,17 @@ namespace brahms
 								{
 									//	all spaces is considered just "padding"
 									if ( !isspace(*t) )
-										ferr << E_XML_PARSE << "mixed content not handled by this parser" << parseat(text, next);
+										ferr << E_XML_PARSE << "mixed content not handled by this parser" << parseat(text, next, end);
 									t++;
 								}
 								node->element.text = "";
 							}
-							else node->element.text = parsedText;
+							else node->element.text.swap(parsedText);
 						}
 
 						//	and it must be _our_ expected close tag
 						if (parsedTagName != node->getObjectName())
-							ferr << E_XML_PARSE << node->nodeNoun() << " closed by </" << parsedTagName << ">" << parseat(text, next);
+							ferr << E_XML_PARSE << node->nodeNoun() << " closed by </" << parsedTagName << ">" << parseat(text, next, end);
 
 						//	so now we can hand control back to the parent parser
 						return;
@@ -400,84 +667,48 @@ namespace brahms
 					{
 						//	check here for mixed content to get a good err msg
 						if (node->element.children.size())
-							ferr << E_XML_PARSE << "mixed content not handled by this parser" << parseat(text, next);
+							ferr << E_XML_PARSE << "mixed content not handled by this parser" << parseat(text, next, end);
 						nonWhitespaceTextContent = true;
 
 						//	consume XML entity
-						string entity;
 						next++;
-						while(true)
-						{
-							if (!*next) ferr << E_XML_PARSE << "unexpected end of file in XML entity" << parseat(text, next);
-
-							if (*next == ';')
-							{
-								if (entity == "amp")
-								{
-									parsedText += "&";
-									next++;
-									break;
-								}
-
-								if (entity == "apos")
-								{
-									parsedText += "'";
-									next++;
-									break;
-								}
-
-								if (entity == "quot")
-								{
-									parsedText += "\"";
-									next++;
-									break;
-								}
-
-								if (entity == "lt")
-								{
-									parsedText += "<";
-									next++;
-									break;
-								}
-
-								if (entity == "gt")
-								{
-									parsedText += ">";
-									next++;
-									break;
-								}
-
-								ferr << E_XML_PARSE << "unrecognised XML entity" << parseat(text, next);
-							}
-							entity += *next;
-							next++;
-						}
-
-						break;
-					}
+						const char* entity = next;
+						next = (const char*) memchr(next, ';', end - next);
+						if (!next) ferr << E_XML_PARSE << "unexpected end of file in XML entity" << parseat(text, end, end);
+						size_t length = next - entity;
+
+						if (length == 3 && !memcmp(entity, "amp", 3)) parsedText += "&";
+						else if (length == 4 && !memcmp(entity, "apos", 4)) parsedText += "'";
+						else if (length == 4 && !memcmp(entity, "quot", 4)) parsedText += "\"";
+						else if (length == 2 && !memcmp(entity, "lt", 2)) parsedText += "<";
+						else if (length == 2 && !memcmp(entity, "gt", 2)) parsedText += ">";
+						else ferr << E_XML_PARSE << "unrecognised XML entity" << parseat(text, next, end);
 
-
-
-					//	white space
-					case ' ': case '\t': case '\r': case '\n':
-					{
-						parsedText += *next;
 						next++;
 						break;
 					}
 
 
 
-					//	other character
+					//	text, up to the next tag or entity
 					default:
 					{
-						//	check here for mixed content to get a good err msg
-						if (node->element.children.size())
-							ferr << E_XML_PARSE << "mixed content not handled by this parser" << parseat(text, next);
-						nonWhitespaceTextContent = true;
+						const char* run = next;
+						while(next < end && *next != '<' && *next != '&')
+						{
+							if (!isxmlspace(*next))
+							{
+								//	check here for mixed content to get a good err msg
+								if (node->element.children.size())
+									ferr << E_XML_PARSE << "mixed content not handled by this parser" << parseat(text, next, end);
+								nonWhitespaceTextContent = true;
+							}
+							next++;
+						}
 
-						parsedText += *next;
-						next++;
+						//	padding between children is dropped at the close tag anyway
+						if (!node->element.children.size())
+							parsedText.append(run, next - run);
 						break;
 					}
 
@@ -486,7 +717,7 @@ namespace brahms
 			}
 
 			//	should never reach EOF without closing a tag
-			ferr << E_XML_PARSE << "unexpected end of file whilst tag open" << parseat(text, next);
+			ferr << E_XML_PARSE << "unexpected end of file whilst tag open" << parseat(text, next, end);
 		}
 
 		void inline xmlsafe(std::ostream& dst, const char* text)
@@ -535,6 +766,10 @@ namespace brahms
 			parent = NULL;
 			userData = 0;
 			control = NULL;
+			deferred.source = NULL;
+			deferred.begin = NULL;
+			deferred.end = NULL;
+			deferred.expanded = false;
 			nodeName(tagName);
 			nodeText(text);
 		}
@@ -546,6 +781,10 @@ namespace brahms
 			parent = NULL;
 			userData = 0;
 			control = NULL;
+			deferred.source = NULL;
+			deferred.begin = NULL;
+			deferred.end = NULL;
+			deferred.expanded = false;
 			parse(src);
 			validateName(this, getObjectName().c_str(), "root node name from parsed document");
 		}
@@ -572,6 +811,10 @@ namespace brahms
 			userData = src.userData;
 			control = src.control;
 
+			//	share deferred content
+			deferred = src.deferred;
+			if (deferred.source) deferred.source->acquire();
+
 			//	a copy is not automatically attached to the same parent
 			parent = NULL;
 		}
@@ -581,6 +824,7 @@ namespace brahms
 			if (this == &src) return *this; // handle self-assignment gracefully
 
 			//	delete all existing children
+			drop();
 			removeChildren();
 
 			//	copy all children
@@ -592,6 +836,10 @@ namespace brahms
 			userData = src.userData;
 			control = src.control;
 
+			//	share deferred content
+			deferred = src.deferred;
+			if (deferred.source) deferred.source->acquire();
+
 			//	on assignment, our parent does not change, just our content
 			//parent = ...
 
@@ -604,6 +852,7 @@ namespace brahms
 			control = NULL;
 
 			//	delete all existing children
+			drop();
 			removeChildren();
 		}
 
@@ -636,17 +885,20 @@ namespace brahms
 
 		const XMLNodeList* XMLNode::childNodes() const
 		{
+			expand();
 			return &element.children;
 		}
 
 		XMLNode* XMLNode::firstChild()
 		{
+			expand();
 			if (element.children.size()) return element.children[0];
 			else return NULL;
 		}
 
 		XMLNode* XMLNode::lastChild()
 		{
+			expand();
 			if (element.children.size()) return element.children[element.children.size() - 1];
 			else return NULL;
 		}
@@ -699,6 +951,7 @@ namespace brahms
 		XMLNode* XMLNode::insertBefore(XMLNode* newChild, XMLNode* refChild)
 		{
 			XMLNODE_CHECK_NOT_READONLY;
+			settle();
 
 			if (refChild)
 			{
@@ -727,6 +980,7 @@ namespace brahms
 		XMLNode* XMLNode::replaceChild(XMLNode* newChild, XMLNode* oldChild)
 		{
 			XMLNODE_CHECK_NOT_READONLY;
+			settle();
 
 			for (UINT32 index=0; index<element.children.size(); index++)
 			{
@@ -754,6 +1008,7 @@ namespace brahms
 		XMLNode* XMLNode::removeChild(XMLNode* oldChild)
 		{
 			XMLNODE_CHECK_NOT_READONLY;
+			settle();
 
 			for (UINT32 index=0; index<element.children.size(); index++)
 			{
@@ -772,6 +1027,7 @@ namespace brahms
 		void XMLNode::deleteChild(XMLNode* oldChild)
 		{
 			XMLNODE_CHECK_NOT_READONLY;
+			settle();
 
 			for (UINT32 index=0; index<element.children.size(); index++)
 			{
@@ -788,6 +1044,7 @@ namespace brahms
 		XMLNode* XMLNode::appendChild(XMLNode* newChild)
 		{
 			XMLNODE_CHECK_NOT_READONLY;
+			settle();
 
 			//	must not have a parent
 			if (newChild->parent) throw E_INVALID_ARG;
@@ -804,6 +1061,7 @@ namespace brahms
 
 		bool XMLNode::hasChildNodes() const
 		{
+			expand();
 			return element.children.size();
 		}
 
@@ -921,6 +1179,7 @@ namespace brahms
 
 		XMLNodeList XMLNode::getElementsByTagName(const char* tagName) const
 		{
+			expand();
 			//	special case (see the DOM specification)
 			if (!tagName) return element.children;
 
@@ -949,6 +1208,7 @@ namespace brahms
 		bool XMLNode::hasChild(const char* child) const
 		{
 			if (!child) ferr << E_XML << "NULL passed to hasChild()";
+			expand();
 
 			for (UINT32 index=0; index<element.children.size(); index++)
 			{
@@ -967,6 +1227,7 @@ namespace brahms
 			//	functionality to the unordered set provided by the DOM.
 
 			//if (!tagName) ferr << E_XML << "NULL passed to getChild()";
+			expand();
 
 			UINT32 count = 0;
 			for (UINT32 index=0; index<element.children.size(); index++)
@@ -987,6 +1248,8 @@ namespace brahms
 
 		XMLNode* XMLNode::getChildOrNull(const char* nodeName, UINT32 p_index)
 		{
+			expand();
+
 			if (nodeName)
 			{
 				//	return p_index'th node with given node name
@@ -1023,6 +1286,7 @@ namespace brahms
 			XMLNODE_CHECK_NOT_READONLY;
 
 			//	just a shortcut to delete all existing children
+			settle();
 			for (UINT32 index=0; index<element.children.size(); index++)
 				delete element.children[index];
 			element.children.clear();
@@ -1033,6 +1297,7 @@ namespace brahms
 			XMLNODE_CHECK_NOT_READONLY;
 
 			//	note nodeName is not cleared!
+			drop();
 			removeChildren();
 			removeAttributes();
 			element.text = "";
@@ -1049,17 +1314,20 @@ namespace brahms
 
 		bool XMLNode::hasNodeText() const
 		{
+			expand();
 			return element.text.length();
 		}
 
 		const char* XMLNode::nodeText() const
 		{
+			expand();
 			return element.text.c_str();
 		}
 
 		void XMLNode::nodeText(const char* text)
 		{
 			XMLNODE_CHECK_NOT_READONLY;
+			settle();
 
 			element.text = text ? text : "";
 		}
@@ -1078,11 +1346,32 @@ namespace brahms
 		{
 			XMLNODE_CHECK_NOT_READONLY;
 
+			ParseContext ctx = { text, text + strlen(text), NULL, NULL };
 			const char* next = text;
-			xmlparse(this, text, next);
+			xmlparse(this, ctx, next);
 			return next;
 		}
 
+		void XMLNode::parseFile(const char* path, const char* deferredNodeName)
+		{
+			XMLNODE_CHECK_NOT_READONLY;
+
+			//	the source is released by the last node to refer to it (we just hold it whilst parsing)
+			XMLSource* source = new XMLSource(path);
+			try
+			{
+				ParseContext ctx = { source->begin(), source->end(), deferredNodeName ? source : NULL, deferredNodeName };
+				const char* next = ctx.text;
+				xmlparse(this, ctx, next);
+			}
+			catch(...)
+			{
+				source->release();
+				throw;
+			}
+			source->release();
+		}
+
 		void XMLNode::serialize(std::ostream& dst, UINT32 indent, UINT32 flags, XMLNode* start, XMLNode* stop) const
 		{
 			/*
@@ -1129,8 +1418,15 @@ namespace brahms
 				dst << "\"";
 			}
 
+			//	deferred content: copy it as it was, close tag and all
+			if (isDeferred())
+			{
+				dst << ">";
+				dst.write(deferred.begin, deferred.end - deferred.begin);
+			}
+
 			//	no mixed content: handle text
-			if (element.text.length())
+			else if (element.text.length())
 			{
 				dst << ">";
 
@@ -1176,6 +1472,73 @@ namespace brahms
 			}
 		}
 
+		bool XMLNode::isDeferred() const
+		{
+			return deferred.source && !deferred.expanded;
+		}
+
+		void XMLNode::collapse()
+		{
+			if (!deferred.source || !deferred.expanded) return;
+
+			//	discard what was parsed, leaving the byte range to parse again if needed
+			for (UINT32 index=0; index<element.children.size(); index++)
+				delete element.children[index];
+			element.children.clear();
+			element.text = "";
+			deferred.expanded = false;
+		}
+
+		void XMLNode::releaseSources()
+		{
+			//	content already parsed is kept, content not yet parsed is
+			//	lost, so only call this once the document has been written
+			drop();
+			for (UINT32 index=0; index<element.children.size(); index++)
+				element.children[index]->releaseSources();
+		}
+
+		void XMLNode::expand() const
+		{
+			if (!isDeferred()) return;
+
+			//	content is parsed as an ordinary part of the document (nothing further deferred)
+			XMLNode* self = const_cast<XMLNode*>(this);
+			ParseContext ctx = { deferred.source->begin(), deferred.end, NULL, NULL };
+			const char* next = deferred.begin;
+			try
+			{
+				xmlparse(self, ctx, next);
+			}
+			catch(...)
+			{
+				//	leave it deferred, so a second look gives the same error
+				for (UINT32 index=0; index<element.children.size(); index++)
+					delete element.children[index];
+				self->element.children.clear();
+				self->element.text = "";
+				throw;
+			}
+			deferred.expanded = true;
+		}
+
+		void XMLNode::settle()
+		{
+			expand();
+			drop();
+		}
+
+		void XMLNode::drop()
+		{
+			if (!deferred.source) return;
+
+			deferred.source->release();
+			deferred.source = NULL;
+			deferred.begin = NULL;
+			deferred.end = NULL;
+			deferred.expanded = false;
+		}
+
 		void XMLNode::setControl(const XMLControl* p_control)
 		{
 			control = p_control;
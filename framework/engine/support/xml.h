@@ -104,6 +104,7 @@ namespace brahms
 	};
 
 	class XMLNode;
+	class XMLSource;
 	typedef std::vector<XMLNode*> XMLNodeList;
 	typedef std::vector<XMLAttr> XMLAttrList;
 
@@ -165,8 +166,14 @@ namespace brahms
 		//	document parse/serialize interface
 		void					parse(std::istream& src);
 		const char*				parse(const char* text);
+		void					parseFile(const char* path, const char* deferredNodeName = NULL); // see XML_DEFERRED_CONTENT
 		void					serialize(std::ostream& dst, UINT32 indent = 0, UINT32 flags = 0, XMLNode* start = NULL, XMLNode* stop = NULL) const;
 
+		//	deferred content interface (see XML_DEFERRED_CONTENT)
+		bool					isDeferred() const;
+		void					collapse();
+		void					releaseSources();
+
 
 
 		//	content
@@ -179,6 +186,22 @@ namespace brahms
 		}
 		element;
 
+		//	content not yet parsed, from the end of the open tag to the end
+		//	of the close tag in "source" (the content above is empty until
+		//	it is "expanded")
+		mutable struct
+		{
+			XMLSource* source;
+			const char* begin;
+			const char* end;
+			bool expanded;
+		}
+		deferred;
+
+		void expand() const;		//	parse deferred content, if not yet parsed
+		void settle();				//	expand, and forget where the content came from (it is about to change)
+		void drop();				//	forget deferred content, without parsing it
+
 		//	other data
 		XMLNode* parent;			//	parent if this node has one, else NULL
 		const XMLControl* control;	//	points to the control object for this node
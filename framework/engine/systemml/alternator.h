@@ -127,11 +127,22 @@ namespace brahms
 				return redundant;
 			}
 
-			Symbol readLock()
+			//	if "wait" is false, return C_NO at once if not READ_READY
+			Symbol readLock(bool wait = true)
 			{
 				//	redundancy
 				if (redundant) return C_OK;
 
+				//	don't wait
+				if (!wait)
+				{
+					if (!readReady.test()) return C_NO;
+			#ifdef DEBUG_ALTERNATORS
+					debugState = 'R';
+			#endif
+					return C_OK;
+				}
+
 				//	wait for signal
 			#ifdef DEBUG_ALTERNATORS
 				stringstream ss;
@@ -186,9 +186,9 @@ namespace brahms
 				flags |= F_IMPLICIT_NAME;
 		}
 
-		Symbol InputPortLocal::readLock(BaseSamples now)
+		Symbol InputPortLocal::readLock(BaseSamples now, bool wait)
 		{
-			return connectedOutputPort->readLock(this, now, readBuffer, NULL);
+			return connectedOutputPort->readLock(this, now, readBuffer, NULL, wait);
 		}
 
 		BaseSamples InputPortLocal::readRelease(BaseSamples now, BaseSamples nextService)
@@ -485,6 +485,7 @@ namespace brahms
 		RingBufferItem::RingBufferItem(brahms::systemml::Data* p_data)
 		{
 			data = p_data;
+			adopted = NULL;
 		}
 
 		RingBufferItem::~RingBufferItem()
@@ -579,46 +580,15 @@ namespace brahms
 
 		Data* RingBuffer::expand(InputPort* port, UINT32 lag, bool redundant, brahms::output::Source& fout, const bool* cancel)
 		{
-			//	store reader
-			attachedReaders.push_back(port);
-
-			//	current number of "readers" for this port (*before* this call!)
-			UINT32 N = at(0)->alternators.size();
-
-			//	add any new buffers that are required - alternators for existing buffers
-			//	will be set to WRITE_READY since they have "already" been read by the
-			//	attached readers (where "already" means "at t = 0 - readerLag"), i.e. it
-			//	never physically happened
-			//
-			//	also - make sure that we always have at least two buffers (front and back)
-			//	so that we can have the writer and reader working in parallel even if they
-			//	are linked with a link of lag zero
+			//	add any new buffers that are required - make sure that we always have
+			//	at least two buffers (front and back) so that we can have the writer and
+			//	reader working in parallel even if they are linked with a link of lag zero
 			UINT32 requiredBuffers = lag + 1;
 			if (requiredBuffers < 2) requiredBuffers = 2;
-			while (size() < requiredBuffers)
-			{
-				//	add new buffer with duplicate of front buffer data object
-				push_back(new RingBufferItem(at(0)->data->duplicate(&fout)));
-
-				//	initialise all these alternators to WRITE_READY
-				for (UINT32 n=0; n<N; n++)
-				{
-					/*	DOCUMENTATION: INTERTHREAD_SIGNALLING
-					
-						alternator redundancy is equal around the ring (time), but not across the ring (readers)
-						so we can propagate it when we add a new ring buffer entry. all new alternators around this
-						reader-ring will thus share the "redundant" setting of the front buffer alternator on this reader-ring
-					*/
+			grow(requiredBuffers, fout, cancel);
 
-					bool redundant_n = at(0)->alternators[n]->getRedundant();
-
-					//	create enough alternators in new ring item for existing readers (not for new reader yet, that's below!)
-					//	init as WRITE_READY because these "used" buffers for existing readers will be written first
-					at(size() - 1)->alternators.push_back(
-						new Alternator(/*true,*/ brahms::os::SIGNAL_INFINITE_WAIT, cancel, redundant_n)
-					);
-				}
-			}
+			//	store reader
+			attachedReaders.push_back(port);
 
 			//	now that the existing readers are all set (and the number of buffers is
 			//	correct given the new max lag on this port) we conclude by adding the new reader
@@ -647,6 +617,40 @@ namespace brahms
 			return at(lag)->data;
 		}
 
+		void RingBuffer::grow(UINT32 requiredBuffers, brahms::output::Source& fout, const bool* cancel)
+		{
+			//	current number of "readers" for this port
+			UINT32 N = at(0)->alternators.size();
+
+			//	alternators of existing readers for new buffers will be set to WRITE_READY
+			//	since they have "already" been read by the attached readers (where "already"
+			//	means "at t = 0 - readerLag"), i.e. it never physically happened
+			while (size() < requiredBuffers)
+			{
+				//	add new buffer with duplicate of front buffer data object
+				push_back(new RingBufferItem(at(0)->data->duplicate(&fout)));
+
+				//	initialise all these alternators to WRITE_READY
+				for (UINT32 n=0; n<N; n++)
+				{
+					/*	DOCUMENTATION: INTERTHREAD_SIGNALLING
+					
+						alternator redundancy is equal around the ring (time), but not across the ring (readers)
+						so we can propagate it when we add a new ring buffer entry. all new alternators around this
+						reader-ring will thus share the "redundant" setting of the front buffer alternator on this reader-ring
+					*/
+
+					bool redundant_n = at(0)->alternators[n]->getRedundant();
+
+					//	create enough alternators in new ring item for existing readers (not for a reader being added, see expand())
+					//	init as WRITE_READY because these "used" buffers for existing readers will be written first
+					at(size() - 1)->alternators.push_back(
+						new Alternator(/*true,*/ brahms::os::SIGNAL_INFINITE_WAIT, cancel, redundant_n)
+					);
+				}
+			}
+		}
+
 
 
 	////////////////	OUTPUT PORT
@@ -663,6 +667,9 @@ namespace brahms
 
 			//	initially new
 			newlyCreated = true;
+
+			//	only set for remote output ports
+			adoptBytes = 0;
 		}
 
 		OutputPort::~OutputPort()
@@ -793,7 +800,7 @@ NO WE DON'T!!!!
 				remoteInputs[p]->additionalInputAttached(ring.size());
 		}
 
-		void OutputPort::startLog(bool encap, string filename, brahms::output::Source* tout)
+		void OutputPort::startLog(UINT32 logFlags, string filename, brahms::output::Source* tout)
 		{
 			//	listened
 			flags |= F_LISTENED;
@@ -804,7 +811,7 @@ NO WE DON'T!!!!
 			//	so all we have to do is set the flags. however, we have to know
 			//	further down that this data object is storing, so we create
 			//	the output node in the output XML object now as a flag of this.
-			logEventData.flags = encap ? F_ENCAPSULATED : 0;
+			logEventData.flags = logFlags;
 			setSuggestedOutputFilename(filename);
 			logEvent.type = EVENT_LOG_INIT;
 			logEvent.tout = tout;
@@ -1025,7 +1032,7 @@ NO WE DON'T!!!!
 		}
 
 		//	acquire read lock (if due)
-		Symbol OutputPort::readLock(InputPort* port, BaseSamples now, UINT32 bufferIndex, Data** p_data)
+		Symbol OutputPort::readLock(InputPort* port, BaseSamples now, UINT32 bufferIndex, Data** p_data, bool wait)
 		{
 			//	if not due, don't go any further
 			if (now%samplePeriod) return S_NULL;
@@ -1039,8 +1046,8 @@ NO WE DON'T!!!!
 #endif
 
 			//	lock for read
-			Symbol result = buffer->alternators[port->readerIndex]->readLock();
-			if (result == C_CANCEL) return C_CANCEL;
+			Symbol result = buffer->alternators[port->readerIndex]->readLock(wait);
+			if (result == C_CANCEL || result == C_NO) return result;
 
 #ifdef DEBUG_ALTERNATORS
 			cerr << "(after read lock)" << endl;
@@ -1094,6 +1101,43 @@ NO WE DON'T!!!!
 			port->additionalInputAttached(ring.size());
 		}
 
+		void OutputPort::reserveBuffers(UINT32 buffers, brahms::output::Source& fout)
+		{
+			//	grow ring
+			ring.grow(buffers, fout, engineData.core.condition.get_p(brahms::base::COND_END_RUN_PHASE));
+
+			//	announce new buffers to any attached remote inputs
+			for (UINT32 p=0; p<remoteInputs.size(); p++)
+				remoteInputs[p]->additionalInputAttached(ring.size());
+		}
+
+		void OutputPort::releaseAdopted()
+		{
+			//	delivery has stopped, so nothing is writing the ring; each data
+			//	object copies its adopted content home before we let it go
+			for (UINT32 d=0; d<ring.size(); d++)
+			{
+				RingBufferItem* item = ring[d];
+				if (!item->adopted) continue;
+
+				EventContent ec;
+				ec.stream = item->adopted->body();
+				ec.bytes = item->adopted->header().bytesAfterHeaderUncompressed;
+				brahms::EventEx event(
+					EVENT_CONTENT_SET,
+					0,
+					item->data,
+					&ec,
+					true,
+					NULL
+				);
+				event.fire();
+
+				item->adopted->release();
+				item->adopted = NULL;
+			}
+		}
+
 
 
 		void OutputPort::initInterThreadLocks(brahms::output::Source& fout)
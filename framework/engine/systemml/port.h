@@ -145,6 +145,9 @@ namespace brahms
 
 			//	one alternator object for each reader (writer addresses them all)
 			vector<Alternator*> alternators;
+
+			//	message whose content "data" has adopted, or NULL (see ZERO_COPY_RECEIVE)
+			brahms::base::IPM* adopted;
 		};
 
 		struct RingBuffer : public vector<RingBufferItem*>
@@ -155,6 +158,7 @@ namespace brahms
 			UINT32 getNumberOfReaders();
 			Data* getWriteBuffer(UINT32 offset = 0);
 			Data* expand(InputPort* port, UINT32 lag, bool redundant, brahms::output::Source& source, const bool* cancel);
+			void grow(UINT32 requiredBuffers, brahms::output::Source& source, const bool* cancel);
 			void dump();
 			void destroy(brahms::output::Source* source);
 			void initLocks(UINT32 reader, UINT32 buffer, bool writeReady);
@@ -258,8 +262,8 @@ namespace brahms
 			//	pointer to formative link, through which to obtain reference data
 			Link* link;
 
-			//	acquire/release read lock (if due)
-			Symbol readLock(BaseSamples now);
+			//	acquire/release read lock (if due; C_NO if not ready and not "wait")
+			Symbol readLock(BaseSamples now, bool wait = true);
 			BaseSamples readRelease(BaseSamples now, BaseSamples nextService);
 		};
 
@@ -318,7 +322,7 @@ namespace brahms
 
 			//	interface
 			void connectInput(InputPort* input, UINT32 lag, brahms::output::Source& source);
-			void startLog(bool encap, string filename, brahms::output::Source* tout);
+			void startLog(UINT32 logFlags, string filename, brahms::output::Source* tout);
 
 			//	only used to get structural info on the data object (e.g. sample period)
 			Data* getZerothData();
@@ -330,8 +334,8 @@ namespace brahms
 			//	cached sample period (set in finalizeComponentTime())
 			BaseSamples samplePeriod;
 
-			//	acquire/release read lock (if due)
-			Symbol readLock(InputPort* port, BaseSamples now, UINT32 bufferIndex, Data** data);
+			//	acquire/release read lock (if due; C_NO if not ready and not "wait")
+			Symbol readLock(InputPort* port, BaseSamples now, UINT32 bufferIndex, Data** data, bool wait = true);
 			BaseSamples readRelease(InputPort* port, BaseSamples now, BaseSamples nextService);
 
 			//	client interface
@@ -347,8 +351,17 @@ namespace brahms
 
 			//	attached remotes
 			void connectRemoteInput(InputPortRemote* port);
+
+			//	let the writer run up to "buffers" - 1 samples ahead of its slowest reader (see LOOKAHEAD)
+			void reserveBuffers(UINT32 buffers, brahms::output::Source& source);
 			vector<InputPortRemote*> remoteInputs;
 
+			//	remote only: payloads of at least this many bytes are adopted, not copied (zero for never)
+			UINT32 adoptBytes;
+
+			//	remote only: take back adopted content, and release the messages that carried it
+			void releaseAdopted();
+
 			//	init locks
 			void initInterThreadLocks(brahms::output::Source& fout);
 
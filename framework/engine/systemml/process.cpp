@@ -66,6 +66,7 @@ namespace brahms
 
 			indexInSystem = p_indexInSystem;
 			thread = NULL;
+			speculation = NULL;
 
 			//	force EVENT_INIT_CONNECT to be fired at least once, with F_FIRST_CALL
 			EVENT_INIT_CONNECT_firstCall = true;
@@ -85,6 +86,9 @@ namespace brahms
 		{
 			for (UINT32 u=0; u<utilities.size(); u++)
 				delete utilities[u];
+
+			if (speculation)
+				delete speculation;
 		}
 
 		void Process::destroy(brahms::output::Source* tout)
@@ -93,6 +97,10 @@ namespace brahms
 			for (UINT32 u=0; u<utilities.size(); u++)
 				utilities[u]->destroy(tout);
 
+			//	and on shadow data objects
+			if (speculation)
+				speculation->destroy(tout);
+
 			//	then on self
 			Component::destroy(tout);
 		}
@@ -454,6 +462,9 @@ namespace brahms
 					ess.state = nodeState->getObjectHandle();
 					brahms::EventEx event(EVENT_STATE_SET, 0, data, &ess, true, &fout);
 					event.fire();
+
+					//	state content is no longer needed in parsed form (see XML_DEFERRED_CONTENT)
+					nodeState->collapse();
 				}
 			}
 		}
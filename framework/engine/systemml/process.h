@@ -42,6 +42,7 @@ namespace brahms
 
 	namespace systemml
 	{
+		class Speculation;
 
 
 
@@ -60,6 +61,7 @@ namespace brahms
 			friend class System;
 			friend class brahms::systemml::InputSet;
 			friend class brahms::systemml::OutputSet;
+			friend class brahms::systemml::Speculation;
 			friend class brahms::thread::WorkerThread;
 
 		public:
@@ -142,6 +144,9 @@ namespace brahms
 			//	handle to thread in which this process runs
 			brahms::thread::WorkerThread* thread;
 
+			//	non-NULL if running optimistically (see OPTIMISTIC_EXECUTION)
+			Speculation* speculation;
+
 			UINT32 indexInSystem; // used for inferred seeds
 
 		private:
@@ -0,0 +1,548 @@
+/*
+________________________________________________________________
+
+	This file is part of BRAHMS
+	Copyright (C) 2007 Ben Mitchinson
+	URL: http://brahms.sourceforge.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+________________________________________________________________
+
+*/
+
+
+
+#include "systemml.h"
+
+using namespace brahms::output;
+using namespace brahms::text;
+
+
+
+namespace brahms
+{
+	namespace systemml
+	{
+
+
+
+		/*	DOCUMENTATION: OPTIMISTIC_EXECUTION
+
+			EXPERIMENTAL. Ordinarily, a process whose input comes from
+			another voice waits for each sample of that input to arrive
+			before it is serviced. Where such traffic is sparse (spike
+			trains that are mostly empty, say), most of that wait is for
+			nothing. If OptimisticWindow is non-zero, a process that sets
+			F_OPTIMISTIC may instead be serviced with any remote input that
+			has not arrived predicted to be zero (empty), and go on to the
+			next sample, holding up to OptimisticWindow such steps. When
+			the input does arrive, it is compared with the prediction. If
+			all a step's predictions were right, the step is committed; if
+			one was wrong, the process is rolled back to the state it had
+			before that step, and that step and all the later ones held
+			are run again with what actually arrived.
+
+			To roll back, the process is asked for a checkpoint of its
+			state (EVENT_STATE_GET, with F_CHECKPOINT) before each step
+			that predicts anything, and is given it back (EVENT_STATE_SET,
+			with F_CHECKPOINT) to roll back. Each held step is run against
+			private copies of the process's inputs and outputs, which
+			lets us release the input rings as usual.
+
+			Classic Time Warp would send a step's outputs at once, and
+			chase them with anti-messages if the step were rolled back.
+			We do not do that: a held step's outputs stay in their copies,
+			and are written into the output rings (logged, and sent on to
+			other voices) only when the step is committed. So nothing
+			downstream ever sees a speculative sample, nothing needs to be
+			cancelled, and results are identical to a conservative run.
+			The gain is that a process's own computation overlaps the wait
+			for its inputs, instead of following it.
+
+			A process only runs this way if it is the only process in
+			its worker thread, and does not read its own outputs, since
+			either could see an output before it had been committed. A
+			statistics block is added to its entry in the Report File.
+		*/
+
+
+
+	////////////////	HELPERS
+
+		//	copy content of one data object into another of the same structure
+		void copyContent(Data* src, Data* dst)
+		{
+			EventContent ec;
+			brahms::EventEx get(EVENT_CONTENT_GET, 0, src, &ec, true, NULL);
+			get.fire();
+
+			//	content follows the space reserved for a header (see System::endInitPhase)
+			ec.stream += sizeof(brahms::base::IPM_HEADER);
+			brahms::EventEx set(EVENT_CONTENT_SET, 0, dst, &ec, true, NULL);
+			set.fire();
+		}
+
+		bool sameContent(Data* a, Data* b)
+		{
+			EventContent eca, ecb;
+			brahms::EventEx geta(EVENT_CONTENT_GET, 0, a, &eca, true, NULL);
+			geta.fire();
+			brahms::EventEx getb(EVENT_CONTENT_GET, 0, b, &ecb, true, NULL);
+			getb.fire();
+
+			if (eca.bytes != ecb.bytes) return false;
+			return !memcmp(
+				eca.stream + sizeof(brahms::base::IPM_HEADER),
+				ecb.stream + sizeof(brahms::base::IPM_HEADER),
+				eca.bytes
+			);
+		}
+
+		void zeroContent(Data* data)
+		{
+			EventStateSet ess;
+			____CLEAR(ess);
+			ess.flags = F_ZERO;
+			brahms::EventEx event(EVENT_STATE_SET, 0, data, &ess, true, NULL);
+			event.fire();
+		}
+
+		Data* shadowOf(Data* data, brahms::output::Source& tout)
+		{
+			Data* shadow = data->duplicate(&tout);
+
+			//	reserve header space as for the ring (see System::endInitPhase)
+			EventInitComplete eic;
+			eic.contentHeaderBytes = sizeof(brahms::base::IPM_HEADER);
+			brahms::EventEx event(EVENT_INIT_COMPLETE, 0, shadow, &eic, true, &tout);
+			event.fire();
+
+			return shadow;
+		}
+
+
+
+	////////////////	SPECULATION
+
+		Speculation::Speculation(Process* p_process, UINT32 p_window, BaseSamples p_executionStop, brahms::output::Source& tout)
+		{
+			process = p_process;
+			window = p_window;
+			executionStop = p_executionStop;
+			firstSerial = 0;
+
+			statSteps = 0;
+			statSpeculative = 0;
+			statPredicted = 0;
+			statMispredicted = 0;
+			statRollbacks = 0;
+			statReplayed = 0;
+			statMaxHeld = 0;
+
+			//	ports
+			inputs = process->getAllInputPorts();
+			outputs = process->getAllOutputPorts();
+
+			//	shadows of inputs (remote output ports have no parent set)
+			for (UINT32 p=0; p<inputs.size(); p++)
+			{
+				OutputPort* src = inputs[p]->connectedOutputPort;
+				remote.push_back(src->parentSet == NULL);
+				shadowInputs.push_back(vector<Data*>());
+				for (UINT32 w=0; w<window; w++)
+					shadowInputs.back().push_back(shadowOf(src->getZerothData(), tout));
+			}
+			predictions.resize(inputs.size());
+			locked.resize(inputs.size());
+
+			//	shadows of outputs
+			for (UINT32 o=0; o<outputs.size(); o++)
+			{
+				shadowOutputs.push_back(vector<Data*>());
+				for (UINT32 w=0; w<window; w++)
+					shadowOutputs.back().push_back(shadowOf(outputs[o]->getZerothData(), tout));
+			}
+		}
+
+		Speculation::~Speculation()
+		{
+			for (UINT32 s=0; s<steps.size(); s++)
+				if (steps[s].checkpoint) delete steps[s].checkpoint;
+
+			for (UINT32 p=0; p<shadowInputs.size(); p++)
+				for (UINT32 w=0; w<shadowInputs[p].size(); w++)
+					delete shadowInputs[p][w];
+
+			for (UINT32 o=0; o<shadowOutputs.size(); o++)
+				for (UINT32 w=0; w<shadowOutputs[o].size(); w++)
+					delete shadowOutputs[o][w];
+		}
+
+		void Speculation::destroy(brahms::output::Source* tout)
+		{
+			for (UINT32 p=0; p<shadowInputs.size(); p++)
+				for (UINT32 w=0; w<shadowInputs[p].size(); w++)
+					shadowInputs[p][w]->destroy(tout);
+
+			for (UINT32 o=0; o<shadowOutputs.size(); o++)
+				for (UINT32 w=0; w<shadowOutputs[o].size(); w++)
+					shadowOutputs[o][w]->destroy(tout);
+		}
+
+		Symbol Speculation::service(BaseSamples now, Event* serviceEvent, brahms::output::Source* tout)
+		{
+			//	take in what has arrived, and commit (or roll back) what that settles
+			Symbol result = settle(false, serviceEvent, tout);
+			if (result != C_OK) return result;
+
+			//	if the window is full, wait for the oldest step to settle
+			while (steps.size() >= window)
+			{
+				result = settle(true, serviceEvent, tout);
+				if (result != C_OK) return result;
+			}
+
+			//	lock inputs: local ones are waited for as usual, remote ones
+			//	are taken only if they have arrived, and only if no earlier
+			//	sample on the same port is still outstanding
+			bool complete = true;
+			for (UINT32 p=0; p<inputs.size(); p++)
+			{
+				locked[p] = false;
+				if (now % inputs[p]->connectedOutputPort->samplePeriod) continue;
+
+				if (remote[p] && predictions[p].size())
+				{
+					complete = false;
+					continue;
+				}
+
+				result = inputs[p]->readLock(now, !remote[p]);
+				if (result == C_CANCEL) return C_CANCEL;
+				if (result == C_OK) locked[p] = true;
+				else complete = false;
+			}
+
+			//	audit
+			statSteps++;
+
+			//	with nothing held, and nothing missing, this is an ordinary step
+			if (complete && steps.empty())
+			{
+				if (process->oif.writeLock(now) == C_CANCEL) return C_CANCEL;
+
+				Symbol err = process->eventHandler(serviceEvent);
+				if (err != C_OK) return err;
+
+				process->writeRelease(now, process->readRelease(now, executionStop), NULL);
+				return C_OK;
+			}
+
+			//	otherwise, the step is run against shadows, and held
+			UINT64 serial = firstSerial + steps.size();
+			UINT32 slot = serial % window;
+
+			SpeculativeStep step;
+			step.now = now;
+			step.checkpoint = NULL;
+			step.unresolved = 0;
+			step.mispredicted = false;
+
+			for (UINT32 p=0; p<inputs.size(); p++)
+			{
+				if (now % inputs[p]->connectedOutputPort->samplePeriod) continue;
+				Data* shadow = shadowInputs[p][slot];
+
+				//	take a copy, and release the ring at once
+				if (locked[p])
+				{
+					copyContent(inputs[p]->getDueData(), shadow);
+					inputs[p]->readRelease(now, executionStop);
+				}
+
+				//	predict that it will carry nothing
+				else
+				{
+					zeroContent(shadow);
+					predictions[p].push_back(serial);
+					step.unresolved++;
+					statPredicted++;
+				}
+			}
+
+			//	only a step that predicts can be rolled back to
+			if (step.unresolved)
+				step.checkpoint = checkpoint(tout);
+
+			//	hold it
+			steps.push_back(step);
+			statSpeculative++;
+			if (steps.size() > statMaxHeld) statMaxHeld = steps.size();
+
+			//	run it
+			return execute(steps.back(), serial, serviceEvent);
+		}
+
+		Symbol Speculation::drain(Event* serviceEvent, brahms::output::Source* tout)
+		{
+			while (steps.size())
+			{
+				Symbol result = settle(true, serviceEvent, tout);
+				if (result != C_OK) return result;
+			}
+
+			//	report
+			if (tout)
+			{
+				(*tout) << "optimistic " << process->getObjectName() << ": " << statSpeculative << " of " << statSteps
+					<< " steps speculative, " << statRollbacks << " rollbacks (" << statReplayed << " steps replayed)" << D_VERB;
+			}
+
+			//	ok
+			return C_OK;
+		}
+
+		Symbol Speculation::settle(bool wait, Event* serviceEvent, brahms::output::Source* tout)
+		{
+			//	take in arrivals, in order on each port
+			for (UINT32 p=0; p<inputs.size(); p++)
+			{
+				while (predictions[p].size())
+				{
+					UINT64 serial = predictions[p].front();
+					SpeculativeStep& step = steps[serial - firstSerial];
+
+					//	only ever wait for the oldest step
+					Symbol result = inputs[p]->readLock(step.now, wait && serial == firstSerial);
+					if (result == C_CANCEL) return C_CANCEL;
+					if (result != C_OK) break;
+
+					//	check prediction, and if wrong, keep what actually arrived for the replay
+					Data* shadow = shadowInputs[p][serial % window];
+					if (!sameContent(inputs[p]->getDueData(), shadow))
+					{
+						copyContent(inputs[p]->getDueData(), shadow);
+						step.mispredicted = true;
+						statMispredicted++;
+					}
+
+					//	release
+					inputs[p]->readRelease(step.now, executionStop);
+					predictions[p].pop_front();
+					step.unresolved--;
+				}
+			}
+
+			//	steps settle oldest first
+			while (steps.size() && !steps.front().unresolved)
+			{
+				if (steps.front().mispredicted)
+				{
+					Symbol result = rollback(serviceEvent, tout);
+					if (result != C_OK) return result;
+				}
+
+				Symbol result = commit(tout);
+				if (result != C_OK) return result;
+			}
+
+			//	ok
+			return C_OK;
+		}
+
+		Symbol Speculation::execute(SpeculativeStep& step, UINT64 serial, Event* serviceEvent)
+		{
+			UINT32 slot = serial % window;
+
+			//	point ports at this step's shadows
+			for (UINT32 p=0; p<inputs.size(); p++)
+			{
+				bool due = !(step.now % inputs[p]->connectedOutputPort->samplePeriod);
+				inputs[p]->setDueData(due ? shadowInputs[p][slot] : NULL);
+			}
+			for (UINT32 o=0; o<outputs.size(); o++)
+			{
+				bool due = !(step.now % outputs[o]->samplePeriod);
+				outputs[o]->setDueData(due ? shadowOutputs[o][slot] : NULL);
+			}
+
+			//	fire EVENT_RUN_SERVICE at the step's time
+			process->componentTime.now = step.now;
+			Symbol err = process->eventHandler(serviceEvent);
+
+			//	unpoint
+			for (UINT32 p=0; p<inputs.size(); p++)
+				inputs[p]->setDueData(NULL);
+			for (UINT32 o=0; o<outputs.size(); o++)
+				outputs[o]->setDueData(NULL);
+
+			//	advance process clock
+			process->componentTime.now = nextService(step.now);
+
+			//	ok
+			return err;
+		}
+
+		Symbol Speculation::rollback(Event* serviceEvent, brahms::output::Source* tout)
+		{
+			//	audit
+			statRollbacks++;
+			statReplayed += steps.size();
+
+			//	back to before the oldest step
+			restore(steps.front().checkpoint, tout);
+
+			//	run them all again, with what has arrived so far
+			for (UINT32 s=0; s<steps.size(); s++)
+			{
+				SpeculativeStep& step = steps[s];
+				step.mispredicted = false;
+
+				//	later checkpoints were taken on the wrong history
+				if (s)
+				{
+					if (step.checkpoint) delete step.checkpoint;
+					step.checkpoint = step.unresolved ? checkpoint(tout) : NULL;
+				}
+
+				Symbol err = execute(step, firstSerial + s, serviceEvent);
+				if (err != C_OK) return err;
+			}
+
+			//	ok
+			return C_OK;
+		}
+
+		Symbol Speculation::commit(brahms::output::Source* tout)
+		{
+			SpeculativeStep& step = steps.front();
+			UINT32 slot = firstSerial % window;
+
+			//	write outputs into their rings, as an ordinary step would have
+			for (UINT32 o=0; o<outputs.size(); o++)
+			{
+				Symbol result = outputs[o]->writeLock(step.now);
+				if (result == C_CANCEL) return C_CANCEL;
+				if (result != C_OK) continue;
+
+				copyContent(shadowOutputs[o][slot], outputs[o]->getDueData());
+				outputs[o]->writeRelease(step.now, NULL, executionStop);
+			}
+
+			//	forget step
+			if (step.checkpoint) delete step.checkpoint;
+			steps.pop_front();
+			firstSerial++;
+
+			//	ok
+			return C_OK;
+		}
+
+		brahms::xml::XMLNode* Speculation::checkpoint(brahms::output::Source* tout)
+		{
+			//	empty DataML struct, for the process to add its fields to
+			brahms::xml::XMLNode* node = new brahms::xml::XMLNode("State");
+			node->setAttribute("c", "z");
+			node->setAttribute("a", "");
+
+			//	event data
+			EventStateGet data;
+			____CLEAR(data);
+			data.flags = F_CHECKPOINT;
+			data.state = node->getObjectHandle();
+			data.precision = PRECISION_NOT_SET;
+
+			//	fire event
+			brahms::EventEx event(
+				EVENT_STATE_GET,
+				process->flags,
+				process,
+				&data,
+				true,
+				tout
+			);
+
+			try
+			{
+				event.fire();
+			}
+
+			catch(...)
+			{
+				delete node;
+				throw;
+			}
+
+			//	process may have modified the node, or replaced it
+			brahms::xml::XMLNode* state = objectRegister.resolveXMLNode(data.state);
+			if (state != node) delete node;
+			return state;
+		}
+
+		void Speculation::restore(brahms::xml::XMLNode* state, brahms::output::Source* tout)
+		{
+			//	event data
+			EventStateSet data;
+			____CLEAR(data);
+			data.flags = F_CHECKPOINT;
+			data.state = state->getObjectHandle();
+
+			//	fire event
+			brahms::EventEx event(
+				EVENT_STATE_SET,
+				process->flags,
+				process,
+				&data,
+				true,
+				tout
+			);
+			event.fire();
+		}
+
+		BaseSamples Speculation::nextService(BaseSamples now)
+		{
+			//	as readRelease() and writeRelease() would have found it
+			BaseSamples next = executionStop;
+
+			for (UINT32 p=0; p<inputs.size(); p++)
+			{
+				BaseSamples samplePeriod = inputs[p]->connectedOutputPort->samplePeriod;
+				next = min(next, now - (now % samplePeriod) + samplePeriod);
+			}
+
+			for (UINT32 o=0; o<outputs.size(); o++)
+			{
+				BaseSamples samplePeriod = outputs[o]->samplePeriod;
+				next = min(next, now - (now % samplePeriod) + samplePeriod);
+			}
+
+			return next;
+		}
+
+		void Speculation::report(brahms::xml::XMLNode* nodeProcess)
+		{
+			brahms::xml::XMLNode* node = nodeProcess->appendChild(new brahms::xml::XMLNode("Optimistic"));
+			node->appendChild(new brahms::xml::XMLNode("Window", n2s(window).c_str()));
+			node->appendChild(new brahms::xml::XMLNode("Steps", n2s(statSteps).c_str()));
+			node->appendChild(new brahms::xml::XMLNode("Speculative", n2s(statSpeculative).c_str()));
+			node->appendChild(new brahms::xml::XMLNode("Predicted", n2s(statPredicted).c_str()));
+			node->appendChild(new brahms::xml::XMLNode("Mispredicted", n2s(statMispredicted).c_str()));
+			node->appendChild(new brahms::xml::XMLNode("Rollbacks", n2s(statRollbacks).c_str()));
+			node->appendChild(new brahms::xml::XMLNode("Replayed", n2s(statReplayed).c_str()));
+			node->appendChild(new brahms::xml::XMLNode("MaxHeld", n2s(statMaxHeld).c_str()));
+		}
+
+	}
+}
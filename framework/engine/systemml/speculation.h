@@ -0,0 +1,139 @@
+/*
+________________________________________________________________
+
+	This file is part of BRAHMS
+	Copyright (C) 2007 Ben Mitchinson
+	URL: http://brahms.sourceforge.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+________________________________________________________________
+
+*/
+
+#ifndef _ENGINE_SYSTEMML_SPECULATION_H_
+#define _ENGINE_SYSTEMML_SPECULATION_H_
+
+namespace brahms
+{
+	namespace systemml
+	{
+
+
+
+	////////////////	SPECULATION
+
+		/*
+
+			Runs an F_OPTIMISTIC process ahead of remote inputs that
+			have not yet arrived (see OPTIMISTIC_EXECUTION in
+			speculation.cpp). Created by the worker thread at the
+			start of the run phase, for processes that qualify.
+
+		*/
+
+		struct SpeculativeStep
+		{
+			//	process time of the step
+			BaseSamples now;
+
+			//	process state before the step, or NULL if the step predicted nothing
+			brahms::xml::XMLNode* checkpoint;
+
+			//	number of predicted inputs still to arrive
+			UINT32 unresolved;
+
+			//	one of the predicted inputs arrived different from its prediction
+			bool mispredicted;
+		};
+
+		class Speculation
+		{
+
+		public:
+
+			Speculation(Process* process, UINT32 window, BaseSamples executionStop, brahms::output::Source& tout);
+			~Speculation();
+
+			//	service process at "now" (does its own locking, may fire several times, or not at all)
+			Symbol service(BaseSamples now, Event* serviceEvent, brahms::output::Source* tout);
+
+			//	wait for everything outstanding to arrive, and commit it (at execution stop)
+			Symbol drain(Event* serviceEvent, brahms::output::Source* tout);
+
+			//	destroy shadow data objects
+			void destroy(brahms::output::Source* tout);
+
+			//	append statistics to report
+			void report(brahms::xml::XMLNode* nodeProcess);
+
+		private:
+
+			//	take in arrived inputs, then commit or roll back settled steps
+			Symbol settle(bool wait, Event* serviceEvent, brahms::output::Source* tout);
+
+			//	fire EVENT_RUN_SERVICE on a step, against its shadows
+			Symbol execute(SpeculativeStep& step, UINT64 serial, Event* serviceEvent);
+
+			//	restore the oldest step's checkpoint, and run every held step again
+			Symbol rollback(Event* serviceEvent, brahms::output::Source* tout);
+
+			//	write the oldest step's outputs into their rings, and forget it
+			Symbol commit(brahms::output::Source* tout);
+
+			//	process state
+			brahms::xml::XMLNode* checkpoint(brahms::output::Source* tout);
+			void restore(brahms::xml::XMLNode* state, brahms::output::Source* tout);
+
+			//	next time the process is due, after "now"
+			BaseSamples nextService(BaseSamples now);
+
+			//	parameters
+			Process* process;
+			UINT32 window;
+			BaseSamples executionStop;
+
+			//	ports, and whether each input is fed from another voice
+			vector<InputPortLocal*> inputs;
+			vector<bool> remote;
+			vector<OutputPort*> outputs;
+
+			//	inputs locked for the current step (scratch)
+			vector<bool> locked;
+
+			//	one copy of each port's data per step held (indexed by serial % window)
+			vector< vector<Data*> > shadowInputs;
+			vector< vector<Data*> > shadowOutputs;
+
+			//	serials of steps that predicted each input, oldest first
+			vector< deque<UINT64> > predictions;
+
+			//	steps held, oldest first, and serial of the oldest
+			deque<SpeculativeStep> steps;
+			UINT64 firstSerial;
+
+			//	statistics
+			UINT64 statSteps;
+			UINT64 statSpeculative;
+			UINT64 statPredicted;
+			UINT64 statMispredicted;
+			UINT64 statRollbacks;
+			UINT64 statReplayed;
+			UINT32 statMaxHeld;
+		};
+
+	}
+}
+
+#endif // _ENGINE_SYSTEMML_SPECULATION_H_
@@ -70,6 +70,11 @@ namespace brahms
 
 			try
 			{
+				//	clear indices (they refer to the objects below)
+				processIndex.clear();
+				localOutputIndex.clear();
+				remoteOutputIndex.clear();
+
 				//	delete remote objects
 				for (UINT32 n=0; n<inputPortRemotes.size(); n++)
 					delete inputPortRemotes[n];
@@ -111,17 +116,13 @@ namespace brahms
 		////////////////	PARSE XML
 
 			fout << "System File" << D_VERB;
-			ifstream fileSystem(path.c_str());
-			if (!fileSystem) ferr << E_OS << "error opening \"" << path << "\"";
-			
 			try
 			{
-				nodeSystem.parse(fileSystem);
+				//	state is parsed only when it is needed (see XML_DEFERRED_CONTENT)
+				nodeSystem.parseFile(path.c_str(), "State");
 			}
 			CATCH_TRACE_RETHROW("parsing \"" + path + "\"")
 
-			fileSystem.close();
-
 			//	report
 			string systemTitle;
 			if (nodeSystem.hasChild("Title")) systemTitle = nodeSystem.getChild("Title")->nodeText();
@@ -140,6 +141,11 @@ namespace brahms
 			for (UINT32 e=0; e<exposes.size(); e++)
 				fout << exposes[e]->what << " <-- " << exposes[e]->as << D_FULL;
 
+			//	index parsed processes by name (position in "processes" is used below)
+			map<string, UINT32> parsedProcessIndex;
+			for (UINT32 p=0; p<processes.size(); p++)
+				parsedProcessIndex[processes[p]->getName()] = p;
+
 			//	resolve exposes
 			fout << "Resolved Exposes" << D_VERB;
 			for (UINT32 l=0; l<links.size(); l++)
@@ -184,18 +190,16 @@ namespace brahms
 					if (!newLink->getLag())
 					{
 						//	find the src process
-						UINT32 src;
-						for (src=0; src<processes.size(); src++)
-							if (newLink->getSrcProcessName() == processes[src]->getName()) break;
-						if (src == processes.size())
+						map<string, UINT32>::iterator isrc = parsedProcessIndex.find(newLink->getSrcProcessName());
+						if (isrc == parsedProcessIndex.end())
 							ferr << E_SYSTEM_FILE << "Link Src process \"" << newLink->getSrcProcessName() << "\" not found";
+						UINT32 src = isrc->second;
 
 						//	find the dst process
-						UINT32 dst;
-						for (dst=0; dst<processes.size(); dst++)
-							if (newLink->getDstProcessName() == processes[dst]->getName()) break;
-						if (dst == processes.size())
+						map<string, UINT32>::iterator idst = parsedProcessIndex.find(newLink->getDstProcessName());
+						if (idst == parsedProcessIndex.end())
 							ferr << E_SYSTEM_FILE << "Link Dst process \"" << newLink->getDstProcessName() << "\" not found";
+						UINT32 dst = idst->second;
 
 						//	store this
 						processes[dst]->addZeroLagSource(src);
@@ -332,6 +336,26 @@ namespace brahms
 				}
 			}
 
+			//	traffic-aware partition places everything that was not placed
+			//	explicitly, replacing the scheduling below (see VOICE_PARTITION)
+			vector<VoiceIndex> partition;
+			if (engineData.core.getVoiceCount() > 1 && engineData.environment.gets("VoicePartition") == "traffic")
+			{
+				partitionByTraffic(unscheduled, processGroup, execution, partition);
+
+				//	groups are scheduled wherever their members went
+				for (UINT32 w=0; w<unscheduled.size(); w++)
+				{
+					INT32 g = processGroup[w];
+					if (g != -1 && execution.groups[g].voice == VOICE_UNDEFINED)
+					{
+						execution.groups[g].voice = partition[w];
+						assignedProcessCount[partition[w]] += execution.groups[g].members;
+						groupsScheduled++;
+					}
+				}
+			}
+
 			//	now schedule any affinity groups that were not explicitly scheduled, largest first
 			while(groupsScheduled < execution.groups.size())
 			{
@@ -411,6 +435,13 @@ namespace brahms
 					voice = execution.groups[group].voice;
 				}
 
+				//	else schedule by partition
+				else if (partition.size())
+				{
+					voice = partition[w];
+					processIsNotInAffinityGroup = true;
+				}
+
 				//	else schedule by round-robin
 				else
 				{
@@ -436,6 +467,7 @@ namespace brahms
 				{
 					//	store it for processing
 					processes.push_back(unscheduled[w]);
+					processIndex[unscheduled[w]->getName()] = unscheduled[w];
 
 					//	report it if it's scheduled by round-robin
 					if (processIsNotInAffinityGroup) fout << unscheduled[w]->getName() << D_FULL;
@@ -444,6 +476,7 @@ namespace brahms
 				{
 					//	mark that we're computing it elsewhere
 					processesOnOtherNodes.push_back(unscheduled[w]->getName());
+					processVoices[unscheduled[w]->getName()] = voice;
 
 					//	and delete it
 					delete unscheduled[w];
@@ -470,28 +503,20 @@ namespace brahms
 				string dstName = links[l]->getDstProcessName();
 
 				//	find the object amongst processes
-				UINT32 p;
-				for (p=0; p<processes.size(); p++)
-					if (dstName == processes[p]->getName()) break;
+				map<string, Process*>::iterator i = processIndex.find(dstName);
 
 				//	if link dst is not on this voice, let's check it is on another one...
-				if (p == processes.size())
+				if (i == processIndex.end())
 				{
-					for (p=0; p<processesOnOtherNodes.size(); p++)
-					{
-						if (processesOnOtherNodes[p] == dstName)
-							break;
-					}
-
 					//	if not, throw
-					if (p == processesOnOtherNodes.size())
+					if (parsedProcessIndex.find(dstName) == parsedProcessIndex.end())
 						ferr << E_SYSTEM_FILE << "link dst process \"" << dstName << "\" not found in system";
 				}
 
 				//	if it is, link to it from the dst process object
 				else
 				{
-					processes[p]->addLink(links[l]);
+					i->second->addLink(links[l]);
 					fout << links[l]->getSrc() << " ==> " << links[l]->getDst() << D_VERB;
 				}
 			}
@@ -597,6 +622,9 @@ namespace brahms
 			//	prepare return result
 			PassResult prLocal = { false, true };
 
+			//	connect all inputs that peers can already supply, in one exchange per peer
+			findOutputsBatched();
+
 			//	for each process
 			for(UINT32 p=0; p<processes.size(); p++)
 			{
@@ -730,6 +758,10 @@ namespace brahms
 						string dataName = process->getObjectName() + ">>" + port->parentSet->getObjectName() + ">" + port->getObjectName();
 						data->setObjectName(dataName);
 
+						//	index it (port names need not be unique on a set, and
+						//	the first port so named is the one that is found)
+						localOutputIndex.insert(make_pair(dataName, port));
+
 						/*
 
 							**** NOTES on naming: ****
@@ -814,6 +846,11 @@ namespace brahms
 			//	message contents are two 0/1 characters representing finished/progress state
 			//	of this Voice at the end of its local pass for this global pass of connect phase
 
+			//	NOTE: ENDPHASE has to go direct to every peer, rather than through a tree,
+			//	since it is what releases each peer from serving us, and it must arrive after
+			//	any requests we made of it on the same channel. Since every peer receives it,
+			//	it also serves as the reduction of PassResult, at no extra cost.
+
 			//	send ENDPHASE to all Voices except ourselves
 			fout << "sending ENDPHASE" << D_VERB;
 			for (VoiceIndex remoteVoiceIndex=0; remoteVoiceIndex<engineData.core.getVoiceCount(); remoteVoiceIndex++)
@@ -868,6 +905,7 @@ namespace brahms
 
 						//	store
 						peerVoices[remoteVoiceIndex].outputs.push_back(outputName);
+						announcedOutputIndex.insert(make_pair(outputName, remoteVoiceIndex));
 
 						//	release message
 						ipmr->release();
@@ -885,166 +923,16 @@ namespace brahms
 						//	release message
 						ipmr->release();
 
-						//	NOTE: we only want to find a local one - if we have it, but it's not local,
-						//	some other voice is better placed than us to supply it!
-						Identifier outputNameIdentifier;
-						outputNameIdentifier.parse(outputName.c_str(), ST_OUTPUT_PORT, "argument of IPMTAG_FINDOUTPUT");
-						OutputPort* port = findOutputLocally(outputNameIdentifier);
-						
 						//	if found
-						if (port)
+						UINT32 msgStreamID;
+						string serial;
+						VoiceIndex relay;
+						if (serveOutput(remoteVoiceIndex, outputName, msgStreamID, serial, relay))
 						{
-							/*	DOCUMENTATION: PUSHDATA_IDENTICAL_TO_ALL_SENDERS
-
-								Search for the tag PUSHDATA_IDENTICAL_TO_ALL_SENDERS in port.cpp for full
-								details. Here, we implement the strategy of making sure multiple
-								InputPortRemote's attached to the same output get the same msgStreamID.
-								Note that this is still guaranteed to be "unique" at the remote voice,
-								since only one of these InputPortRemote's is connected to each remote voice.
-
-								(UNSORTED NOTES...)
-
-								The IPMTAG_OUTPUTFOUND returns with a "msgStreamID" value
-								which is the index of the Inlet to which the newly
-								created outlet is attached in this voice. This value is
-								unique to this Inlet in this voice, and, thus, to the
-								PUSHDATA connection on the channel it will be sent over
-								at runtime.
-
-								At the other end, when the message is received, a new
-								InletRemote is created. PUSHDATA messages, at runtime,
-								will be given the same "msgStreamID" value as this message,
-								so the receiving voice can associate the msgStreamID value
-								with a pointer to the newly created InletRemote.
-
-								Then, when the receiving thread gets PUSHDATA messages,
-								it can use the msgStreamID value to look up the pointer
-								to the Inlet in its msgStreamID table, and therefore push
-								the messages directly into the proper Inlet.
-
-								HOWEVER!
-
-								There may be multiple target peers that receive the same
-								stream from this voice. See notes in port.cpp as to why
-								they *must* accept the same msgStreamID. Therefore, if the
-								stream is already being sent to another voice, we use
-								the *same* msgStreamID in the later connection too...
-
-								THIS IS STILL BAD, in that the target will maintain
-								a sparse array (not that bad) and that we will make
-								a separate call to EVENT_GET_CONTENT for every attached
-								peer voice (this is potentially quite bad, though not
-								that bad for our supplied data classes because they don't
-								do a copy operation as part of that EVENT).
-
-							//	message stream ID need only be unique between us and the
-							//	peer voice who is asking for this, but this algorithm is
-							//	easy, at least. TODO: it's probably not good though, because
-							//	the receiving voice will keep a sparse array as a routing
-							//	table, potentially wasteful with large systems. better to
-							//	index per inter-voice channel rather than per system.
-
-							*/
-
-							//	old code works unless multiple InputPortRemote's attach to the same output
-							UINT32 msgStreamID = inputPortRemotes.size();
-
-							//	subtlety introduced to fix that problem (see documentation above)
-							for (UINT32 i=0; i<inputPortRemotes.size(); i++)
-							{
-								//	if an existing port has the same name we were seeking...
-								if (inputPortRemotes[i]->getObjectName() == outputName)
-								{
-									//	then just steal the msgStreamID from it!
-									msgStreamID = inputPortRemotes[i]->msgStreamID;
-									break;
-								}
-							}
-
-							//	report
-							fout << "(found)" << D_VERB;
-							fout << "serializing..." << D_FULL;
-
-
-
-							/*	DOCUMENTATION: INTERTHREAD_SIGNALLING
-					
-								We do syncing across an inlet/outlet pair if the two objects are running in
-								different threads. Remote outlets are given thread INDEX_NOT_SET so that they
-								must be different from all phsyical inlets on the local node, and thus will
-								be synced.
-							*/
-
-							//	create a new "remote input"
-							InputPortRemote* input = new InputPortRemote(
-								outputName,
-								engineData,
-								comms.channels[remoteVoiceIndex],
-								msgStreamID,
-								remoteVoiceIndex
-								);
-							inputPortRemotes.push_back(input);
-
-							//	report
-//							____INFO("new InputPortRemote");
-
-							//	connect to output port (zero lag for these, always)
-							port->connectInput(input, 0, fout);
-							port->connectRemoteInput(input);
-
-							//	get zeroth data object, for reference data
-							Data* data = port->getZerothData();
-							const ModuleInfo* moduleInfo = data->module->getInfo();
-							const ComponentInfo* componentInfo = data->getComponentInfo();
-
-							//	get wrapped data object, and have it serialize with structure for passing on to remote process
-							brahms::xml::XMLNode nodeSerial("Serial");
-							brahms::xml::XMLNode* nodeSpec = nodeSerial.appendChild(new brahms::xml::XMLNode("Spec"));
-							nodeSpec->appendChild(new brahms::xml::XMLNode("Class", componentInfo->cls));
-							nodeSpec->appendChild(new brahms::xml::XMLNode("Binding", brahms::text::n2s(moduleInfo->binding).c_str()));
-							nodeSpec->appendChild(new brahms::xml::XMLNode("Release", brahms::text::n2s(componentInfo->componentVersion->release).c_str()));
-
-							//	serialize base class state (Component)
-							brahms::xml::XMLNode* nodeComponent = nodeSerial.appendChild(new brahms::xml::XMLNode("Component"));
-							nodeComponent->appendChild(new brahms::xml::XMLNode("Name", data->getObjectName().c_str()));
-							
-							//	serialize base class state (Data)
-							ComponentTime* time = &data->componentTime;
-							brahms::xml::XMLNode* nodeData = nodeSerial.appendChild(new brahms::xml::XMLNode("Data"));
-							nodeData->appendChild(new brahms::xml::XMLNode("sampleRateNum", brahms::text::n2s(time->sampleRate.num).c_str()));
-							nodeData->appendChild(new brahms::xml::XMLNode("sampleRateDen", brahms::text::n2s(time->sampleRate.den).c_str()));
-
-							//	serialize derived class state (SystemML Object)
-							EventStateGet esg;
-							____CLEAR(esg);
-							esg.precision = PRECISION_NOT_SET;
-							brahms::EventEx event(
-								EVENT_STATE_GET,
-								0,
-								data,
-								&esg,
-								true,
-								&fout
-							);
-							event.fire();
-
-							if (!esg.state)
-								ferr << E_NOT_COMPLIANT << "data object \"" << data->getObjectName() << "\" did not return state in EVENT_STATE_GET";
-							brahms::xml::XMLNode* xnode = objectRegister.resolveXMLNode(esg.state);
-							if (xnode->nodeName() != string(""))
-								ferr << E_NOT_COMPLIANT << "data object \"" << data->getObjectName() << "\" set state node name in EVENT_STATE_GET";
-							xnode->nodeName("State");
-							nodeSerial.appendChild(xnode);
-
-							//	serialize it
-							stringstream ss;
-							nodeSerial.serialize(ss);
-							string sss = ss.str();
-
 							//	respond that we have it, and pass serialized object to remote process
 							brahms::base::IPM* ipms = engineData.pool.get(brahms::base::IPMTAG_OUTPUTFOUND, remoteVoiceIndex);
 							ipms->header().msgStreamID = msgStreamID;
-							ipms->appendString(sss);
+							ipms->appendString(serial);
 
 							//	send it
 							comms.push(ipms, fout);
@@ -1054,6 +942,16 @@ namespace brahms
 							fout << "OK" << D_VERB;
 						}
 
+						//	if it is to be fetched from a relay
+						else if (relay != VOICE_UNDEFINED)
+						{
+							//	respond with the voice to ask instead
+							brahms::base::IPM* ipms = engineData.pool.get(brahms::base::IPMTAG_OUTPUTRELAYED, remoteVoiceIndex);
+							ipms->appendString(brahms::text::n2s(relay));
+							comms.push(ipms, fout);
+							fout << "(pushed IPMTAG_OUTPUTRELAYED)" << D_VERB;
+						}
+
 						//	if not found
 						else
 						{
@@ -1068,6 +966,60 @@ namespace brahms
 						break;
 					}
 
+					case brahms::base::IPMTAG_FINDOUTPUTS:
+					{
+						//	requested outputs are packed end to end, each NULL-terminated
+						VSTRING outputNames;
+						const char* next = (const char*)ipmr->body();
+						const char* end = next + ipmr->header().bytesAfterHeaderUncompressed;
+						while (next < end)
+						{
+							outputNames.push_back(next);
+							next += outputNames.back().length() + 1;
+						}
+						fout << "received IPMTAG_FINDOUTPUTS (" << outputNames.size() << " outputs)" << D_VERB;
+
+						//	release message
+						ipmr->release();
+
+						//	answer all requests in a single message: for each, in the order
+						//	requested, a msgStreamID (IPM_UNDEFINED if not found, IPM_RELAYED
+						//	if to be fetched from a relay) followed by the serialized data
+						//	object (empty if not found, the relay voice if relayed). the header
+						//	msgStreamID carries the highest stream ID in the batch, so that
+						//	the sender can initialise its send auditors in one go.
+						brahms::base::IPM* ipms = engineData.pool.get(brahms::base::IPMTAG_OUTPUTSFOUND, remoteVoiceIndex);
+						for (UINT32 o=0; o<outputNames.size(); o++)
+						{
+							UINT32 msgStreamID;
+							string serial;
+							VoiceIndex relay;
+							if (serveOutput(remoteVoiceIndex, outputNames[o], msgStreamID, serial, relay))
+							{
+								UINT32& maxID = ipms->header().msgStreamID;
+								if (maxID == brahms::base::IPM_UNDEFINED || msgStreamID > maxID)
+									maxID = msgStreamID;
+								fout << "(found \"" << outputNames[o] << "\")" << D_FULL;
+							}
+							else if (relay != VOICE_UNDEFINED)
+							{
+								msgStreamID = brahms::base::IPM_RELAYED;
+								serial = brahms::text::n2s(relay);
+								fout << "(relayed \"" << outputNames[o] << "\" by voice " << unitIndex(relay) << ")" << D_VERB;
+							}
+							else fout << "(not found \"" << outputNames[o] << "\")" << D_VERB;
+
+							ipms->appendBytes((BYTE*)&msgStreamID, sizeof(UINT32));
+							ipms->appendString(serial);
+						}
+
+						//	send it
+						comms.push(ipms, fout);
+						fout << "(pushed IPMTAG_OUTPUTSFOUND)" << D_FULL;
+
+						//	ok
+						break;
+					}
 					default:
 					{
 						//	we don't understand!
@@ -1083,56 +1035,540 @@ namespace brahms
 			}
 		}
 
-		OutputPort* System::findOutputLocally(Identifier& outputName)
+		/*	DOCUMENTATION: RELAY_TREE
+
+			An output read on many voices is, by default, sent by its own
+			voice once to each of them, so that its sender thread and link
+			carry every copy. If RelayFanout is non-zero, the readers are
+			instead arranged into a tree with RelayFanout children per node,
+			rooted at the voice that owns the output. The tree is built from
+			the order in which readers ask for the output during the connect
+			phase: the first RelayFanout readers are served directly, and each
+			later reader is answered with IPMTAG_OUTPUTRELAYED (IPM_RELAYED in
+			a batch) naming an earlier reader, in breadth-first order, which
+			it then asks instead.
+
+			A relay serves such a request from its remote OutputPort, just
+			as it would a local one, by attaching an InputPortRemote to it.
+			Writing a remote OutputPort, which the relay's receiver thread
+			does on each PUSHDATA, then forwards the sample to its children
+			(see InputPortRemote::outputWriteReleased()), so no PUSHDATA is
+			handled other than as a received sample would be anyway. A child
+			that is slow to receive holds the relay's ring buffer, and so in
+			turn the relay's receiver, so back-pressure reaches the root as
+			it would over a direct link. The cost is one extra hop of latency
+			per level of the tree.
+		*/
+
+		bool System::serveOutput(UINT32 remoteVoiceIndex, const string& outputName, UINT32& msgStreamID, string& serial, VoiceIndex& relay)
 		{
-			//	look for it locally
-			for (UINT32 p=0; p<processes.size(); p++)
+			brahms::output::Source& fout(engineData.core.caller.tout);
+
+			//	default return
+			msgStreamID = brahms::base::IPM_UNDEFINED;
+			relay = VOICE_UNDEFINED;
+
+			//	NOTE: we only want to find a local one - if we have it, but it's not local,
+			//	some other voice is better placed than us to supply it!
+			Identifier outputNameIdentifier;
+			outputNameIdentifier.parse(outputName.c_str(), ST_OUTPUT_PORT, "argument of IPMTAG_FINDOUTPUT");
+			OutputPort* port = findOutputLocally(outputNameIdentifier);
+
+			//	unless we have been asked as a relay (see RELAY_TREE)
+			if (!port)
 			{
-				if (processes[p]->getObjectName() == outputName.processName)
-					return processes[p]->findOutput(outputName);
+				port = findOutputRemotely(outputName);
+				if (port) fout << "(relaying)" << D_VERB;
+			}
+
+			//	if it is ours, place the reader in the relay tree
+			else
+			{
+				UINT32 fanout = engineData.environment.getu("RelayFanout");
+				vector<VoiceIndex>& readers = remoteReaders[outputName];
+				UINT32 k = readers.size();
+				readers.push_back(remoteVoiceIndex);
+
+				//	the first "fanout" readers are ours, reader k has parent reader (k - fanout) / fanout
+				if (fanout && k >= fanout)
+				{
+					relay = readers[(k - fanout) / fanout];
+					fout << "(relayed by voice " << unitIndex(relay) << ")" << D_VERB;
+					return false;
+				}
 			}
 
 			//	not found
-			return NULL;
+			if (!port) return false;
+
+			/*	DOCUMENTATION: PUSHDATA_IDENTICAL_TO_ALL_SENDERS
+
+				Search for the tag PUSHDATA_IDENTICAL_TO_ALL_SENDERS in port.cpp for full
+				details. Here, we implement the strategy of making sure multiple
+				InputPortRemote's attached to the same output get the same msgStreamID.
+				Note that this is still guaranteed to be "unique" at the remote voice,
+				since only one of these InputPortRemote's is connected to each remote voice.
+
+				(UNSORTED NOTES...)
+
+				The IPMTAG_OUTPUTFOUND returns with a "msgStreamID" value
+				which is the index of the Inlet to which the newly
+				created outlet is attached in this voice. This value is
+				unique to this Inlet in this voice, and, thus, to the
+				PUSHDATA connection on the channel it will be sent over
+				at runtime.
+
+				At the other end, when the message is received, a new
+				InletRemote is created. PUSHDATA messages, at runtime,
+				will be given the same "msgStreamID" value as this message,
+				so the receiving voice can associate the msgStreamID value
+				with a pointer to the newly created InletRemote.
+
+				Then, when the receiving thread gets PUSHDATA messages,
+				it can use the msgStreamID value to look up the pointer
+				to the Inlet in its msgStreamID table, and therefore push
+				the messages directly into the proper Inlet.
+
+				HOWEVER!
+
+				There may be multiple target peers that receive the same
+				stream from this voice. See notes in port.cpp as to why
+				they *must* accept the same msgStreamID. Therefore, if the
+				stream is already being sent to another voice, we use
+				the *same* msgStreamID in the later connection too...
+
+				THIS IS STILL BAD, in that the target will maintain
+				a sparse array (not that bad) and that we will make
+				a separate call to EVENT_GET_CONTENT for every attached
+				peer voice (this is potentially quite bad, though not
+				that bad for our supplied data classes because they don't
+				do a copy operation as part of that EVENT).
+
+			//	message stream ID need only be unique between us and the
+			//	peer voice who is asking for this, but this algorithm is
+			//	easy, at least. TODO: it's probably not good though, because
+			//	the receiving voice will keep a sparse array as a routing
+			//	table, potentially wasteful with large systems. better to
+			//	index per inter-voice channel rather than per system.
+
+			*/
+
+			//	old code works unless multiple InputPortRemote's attach to the same output
+			msgStreamID = inputPortRemotes.size();
+
+			//	subtlety introduced to fix that problem (see documentation above):
+			//	if an existing port has the same name we were seeking, then just
+			//	steal the msgStreamID from it!
+			map<string, UINT32>::iterator i = remoteInputStreamIndex.find(outputName);
+			if (i != remoteInputStreamIndex.end()) msgStreamID = i->second;
+			else remoteInputStreamIndex[outputName] = msgStreamID;
+
+			//	report
+			fout << "(found)" << D_VERB;
+			fout << "serializing..." << D_FULL;
+
+
+
+			/*	DOCUMENTATION: INTERTHREAD_SIGNALLING
+	
+				We do syncing across an inlet/outlet pair if the two objects are running in
+				different threads. Remote outlets are given thread INDEX_NOT_SET so that they
+				must be different from all phsyical inlets on the local node, and thus will
+				be synced.
+			*/
+
+			//	create a new "remote input"
+			InputPortRemote* input = new InputPortRemote(
+				outputName,
+				engineData,
+				comms.channels[remoteVoiceIndex],
+				msgStreamID,
+				remoteVoiceIndex
+				);
+			inputPortRemotes.push_back(input);
+
+			//	report
+//			____INFO("new InputPortRemote");
+
+			//	connect to output port (zero lag for these, always)
+			port->connectInput(input, 0, fout);
+			port->connectRemoteInput(input);
+
+			//	get zeroth data object, for reference data
+			Data* data = port->getZerothData();
+
+			//	let the writer run ahead of the peer as far as its links allow (see LOOKAHEAD)
+			UINT32 lookahead = remoteLookahead(outputName, remoteVoiceIndex);
+			if (lookahead)
+			{
+				port->reserveBuffers(lookahead + 1, fout);
+				const SampleRate& rate = data->componentTime.sampleRate;
+				fout << "lookahead to voice " << unitIndex(remoteVoiceIndex) << " is " << lookahead << " samples ("
+					<< (((DOUBLE)lookahead) * ((DOUBLE)rate.den) / ((DOUBLE)rate.num)) << "s)" << D_VERB;
+			}
+			const ModuleInfo* moduleInfo = data->module->getInfo();
+			const ComponentInfo* componentInfo = data->getComponentInfo();
+
+			//	get wrapped data object, and have it serialize with structure for passing on to remote process
+			brahms::xml::XMLNode nodeSerial("Serial");
+			brahms::xml::XMLNode* nodeSpec = nodeSerial.appendChild(new brahms::xml::XMLNode("Spec"));
+			nodeSpec->appendChild(new brahms::xml::XMLNode("Class", componentInfo->cls));
+			nodeSpec->appendChild(new brahms::xml::XMLNode("Binding", brahms::text::n2s(moduleInfo->binding).c_str()));
+			nodeSpec->appendChild(new brahms::xml::XMLNode("Release", brahms::text::n2s(componentInfo->componentVersion->release).c_str()));
+
+			//	serialize base class state (Component)
+			brahms::xml::XMLNode* nodeComponent = nodeSerial.appendChild(new brahms::xml::XMLNode("Component"));
+			nodeComponent->appendChild(new brahms::xml::XMLNode("Name", data->getObjectName().c_str()));
+			
+			//	serialize base class state (Data)
+			ComponentTime* time = &data->componentTime;
+			brahms::xml::XMLNode* nodeData = nodeSerial.appendChild(new brahms::xml::XMLNode("Data"));
+			nodeData->appendChild(new brahms::xml::XMLNode("sampleRateNum", brahms::text::n2s(time->sampleRate.num).c_str()));
+			nodeData->appendChild(new brahms::xml::XMLNode("sampleRateDen", brahms::text::n2s(time->sampleRate.den).c_str()));
+
+			//	serialize derived class state (SystemML Object)
+			EventStateGet esg;
+			____CLEAR(esg);
+			esg.precision = PRECISION_NOT_SET;
+			brahms::EventEx event(
+				EVENT_STATE_GET,
+				0,
+				data,
+				&esg,
+				true,
+				&fout
+			);
+			event.fire();
+
+			if (!esg.state)
+				ferr << E_NOT_COMPLIANT << "data object \"" << data->getObjectName() << "\" did not return state in EVENT_STATE_GET";
+			brahms::xml::XMLNode* xnode = objectRegister.resolveXMLNode(esg.state);
+			if (xnode->nodeName() != string(""))
+				ferr << E_NOT_COMPLIANT << "data object \"" << data->getObjectName() << "\" set state node name in EVENT_STATE_GET";
+			xnode->nodeName("State");
+			nodeSerial.appendChild(xnode);
+
+			//	serialize it
+			stringstream ss;
+			nodeSerial.serialize(ss);
+			serial = ss.str();
+
+			//	ok
+			return true;
 		}
 
-		OutputPort* System::findOutput(Identifier& outputName)
+
+		/*	DOCUMENTATION: LOOKAHEAD
+
+			A link of lag L lets its reader run up to L samples ahead of its
+			writer. Across voices, the reader's end already allows this, since
+			the remote OutputPort that receives the link has a ring buffer of
+			L+1 samples for its lagged reader. But at the writer's end, the
+			InputPortRemote that sends the link reads at lag zero, so unless
+			some local reader had a lag, the writer could get only one sample
+			ahead of the send of each sample, and the two voices ran close to
+			lock-step, each sample waiting on the sender thread.
+
+			The lookahead of a link to a peer is therefore worked out when it
+			is served: the smallest lag of any link from the output to a process
+			on that voice, which is L samples, or L sample periods. The writer's
+			ring buffer is grown to hold that many samples more (up to
+			PushDataMaxItems, beyond which the sender would hold it back anyway)
+			so that the writer, too, may run a whole window ahead, and the two
+			voices advance independently within it. This is the conservative
+			synchronisation of parallel discrete-event simulation: no voice ever
+			computes a sample whose inputs could still change, so results are
+			unchanged. A window's worth of PUSHDATA that builds up in the sender
+			queue is coalesced on the wire (see SENDER_COALESCING).
+		*/
+
+		UINT32 System::remoteLookahead(const string& outputName, VoiceIndex remoteVoiceIndex)
+		{
+			//	smallest lag of any link from this output to a process on that voice
+			UINT32 lookahead = 0;
+			bool found = false;
+			for (UINT32 l=0; l<links.size(); l++)
+			{
+				if (string(links[l]->src) != outputName) continue;
+				map<string, VoiceIndex>::iterator i = processVoices.find(links[l]->getDstProcessName());
+				if (i == processVoices.end() || i->second != remoteVoiceIndex) continue;
+				if (!found || links[l]->lag < lookahead) lookahead = links[l]->lag;
+				found = true;
+			}
+
+			//	the sender would hold back a writer that got further ahead than this
+			UINT32 maxItems = engineData.environment.getu("PushDataMaxItems");
+			if (lookahead > maxItems) lookahead = maxItems;
+
+			//	ok
+			return lookahead;
+		}
+
+		OutputPort* System::connectRemoteOutput(UINT32 remoteVoiceIndex, UINT32 msgStreamID, const char* serial)
 		{
 			brahms::output::Source& fout(engineData.core.caller.tout);
 
+			//	message content will be a serialized (with structure) data object
+			brahms::xml::XMLNode nodeSerial;
+			nodeSerial.parse(serial);
+			brahms::xml::XMLNode* nodeSpec = nodeSerial.getChild("Spec");
+			string className = nodeSpec->getChild("Class")->nodeText();
+			string language = nodeSpec->getChild("Binding")->nodeText();
+			string release = nodeSpec->getChild("Release")->nodeText();
+			UINT16 urelease = atof(release.c_str());
+
+			//	unserialize base class state (Component)
+			brahms::xml::XMLNode* nodeComponent = nodeSerial.getChild("Component");
+			string name = nodeComponent->getChild("Name")->nodeText();
+
+			//	unserialize base class state (Data)
+			brahms::xml::XMLNode* nodeData = nodeSerial.getChild("Data");
+			SampleRate sampleRate;
+			sampleRate.num = atof(nodeData->getChild("sampleRateNum")->nodeText());
+			sampleRate.den = atof(nodeData->getChild("sampleRateDen")->nodeText());
+
+			//	instantiate the data object
+			Data* data = new Data(name.c_str(), engineData, &fout, className, urelease, sampleRate);
+
+			//	load component module
+			data->load(fout);
+
+			//	instantiate the data component
+			data->instantiate(&fout);
+
+			//	unserialize derived class state (SystemML Object)
+			EventStateSet ess;
+			____CLEAR(ess);
+			ess.state = nodeSerial.getChild("State")->getObjectHandle();
+			brahms::EventEx event(
+				EVENT_STATE_SET,
+				0,
+				data,
+				&ess,
+				true,
+				&fout
+			);
+			event.fire();
+
+			//	create new port
+			/* SEE NOTES on naming */
+			outputPortRemotes.push_back(new OutputPort(name.c_str(), engineData, data, NULL));
+			remoteOutputIndex.insert(make_pair(name, outputPortRemotes.back()));
+			remoteOutputStreamNames[make_pair(remoteVoiceIndex, msgStreamID)] = name;
+
+			//	report
+//			____INFO("new OutputPort(Remote)\n");
+
+			//	set port due data to zeroth buffer so that it's available for sml_getPortData() before run phase begins
+			outputPortRemotes.back()->setDueData(data);
+
+			//	large payloads are read in place (see ZERO_COPY_RECEIVE)
+			outputPortRemotes.back()->adoptBytes = engineData.environment.getu("ZeroCopyReceive");
+
+			/*	DOCUMENTATION: INTERTHREAD_SIGNALLING
+
+				we do syncing across an inlet/outlet pair if the two
+				objects are running in different threads. remote OutputPorts
+				have no "parentSet", so they are always known to be running
+				in different threads from any worker thread, and are thus
+				not given redundant thread-locking.
+			*/
+
+			//	add entry to channel's routing table
+			comms.addRoutingEntry(remoteVoiceIndex, msgStreamID, pushdataHandler, outputPortRemotes.back());
+
+			//	report
+			fout << "OK" << D_FULL;
+
+			//	ok
+			return outputPortRemotes.back();
+		}
+
+
+		OutputPort* System::findOutputLocally(Identifier& outputName)
+		{
 			//	look for it locally
-			OutputPort* localPort = findOutputLocally(outputName);
-			if (localPort) return localPort;
+			map<string, OutputPort*>::iterator i = localOutputIndex.find(string(outputName));
+			if (i != localOutputIndex.end()) return i->second;
 
+			//	not found
+			return NULL;
+		}
+
+		OutputPort* System::findOutputRemotely(const string& dataName)
+		{
 			//	look for it amongst already-connected remote outputs
-			string dataName = string(outputName);
-			for (UINT32 i=0; i<outputPortRemotes.size(); i++)
+			map<string, OutputPort*>::iterator i = remoteOutputIndex.find(dataName);
+			if (i != remoteOutputIndex.end()) return i->second;
+
+			//	not found
+			return NULL;
+		}
+
+		VoiceIndex System::findAnnouncingVoice(const string& dataName)
+		{
+			//	only ask remote voice for this object if our register (created
+			//	by servicing IPMTAG_ANNOUNCEOUTPUT messages) says that they
+			//	have it (otherwise, the call would be a waste of time)
+			map<string, VoiceIndex>::iterator i = announcedOutputIndex.find(dataName);
+			if (i != announcedOutputIndex.end()) return i->second;
+
+			//	not announced
+			return VOICE_UNDEFINED;
+		}
+
+		void System::findOutputsBatched()
+		{
+			brahms::output::Source& fout(engineData.core.caller.tout);
+
+			/*
+
+				Calling findOutput() for each unseen input costs one round trip
+				to a peer for every input that is satisfied remotely. Instead, we
+				collect all unseen inputs that some peer has announced, and ask
+				each peer for all of its outputs we need in a single message. All
+				requests are sent before any reply is collected, so that peers
+				serve them concurrently. The connected remote outputs are then
+				found by findOutput() during the pass itself without any further
+				traffic, so the cost of a pass is O(peers) rather than O(links).
+
+			*/
+
+			//	solo has nothing to ask for
+			VoiceIndex voiceCount = engineData.core.getVoiceCount();
+			if (voiceCount < 2) return;
+
+			//	collect requests for each peer
+			vector<VSTRING> requests(voiceCount);
+			set<string> requested;
+			for (UINT32 p=0; p<processes.size(); p++)
 			{
-				if (outputPortRemotes[i]->getObjectName() == dataName)
-					return outputPortRemotes[i];
+				vector<InputPortLocal*> unseenInputs = processes[p]->getUnseenInputs();
+				for (UINT32 i=0; i<unseenInputs.size(); i++)
+				{
+					Identifier& src = unseenInputs[i]->link->src;
+
+					//	local outputs don't need asking for
+					if (findOutputLocally(src)) continue;
+
+					//	nor do those we've already connected
+					string dataName = string(src);
+					if (findOutputRemotely(dataName)) continue;
+
+					//	nor those that nobody has yet
+					VoiceIndex remoteVoiceIndex = findAnnouncingVoice(dataName);
+					if (remoteVoiceIndex == VOICE_UNDEFINED) continue;
+
+					//	several inputs may read the same output
+					if (!requested.insert(dataName).second) continue;
+
+					//	add to request
+					requests[remoteVoiceIndex].push_back(dataName);
+				}
 			}
 
-			//	ask peers if they have it, and connect a stream if so
-			for (UINT32 remoteVoiceIndex=0; remoteVoiceIndex<engineData.core.getVoiceCount(); remoteVoiceIndex++)
+			//	nothing to do
+			if (requested.empty()) return;
+
+			//	outputs that are relayed are asked for again from the relay (see RELAY_TREE)
+			while (true)
 			{
-				//	skip ourselves
-				if (remoteVoiceIndex == ((UINT32)engineData.core.getVoiceIndex())) continue;
+				vector<VSTRING> relayed(voiceCount);
+				bool anyRelayed = false;
 
-				//	only ask remote voice for this object if our register (created
-				//	by servicing IPMTAG_ANNOUNCEOUTPUT messages) says that they
-				//	have it (otherwise, the call would be a waste of time)
-				bool available = false;
-				PeerVoice& peerVoice = peerVoices[remoteVoiceIndex];
-				for (UINT32 o=0; o<peerVoice.outputs.size(); o++)
+				//	send all requests
+				for (VoiceIndex remoteVoiceIndex=0; remoteVoiceIndex<voiceCount; remoteVoiceIndex++)
 				{
-					if (peerVoice.outputs[o] == dataName)
+					VSTRING& request = requests[remoteVoiceIndex];
+					if (!request.size()) continue;
+
+					brahms::base::IPM* ipms = engineData.pool.get(brahms::base::IPMTAG_FINDOUTPUTS, remoteVoiceIndex);
+					for (UINT32 o=0; o<request.size(); o++)
+						ipms->appendString(request[o]);
+					comms.push(ipms, fout);
+					fout << "sent IPMTAG_FINDOUTPUTS (" << request.size() << " outputs) to voice " << unitIndex(remoteVoiceIndex) << D_VERB;
+				}
+
+				//	collect all replies
+				for (VoiceIndex remoteVoiceIndex=0; remoteVoiceIndex<voiceCount; remoteVoiceIndex++)
+				{
+					VSTRING& request = requests[remoteVoiceIndex];
+					if (!request.size()) continue;
+
+					//	get response
+					brahms::base::IPM* ipmr;
+					comms.pull(remoteVoiceIndex, ipmr, brahms::base::IPMTAG_UNDEFINED, fout, brahms::channel::COMMS_TIMEOUT_DEFAULT, true);
+
+					//	check
+					UINT8 tag = ipmr->header().tag;
+					if (tag != brahms::base::IPMTAG_OUTPUTSFOUND)
 					{
-						available = true;
-						break;
+						ipmr->release();
+						ferr << E_COMMS << "invalid response received to IPMTAG_FINDOUTPUTS (" << brahms::base::TranslateIPMTAG(tag) << ")";
+					}
+					fout << "recv IPMTAG_OUTPUTSFOUND" << D_VERB;
+
+					//	unpack one answer per request
+					UINT32 offset = 0;
+					for (UINT32 o=0; o<request.size(); o++)
+					{
+						UINT32 msgStreamID;
+						memcpy(&msgStreamID, ipmr->body(offset), sizeof(UINT32));
+						offset += sizeof(UINT32);
+						const char* serial = (const char*)ipmr->body(offset);
+						offset += strlen(serial) + 1;
+
+						if (msgStreamID == brahms::base::IPM_UNDEFINED)
+						{
+							fout << "(not found \"" << request[o] << "\")" << D_VERB;
+							continue;
+						}
+
+						if (msgStreamID == brahms::base::IPM_RELAYED)
+						{
+							VoiceIndex relay = atoi(serial);
+							if (relay >= voiceCount || relay == remoteVoiceIndex)
+							{
+								ipmr->release();
+								ferr << E_COMMS << "invalid relay voice in IPMTAG_OUTPUTSFOUND";
+							}
+							fout << "(relayed \"" << request[o] << "\" by voice " << unitIndex(relay) << ")" << D_VERB;
+							relayed[relay].push_back(request[o]);
+							anyRelayed = true;
+							continue;
+						}
+
+						connectRemoteOutput(remoteVoiceIndex, msgStreamID, serial);
 					}
+
+					//	release
+					ipmr->release();
 				}
-				if (!available) continue;
 
+				//	done, unless some outputs are to be asked for from relays
+				if (!anyRelayed) break;
+				requests = relayed;
+			}
+		}
+
+		OutputPort* System::findOutput(Identifier& outputName)
+		{
+			brahms::output::Source& fout(engineData.core.caller.tout);
+
+			//	look for it locally
+			OutputPort* localPort = findOutputLocally(outputName);
+			if (localPort) return localPort;
+
+			//	look for it amongst already-connected remote outputs
+			string dataName = string(outputName);
+			OutputPort* remotePort = findOutputRemotely(dataName);
+			if (remotePort) return remotePort;
+
+			//	ask the peer that announced it for it, and connect a stream if so
+			//	(or ask the relay it names instead, see RELAY_TREE)
+			VoiceIndex remoteVoiceIndex = findAnnouncingVoice(dataName);
+			while (remoteVoiceIndex != VOICE_UNDEFINED)
+			{
 				//	ask remote Voice for this data object
 				brahms::base::IPM* ipms = engineData.pool.get(brahms::base::IPMTAG_FINDOUTPUT, remoteVoiceIndex);
 				ipms->appendString(dataName);
@@ -1149,77 +1585,29 @@ namespace brahms
 					fout << "recv IPMTAG_OUTPUTFOUND" << D_VERB;
 
 					//	message content will be a serialized (with structure) data object
-					brahms::xml::XMLNode nodeSerial;
-					nodeSerial.parse((const char*)ipmr->body());
-					brahms::xml::XMLNode* nodeSpec = nodeSerial.getChild("Spec");
-					string className = nodeSpec->getChild("Class")->nodeText();
-					string language = nodeSpec->getChild("Binding")->nodeText();
-					string release = nodeSpec->getChild("Release")->nodeText();
-					UINT16 urelease = atof(release.c_str());
-
-					//	unserialize base class state (Component)
-					brahms::xml::XMLNode* nodeComponent = nodeSerial.getChild("Component");
-					string name = nodeComponent->getChild("Name")->nodeText();
-
-					//	unserialize base class state (Data)
-					brahms::xml::XMLNode* nodeData = nodeSerial.getChild("Data");
-					SampleRate sampleRate;
-					sampleRate.num = atof(nodeData->getChild("sampleRateNum")->nodeText());
-					sampleRate.den = atof(nodeData->getChild("sampleRateDen")->nodeText());
-
-					//	instantiate the data object
-					Data* data = new Data(name.c_str(), engineData, &fout, className, urelease, sampleRate);
-
-					//	load component module
-					data->load(fout);
-
-					//	instantiate the data component
-					data->instantiate(&fout);
-
-					//	unserialize derived class state (SystemML Object)
-					EventStateSet ess;
-					____CLEAR(ess);
-					ess.state = nodeSerial.getChild("State")->getObjectHandle();
-					brahms::EventEx event(
-						EVENT_STATE_SET,
-						0,
-						data,
-						&ess,
-						true,
-						&fout
-					);
-					event.fire();
-
-					//	create new port
-					/* SEE NOTES on naming */
-					outputPortRemotes.push_back(new OutputPort(name.c_str(), engineData, data, NULL));
-
-					//	report
-//					____INFO("new OutputPort(Remote)\n");
-
-					//	set port due data to zeroth buffer so that it's available for sml_getPortData() before run phase begins
-					outputPortRemotes.back()->setDueData(data);
-
-					/*	DOCUMENTATION: INTERTHREAD_SIGNALLING
-
-						we do syncing across an inlet/outlet pair if the two
-						objects are running in different threads. remote OutputPorts
-						have no "parentSet", so they are always known to be running
-						in different threads from any worker thread, and are thus
-						not given redundant thread-locking.
-					*/
-
-					//	add entry to channel's routing table
-					comms.addRoutingEntry(remoteVoiceIndex, ipmr->header().msgStreamID, pushdataHandler, outputPortRemotes.back());
-
-					//	report
-					fout << "OK" << D_FULL;
+					OutputPort* port = connectRemoteOutput(remoteVoiceIndex, ipmr->header().msgStreamID, (const char*)ipmr->body());
 
 					//	release
 					ipmr->release();
 
 					//	ok, we can return it now
-					return outputPortRemotes.back();
+					return port;
+				}
+
+				else if (ipmr->header().tag == brahms::base::IPMTAG_OUTPUTRELAYED)
+				{
+					//	ask the relay
+					VoiceIndex relay = atoi((const char*)ipmr->body());
+					fout << "recv IPMTAG_OUTPUTRELAYED (voice " << unitIndex(relay) << ")" << D_VERB;
+					if (relay >= engineData.core.getVoiceCount() || relay == remoteVoiceIndex)
+					{
+						ipmr->release();
+						ferr << E_COMMS << "invalid relay voice in IPMTAG_OUTPUTRELAYED";
+					}
+
+					//	release
+					ipmr->release();
+					remoteVoiceIndex = relay;
 				}
 
 				else if (ipmr->header().tag == brahms::base::IPMTAG_OUTPUTNOTFOUND)
@@ -1229,6 +1617,7 @@ namespace brahms
 
 					//	no action, not yet found
 					fout << "recv IPMTAG_OUTPUTNOTFOUND" << D_VERB;
+					break;
 				}
 
 				else
@@ -1292,6 +1681,389 @@ namespace brahms
 			return ret;
 		}
 
+
+
+		////////////////	VOICE PARTITION
+
+		/*	DOCUMENTATION: VOICE_PARTITION
+
+			By default, processes not placed by the Affinity section of the
+			Execution File are spread across voices by count alone. If the
+			execution parameter VoicePartition is "traffic", they are instead
+			placed so as to minimise the bytes per second that cross between
+			voices, subject to no voice taking more than its share of the
+			processes (plus VOICE_PARTITION_IMBALANCE). Affinity groups are
+			placed as a unit, and groups with an explicit Voice stay put.
+
+			A link is weighted by the sample rate of its source times the
+			bytes per sample of its source output. The latter is not known
+			until the connect passes are complete, so it is read from the
+			<Traffic> section of the previous run's Report Files (written
+			by reportTraffic()); outputs not found there are taken to be of
+			average size, so that on a first run links are weighted by rate.
+
+			Placement is by greedy growth (heaviest units first, each to the
+			voice it talks to most that has room) followed by a few passes
+			of single moves that reduce the cut. Voices may not all see the
+			same Report Files, so only the master computes the partition,
+			and it sends it to the others (IPMTAG_PUSHPARTITION).
+		*/
+
+		const DOUBLE VOICE_PARTITION_IMBALANCE = 0.05;
+		const UINT32 VOICE_PARTITION_PASSES = 8;
+
+		void System::partitionByTraffic(const vector<Process*>& unscheduled, const vector<INT32>& processGroup, brahms::Execution& execution, vector<VoiceIndex>& partition)
+		{
+			brahms::output::Source& fout(engineData.core.caller.tout);
+			VoiceCount voiceCount = engineData.core.getVoiceCount();
+			UINT32 processCount = unscheduled.size();
+			partition.resize(processCount);
+
+			//	if not master, get partition from master
+			if (engineData.core.getVoiceIndex() != VOICE_MASTER)
+			{
+				fout << "retrieve partition from master" << D_VERB;
+				brahms::base::IPM* ipmr;
+				comms.pull(VOICE_MASTER, ipmr, brahms::base::IPMTAG_UNDEFINED, fout, brahms::channel::COMMS_TIMEOUT_DEFAULT, true);
+				if (ipmr->header().tag != brahms::base::IPMTAG_PUSHPARTITION)
+				{
+					ipmr->release();
+					ferr << E_COMMS << "expected IPMTAG_PUSHPARTITION at this point";
+				}
+				if (ipmr->header().bytesAfterHeaderUncompressed != processCount * sizeof(VoiceIndex))
+				{
+					ipmr->release();
+					ferr << E_COMMS << "invalid IPMTAG_PUSHPARTITION msg (do all voices have the same System File?)";
+				}
+				if (processCount) memcpy(&partition[0], ipmr->body(), processCount * sizeof(VoiceIndex));
+				ipmr->release();
+				return;
+			}
+
+			//	---- BYTES PER SAMPLE FROM PREVIOUS RUN ----
+
+			map<string, DOUBLE> bytesPerSample;
+			for (VoiceIndex v=0; v<voiceCount; v++)
+			{
+				string path = execution.fileReportForm;
+				brahms::text::grep(path, "((VOICE))", brahms::text::n2s(unitIndex(v)));
+				ifstream fileReport(path.c_str());
+				if (!fileReport) continue;
+
+				brahms::xml::XMLNode nodeReport;
+				try
+				{
+					nodeReport.parse(fileReport);
+				}
+				catch(brahms::error::Error& e)
+				{
+					fout << "could not parse previous Report File \"" << path << "\" (" << e.format(FMT_TEXT, false) << ")" << D_WARN;
+					continue;
+				}
+
+				brahms::xml::XMLNode* node = nodeReport.getChildOrNull("Environment");
+				if (node) node = node->getChildOrNull("Client");
+				if (node) node = node->getChildOrNull("Performance");
+				if (node) node = node->getChildOrNull("Traffic");
+				if (!node) continue;
+
+				const brahms::xml::XMLNodeList* nodesOutput = node->childNodes();
+				for (UINT32 n=0; n<nodesOutput->size(); n++)
+				{
+					brahms::xml::XMLNode* nodeOutput = nodesOutput->at(n);
+					DOUBLE bytes = brahms::text::s2n(nodeOutput->getChild("Bytes")->nodeText());
+					if (bytes == brahms::text::S2N_FAILED) continue;
+					bytesPerSample[nodeOutput->getChild("Name")->nodeText()] = bytes;
+				}
+			}
+
+			//	unknown outputs are taken to be average
+			DOUBLE defaultBytes = 1.0;
+			if (bytesPerSample.size())
+			{
+				DOUBLE sum = 0.0;
+				for (map<string, DOUBLE>::iterator i=bytesPerSample.begin(); i!=bytesPerSample.end(); i++)
+					sum += i->second;
+				defaultBytes = sum / bytesPerSample.size();
+			}
+			fout << "have bytes per sample for " << bytesPerSample.size() << " outputs from previous run" << D_VERB;
+
+			//	---- UNITS (AFFINITY GROUPS, OR SINGLE PROCESSES) ----
+
+			vector<UINT32> unitOf(processCount);
+			vector<UINT32> unitSize;
+			vector<VoiceIndex> unitVoice;
+			map<INT32, UINT32> groupUnit;
+			map<string, UINT32> processByName;
+			for (UINT32 w=0; w<processCount; w++)
+			{
+				processByName[unscheduled[w]->getName()] = w;
+
+				INT32 g = processGroup[w];
+				if (g != -1 && groupUnit.count(g))
+				{
+					unitOf[w] = groupUnit[g];
+				}
+				else
+				{
+					unitOf[w] = unitSize.size();
+					unitSize.push_back(0);
+					unitVoice.push_back(g == -1 ? VOICE_UNDEFINED : execution.groups[g].voice);
+					if (g != -1) groupUnit[g] = unitOf[w];
+				}
+				unitSize[unitOf[w]]++;
+			}
+			UINT32 unitCount = unitSize.size();
+
+			//	---- TRAFFIC BETWEEN UNITS ----
+
+			vector< map<UINT32, DOUBLE> > traffic(unitCount);
+			vector<DOUBLE> unitTraffic(unitCount, 0.0);
+			DOUBLE totalTraffic = 0.0;
+			for (UINT32 l=0; l<links.size(); l++)
+			{
+				Link* link = links[l];
+				map<string, UINT32>::iterator isrc = processByName.find(link->getSrcProcessName());
+				map<string, UINT32>::iterator idst = processByName.find(link->getDstProcessName());
+				if (isrc == processByName.end() || idst == processByName.end()) continue;
+				UINT32 us = unitOf[isrc->second];
+				UINT32 ud = unitOf[idst->second];
+				if (us == ud) continue;
+
+				SampleRate sampleRate = unscheduled[isrc->second]->getSampleRate();
+				DOUBLE rate = ((DOUBLE)sampleRate.num) / ((DOUBLE)sampleRate.den);
+				map<string, DOUBLE>::iterator ib = bytesPerSample.find(string(link->src));
+				DOUBLE bytesPerSec = rate * (ib == bytesPerSample.end() ? defaultBytes : ib->second);
+
+				traffic[us][ud] += bytesPerSec;
+				traffic[ud][us] += bytesPerSec;
+				unitTraffic[us] += bytesPerSec;
+				unitTraffic[ud] += bytesPerSec;
+				totalTraffic += bytesPerSec;
+			}
+
+			//	---- GREEDY PLACEMENT ----
+
+			UINT32 maxLoad = (UINT32) ceil(((DOUBLE)processCount) * (1.0 + VOICE_PARTITION_IMBALANCE) / ((DOUBLE)voiceCount));
+			vector<UINT32> load(voiceCount, 0);
+			vector<VoiceIndex> place(unitCount, VOICE_UNDEFINED);
+
+			//	explicitly placed units first
+			vector<UINT32> order;
+			for (UINT32 u=0; u<unitCount; u++)
+			{
+				if (unitVoice[u] != VOICE_UNDEFINED)
+				{
+					place[u] = unitVoice[u];
+					load[place[u]] += unitSize[u];
+				}
+				else order.push_back(u);
+			}
+
+			//	then heaviest talkers first (stable, so all ties resolve the same way)
+			for (UINT32 i=1; i<order.size(); i++)
+			{
+				UINT32 u = order[i];
+				UINT32 j = i;
+				while (j && unitTraffic[order[j-1]] < unitTraffic[u])
+				{
+					order[j] = order[j-1];
+					j--;
+				}
+				order[j] = u;
+			}
+
+			vector<DOUBLE> conn(voiceCount);
+			for (UINT32 i=0; i<order.size(); i++)
+			{
+				UINT32 u = order[i];
+
+				//	traffic to each voice from units already placed
+				for (VoiceIndex v=0; v<voiceCount; v++) conn[v] = 0.0;
+				for (map<UINT32, DOUBLE>::iterator t=traffic[u].begin(); t!=traffic[u].end(); t++)
+					if (place[t->first] != VOICE_UNDEFINED) conn[place[t->first]] += t->second;
+
+				//	most connected voice with room, else least loaded
+				VoiceIndex best = VOICE_UNDEFINED;
+				for (VoiceIndex v=0; v<voiceCount; v++)
+				{
+					bool fits = load[v] + unitSize[u] <= maxLoad;
+					if (!fits) continue;
+					if (best == VOICE_UNDEFINED || conn[v] > conn[best] || (conn[v] == conn[best] && load[v] < load[best]))
+						best = v;
+				}
+				if (best == VOICE_UNDEFINED)
+				{
+					best = 0;
+					for (VoiceIndex v=1; v<voiceCount; v++)
+						if (load[v] < load[best]) best = v;
+				}
+
+				place[u] = best;
+				load[best] += unitSize[u];
+			}
+
+			//	---- REFINEMENT ----
+
+			for (UINT32 pass=0; pass<VOICE_PARTITION_PASSES; pass++)
+			{
+				bool moved = false;
+				for (UINT32 i=0; i<order.size(); i++)
+				{
+					UINT32 u = order[i];
+					for (VoiceIndex v=0; v<voiceCount; v++) conn[v] = 0.0;
+					for (map<UINT32, DOUBLE>::iterator t=traffic[u].begin(); t!=traffic[u].end(); t++)
+						conn[place[t->first]] += t->second;
+
+					//	move to the voice that most reduces the cut, if it has room
+					VoiceIndex from = place[u];
+					VoiceIndex best = from;
+					for (VoiceIndex v=0; v<voiceCount; v++)
+					{
+						if (v == from || load[v] + unitSize[u] > maxLoad) continue;
+						if (conn[v] > conn[best]) best = v;
+					}
+					if (best != from)
+					{
+						load[from] -= unitSize[u];
+						load[best] += unitSize[u];
+						place[u] = best;
+						moved = true;
+					}
+				}
+				if (!moved) break;
+			}
+
+			//	report
+			DOUBLE cutTraffic = 0.0;
+			for (UINT32 u=0; u<unitCount; u++)
+				for (map<UINT32, DOUBLE>::iterator t=traffic[u].begin(); t!=traffic[u].end(); t++)
+					if (t->first > u && place[t->first] != place[u]) cutTraffic += t->second;
+			fout << "partition sends " << cutTraffic << " of " << totalTraffic << " bytes/sec between voices" << D_VERB;
+
+			//	---- BROADCAST ----
+
+			for (UINT32 w=0; w<processCount; w++)
+				partition[w] = place[unitOf[w]];
+
+			for (VoiceIndex remoteVoiceIndex=0; remoteVoiceIndex<voiceCount; remoteVoiceIndex++)
+			{
+				//	not to self
+				if (remoteVoiceIndex == VOICE_MASTER) continue;
+
+				brahms::base::IPM* ipms = engineData.pool.get(brahms::base::IPMTAG_PUSHPARTITION, remoteVoiceIndex);
+				ipms->appendBytes(processCount ? (BYTE*)&partition[0] : NULL, processCount * sizeof(VoiceIndex));
+				comms.push(ipms, fout);
+			}
+		}
+
+		void System::reportTraffic(brahms::xml::XMLNode* nodeTraffic)
+		{
+			//	bytes per sample of each local output, for VoicePartition in the next run (see VOICE_PARTITION)
+			vector<OutputPort*> outputs = getAllOutputPorts();
+			for (UINT32 o=0; o<outputs.size(); o++)
+			{
+				Data* data = outputs[o]->getZerothDataOrNull();
+				if (!data) continue;
+
+				EventContent ec;
+				brahms::EventEx event(
+					EVENT_CONTENT_GET,
+					0,
+					data,
+					&ec,
+					true,
+					NULL
+				);
+				event.fire();
+
+				SampleRate sampleRate = data->getSampleRate();
+				DOUBLE rate = ((DOUBLE)sampleRate.num) / ((DOUBLE)sampleRate.den);
+
+				brahms::xml::XMLNode* nodeOutput = nodeTraffic->appendChild(new brahms::xml::XMLNode("Output"));
+				nodeOutput->appendChild(new brahms::xml::XMLNode("Name", data->getObjectName().c_str()));
+				nodeOutput->appendChild(new brahms::xml::XMLNode("Rate", brahms::text::n2s(rate).c_str()));
+				nodeOutput->appendChild(new brahms::xml::XMLNode("Bytes", brahms::text::n2s(ec.bytes).c_str()));
+			}
+		}
+
+		////////////////	COMMS TELEMETRY
+
+		void appendHistogram(brahms::xml::XMLNode* parent, const char* name, const brahms::channel::Histogram& h)
+		{
+			if (!h.count) return;
+
+			//	bins are written up to the last non-empty one
+			UINT32 last = 0;
+			for (UINT32 b=0; b<brahms::channel::HISTOGRAM_BINS; b++)
+				if (h.bins[b]) last = b;
+			string bins;
+			for (UINT32 b=0; b<=last; b++)
+			{
+				if (b) bins += " ";
+				bins += brahms::text::u2s(h.bins[b]);
+			}
+
+			brahms::xml::XMLNode* node = parent->appendChild(new brahms::xml::XMLNode(name));
+			node->appendChild(new brahms::xml::XMLNode("Count", brahms::text::u2s(h.count).c_str()));
+			node->appendChild(new brahms::xml::XMLNode("Mean", brahms::text::n2s(((DOUBLE)h.sum) / ((DOUBLE)h.count)).c_str()));
+			node->appendChild(new brahms::xml::XMLNode("Max", brahms::text::u2s(h.max).c_str()));
+			node->appendChild(new brahms::xml::XMLNode("Bins", bins.c_str()));
+		}
+
+		void appendTelemetry(brahms::xml::XMLNode* node, const brahms::channel::LinkTelemetry& t)
+		{
+			node->appendChild(new brahms::xml::XMLNode("Backoffs", brahms::text::u2s(t.backoffs).c_str()));
+			appendHistogram(node, "QueueWait", t.queueWait);
+			appendHistogram(node, "WireTime", t.wireTime);
+			appendHistogram(node, "DelivererWait", t.delivererWait);
+			appendHistogram(node, "BytesRaw", t.bytesRaw);
+			appendHistogram(node, "BytesWire", t.bytesWire);
+		}
+
+		void System::reportComms(brahms::xml::XMLNode* nodeComms)
+		{
+			//	names of links we send on
+			map<UINT32, string> sentNames;
+			for (map<string, UINT32>::iterator i=remoteInputStreamIndex.begin(); i!=remoteInputStreamIndex.end(); i++)
+				sentNames[i->second] = i->first;
+
+			for (VoiceIndex remoteVoiceIndex=0; remoteVoiceIndex<comms.channels.size(); remoteVoiceIndex++)
+			{
+				//	except ourselves
+				if (!comms.channels[remoteVoiceIndex]) continue;
+
+				brahms::channel::ChannelTelemetryData data;
+				if (!comms.channels[remoteVoiceIndex]->telemetry(data)) continue;
+
+				brahms::xml::XMLNode* nodeChannel = nodeComms->appendChild(new brahms::xml::XMLNode("Channel"));
+				nodeChannel->appendChild(new brahms::xml::XMLNode("Remote", brahms::text::n2s(unitIndex(remoteVoiceIndex)).c_str()));
+				appendTelemetry(nodeChannel, data.channel);
+
+				//	links sent (msgStreamIDs are ours)
+				for (UINT32 s=0; s<data.sent.size(); s++)
+				{
+					if (!data.sent[s].bytesRaw.count) continue;
+					brahms::xml::XMLNode* nodeLink = nodeChannel->appendChild(new brahms::xml::XMLNode("Link"));
+					nodeLink->appendChild(new brahms::xml::XMLNode("Direction", "send"));
+					nodeLink->appendChild(new brahms::xml::XMLNode("Stream", brahms::text::n2s(s).c_str()));
+					nodeLink->appendChild(new brahms::xml::XMLNode("Name", sentNames[s].c_str()));
+					appendTelemetry(nodeLink, data.sent[s]);
+				}
+
+				//	links received (msgStreamIDs are the remote voice's)
+				for (UINT32 s=0; s<data.received.size(); s++)
+				{
+					if (!data.received[s].delivererWait.count) continue;
+					brahms::xml::XMLNode* nodeLink = nodeChannel->appendChild(new brahms::xml::XMLNode("Link"));
+					nodeLink->appendChild(new brahms::xml::XMLNode("Direction", "recv"));
+					nodeLink->appendChild(new brahms::xml::XMLNode("Stream", brahms::text::n2s(s).c_str()));
+					nodeLink->appendChild(new brahms::xml::XMLNode("Name", remoteOutputStreamNames[make_pair(remoteVoiceIndex, s)].c_str()));
+					appendTelemetry(nodeLink, data.received[s]);
+				}
+			}
+		}
+
 		void System::parse(brahms::xml::XMLNode* systemML, string pathToSubSystem)
 		{
 			brahms::output::Source& fout(engineData.core.caller.tout);
@@ -1694,6 +2466,26 @@ namespace brahms
 				if (oport) oports.push_back(oport);
 			}
 
+			//	an optimistic process copies the content of every port it
+			//	touches (see OPTIMISTIC_EXECUTION), so those need the same
+			//	layout; we do this now, before remote data can arrive
+			if (engineData.core.execPars.getu("OptimisticWindow"))
+			{
+				for (UINT32 p=0; p<processes.size(); p++)
+				{
+					if (!(processes[p]->componentInfo->flags & F_OPTIMISTIC)) continue;
+
+					vector<OutputPort*> touched = processes[p]->getAllOutputPorts();
+					vector<InputPortLocal*> inputs = processes[p]->getAllInputPorts();
+					for (UINT32 i=0; i<inputs.size(); i++)
+						touched.push_back(inputs[i]->connectedOutputPort);
+
+					for (UINT32 t=0; t<touched.size(); t++)
+						if (find(oports.begin(), oports.end(), touched[t]) == oports.end())
+							oports.push_back(touched[t]);
+				}
+			}
+
 			//	for each output port, have it handle the next bit
 			for (UINT32 p=0; p<oports.size(); p++)
 			{
@@ -1764,6 +2556,47 @@ namespace brahms
 			return brahms::text::n2s(precision);
 		}
 
+		string logFormatToString(const LogMode& mode)
+		{
+			string format = "unencapsulated";
+			if (mode.encapsulated) format = "encapsulated";
+			else if (mode.compressed) format = "unencapsulated, compressed";
+			else if (mode.chunked) format = "unencapsulated, chunked";
+
+			if (mode.decimate > 1)
+			{
+				string n = brahms::text::n2s(mode.decimate);
+				switch (mode.aggregate)
+				{
+					case C_LOG_MEAN: format += ", mean of each " + n; break;
+					case C_LOG_MIN: format += ", min of each " + n; break;
+					case C_LOG_MAX: format += ", max of each " + n; break;
+					case C_LOG_RMS: format += ", rms of each " + n; break;
+					default: format += ", first of each " + n; break;
+				}
+			}
+
+			return format;
+		}
+
+		UINT32 logFlags(bool encapsulated, bool compressed, bool chunked)
+		{
+			return (encapsulated ? F_ENCAPSULATED : 0) | (compressed ? F_COMPRESSED : 0) | (chunked ? F_CHUNKED : 0);
+		}
+
+		UINT64 logMemoryLeft(const EngineData& engineData)
+		{
+			const UINT64 budget = engineData.logMemory.budget;
+			const UINT64 held = engineData.logMemory.held;
+			return budget > held ? budget - held : 0;
+		}
+
+		void logMemoryTaken(EngineData& engineData, UINT64 given, UINT64 left)
+		{
+			//	the data object subtracted what it will hold from what it was given (see LOG_MEMORY_BUDGET)
+			if (left < given) engineData.logMemory.held += given - left;
+		}
+
 		void System::startLogs(brahms::thread::Workers& workers)
 		{
 			brahms::output::Source& fout(engineData.core.caller.tout);
@@ -1784,6 +2617,10 @@ namespace brahms
 				//	initially, assume default log mode
 				INT32 precision = engineData.execution.defaultLogMode.precision;
 				bool encapsulated = engineData.execution.defaultLogMode.encapsulated;
+				bool compressed = engineData.execution.defaultLogMode.compressed;
+				bool chunked = engineData.execution.defaultLogMode.chunked;
+				UINT32 decimate = engineData.execution.defaultLogMode.decimate;
+				Symbol aggregate = engineData.execution.defaultLogMode.aggregate;
 				vector<LogOriginSeconds> origins = engineData.execution.defaultLogMode.origins;
 
 				//	find best match amongst specific log modes
@@ -1824,6 +2661,10 @@ namespace brahms
 					logRule.logged.push_back(processName + " (Process)"); // mark that this rule caused this item to log, for audit
 					precision = logRule.mode.precision;
 					encapsulated = logRule.mode.encapsulated;
+					compressed = logRule.mode.compressed;
+					chunked = logRule.mode.chunked;
+					decimate = logRule.mode.decimate;
+					aggregate = logRule.mode.aggregate;
 					origins = logRule.mode.origins;
 				}
 				else unloggedItems.push_back(processName + " (Process)");
@@ -1837,11 +2678,16 @@ namespace brahms
 
 					//	prepare event data
 					process->logEventData.precision = precision;
-					process->logEventData.flags = encapsulated ? F_ENCAPSULATED : 0;
+					process->logEventData.flags = logFlags(encapsulated, compressed, chunked);
+					process->logEventData.decimate = decimate;
+					process->logEventData.aggregate = aggregate;
+					UINT64 memoryBudget = logMemoryLeft(engineData);
+					process->logEventData.memoryBudget = memoryBudget;
 
 					//	fire EVENT_LOG_INIT
 					process->logEvent.type = EVENT_LOG_INIT;
 					workers.fireSingleEvent(process->logEvent);
+					logMemoryTaken(engineData, memoryBudget, process->logEventData.memoryBudget);
 				}
 
 				//	loop through its inputs checking compliance
@@ -1887,6 +2733,10 @@ namespace brahms
 					//	initially, assume default log mode
 					INT32 precision = engineData.execution.defaultLogMode.precision;
 					bool encapsulated = engineData.execution.defaultLogMode.encapsulated;
+					bool compressed = engineData.execution.defaultLogMode.compressed;
+					bool chunked = engineData.execution.defaultLogMode.chunked;
+					UINT32 decimate = engineData.execution.defaultLogMode.decimate;
+					Symbol aggregate = engineData.execution.defaultLogMode.aggregate;
 					vector<LogOriginSeconds> origins = engineData.execution.defaultLogMode.origins;
 
 					//	find best match amongst specific log modes
@@ -1928,23 +2778,32 @@ namespace brahms
 						logRule.logged.push_back(dataName); // mark that this rule caused this item to log, for audit
 						precision = logRule.mode.precision;
 						encapsulated = logRule.mode.encapsulated;
+						compressed = logRule.mode.compressed;
+						chunked = logRule.mode.chunked;
+						decimate = logRule.mode.decimate;
+						aggregate = logRule.mode.aggregate;
 						origins = logRule.mode.origins;
 					}
 					else unloggedItems.push_back(dataName);
 
 					//	store log information in Data
 					port->logEventData.precision = precision;
+					port->logEventData.decimate = decimate;
+					port->logEventData.aggregate = aggregate;
 					port->origins = originToBaseSamples(origins, data->componentTime.samplePeriod, data->componentTime.baseSampleRate);
 
 					//	if logging, advise the data component
 					if (precision != PRECISION_DO_NOT_LOG)
 					{
 						//	start log of port
+						UINT64 memoryBudget = logMemoryLeft(engineData);
+						port->logEventData.memoryBudget = memoryBudget;
 						port->startLog(
-							encapsulated,
+							logFlags(encapsulated, compressed, chunked),
 							engineData.execution.fileReport + "." + brahms::text::n2s(subfiles, 4),
 							&fout
 						);
+						logMemoryTaken(engineData, memoryBudget, port->logEventData.memoryBudget);
 
 						//	increment subfiles
 						subfiles++;
@@ -1959,7 +2818,7 @@ namespace brahms
 				{
 					const LogRule& logRule = engineData.execution.logRules[n];
 
-					string encap = logRule.mode.encapsulated ? "encapsulated" : "unencapsulated";
+					string encap = logFormatToString(logRule.mode);
 					string recur = logRule.mode.recurse ? "recurse" : "no recurse";
 					fout << "\"" << logRule.name << "\" (precision " << precisionToString(logRule.mode.precision) << ", " << encap << ", " << recur << "):" << D_VERB;
 					for (UINT32 l=0; l<logRule.logged.size(); l++)
@@ -1973,7 +2832,7 @@ namespace brahms
 				}
 				else
 				{
-					string encap = engineData.execution.defaultLogMode.encapsulated ? "encapsulated" : "unencapsulated";
+					string encap = logFormatToString(engineData.execution.defaultLogMode);
 					string recur = engineData.execution.defaultLogMode.recurse ? "recurse" : "no recurse";
 					fout << "\"default logging rule\" (precision " << precisionToString(engineData.execution.defaultLogMode.precision) << ", " << encap << ", " << recur << "):" << D_VERB;
 				}
@@ -2001,11 +2860,33 @@ namespace brahms
 
 
 
-		Symbol pushdataHandler(void* arg, BYTE* stream, UINT32 count)
+		/*	DOCUMENTATION: ZERO_COPY_RECEIVE
+
+			A PUSHDATA payload arrives in a pooled IPM, and would be copied
+			into the ring slot's data object by EVENT_CONTENT_SET. If it is
+			at least ZeroCopyReceive bytes, we first offer it to the data
+			object with EVENT_CONTENT_ADOPT, which lets the object read it
+			in place. The ring slot then holds on to the IPM, and releases
+			it to its pool when the slot is next written, which is to say
+			once every reader has released it and the next sample has come
+			in. A data class that does not handle the event is not offered
+			it again. When delivery stops, the deliverer calls us once more
+			with no message, and each slot copies its content home so that
+			the IPMs can go back to the pool before the channel does.
+		*/
+
+		Symbol pushdataHandler(void* arg, BYTE* stream, UINT32 count, brahms::base::IPM* msg)
 		{
 			//	route to the appropriate OutputPortRemote
 			brahms::systemml::OutputPort* port = (brahms::systemml::OutputPort*) arg;
 
+			//	delivery has stopped
+			if (!msg)
+			{
+				port->releaseAdopted();
+				return C_OK;
+			}
+
 			//	lock for write
 			Symbol result = port->writeLock(0);
 
@@ -2013,28 +2894,52 @@ namespace brahms
 			if (result == C_CANCEL)
 				return C_CANCEL;
 
-			//	get data object
+			//	get data object, and the slot it sits in
 			Data* data = port->getDueData();
+			RingBufferItem* item = port->ring.at(port->ring.writeBuffer);
 
-			//	set content (unserialize)
+			//	offer content for adoption (see ZERO_COPY_RECEIVE)
 			EventContent ec;
 			ec.stream = stream;
 			ec.bytes = count;
-			brahms::EventEx event(
-				EVENT_CONTENT_SET,
-				0,
-				data,
-				&ec,
-				true,
-				NULL
-			);
-			event.fire();
+			Symbol adopted = S_NULL;
+			if (port->adoptBytes && count >= port->adoptBytes)
+			{
+				brahms::EventEx event(
+					EVENT_CONTENT_ADOPT,
+					0,
+					data,
+					&ec,
+					false,
+					NULL
+				);
+				adopted = event.fire();
+				if (adopted == S_NULL) port->adoptBytes = 0;
+			}
+
+			//	else set content (unserialize)
+			if (adopted == S_NULL)
+			{
+				brahms::EventEx event(
+					EVENT_CONTENT_SET,
+					0,
+					data,
+					&ec,
+					true,
+					NULL
+				);
+				event.fire();
+			}
+
+			//	the message previously adopted in this slot is no longer referenced
+			if (item->adopted) item->adopted->release();
+			item->adopted = (adopted == S_NULL) ? NULL : msg;
 
 			//	release
 			port->writeRelease(0, NULL, 0);
 
 			//	ok
-			return C_OK;
+			return (adopted == S_NULL) ? C_OK : C_YES;
 		}
 
 
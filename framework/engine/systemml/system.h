@@ -98,8 +98,16 @@ namespace brahms
 			//	find an output that has the name expected by the passed input port
 			OutputPort* findOutputLocally(Identifier& outputName);
 			OutputPort* findOutput(Identifier& outputName);
+			OutputPort* findOutputRemotely(const string& dataName);
+			VoiceIndex findAnnouncingVoice(const string& dataName);
+			void findOutputsBatched();
 			void announceOutput(string name);
 
+			//	serve a request for a local output to a peer, and connect to one served by a peer
+			bool serveOutput(UINT32 remoteVoiceIndex, const string& outputName, UINT32& msgStreamID, string& serial, VoiceIndex& relay);
+			UINT32 remoteLookahead(const string& outputName, VoiceIndex remoteVoiceIndex);
+			OutputPort* connectRemoteOutput(UINT32 remoteVoiceIndex, UINT32 msgStreamID, const char* serial);
+
 			//	operations
 			void terminate(brahms::output::Source& tout);
 
@@ -116,6 +124,11 @@ namespace brahms
 			//	get all output ports
 			vector<OutputPort*> getAllOutputPorts();
 
+			//	traffic-aware placement of processes on voices, and traffic report for the next run
+			void partitionByTraffic(const vector<Process*>& unscheduled, const vector<INT32>& processGroup, brahms::Execution& execution, vector<VoiceIndex>& partition);
+			void reportTraffic(brahms::xml::XMLNode* nodeTraffic);
+			void reportComms(brahms::xml::XMLNode* nodeComms);
+
 
 
 		public:
@@ -132,6 +145,9 @@ namespace brahms
 			//	list of processes on other nodes (only for validation)
 			vector<string> processesOnOtherNodes;
 
+			//	voice computing each process on another node (see LOOKAHEAD)
+			map<string, VoiceIndex> processVoices;
+
 			//	System File (is maintained so it can be updated and re-serialized)
 			brahms::xml::XMLNode nodeSystem;
 
@@ -142,6 +158,32 @@ namespace brahms
 			//	peer voice data
 			vector<PeerVoice> peerVoices;
 
+			/*
+
+				Connection resolution looks up processes and outputs by name
+				once for every input in every connect pass, so these are
+				indexed rather than searched. Outputs are keyed by their
+				canonical data name (e.g. mysys/myprocess>>myset>myport),
+				which is what string(Identifier) gives for an output port.
+				Local outputs are added as processes create them during
+				EVENT_INIT_CONNECT, remote outputs as they are connected,
+				and announced outputs as peers announce them.
+
+			*/
+
+			map<string, Process*> processIndex;
+			map<string, OutputPort*> localOutputIndex;
+			map<string, OutputPort*> remoteOutputIndex;
+			map<string, VoiceIndex> announcedOutputIndex;
+			map<string, UINT32> remoteInputStreamIndex;
+
+			//	voices reading each local output, in the order they asked for it
+			//	(which is the breadth-first order of its relay tree, see RELAY_TREE)
+			map<string, vector<VoiceIndex> > remoteReaders;
+
+			//	names of remote outputs by (remote voice, msgStreamID), for the report
+			map< pair<VoiceIndex, UINT32>, string > remoteOutputStreamNames;
+
 
 		////	I/Ps and O/Ps
 
@@ -170,7 +212,7 @@ namespace brahms
 
 	////////////////	PUSHDATA HANDLER directs PUSHDATA messages into a "remote" OutputPort
 
-		Symbol pushdataHandler(void* arg, BYTE* stream, UINT32 count);
+		Symbol pushdataHandler(void* arg, BYTE* stream, UINT32 count, brahms::base::IPM* msg);
 
 
 	}
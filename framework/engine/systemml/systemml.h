@@ -77,6 +77,7 @@ namespace brahms
 #include "component.h"
 #include "data.h"
 #include "process.h"
+#include "speculation.h"
 #include "utility.h"
 #include "thread.h"
 #include "system.h"
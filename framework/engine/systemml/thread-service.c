@@ -170,6 +170,33 @@ ________________________________________________________________
 
 
 
+			////	OPTIMISTIC PROCESS (see OPTIMISTIC_EXECUTION)
+
+			//	does its own locking, and fires as many times as it needs to
+			if (processBeingServiced->speculation)
+			{
+				serviceEvent.flags = processBeingServiced->flags;
+				serviceEvent.object = processBeingServiced->object;
+
+				processBeingFired = processBeingServiced;
+				Symbol err = processBeingServiced->speculation->service(time_now, &serviceEvent, &tout);
+				processBeingFired = NULL;
+
+				if (err == C_CANCEL)
+				{
+					EXIT_MAIN_LOOP("C_CANCEL whilst speculating");
+				}
+
+				if (err != C_OK)
+				{
+					EXIT_MAIN_LOOP(serviceFailed(err, processBeingServiced));
+				}
+
+				continue;
+			}
+
+
+
 #ifdef USE_SLOW_VERSION
 	if (ShowServicePhaseTiming)
 	{
@@ -289,46 +316,7 @@ ________________________________________________________________
 			//	catch error and cancel
 			if (err != C_OK)
 			{
-				//	process name
-				processBeingFired = processBeingServiced;
-				string processName = processBeingServiced->getObjectName();
-				string trace = "whilst firing \"EVENT_RUN_SERVICE\" on \"" + processName + "\"";
-
-				//	catch errors
-				if (S_ERROR(err))
-				{
-					brahms::error::Error e = brahms::error::globalErrorRegister.pull(err);
-					e.trace(trace);
-					throw e;
-				}
-
-				//	otherwise
-				switch(err)
-				{
-					case S_NULL:
-					{
-						ferr << E_NOT_COMPLIANT << "no response from process whilst handling required event";
-					}
-
-					case C_STOP_USER:
-					case C_STOP_EXTERNAL:
-					case C_STOP_CONDITION:
-					case C_STOP_THEREFOREIAM:
-					{
-						//	signal local
-						engineData.core.condition.set(brahms::base::COND_LOCAL_CANCEL);
-
-						//	exit
-						string reason = brahms::base::symbol2string(err);
-						reason += (" from \"" + processName + "\"");
-						EXIT_MAIN_LOOP(reason);
-					}
-
-					default:
-					{
-						ferr << E_NOT_COMPLIANT << "unrecognised response from process (0x" << hex << err << ")";
-					}
-				}
+				EXIT_MAIN_LOOP(serviceFailed(err, processBeingServiced));
 			}
 
 
@@ -450,6 +438,30 @@ ________________________________________________________________
 
 
 
+////////////////	COMMIT OPTIMISTIC PROCESSES
+
+	//	steps still held at execution stop are committed before we go (see OPTIMISTIC_EXECUTION)
+	if (time_now >= time_executionStop && !*globalStop)
+	{
+		for (UINT32 p=0; p<processes.size(); p++)
+		{
+			brahms::systemml::Process* process = processes[p];
+			if (!process->speculation) continue;
+
+			serviceEvent.flags = process->flags;
+			serviceEvent.object = process->object;
+
+			processBeingFired = process;
+			Symbol err = process->speculation->drain(&serviceEvent, &tout);
+			processBeingFired = NULL;
+
+			if (err != C_OK && err != C_CANCEL)
+				serviceFailed(err, process);
+		}
+	}
+
+
+
 ////////////////	REPORT SERVICE PHASE TIMING
 
 #ifdef USE_SLOW_VERSION
@@ -463,6 +463,9 @@ namespace brahms
 
 				BaseSamples time_executionStop = time_stop;
 
+				//	optimistic processes
+				prepareSpeculation(time_executionStop);
+
 				/*
 					For uber-efficiency, we actually run entirely different
 					code depending on what measurements we want to make...
@@ -512,6 +515,96 @@ namespace brahms
 			throw e;
 		}
 
+		void WorkerThread::prepareSpeculation(BaseSamples executionStop)
+		{
+			//	see OPTIMISTIC_EXECUTION
+			UINT32 window = engineData.core.execPars.getu("OptimisticWindow");
+			if (!window) return;
+
+			for (UINT32 p=0; p<processes.size(); p++)
+			{
+				brahms::systemml::Process* process = processes[p];
+				if (process->speculation) continue;
+				if (!(process->componentInfo->flags & F_OPTIMISTIC)) continue;
+
+				//	nothing to gain unless it reads from another voice, and it
+				//	mustn't read its own outputs, which it holds back
+				vector<brahms::systemml::InputPortLocal*> inputs = process->getAllInputPorts();
+				vector<brahms::systemml::OutputPort*> outputs = process->getAllOutputPorts();
+				bool remote = false;
+				bool loop = false;
+				for (UINT32 i=0; i<inputs.size(); i++)
+				{
+					brahms::systemml::OutputPort* src = inputs[i]->connectedOutputPort;
+					if (!src->parentSet) remote = true;
+					if (find(outputs.begin(), outputs.end(), src) != outputs.end()) loop = true;
+				}
+
+				//	and another process in this thread could read those outputs
+				//	before they were committed, or hold up their commits
+				string reason;
+				if (!remote) reason = "it has no input from another voice";
+				else if (loop) reason = "it reads its own output";
+				else if (processes.size() != 1) reason = "it shares its worker thread";
+
+				if (reason.length())
+				{
+					tout << "\"" << process->getObjectName() << "\" will not run optimistically, because " << reason << D_VERB;
+					continue;
+				}
+
+				process->speculation = new brahms::systemml::Speculation(process, window, executionStop, tout);
+				tout << "\"" << process->getObjectName() << "\" runs optimistically, up to " << window << " samples ahead" << D_VERB;
+			}
+		}
+
+		string WorkerThread::serviceFailed(Symbol err, brahms::systemml::Process* process)
+		{
+			//	process name
+			processBeingFired = process;
+			string processName = process->getObjectName();
+			string trace = "whilst firing \"EVENT_RUN_SERVICE\" on \"" + processName + "\"";
+
+			//	catch errors
+			if (S_ERROR(err))
+			{
+				brahms::error::Error e = brahms::error::globalErrorRegister.pull(err);
+				e.trace(trace);
+				throw e;
+			}
+
+			//	otherwise
+			switch(err)
+			{
+				case S_NULL:
+				{
+					ferr << E_NOT_COMPLIANT << "no response from process whilst handling required event";
+				}
+
+				case C_STOP_USER:
+				case C_STOP_EXTERNAL:
+				case C_STOP_CONDITION:
+				case C_STOP_THEREFOREIAM:
+				{
+					//	signal local
+					engineData.core.condition.set(brahms::base::COND_LOCAL_CANCEL);
+
+					//	reason to exit
+					string reason = brahms::base::symbol2string(err);
+					reason += (" from \"" + processName + "\"");
+					return reason;
+				}
+
+				default:
+				{
+					ferr << E_NOT_COMPLIANT << "unrecognised response from process (0x" << hex << err << ")";
+				}
+			}
+
+			//	not reached
+			return "";
+		}
+
 		void WorkerThread::FireCommonEvent()
 		{
 //			stringstream ss;
@@ -565,7 +658,8 @@ namespace brahms
 						//	event data
 						EventStateSet data;
 						____CLEAR(data);
-						data.state = process->nodeProcess->getChild("State")->getObjectHandle();
+						brahms::xml::XMLNode* nodeState = process->nodeProcess->getChild("State");
+						data.state = nodeState->getObjectHandle();
 
 						//	fire event
 						processBeingFired = process;
@@ -580,6 +674,9 @@ namespace brahms
 						event.fire();
 						processBeingFired = NULL;
 
+						//	state content is no longer needed in parsed form (see XML_DEFERRED_CONTENT)
+						nodeState->collapse();
+
 						//	ok
 						process->irtWallclock.init += threadTimer.elapsed() - t0;
 						break;
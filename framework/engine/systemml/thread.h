@@ -146,6 +146,8 @@ namespace brahms
 			//	service loop
 			void LockForWrite();
 			void Service();
+			void prepareSpeculation(BaseSamples executionStop);
+			string serviceFailed(Symbol err, brahms::systemml::Process* process);
 
 			//	pars
 			UINT32 TimeoutThreadHang;
@@ -140,6 +140,7 @@ brahms::info::usage()
         "  general options:\n"
         "    --voice-i        set this to be the ith voice (sockets only)\n"
         "    --voice-mpi      get voice index from MPI layer (mpi only)\n"
+        "    --loopback-N     run all N voices in this process\n"
         "    --pause          pause before exiting worker threads\n"
         "    --par-X=Y        set Execution Parameter X to value Y\n"
         "    --nogui          Avoid displaying the execution progress window\n"
@@ -89,6 +89,7 @@ struct Instance
 		operation = OP_NULL;
 		walkLevel = WL_NULL;
 		segfault = false;
+		loopbackVoices = 0;
 	}
 
 	void setOperation(Operation o, string arg)
@@ -108,6 +109,9 @@ struct Instance
 	string logFilename;
 	string exitFilename;
 
+	//	number of voices to run in this process (--loopback-N), or zero
+	UINT32 loopbackVoices;
+
         bool nogui;
 }
 instance;
@@ -216,6 +220,19 @@ void interpretArgs(int argc, char *argv[])
 			continue;
 		}
 
+		//	all voices in this process
+		if (arg.length() > 11 && arg.substr(0,11) == "--loopback-")
+		{
+			instance.loopbackVoices = atof(arg.substr(11).c_str());
+			ostringstream ss;
+			ss << "--loopback-" << instance.loopbackVoices;
+			if (ss.str() != arg) client_err << "E_INVOCATION: unrecognised option \"" + arg + "\"";
+			if (instance.loopbackVoices < 1 || instance.loopbackVoices > 1024) client_err << "E_INVOCATION: voice count out of range \"" + arg + "\"";
+			createEngine.voiceCount = instance.loopbackVoices;
+			createEngine.engineFlags |= F_LOOPBACK;
+			continue;
+		}
+
 		//	execution parameter
 		if (arg.length() >= 6 && arg.substr(0,6) == "--par-")
 		{
@@ -395,7 +412,7 @@ struct EngineResult
 
 struct Engine
 {
-	Engine()
+	Engine(CreateEngine& createEngine)
 	{
 		//	create engine
 		hEngine = S_NULL;
@@ -447,6 +464,96 @@ void inline freopen_local(const char* path, const char* mode, FILE* stream)
 ExecuteGUI* executeGUI;
 #endif
 
+/*
+	runEngine() brings an engine up, performs the requested operation,
+	and brings it down again. Any error is formatted by the engine.
+*/
+
+EngineResult runEngine(Engine& engine)
+{
+	//	engine-instance catch
+	try
+	{
+		//	init engine
+		engine.up();
+
+		//	operations
+		switch (instance.operation)
+		{
+			case OP_WALK:
+			{
+				//	must be done after environment is finalized, so we know where the NamespaceRoots are
+				Symbol result = engine_walk(engine.hEngine, instance.walkLevel);
+				if (S_ERROR(result)) return engine.down();
+				break;
+			}
+
+			case OP_EXECUTE:
+			{
+				//	init
+				Symbol result = engine_open(engine.hEngine);
+				if (S_ERROR(result)) return engine.down();
+
+				//	run
+				result = engine_execute(engine.hEngine);
+				if (S_ERROR(result)) return engine.down();
+
+				//	term
+				result = engine_close(engine.hEngine);
+				if (S_ERROR(result)) return engine.down();
+				break;
+			}
+
+			default:
+			{
+				client_err << "E_INVOCATION: no operation specified on command line";
+			}
+		}
+	}
+
+	catch(Symbol e)
+	{
+		return engine.down();
+	}
+
+	//	down
+	return engine.down();
+}
+
+/*
+	With --loopback-N, all N voices run in this process, one engine
+	per voice, each on its own thread (see LOOPBACK_CHANNEL).
+*/
+
+struct LoopbackVoice
+{
+	CreateEngine createEngine;
+	EngineResult result;
+};
+
+void executeLoopbackVoice(void* arg)
+{
+	LoopbackVoice* voice = (LoopbackVoice*) arg;
+
+	try
+	{
+		Engine engine(voice->createEngine);
+		voice->result = runEngine(engine);
+	}
+
+	catch(const string& e)
+	{
+		voice->result.localError = e;
+		voice->result.error = true;
+	}
+
+	catch(...)
+	{
+		voice->result.localError = "...";
+		voice->result.error = true;
+	}
+}
+
 EngineResult execute(int argc, char *argv[])
 {
 	EngineResult engineResult;
@@ -524,8 +631,47 @@ EngineResult execute(int argc, char *argv[])
 				;
 		}
 
+		//	all voices in this process
+		if (instance.loopbackVoices)
+		{
+			if (createEngine.voiceIndex != VOICE_UNDEFINED)
+				client_err << "E_INVOCATION: voice cannot be specified with --loopback";
+			if (instance.operation != OP_EXECUTE)
+				client_err << "E_INVOCATION: --loopback can only be used to execute";
+			if (instance.logFilename.length() && instance.logFilename.find("((VOICE))") == string::npos)
+				client_err << "E_INVOCATION: log filename must contain ((VOICE)) with --loopback";
+
+			//	one engine per voice (each replaces ((VOICE)) in the log
+			//	filename itself), and only the first drives the monitor
+			vector<LoopbackVoice> voices(instance.loopbackVoices);
+			vector<void*> args(instance.loopbackVoices);
+			for (UINT32 v=0; v<instance.loopbackVoices; v++)
+			{
+				voices[v].createEngine = createEngine;
+				voices[v].createEngine.voiceIndex = v;
+				if (v) voices[v].createEngine.handler = NULL;
+				args[v] = &voices[v];
+			}
+
+			//	run them together
+			os::concurrently(executeLoopbackVoice, &args[0], instance.loopbackVoices);
+
+			//	one exit file covers all voices
+			grep(instance.exitFilename, "((VOICE))", "1");
+
+			//	in error if any voice was
+			for (UINT32 v=0; v<instance.loopbackVoices; v++)
+			{
+				if (voices[v].result.error) engineResult.error = true;
+				engineResult.messageCount += voices[v].result.messageCount;
+				if (!engineResult.localError.length())
+					engineResult.localError = voices[v].result.localError;
+			}
+			return engineResult;
+		}
+
 		//	create engine
-		Engine engine;
+		Engine engine(createEngine);
 
 		//	if any ((VOICE)) tokens are in use, we must have voice at this stage
 		size_t f1 = instance.logFilename.find("((VOICE))");
@@ -546,53 +692,8 @@ EngineResult execute(int argc, char *argv[])
 		//	default error now true
 		engineResult.error = true;
 
-		//	engine-instance catch
-		try
-		{
-			//	init engine
-			engine.up();
-
-			//	operations
-			switch (instance.operation)
-			{
-				case OP_WALK:
-				{
-					//	must be done after environment is finalized, so we know where the NamespaceRoots are
-					Symbol result = engine_walk(engine.hEngine, instance.walkLevel);
-					if (S_ERROR(result)) return engine.down();
-					break;
-				}
-
-				case OP_EXECUTE:
-				{
-					//	init
-					Symbol result = engine_open(engine.hEngine);
-					if (S_ERROR(result)) return engine.down();
-
-					//	run
-					result = engine_execute(engine.hEngine);
-					if (S_ERROR(result)) return engine.down();
-
-					//	term
-					result = engine_close(engine.hEngine);
-					if (S_ERROR(result)) return engine.down();
-					break;
-				}
-
-				default:
-				{
-					client_err << "E_INVOCATION: no operation specified on command line";
-				}
-			}
-		}
-
-		catch(Symbol e)
-		{
-			return engine.down();
-		}
-
-		//	down
-		return engine.down();
+		//	up, operate, down
+		return runEngine(engine);
 	}
 
 	catch(const string& e)
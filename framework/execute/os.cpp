@@ -141,4 +141,68 @@ namespace os
         return !stat(path.c_str(), &buf);
 #endif
     }
+    // RUN CONCURRENTLY
+
+    struct ConcurrentCall
+    {
+        void (*func)(void*);
+        void* arg;
+    };
+
+#ifdef __WIN__
+    DWORD WINAPI concurrentThreadProc(LPVOID arg)
+    {
+        ConcurrentCall* call = (ConcurrentCall*) arg;
+        call->func(call->arg);
+        return 0;
+    }
+#endif
+
+#ifdef __NIX__
+    void* concurrentThreadProc(void* arg)
+    {
+        ConcurrentCall* call = (ConcurrentCall*) arg;
+        call->func(call->arg);
+        return NULL;
+    }
+#endif
+
+    void concurrently(void (*func)(void*), void** args, UINT32 count)
+    {
+        ConcurrentCall* calls = new ConcurrentCall[count];
+        for (UINT32 c=0; c<count; c++)
+        {
+            calls[c].func = func;
+            calls[c].arg = args[c];
+        }
+
+#ifdef __WIN__
+        HANDLE* threads = new HANDLE[count];
+        for (UINT32 c=0; c<count; c++)
+        {
+            threads[c] = CreateThread(NULL, 0, concurrentThreadProc, &calls[c], 0, NULL);
+            if (!threads[c]) client_err << "E_OS: failed to create thread";
+        }
+        for (UINT32 c=0; c<count; c++)
+        {
+            WaitForSingleObject(threads[c], INFINITE);
+            CloseHandle(threads[c]);
+        }
+#endif
+
+#ifdef __NIX__
+        pthread_t* threads = new pthread_t[count];
+        for (UINT32 c=0; c<count; c++)
+        {
+            if (pthread_create(&threads[c], NULL, concurrentThreadProc, &calls[c]))
+                client_err << "E_OS: failed to create thread";
+        }
+        for (UINT32 c=0; c<count; c++)
+            pthread_join(threads[c], NULL);
+#endif
+
+        delete [] threads;
+        delete [] calls;
+    }
+
 }
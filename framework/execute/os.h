@@ -72,6 +72,9 @@ namespace os
     string expandpath(string path);
     string getenv(string key, bool exceptionIfAbsent = true);
     bool fileexists(string path);
+
+    //	call func(arg[i]) for each of "count" args, each in its own thread, and wait for them all
+    void concurrently(void (*func)(void*), void** args, UINT32 count);
 }
 
 #endif // _EXECUTE_OS_H_
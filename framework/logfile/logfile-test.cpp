@@ -0,0 +1,304 @@
+/*
+________________________________________________________________
+
+	This file is part of BRAHMS
+	Copyright (C) 2007 Ben Mitchinson
+	URL: http://brahms.sourceforge.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+________________________________________________________________
+
+*/
+
+/*
+
+	Writes chunked log files (see LOG_CHUNKS) the way the log
+	writer in components/logwriter.h does, and reads them back
+	with LogFileReader: whole, with the trailer cut off (so the
+	index is rebuilt from the chunk headers), with the last chunk
+	cut short, and as written on a host of the other byte order.
+	Returns non-zero if anything read back differs.
+
+*/
+
+////////////////	INCLUDE SUPPORT
+
+//	includes
+#include "brahms-client.h"
+#include "brahms-logfile.h"
+#include "lz.h"
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace brahms::logfile;
+
+const char* const FILENAME = "logfile-test.dat";
+
+//	sample is two DOUBLEs, three chunks of them, one per codec
+const UINT32 SAMPLE_ELEMENTS = 2;
+const UINT32 SAMPLE_BYTES = SAMPLE_ELEMENTS * sizeof(DOUBLE);
+const UINT64 CHUNK_SAMPLES[] = { 1000, 1000, 337 };
+const UINT8 CHUNK_CODECS[] = { CODEC_SHUFFLE8_LZ, CODEC_LZ, CODEC_STORED };
+const UINT32 CHUNKS = 3;
+
+UINT32 failures = 0;
+
+#define CHECK(cond) check(cond, #cond, __LINE__)
+
+void check(bool cond, const char* what, int line)
+{
+	if (cond) return;
+	printf("FAILED (line %i): %s\n", line, what);
+	failures++;
+}
+
+
+
+////////////////	WRITE
+
+DOUBLE value(UINT64 sample, UINT32 element)
+{
+	//	smooth, so the LZ chunks really are compressed
+	return element ? cos(sample * 0.01) : (DOUBLE)(sample / 8);
+}
+
+void append(vector<UINT8>& file, const void* data, UINT64 bytes)
+{
+	const UINT8* p = (const UINT8*) data;
+	file.insert(file.end(), p, p + bytes);
+}
+
+//	whole file, and where its trailer and its last chunk begin
+void build(vector<UINT8>& file, UINT64& indexOffset, UINT64& lastChunkOffset)
+{
+	file.clear();
+	vector<IndexEntry> index;
+	UINT64 sample = 0;
+
+	for (UINT32 c=0; c<CHUNKS; c++)
+	{
+		//	samples
+		vector<UINT8> raw(CHUNK_SAMPLES[c] * SAMPLE_BYTES);
+		DOUBLE* d = (DOUBLE*) &raw[0];
+		for (UINT64 s=0; s<CHUNK_SAMPLES[c]; s++)
+			for (UINT32 e=0; e<SAMPLE_ELEMENTS; e++)
+				*(d++) = value(sample + s, e);
+
+		//	encode
+		vector<UINT8> stored = raw;
+		if (CHUNK_CODECS[c] != CODEC_STORED)
+		{
+			vector<UINT8> src = raw;
+			if (CHUNK_CODECS[c] == CODEC_SHUFFLE8_LZ)
+				shuffle(&raw[0], (UINT32) raw.size(), 8, &src[0]);
+			stored.resize(lzBound((UINT32) raw.size()));
+			stored.resize(lzCompress(&src[0], (UINT32) src.size(), &stored[0]));
+			CHECK(stored.size() < raw.size());
+		}
+
+		ChunkHeader header;
+		header.magic = CHUNK_MAGIC;
+		header.codec = CHUNK_CODECS[c];
+		header.width = sizeof(DOUBLE);
+		header.reserved = 0;
+		header.rawBytes = (UINT32) raw.size();
+		header.storedBytes = (UINT32) stored.size();
+		header.firstSample = sample;
+		header.lastSample = sample + CHUNK_SAMPLES[c] - 1;
+
+		IndexEntry entry;
+		entry.offset = file.size();
+		entry.firstSample = header.firstSample;
+		entry.lastSample = header.lastSample;
+		entry.rawBytes = header.rawBytes;
+		entry.storedBytes = header.storedBytes;
+		index.push_back(entry);
+
+		lastChunkOffset = file.size();
+		append(file, &header, sizeof(header));
+		append(file, &stored[0], stored.size());
+		sample += CHUNK_SAMPLES[c];
+	}
+
+	//	footer
+	string cls = "std/2009/data/numeric";
+	string struc = "DOUBLE/REAL/CPXFMT_ADJACENT/COLUMN_MAJOR/2";
+
+	Info info;
+	memset(&info, 0, sizeof(info));
+	info.sampleRate.num = 1000;
+	info.sampleRate.den = 1;
+	info.type = TYPE_DOUBLE | TYPE_REAL;
+	info.sampleBytes = SAMPLE_BYTES;
+	info.classBytes = (UINT16) cls.length();
+	info.structureBytes = (UINT16) struc.length();
+
+	Trailer trailer;
+	trailer.indexOffset = file.size();
+	trailer.sampleCount = sample;
+	trailer.chunkCount = CHUNKS;
+	trailer.infoBytes = sizeof(info) + info.classBytes + info.structureBytes;
+	trailer.version = FORMAT_VERSION;
+	trailer.magic = TRAILER_MAGIC;
+
+	indexOffset = file.size();
+	append(file, &index[0], index.size() * sizeof(IndexEntry));
+	append(file, &info, sizeof(info));
+	append(file, cls.c_str(), cls.length());
+	append(file, struc.c_str(), struc.length());
+	append(file, &trailer, sizeof(trailer));
+}
+
+bool save(const vector<UINT8>& file, UINT64 bytes)
+{
+	FILE* fid = fopen(FILENAME, "wb");
+	if (!fid) return false;
+	bool ok = !bytes || fwrite(&file[0], bytes, 1, fid) == 1;
+	return !fclose(fid) && ok;
+}
+
+
+
+////////////////	READ
+
+//	samples "first" to "last" read back as they were written
+bool samplesMatch(const LogFileReader& reader, UINT64 first, UINT64 last)
+{
+	vector<UINT8> out;
+	if (reader.readSamples(first, last, out)) return false;
+	if (out.size() != (last - first + 1) * SAMPLE_BYTES) return false;
+	const DOUBLE* d = (const DOUBLE*) &out[0];
+	for (UINT64 s=first; s<=last; s++)
+		for (UINT32 e=0; e<SAMPLE_ELEMENTS; e++)
+			if (*(d++) != value(s, e)) return false;
+	return true;
+}
+
+//	what can be read from any whole chunks, with or without a trailer
+void checkChunks(const LogFileReader& reader, UINT32 chunks)
+{
+	UINT64 samples = 0;
+	for (UINT32 c=0; c<chunks; c++) samples += CHUNK_SAMPLES[c];
+
+	CHECK(reader.chunkCount() == chunks);
+	CHECK(reader.sampleCount() == samples);
+	CHECK(reader.sampleBytes() == SAMPLE_BYTES);
+
+	//	each chunk whole, and runs across the boundaries between them
+	UINT64 first = 0;
+	for (UINT32 c=0; c<chunks; c++)
+	{
+		CHECK(reader.findChunk(first) == c);
+		CHECK(reader.findChunk(first + CHUNK_SAMPLES[c] - 1) == c);
+		CHECK(samplesMatch(reader, first, first + CHUNK_SAMPLES[c] - 1));
+		if (c) CHECK(samplesMatch(reader, first - 10, first + 10));
+		first += CHUNK_SAMPLES[c];
+	}
+	CHECK(samplesMatch(reader, 0, samples - 1));
+	CHECK(samplesMatch(reader, samples - 1, samples - 1));
+	CHECK(reader.findChunk(samples) == chunks);
+
+	//	out of range
+	vector<UINT8> out;
+	CHECK(reader.readSamples(0, samples, out) != NULL);
+	CHECK(reader.readSamples(10, 9, out) != NULL);
+	CHECK(reader.readChunk(chunks, out) != NULL);
+}
+
+//	open fails, for the right reason
+bool refusedByteOrder(LogFileReader& reader)
+{
+	const char* err = reader.open(FILENAME);
+	return err && strstr(err, "byte order");
+}
+
+
+
+////////////////	MAIN
+
+int main()
+{
+	vector<UINT8> file;
+	UINT64 indexOffset = 0, lastChunkOffset = 0;
+	build(file, indexOffset, lastChunkOffset);
+	LogFileReader reader;
+
+	//	whole file
+	CHECK(save(file, file.size()));
+	CHECK(reader.open(FILENAME) == NULL);
+	CHECK(!reader.recovered());
+	CHECK(reader.className() == "std/2009/data/numeric");
+	CHECK(reader.structure() == "DOUBLE/REAL/CPXFMT_ADJACENT/COLUMN_MAJOR/2");
+	CHECK(reader.dims().size() == 1 && reader.dims()[0] == 2);
+	CHECK(reader.type() == (TYPE_DOUBLE | TYPE_REAL));
+	CHECK(reader.sampleRate().num == 1000 && reader.sampleRate().den == 1);
+	checkChunks(reader, CHUNKS);
+	reader.close();
+
+	//	no trailer: index rebuilt from the chunk headers, info blank
+	CHECK(save(file, indexOffset));
+	CHECK(reader.open(FILENAME) == NULL);
+	CHECK(reader.recovered());
+	CHECK(reader.className().empty() && reader.structure().empty());
+	checkChunks(reader, CHUNKS);
+	reader.close();
+
+	//	last chunk cut short: the whole ones are still recovered
+	CHECK(save(file, lastChunkOffset + sizeof(ChunkHeader) + 10));
+	CHECK(reader.open(FILENAME) == NULL);
+	CHECK(reader.recovered());
+	checkChunks(reader, CHUNKS - 1);
+	reader.close();
+
+	//	not a log file at all
+	vector<UINT8> junk(100, 0x55);
+	CHECK(save(junk, junk.size()));
+	CHECK(reader.open(FILENAME) != NULL);
+	reader.close();
+
+	//	other byte order is refused, with or without a trailer
+	vector<UINT8> swapped = file;
+	Trailer trailer;
+	memcpy(&trailer, &swapped[swapped.size() - sizeof(trailer)], sizeof(trailer));
+	UINT8* magic = (UINT8*) &trailer.magic;
+	swap(magic[0], magic[3]);
+	swap(magic[1], magic[2]);
+	memcpy(&swapped[swapped.size() - sizeof(trailer)], &trailer, sizeof(trailer));
+	CHECK(save(swapped, swapped.size()));
+	CHECK(refusedByteOrder(reader));
+	reader.close();
+
+	magic = &swapped[0];
+	swap(magic[0], magic[3]);
+	swap(magic[1], magic[2]);
+	CHECK(save(swapped, indexOffset));
+	CHECK(refusedByteOrder(reader));
+	reader.close();
+
+	remove(FILENAME);
+
+	if (failures)
+	{
+		printf("%u check(s) failed\n", failures);
+		return 1;
+	}
+
+	printf("all checks passed\n");
+	return 0;
+}
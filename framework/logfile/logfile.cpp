@@ -0,0 +1,367 @@
+/*
+________________________________________________________________
+
+	This file is part of BRAHMS
+	Copyright (C) 2007 Ben Mitchinson
+	URL: http://brahms.sourceforge.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+________________________________________________________________
+
+*/
+
+////////////////	INCLUDE SUPPORT
+#define BRAHMS_BUILDING_LOGFILE
+
+//	includes
+#include "brahms-client.h"
+#include "brahms-logfile.h"
+#include "lz.h"
+#include <cstring>
+#include <cstdlib>
+
+#ifdef __WIN__
+#define WIN32_LEAN_AND_MEAN
+#include "windows.h"
+#endif
+
+#ifdef __NIX__
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace brahms
+{
+	namespace logfile
+	{
+
+
+
+	////////////////	HELPERS
+
+		//	magic as read on a host of the other byte order
+		static UINT32 reversed(UINT32 magic)
+		{
+			return (magic >> 24) | ((magic >> 8) & 0xFF00) | ((magic << 8) & 0xFF0000) | (magic << 24);
+		}
+
+		const char* const E_BYTE_ORDER = "file was written on a host of the other byte order";
+
+
+
+	////////////////	LOG FILE READER
+
+		LogFileReader::LogFileReader()
+		{
+			base = NULL;
+			bytes = 0;
+#ifdef __WIN__
+			hFile = INVALID_HANDLE_VALUE;
+			hMapping = NULL;
+#endif
+#ifdef __NIX__
+			fd = -1;
+#endif
+			memset(&info, 0, sizeof(info));
+			count = 0;
+			rebuilt = false;
+		}
+
+		LogFileReader::~LogFileReader()
+		{
+			close();
+		}
+
+		const char* LogFileReader::open(const char* filename)
+		{
+			close();
+
+#ifdef __WIN__
+			hFile = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+			if (hFile == INVALID_HANDLE_VALUE) return "failed to open file";
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(hFile, &size)) return "failed to get file size";
+			bytes = size.QuadPart;
+			if (bytes)
+			{
+				hMapping = CreateFileMapping(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+				if (!hMapping) return "failed to map file";
+				base = (const UINT8*) MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+				if (!base) return "failed to map file";
+			}
+#endif
+#ifdef __NIX__
+			fd = ::open(filename, O_RDONLY);
+			if (fd == -1) return "failed to open file";
+			struct stat st;
+			if (fstat(fd, &st)) return "failed to get file size";
+			bytes = st.st_size;
+			if (bytes != (size_t)bytes) return "file too large to map";
+			if (bytes)
+			{
+				void* p = mmap(NULL, bytes, PROT_READ, MAP_SHARED, fd, 0);
+				if (p == MAP_FAILED) return "failed to map file";
+				base = (const UINT8*) p;
+			}
+#endif
+
+			//	index and info from trailer, or rebuild index if there isn't one
+			const char* err = readTrailer();
+			if (err) return err;
+			return parseStructure();
+		}
+
+		void LogFileReader::close()
+		{
+#ifdef __WIN__
+			if (base) UnmapViewOfFile(base);
+			if (hMapping) CloseHandle(hMapping);
+			if (hFile != INVALID_HANDLE_VALUE) CloseHandle(hFile);
+			hFile = INVALID_HANDLE_VALUE;
+			hMapping = NULL;
+#endif
+#ifdef __NIX__
+			if (base) munmap((void*)base, bytes);
+			if (fd != -1) ::close(fd);
+			fd = -1;
+#endif
+			base = NULL;
+			bytes = 0;
+
+			memset(&info, 0, sizeof(info));
+			cls.clear();
+			struc.clear();
+			sampleDims.clear();
+			index.clear();
+			count = 0;
+			rebuilt = false;
+		}
+
+		const char* LogFileReader::readTrailer()
+		{
+			Trailer trailer;
+			if (bytes < sizeof(trailer)) return scanChunks();
+			memcpy(&trailer, base + bytes - sizeof(trailer), sizeof(trailer));
+			if (trailer.magic == reversed(TRAILER_MAGIC)) return E_BYTE_ORDER;
+			if (trailer.magic != TRAILER_MAGIC) return scanChunks();
+			if (trailer.version != FORMAT_VERSION) return "unsupported format version";
+
+			//	locate sections
+			UINT64 indexBytes = (UINT64)trailer.chunkCount * sizeof(IndexEntry);
+			UINT64 infoOffset = trailer.indexOffset + indexBytes;
+			if (infoOffset < trailer.indexOffset || infoOffset > bytes || bytes - infoOffset != trailer.infoBytes + sizeof(trailer))
+				return "trailer corrupt";
+
+			//	index
+			index.resize(trailer.chunkCount);
+			if (indexBytes) memcpy(&index[0], base + trailer.indexOffset, indexBytes);
+			for (UINT32 c=0; c<index.size(); c++)
+			{
+				//	chunk must lie before the index (compared by subtraction, so a corrupt entry can't wrap round)
+				const IndexEntry& entry = index[c];
+				if (entry.lastSample < entry.firstSample)
+					return "index corrupt";
+				if (entry.offset > trailer.indexOffset || trailer.indexOffset - entry.offset < sizeof(ChunkHeader))
+					return "index corrupt";
+				if (entry.storedBytes > trailer.indexOffset - entry.offset - sizeof(ChunkHeader))
+					return "index corrupt";
+				if (c && entry.firstSample <= index[c-1].lastSample)
+					return "index corrupt (samples out of order)";
+			}
+
+			//	info
+			const UINT8* p = base + infoOffset;
+			if (trailer.infoBytes < sizeof(info)) return "info corrupt";
+			memcpy(&info, p, sizeof(info));
+			if (sizeof(info) + info.classBytes + info.structureBytes != trailer.infoBytes) return "info corrupt";
+			p += sizeof(info);
+			cls.assign((const char*)p, info.classBytes);
+			p += info.classBytes;
+			struc.assign((const char*)p, info.structureBytes);
+
+			count = trailer.sampleCount;
+			return NULL;
+		}
+
+		const char* LogFileReader::scanChunks()
+		{
+			//	no trailer, so keep what chunks were written whole (info stays blank)
+			rebuilt = true;
+			UINT64 offset = 0;
+			while (offset + sizeof(ChunkHeader) <= bytes)
+			{
+				ChunkHeader header;
+				memcpy(&header, base + offset, sizeof(header));
+				if (!offset && header.magic == reversed(CHUNK_MAGIC)) return E_BYTE_ORDER;
+				if (header.magic != CHUNK_MAGIC) break;
+				if (header.lastSample < header.firstSample) break;
+				if (index.size() && header.firstSample <= index.back().lastSample) break;
+				if (header.storedBytes > bytes - offset - sizeof(header)) break;
+
+				IndexEntry entry;
+				entry.offset = offset;
+				entry.firstSample = header.firstSample;
+				entry.lastSample = header.lastSample;
+				entry.rawBytes = header.rawBytes;
+				entry.storedBytes = header.storedBytes;
+				index.push_back(entry);
+
+				offset += sizeof(header) + header.storedBytes;
+			}
+
+			if (index.empty() && bytes) return "not a chunked log file";
+			if (index.size()) count = index.back().lastSample + 1;
+
+			//	fixed size, if every chunk says so
+			for (UINT32 c=0; c<index.size(); c++)
+			{
+				//	(samples wraps to zero if a chunk claims every sample there is)
+				UINT64 samples = index[c].lastSample - index[c].firstSample + 1;
+				UINT64 sampleBytes = samples ? index[c].rawBytes / samples : 0;
+				if (!samples || sampleBytes * samples != index[c].rawBytes || (c && sampleBytes != info.sampleBytes))
+				{
+					info.sampleBytes = 0;
+					break;
+				}
+				info.sampleBytes = (UINT32) sampleBytes;
+			}
+
+			return NULL;
+		}
+
+		const char* LogFileReader::parseStructure()
+		{
+			//	dims are the last part, e.g. "DOUBLE/REAL/CPXFMT_ADJACENT/COLUMN_MAJOR/3,4"
+			sampleDims.clear();
+			if (struc.empty()) return NULL;
+
+			size_t slash = struc.rfind('/');
+			string sdims = slash == string::npos ? struc : struc.substr(slash + 1);
+			size_t pos = 0;
+			while (pos <= sdims.length())
+			{
+				size_t comma = sdims.find(',', pos);
+				if (comma == string::npos) comma = sdims.length();
+				string dim = sdims.substr(pos, comma - pos);
+				if (dim == "*") sampleDims.push_back(-1);
+				else
+				{
+					char* end = NULL;
+					INT64 d = strtol(dim.c_str(), &end, 10);
+					if (dim.empty() || *end || d < 0) return "structure corrupt";
+					sampleDims.push_back(d);
+				}
+				pos = comma + 1;
+			}
+
+			return NULL;
+		}
+
+		UINT32 LogFileReader::findChunk(UINT64 sample) const
+		{
+			//	first chunk whose last sample is not before "sample"
+			UINT32 lo = 0;
+			UINT32 hi = (UINT32) index.size();
+			while (lo < hi)
+			{
+				UINT32 mid = lo + (hi - lo) / 2;
+				if (index[mid].lastSample < sample) lo = mid + 1;
+				else hi = mid;
+			}
+			return lo;
+		}
+
+		const char* LogFileReader::readChunk(UINT32 c, vector<UINT8>& out) const
+		{
+			if (c >= index.size()) return "chunk out of range";
+			const IndexEntry& entry = index[c];
+
+			ChunkHeader header;
+			memcpy(&header, base + entry.offset, sizeof(header));
+			if (header.magic != CHUNK_MAGIC || header.rawBytes != entry.rawBytes || header.storedBytes != entry.storedBytes)
+				return "chunk header corrupt";
+			const UINT8* payload = base + entry.offset + sizeof(header);
+
+			out.resize(header.rawBytes);
+			if (!header.rawBytes) return NULL;
+
+			switch (header.codec)
+			{
+				case CODEC_STORED:
+				{
+					if (header.storedBytes != header.rawBytes) return "chunk header corrupt";
+					memcpy(&out[0], payload, header.rawBytes);
+					return NULL;
+				}
+
+				case CODEC_LZ:
+				case CODEC_SHUFFLE4_LZ:
+				case CODEC_SHUFFLE8_LZ:
+				{
+					//	decode straight into "out" if there's no shuffle to undo
+					vector<UINT8> shuffled;
+					UINT8* dst = &out[0];
+					if (header.codec != CODEC_LZ)
+					{
+						shuffled.resize(header.rawBytes);
+						dst = &shuffled[0];
+					}
+
+					UINT32 decoded = header.rawBytes;
+					const char* err = lzDecompress(payload, header.storedBytes, dst, &decoded);
+					if (err) return err;
+					if (decoded != header.rawBytes) return "chunk decoded to wrong length";
+
+					if (header.codec != CODEC_LZ)
+						unshuffle(dst, header.rawBytes, header.codec == CODEC_SHUFFLE4_LZ ? 4 : 8, &out[0]);
+					return NULL;
+				}
+
+				default:
+					return "unrecognised codec";
+			}
+		}
+
+		const char* LogFileReader::readSamples(UINT64 first, UINT64 last, vector<UINT8>& out) const
+		{
+			out.clear();
+			if (!info.sampleBytes) return "samples are not of fixed size (use readChunk())";
+			if (last < first || last >= count) return "samples out of range";
+
+			out.resize((last - first + 1) * info.sampleBytes);
+			vector<UINT8> chunkData;
+			for (UINT32 c=findChunk(first); c<index.size() && index[c].firstSample<=last; c++)
+			{
+				const char* err = readChunk(c, chunkData);
+				if (err) return err;
+
+				//	overlap of chunk with request
+				const IndexEntry& entry = index[c];
+				UINT64 from = entry.firstSample > first ? entry.firstSample : first;
+				UINT64 to = entry.lastSample < last ? entry.lastSample : last;
+				if (to - entry.firstSample >= chunkData.size() / info.sampleBytes) return "chunk shorter than its sample range";
+				memcpy(&out[(from - first) * info.sampleBytes], &chunkData[(from - entry.firstSample) * info.sampleBytes], (to - from + 1) * info.sampleBytes);
+			}
+
+			return NULL;
+		}
+
+	}
+}
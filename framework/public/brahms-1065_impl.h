@@ -241,6 +241,14 @@ BRAHMS_DLL_EXPORT Symbol EventHandler(Event* event)
 				break;
 			}
 
+#ifdef COMPONENT_DATA
+			case EVENT_CONTENT_ADOPT:
+			{
+				//	1065 data objects only ever copy their content in
+				break;
+			}
+#endif
+
 			default:
 			{
 				//	ignore unrecognised module-level events so that if new
@@ -128,6 +128,9 @@ using namespace brahms;
 #include <cctype>
 #include <cstring>
 
+//	numbers as DataML text
+#include "brahms-numtext.h"
+
 //	helper function
 std::string ____N2S(UINT32 n)
 {
@@ -1278,6 +1281,43 @@ namespace brahms
 
 	*/
 
+	/*	DOCUMENTATION: DATAML_BINARY
+
+		A numeric DataML node holds its numbers as text (see
+		DATAML_NUMBERS) unless its storage modifier, s, says
+		otherwise:
+
+			s="64"	the node text is the elements in base64
+			s="b"	the node text is the name of a binary file
+			s="c"	as "b", but a chunked log file (LOG_CHUNKS)
+
+		With s="64", the elements are in the order they would
+		be written as text (for complex data, all real parts
+		then all imaginary parts if the class ends "x", or the
+		real and imaginary part of each element in turn if it
+		ends "y"), each little-endian, and the text is their
+		bytes in standard base64 (RFC 4648), padded with "=".
+		Whitespace in the text is ignored. setArray() (and
+		setRaw()) write arrays of at least DataMLBinaryThreshold
+		bytes this way, so this covers SystemML state,
+		EVENT_STATE_GET output and encapsulated logs; at its
+		default of zero, they are always written as text. A
+		number takes 4/3 of its width in base64, against up to
+		24 characters as text, and is copied, rather than
+		converted, both ways.
+
+		With s="b", the file holds the raw elements, in machine
+		order, complex data interleaved real/imaginary at the
+		granularity of the last dimension ("x") or of the
+		element ("y"). A file name that is not absolute is
+		relative to the SupplementaryFilePath. If the node has
+		an offset attribute, o, the data start that many bytes
+		into the file and the file may hold other data too;
+		otherwise, the file must hold exactly the data. Either
+		way, the length of the data is given by the class and
+		dims (c and b).
+	*/
+
 	//	version
 	#define DATAML_VERSION "5"
 
@@ -1288,6 +1328,7 @@ namespace brahms
 	//	private flags
 	const UINT32 F_STRING_FMT		= 0x80000000;
 	const UINT32 F_BINARY_FILE_FMT	= 0x40000000;
+	const UINT32 F_BASE64_FMT		= 0x20000000;
 
 	#define ENSURE_STRUCT { if ((cache.type & TYPE_ELEMENT_MASK) != TYPE_STRUCT) berr << E_DATAML << "expected " << getNodeNoun() << " to be a struct node"; }
 	#define ENSURE_CELL { if ((cache.type & TYPE_ELEMENT_MASK) != TYPE_CELL) berr << E_DATAML << "expected " << getNodeNoun() << " to be a cell node"; }
@@ -1428,13 +1469,17 @@ namespace brahms
 			//	get node text
 			const char* text = xmlNode->nodeText();
 
-			//	assume not binary file fmt, unless specified
-			flags &= (~F_BINARY_FILE_FMT);
+			//	assume not binary file or base64 fmt, unless specified
+			flags &= (~(F_BINARY_FILE_FMT | F_BASE64_FMT));
 			const char* storage = xmlNode->getAttributeOrNull("s");
 			if (storage)
 			{
 				if (storage == std::string("b"))
 					flags |= F_BINARY_FILE_FMT;
+				else if (storage == std::string("64"))
+					flags |= F_BASE64_FMT;
+				else if (storage == std::string("c"))
+					berr << E_DATAML << "chunked log file (storage modifier \"c\") cannot be read as DataML during parse of " << getNodeNoun();
 				else berr << E_DATAML << "malformed storage modifier \"" << storage << "\" during parse of " << getNodeNoun();
 			}
 
@@ -2118,185 +2163,17 @@ namespace brahms
 
 		template <class T> const char* textToNumericData(T* p_arr, const char* p_text, UINT64 N, const char* nodeName) const
 		{
-			//	prepare type-specific infinity and nan
-			T inf = 0;
-			T nan = 0;
-			if (std::numeric_limits<T>::has_infinity)
-				inf = std::numeric_limits<T>::infinity();
-			if (std::numeric_limits<T>::has_quiet_NaN)
-				nan = std::numeric_limits<T>::quiet_NaN();
-
-			//	prepare working text pointer
-			const char* p_next = p_text;
+			//	each number is scanned and then converted exactly (see DATAML_NUMBERS)
+			brahms::numtext::Decimal decimal;
+			const char* p_end = p_text + strlen(p_text);
 
 			//	do the parse and fill
 			for (UINT64 n=0; n<N; n++)
 			{
-				/*
-
-				OLD CODE USES atof()
-
-				//	scan to first space
-				if (!*p_next) berr << E_DATAML << "overflow during parse of node \"" << nodeName
-					<< "\" (" << i << " of " << N << ")";
-				p_next = p_text;
-				while(*p_next && *p_next != ' ') p_next++;
-
 				//	scan a number
-				if ((p_next - p_text) == 3 && p_text[0] == 'I' && p_text[1] == 'n' && p_text[2] == 'f')
-					p_arr[i] = inf;
-				else if ((p_next - p_text) == 4 && p_text[0] == '-' && p_text[1] == 'I' && p_text[2] == 'n' && p_text[3] == 'f')
-					p_arr[i] = ninf;
-				else if ((p_next - p_text) == 3 && p_text[0] == 'N' && p_text[1] == 'a' && p_text[2] == 'N')
-					p_arr[i] = nan;
-				else if ((p_next - p_text) == 4 && p_text[0] == '-' && p_text[1] == 'N' && p_text[2] == 'a' && p_text[3] == 'N')
-					p_arr[i] = nnan;
-				else p_arr[i] = (T)atof(p_text);
-
-				//	advance
-				p_text = p_next + 1;
-
-				NEW CODE USES custom parsing, that is faster because we don't have
-				to handle so many cases as atof() tries to...
-
-				*/
-
-				double neg = 1.0;
-				double val = 0.0;
-
-				//	collect -ve
-				if (*p_next == '-')
-				{
-					neg = -1.0;
-					p_next++;
-				}
-
-				//	collect +ve
-				else if (*p_next == '+')
-				{
-					p_next++;
-				}
-
-				//	collect Inf
-				if (*p_next == 'I')
-				{
-					p_next++;
-					if (*p_next != 'n')
-						parse_error(p_text, "Inf");
-					p_next++;
-					if (*p_next != 'f')
-						parse_error(p_text, "Inf");
-					p_next++;
-					if (*p_next) // could be last, so no trailing space
-					{
-						if (*p_next != ' ')
-							parse_error(p_text, "Inf");
-						p_next++;
-					}
-					p_text = p_next;
-					p_arr[n] = (T)(neg * inf);
-					continue;
-				}
-
-				//	collect NaN
-				if (*p_next == 'N')
-				{
-					p_next++;
-					if (*p_next != 'a')
-						parse_error(p_text, "NaN");
-					p_next++;
-					if (*p_next != 'N')
-						parse_error(p_text, "NaN");
-					p_next++;
-					if (*p_next) // could be last, so no trailing space
-					{
-						if (*p_next != ' ')
-							parse_error(p_text, "NaN");
-						p_next++;
-					}
-					p_text = p_next;
-					p_arr[n] = (T)(neg * nan);
-					continue;
-				}
-
-				//	collect integer
-				if (*p_next >= '0' && *p_next <= '9')
-				{
-					UINT64 num = *p_next - '0';
-					p_next++;
-
-					//	have to stop collecting before the UINT64 container overflows: we can't represent additional precision anyway
-					while (*p_next >= '0' && *p_next <= '9')
-					{
-						if (num <= SUB_MAX_UINT64)
-						{
-							num *= 10;
-							num += *p_next - '0';
-						}
-						p_next++;
-					}
-
-					val = num;
-				}
-
-				//	collect fraction
-				if (*p_next == '.')
-				{
-					p_next++;
-					if (!(*p_next >= '0' && *p_next <= '9'))
-						parse_error(p_text, "fraction");
-
-					UINT64 num = *p_next - '0';
-					p_next++;
-					double divisor = 10.0;
-
-					//	have to stop collecting before the UINT64 container overflows: we can't represent additional precision anyway
-					while (*p_next >= '0' && *p_next <= '9')
-					{
-						if (num <= SUB_MAX_UINT64)
-						{
-							num *= 10;
-							num += *p_next - '0';
-							divisor *= 10.0;
-						}
-						p_next++;
-					}
-
-					val += ((double)num) / divisor;
-				}
-
-				//	collect exponent
-				if (*p_next == 'E' || *p_next == 'e')
-				{
-					p_next++;
-					double eneg = 1.0;
-
-					if (*p_next == '-')
-					{
-						eneg = -1.0;
-						p_next++;
-					}
-
-					else if (*p_next == '+')
-					{
-						p_next++;
-					}
-
-					if (!(*p_next >= '0' && *p_next <= '9'))
-						parse_error(p_text, "exponent");
-
-					UINT64 num = *p_next - '0';
-					p_next++;
-
-					while (*p_next >= '0' && *p_next <= '9')
-					{
-						num *= 10;
-						num += *p_next - '0';
-						p_next++;
-					}
-
-					val *= std::pow(10.0, eneg * ((double)num));
-				}
+				const char* p_next = p_text;
+				const char* malformed = brahms::numtext::scanDecimal(p_next, p_end, decimal);
+				if (malformed) parse_error(p_text, malformed);
 
 				//	skip final space
 				if (*p_next != ' ')
@@ -2308,7 +2185,7 @@ namespace brahms
 				else p_next++;
 
 				//	load output array and advance p_text
-				p_arr[n] = (T)(val * neg);
+				brahms::numtext::decimalToNumber(decimal, p_arr[n]);
 				p_text = p_next;
 			}
 
@@ -2323,9 +2200,31 @@ namespace brahms
 			if (p_imag && (cache.type & TYPE_REAL))
 				berr << E_DATAML << "attempt to read complex data from a non-complex array";
 
-			if (!p_imag && (cache.type & TYPE_COMPLEX))
+			//	data must either be split between the two pointers, or (if interleaved) all in p_real, as for setRaw()
+			if (!p_imag && (cache.type & TYPE_COMPLEX) && !(cache.type & TYPE_CPXFMT_INTERLEAVED))
 				berr << E_DATAML << "attempt to read non-complex data from a complex array";
 
+			//	interleaved data asked for in two blocks is read as it is, then split
+			if (p_imag && (cache.type & TYPE_CPXFMT_INTERLEAVED))
+			{
+				UINT64 N = getNumberOfElementsReal();
+				if (!N) return;
+				UINT32 bytesPerElement = TYPE_BYTES(cache.type);
+				std::vector<BYTE> both(N * 2 * bytesPerElement);
+				getRaw(&both[0]);
+				const BYTE* p_both = &both[0];
+				for (UINT64 n=0; n<N; n++)
+				{
+					memcpy(p_real, p_both, bytesPerElement);
+					p_real += bytesPerElement;
+					p_both += bytesPerElement;
+					memcpy(p_imag, p_both, bytesPerElement);
+					p_imag += bytesPerElement;
+					p_both += bytesPerElement;
+				}
+				return;
+			}
+
 			//	handle special case
 			if (flags & F_STRING_FMT)
 			{
@@ -2359,23 +2258,36 @@ namespace brahms
 					filename = pars.getChild("SupplementaryFilePath")->nodeText() + ("/" + filename);
 				}
 
+				//	data may be a blob within a larger file
+				const char* attrOffset = xmlNode->getAttributeOrNull("o");
+				UINT64 offset = 0;
+				if (attrOffset && !(std::istringstream(attrOffset) >> offset))
+					berr << E_DATAML << "malformed offset \"" << attrOffset << "\" during parse of " << getNodeNoun();
+
 				//	open it and check the size
 				std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
 				if (!file) berr << E_DATAML << "error opening \"" << filename << "\"";
 				file.seekg( 0, std::ios::end );
 				UINT64 fileBytes = file.tellg();
-				file.seekg( 0 );
-				if (N != fileBytes)
+				file.seekg( offset );
+				if (attrOffset ? (fileBytes < offset || fileBytes - offset < N) : N != fileBytes)
 				{
 					file.close();
-					berr << E_DATAML << "file \"" << filename << "\" should be " << N << " bytes (was " << fileBytes << ")";
+					if (attrOffset) berr << E_DATAML << "file \"" << filename << "\" should be at least " << offset << " + " << N << " bytes (was " << fileBytes << ")";
+					else berr << E_DATAML << "file \"" << filename << "\" should be " << N << " bytes (was " << fileBytes << ")";
 				}
 
-				//	fill it - the data will be interleaved real/complex/real/complex
+				//	fill it - interleaved data is read as it is
+				if (cache.type & TYPE_CPXFMT_INTERLEAVED)
+				{
+					if (N) file.read((char*)p_real, N);
+				}
+
+				//	otherwise the data will be interleaved real/complex/real/complex
 				//	at the granularity of the last dimension, so we need to know
 				//	what the last dimension is, and what the product of the other
 				//	dimensions is, for the chunk size
-				if (cache.dims.size())
+				else if (cache.dims.size())
 				{
 					UINT32 lastDim = cache.dims.back();
 					UINT32 chunkBytes = TYPE_BYTES(cache.type);
@@ -2411,6 +2323,24 @@ namespace brahms
 			if ( ! (format == TYPE_FORMAT_BOOL || format == TYPE_FORMAT_UINT || format == TYPE_FORMAT_INT || format == TYPE_FORMAT_FLOAT || format == TYPE_FORMAT_CHAR) )
 				berr << E_DATAML << "cannot fill from DataML node with data format \"" << getElementTypeString(cache.type) << "\"";
 
+			//	handle special case
+			if (flags & F_BASE64_FMT)
+			{
+				//	elements in the same order as text (see DATAML_BINARY)
+				brahms::numtext::Base64Reader reader(xmlNode->nodeText());
+				UINT64 bytes = getNumberOfBytesReal();
+				UINT32 nPhases = cache.type & TYPE_COMPLEX ? 2 : 1;
+				for (UINT32 phase=0; phase<nPhases; phase++)
+				{
+					BYTE* p_arr = phase == 1 ? (p_imag ? p_imag : p_real + bytes) : p_real;
+					const char* err = reader.read((UINT8*)p_arr, bytes, TYPE_BYTES(cache.type));
+					if (err) berr << E_DATAML << "content scan error during parse of " << getNodeNoun() << " (" << err << ")";
+				}
+				const char* err = reader.finish();
+				if (err) berr << E_DATAML << "content scan error during parse of " << getNodeNoun() << " (" << err << ")";
+				return;
+			}
+
 			//	get vital statistics
 //			UINT32 bytesPerElement = TYPE_BYTES(cache.type);
 			UINT64 N = getNumberOfElementsReal();
@@ -2462,26 +2392,21 @@ namespace brahms
 			//	prepare buffer
 			const UINT32 BUFFERSIZE = 16384;
 			char buffer[BUFFERSIZE];
-			buffer[0] = 0; // necessary!
 			char* p_buffer = buffer;
 
-			//	prepare fmt
-			std::string sfmtx = "%";
-			if (prec == PRECISION_NOT_SET)
-			{
-				if (fmt[0] == 'g') // is a float format, have to force max precision
-					sfmtx += ".20";
-			}
-			else
+			//	prepare fmt (if precision is not set, numbers are written exactly, see DATAML_NUMBERS)
+			std::string sfmtx;
+			if (prec != PRECISION_NOT_SET)
 			{
 				std::stringstream event;
-				event << prec;
-				sfmtx += "." + event.str();
+				event << "%." << prec << fmt;
+				sfmtx = event.str();
 			}
-			sfmtx += fmt;
-			sfmtx += " ";
 			const char* fmtx = sfmtx.c_str();
 
+			//	room for typical numbers of this type, so the string grows once
+			str.reserve(str.size() + numEls * (p2 ? 2 : 1) * (sizeof(T) * 2 + 2));
+
 			//	for each
 			for (UINT32 i=0; i<2; i++)
 			{
@@ -2492,21 +2417,26 @@ namespace brahms
 				//	loop over array
 				while(p_array < p_stop)
 				{
-					//	add to buffer and advance buffer pointer
+					//	add to buffer and advance buffer pointer (Inf and NaN are
+					//	written by numtext whatever the precision, as the CRTs differ)
+					if (prec == PRECISION_NOT_SET || !brahms::numtext::isFinite(*p_array))
+						p_buffer = brahms::numtext::formatNumber(p_buffer, *p_array);
+					else
+					{
 		#ifdef _MSC_VER
-					//	new security in CRT
-					sprintf_s(p_buffer, 30, fmtx, *p_array);
+						//	new security in CRT
+						p_buffer += sprintf_s(p_buffer, 30, fmtx, *p_array);
 		#else
-					sprintf(p_buffer, fmtx, *p_array);
+						p_buffer += sprintf(p_buffer, fmtx, *p_array);
 		#endif
-					while(*p_buffer) p_buffer++;
+					}
+					*p_buffer++ = ' ';
 
 					// flush buffer if approaching full
-					if ((p_buffer - buffer) > ((int)(BUFFERSIZE - 32)))
+					if ((p_buffer - buffer) > ((int)(BUFFERSIZE - 64)))
 					{
-						str += buffer;
+						str.append(buffer, p_buffer - buffer);
 						p_buffer = buffer;
-						*p_buffer = 0;
 					}
 
 					//	advance to next array element
@@ -2518,36 +2448,10 @@ namespace brahms
 			}
 
 			//	flush buffer one last time
-			str += buffer;
+			str.append(buffer, p_buffer - buffer);
 
 			//	remove trailing space
 			if (str.size()) str.erase(str.end() - 1);
-
-			//	convert IEEE representations to DataML representations
-			size_t from = 0;
-			while(true)
-			{
-				size_t next = str.find("1.#INF ", from);
-				if (next == std::string::npos) break;
-				str.replace(next, 7, "Inf    ");
-			}
-			while(true)
-			{
-				size_t next = str.find("1.#QNAN ", from);
-				if (next == std::string::npos) break;
-				str.replace(next, 8, "NaN     ");
-			}
-
-			//	-1.#IND (indeterminate) is achieved if we try to pass in a NaN through
-			//	a binary file. i have no idea why this comes out differently, but one
-			//	comes direct from matlab's binary representation, and the other comes
-			//	via matlab's sprintf and c++'s atof, so something is lost in translation.
-			while(true)
-			{
-				size_t next = str.find("-1.#IND ", from);
-				if (next == std::string::npos) break;
-				str.replace(next, 8, "NaN     ");
-			}
 		}
 
 		const char* datamlString(TYPE type)
@@ -2611,6 +2515,23 @@ namespace brahms
 			}
 		}
 
+		//	arrays of at least this many bytes are written in base64 (zero, never)
+		static UINT64 getBinaryThreshold()
+		{
+			//	execution parameters are read once, when they're there to be read
+			static INT64 threshold = -1;
+			if (threshold >= 0) return threshold;
+			if (!executionInfo) return 0;
+
+			XMLNode pars(executionInfo->executionParameters);
+			XMLNode* node = pars.getChildOrNull("DataMLBinaryThreshold");
+			UINT64 value = 0;
+			if (node && *node->nodeText() && !(std::istringstream(node->nodeText()) >> value))
+				berr << E_DATAML << "malformed DataMLBinaryThreshold \"" << node->nodeText() << "\"";
+			threshold = value;
+			return value;
+		}
+
 		void setRaw(const Dims& dims, TYPE type, const void* p_real, const void* p_imag)
 		{
 			//	validate data is supplied
@@ -2631,6 +2552,23 @@ namespace brahms
 			if (p_imag && (cache.type & TYPE_CPXFMT_INTERLEAVED))
 				berr << E_DATAML << "interleaved data supplied in two blocks is not correct usage";
 
+			//	large arrays are written in base64 (see DATAML_BINARY)
+			UINT32 bytesPerElement = TYPE_BYTES(type);
+			UINT64 bytes = cache.numberOfRealElements * mult * bytesPerElement;
+			UINT64 threshold = getBinaryThreshold();
+			if (threshold && bytes * (p_imag ? 2 : 1) >= threshold)
+			{
+				tempNodeTextString.reserve((bytes * (p_imag ? 2 : 1) + 2) / 3 * 4);
+				brahms::numtext::Base64Writer writer(tempNodeTextString);
+				writer.write((const UINT8*)p_real, bytes, bytesPerElement);
+				if (p_imag) writer.write((const UINT8*)p_imag, bytes, bytesPerElement);
+				writer.finish();
+
+				xmlNode->setAttribute("s", "64");
+				xmlNode->nodeText(tempNodeTextString.c_str());
+				return;
+			}
+
 			switch(type & TYPE_ELEMENT_MASK)
 			{
 				case TYPE_DOUBLE:
@@ -3323,11 +3261,18 @@ namespace brahms
 	////	BINARY NUMERIC INTERFACE
 
 		//	set numeric data in binary file form, where the caller has already written the binary file
-		void setBinaryFile(const Dims& dims, TYPE type, const char* filename)
+		//	(if "offset" is non-zero, the data are a blob that starts that far into the file)
+		void setBinaryFile(const Dims& dims, TYPE type, const char* filename, UINT64 offset = 0)
 		{
 			setArrayStructure(this, type, dims);
 
 			xmlNode->setAttribute("s", "b");
+			if (offset)
+			{
+				std::ostringstream o;
+				o << offset;
+				xmlNode->setAttribute("o", o.str().c_str());
+			}
 
 			//	if the fully-specified pathname has the path of the report file on it,
 			//	just write out the relative path name, for ease of moving the report data around
@@ -3345,6 +3290,15 @@ namespace brahms
 			else xmlNode->nodeText(filename);
 		}
 
+		void setChunkedFile(const Dims& dims, TYPE type, const char* filename)
+		{
+			//	as setBinaryFile(), but the file is a chunked log file, which
+			//	carries its own index and structure (see LOG_CHUNKS in
+			//	brahms-logfile.h)
+			setBinaryFile(dims, type, filename);
+			xmlNode->setAttribute("s", "c");
+		}
+
 
 
 
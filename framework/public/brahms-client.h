@@ -68,6 +68,7 @@ namespace brahms
 
         const UINT32 F_PAUSE_ON_EXIT    = 0x00000001;
         const UINT32 F_MAXERR      = 0x00000002;
+        const UINT32 F_LOOPBACK    = 0x00000004; // all voices are engines in this process (see LOOPBACK_CHANNEL)
 
         const Symbol C_BASE_MONITOR_EVENT   = C_BASE_ENGINE_EVENT + 0x1000;
 
@@ -406,7 +406,8 @@ namespace brahms
 #define F_INPUTS_SAME_RATE          ( 0x00000002 ) // component must only receive inputs that share its sample rate
 #define F_OUTPUTS_SAME_RATE         ( 0x00000004 ) // component must only create outputs that share its sample rate
 #define F_NOT_RATE_CHANGER          ( F_INPUTS_SAME_RATE | F_OUTPUTS_SAME_RATE )
-#define M_COMPONENT_FLAGS           ( 0x00000007 )
+#define F_OPTIMISTIC                ( 0x00000008 ) // component can be rolled back, by EVENT_STATE_GET/EVENT_STATE_SET with F_CHECKPOINT during the run phase
+#define M_COMPONENT_FLAGS           ( 0x0000000F )
 
         struct ComponentData
         {
@@ -536,6 +537,11 @@ namespace brahms
 #define C_BUFFERING_BALANCED       ( C_BASE_COMPONENT + 0x0043 )
 #define C_BUFFERING_FAVOUR_MEMORY  ( C_BASE_COMPONENT + 0x0044 )
 #define C_BUFFERING_ONLY_MEMORY    ( C_BASE_COMPONENT + 0x0045 )
+#define C_LOG_DECIMATE             ( C_BASE_COMPONENT + 0x0051 )
+#define C_LOG_MEAN                 ( C_BASE_COMPONENT + 0x0052 )
+#define C_LOG_MIN                  ( C_BASE_COMPONENT + 0x0053 )
+#define C_LOG_MAX                  ( C_BASE_COMPONENT + 0x0054 )
+#define C_LOG_RMS                  ( C_BASE_COMPONENT + 0x0055 )
 
         // error range symbols
 #define E_BASE_COMPONENT           ( S_TYPE_ERROR + 0x0000 )
@@ -611,6 +617,7 @@ namespace brahms
         //  data event symbols
 #define EVENT_CONTENT_SET           ( C_BASE_COMPONENT_EVENT + 0x0131 )  //  here's your content as a binary stream
 #define EVENT_CONTENT_GET           ( C_BASE_COMPONENT_EVENT + 0x0132 )  //  please supply your content as a binary stream
+#define EVENT_CONTENT_ADOPT         ( C_BASE_COMPONENT_EVENT + 0x0133 )  //  here's your content as a binary stream, read it in place (optional, see below)
 #define EVENT_LOG_INIT              ( C_BASE_COMPONENT_EVENT + 0x0141 )  //  initialise storage
 #define EVENT_LOG_SERVICE           ( C_BASE_COMPONENT_EVENT + 0x0142 )  //  service (increment) storage
 #define EVENT_LOG_TERM              ( C_BASE_COMPONENT_EVENT + 0x0143 )  //  terminate storage (and return it)
@@ -708,6 +715,7 @@ namespace brahms
 
 #define F_UNDEFINED     ( 0x00000001 )   //  set state to "undefined", whatever that means to you
 #define F_ZERO      ( 0x00000002 )   //  set state to "zero", whatever that means to you
+#define F_CHECKPOINT    ( 0x00000004 )   //  (also EventStateGet) state is a run-phase checkpoint, see F_OPTIMISTIC
 
         struct EventStateSet
         {
@@ -742,6 +750,8 @@ namespace brahms
 ////////////////    DATA EVENTS
 
 #define F_ENCAPSULATED    ( 0x00000001 )
+#define F_COMPRESSED      ( 0x00000002 ) // (unencapsulated only) write the log as compressed chunks, if the data class can
+#define F_CHUNKED         ( 0x00000004 ) // (unencapsulated only) write the log as chunks, with an index (see brahms-logfile.h), if the data class can
         // INT32 flag
 #define PRECISION_NOT_SET   ( 0x40000000 )
 
@@ -751,6 +761,16 @@ namespace brahms
             UINT64 bytes;   //  number of bytes available in stream
         };
 
+        /*
+          EVENT_CONTENT_ADOPT carries an EventContent, like EVENT_CONTENT_SET,
+          but the data object may point its read state straight at "stream"
+          instead of copying it. The stream stays valid, and unchanged, until
+          the next EVENT_CONTENT_SET or EVENT_CONTENT_ADOPT on the same object;
+          the object must not write to it, and must go back to its own storage
+          when next written by any route. Return C_OK if adopted; a data class
+          that does not handle the event (S_NULL) is sent EVENT_CONTENT_SET.
+        */
+
         struct EventLog
         {
             UINT32 flags;
@@ -759,6 +779,10 @@ namespace brahms
             UINT64 count;
             void* source;
             Symbol result;
+            UINT32 decimate;    //  log one sample for every "decimate" serviced (zero or one means every sample)
+            Symbol aggregate;   //  how each "decimate" samples become one: C_LOG_DECIMATE (first of them), C_LOG_MEAN, C_LOG_MIN, C_LOG_MAX, or C_LOG_RMS
+            UINT64 memoryBudget;    //  at EVENT_LOG_INIT, bytes of the voice's log memory budget that remain; a data object that will hold its log in memory subtracts what it will hold
+            UINT64 spilled;     //  at EVENT_LOG_TERM, bytes of log that a data object held on disk because they did not fit the budget
         };
 
 
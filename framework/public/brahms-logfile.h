@@ -0,0 +1,248 @@
+/*
+________________________________________________________________
+
+	This file is part of BRAHMS
+	Copyright (C) 2007 Ben Mitchinson
+	URL: http://brahms.sourceforge.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+________________________________________________________________
+
+*/
+
+////////////////	CHUNKED LOG FILES
+
+#ifndef INCLUDED_BRAHMS_LOGFILE
+#define INCLUDED_BRAHMS_LOGFILE
+
+/*
+ "brahms-logfile.h" defines the format of chunked log files, which
+ data objects write for logs marked Chunked or Compressed in the
+ Execution File, and declares LogFileReader, which reads them back
+ with random access. Data objects include it for the format only;
+ clients that use the reader link against brahms-logfile.
+
+ It must be included after "brahms-component.h" (or a binding, or
+ "brahms-client.h"), which supplies the basic types.
+*/
+
+/*	DOCUMENTATION: LOG_CHUNKS
+
+	A chunked log file (marked s="c" in the report, where the
+	file name appears in place of the data) holds the log of
+	one output port. It is laid out as:
+
+		chunk 0
+		chunk 1
+		...
+		index (one IndexEntry per chunk)
+		info (Info, then class name, then structure string)
+		trailer (Trailer)
+
+	Each chunk is a ChunkHeader followed by its payload. A
+	chunk holds whole log samples (EventLog::count), so that
+	it can be decoded on its own, and its header gives the
+	range of samples it covers. The payload is those samples
+	exactly as they would have been written to an unchunked
+	(s="b") file, compressed with the in-tree LZ coder (see
+	COMPRESS_LZ), first byte-shuffled at the element width if
+	that is 4 or 8; or stored as is (CODEC_STORED) if that is
+	no smaller, or if the log was not marked Compressed.
+
+	The trailer, at the very end, locates the index and the
+	info. The info is what a reader needs to interpret the
+	samples without the report: the class of the data object,
+	its element type and sample rate, and its structure as a
+	string in the format of EVENT_GENERIC_STRUCTURE_GET, for
+	example "DOUBLE/REAL/CPXFMT_ADJACENT/COLUMN_MAJOR/3,4".
+	Samples of a fixed size (sampleBytes non-zero) are
+	numbered contiguously, so sample n of a chunk is at byte
+	(n - firstSample) * sampleBytes of its raw payload. Where
+	the size of a sample varies (data/spikes, for instance),
+	the last dimension is given as "*", samples that were
+	empty have no bytes at all, and a chunk must be decoded
+	whole.
+
+	If the run did not finish, the file may have no trailer;
+	chunks that were written whole can still be recovered by
+	hopping from header to header, and LogFileReader does so.
+
+	Headers, index, info and trailer are written as the structs
+	below, in the byte order of the host that wrote the file,
+	as the samples of an s="b" file are. A reader on a host of
+	the other byte order finds the magic numbers reversed, and
+	LogFileReader refuses such a file rather than misread it.
+*/
+
+namespace brahms
+{
+	namespace logfile
+	{
+		const UINT32 CHUNK_MAGIC = 0x4B434C42;			//	"BLCK"
+		const UINT32 TRAILER_MAGIC = 0x54464C42;		//	"BLFT"
+		const UINT32 FORMAT_VERSION = 1;
+
+		//	codecs (values match COMPRESS_CODEC_* in framework/compress/compress.h)
+		const UINT8 CODEC_STORED = 0x00;
+		const UINT8 CODEC_LZ = 0x03;
+		const UINT8 CODEC_SHUFFLE4_LZ = 0x04;
+		const UINT8 CODEC_SHUFFLE8_LZ = 0x05;
+
+		struct ChunkHeader
+		{
+			UINT32 magic;			//	CHUNK_MAGIC
+			UINT8 codec;			//	CODEC_*
+			UINT8 width;			//	element width in bytes
+			UINT16 reserved;
+			UINT32 rawBytes;		//	bytes of samples
+			UINT32 storedBytes;		//	bytes of payload that follow this header
+			UINT64 firstSample;		//	log sample of first sample in chunk
+			UINT64 lastSample;		//	log sample of last sample in chunk
+		};
+
+		struct IndexEntry
+		{
+			UINT64 offset;			//	of ChunkHeader, from start of file
+			UINT64 firstSample;
+			UINT64 lastSample;
+			UINT32 rawBytes;
+			UINT32 storedBytes;
+		};
+
+		struct Info
+		{
+			struct SampleRate sampleRate;	//	of the logged port
+			TYPE type;				//	element type, complexity, and ordering
+			UINT32 sampleBytes;		//	bytes per sample, or zero if it varies
+			UINT16 classBytes;		//	bytes of class name that follow
+			UINT16 structureBytes;	//	bytes of structure string that follow that
+			UINT32 reserved;
+		};
+
+		struct Trailer
+		{
+			UINT64 indexOffset;		//	of first IndexEntry, from start of file
+			UINT64 sampleCount;		//	log samples (EventLog::count at EVENT_LOG_TERM)
+			UINT32 chunkCount;		//	IndexEntry count
+			UINT32 infoBytes;		//	Info, class name, and structure string
+			UINT32 version;			//	FORMAT_VERSION
+			UINT32 magic;			//	TRAILER_MAGIC
+		};
+	}
+}
+
+
+
+////////////////	READER
+
+#ifdef __cplusplus
+
+#include <string>
+#include <vector>
+
+#ifdef BRAHMS_BUILDING_LOGFILE
+#define BRAHMS_LOGFILE_VIS BRAHMS_DLL_EXPORT_CPP
+#else
+#define BRAHMS_LOGFILE_VIS BRAHMS_DLL_IMPORT_CPP
+#endif
+
+namespace brahms
+{
+	namespace logfile
+	{
+		/*
+
+			Maps a chunked log file read-only, so that only the
+			chunks asked for are paged in. Functions that can fail
+			return an error string, or NULL on success, as does
+			CompressCodec().
+
+		*/
+
+		class BRAHMS_LOGFILE_VIS LogFileReader
+		{
+
+		public:
+
+			LogFileReader();
+			~LogFileReader();
+
+			//	map file, and read its index and info
+			const char* open(const char* filename);
+			void close();
+
+			//	info
+			const std::string& className() const { return cls; }
+			const std::string& structure() const { return struc; }
+			TYPE type() const { return info.type; }
+			SampleRate sampleRate() const { return info.sampleRate; }
+			UINT32 sampleBytes() const { return info.sampleBytes; }
+			UINT64 sampleCount() const { return count; }
+
+			//	dimensions of one sample, from structure() (-1 where it varies)
+			const std::vector<INT64>& dims() const { return sampleDims; }
+
+			//	true if the file had no trailer, and the index was rebuilt from the chunks
+			bool recovered() const { return rebuilt; }
+
+			//	chunks
+			UINT32 chunkCount() const { return (UINT32) index.size(); }
+			const IndexEntry& chunk(UINT32 c) const { return index[c]; }
+
+			//	chunk holding "sample", or the first after it, or chunkCount() if none
+			UINT32 findChunk(UINT64 sample) const;
+
+			//	decode chunk "c" into "out" (replacing its contents)
+			const char* readChunk(UINT32 c, std::vector<UINT8>& out) const;
+
+			//	decode samples "first" to "last" inclusive into "out" (fixed-size samples only)
+			const char* readSamples(UINT64 first, UINT64 last, std::vector<UINT8>& out) const;
+
+		private:
+
+			//	not copyable
+			LogFileReader(const LogFileReader&);
+			LogFileReader& operator=(const LogFileReader&);
+
+			const char* readTrailer();
+			const char* scanChunks();
+			const char* parseStructure();
+
+			//	mapping
+			const UINT8* base;
+			UINT64 bytes;
+#ifdef __WIN__
+			void* hFile;
+			void* hMapping;
+#endif
+#ifdef __NIX__
+			int fd;
+#endif
+
+			//	contents
+			Info info;
+			std::string cls;
+			std::string struc;
+			std::vector<INT64> sampleDims;
+			std::vector<IndexEntry> index;
+			UINT64 count;
+			bool rebuilt;
+		};
+	}
+}
+
+#endif
+
+#endif // INCLUDED_BRAHMS_LOGFILE
@@ -0,0 +1,1237 @@
+/*
+________________________________________________________________
+
+	This file is part of BRAHMS
+	Copyright (C) 2007 Ben Mitchinson
+	URL: http://brahms.sourceforge.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+________________________________________________________________
+
+*/
+
+////////////////	NUMBERS AS TEXT
+
+#ifndef INCLUDED_BRAHMS_NUMTEXT
+#define INCLUDED_BRAHMS_NUMTEXT
+
+/*
+ "brahms-numtext.h" converts numbers to and from the text of
+ DataML nodes; "brahms-c++-common.h" includes it, and the
+ DataMLNode read and write functions use it.
+
+ It must be included after "brahms-component.h" (or a binding, or
+ "brahms-client.h"), which supplies the basic types.
+*/
+
+/*	DOCUMENTATION: DATAML_NUMBERS
+
+	Numeric DataML is stored as text, numbers separated by
+	single spaces. A number is written in the fewest digits
+	that read back to the same value, bit for bit: 0.1, not
+	0.10000000000000000555 (nor, for SINGLE, 0.10000000149).
+	The layout follows printf's %g (at precision 17 for DOUBLE
+	and 9 for SINGLE), so that 1.5e-07 and 123456 appear as
+	they always have. Non-finite values are written Inf, -Inf
+	and NaN, and integers are written in full.
+
+	Reading is exact too: a number is rounded once, correctly,
+	to the element type it is read into. Digits are scanned
+	eight at a time. Numbers of up to 19 significant digits
+	are then converted in integer arithmetic (Eisel-Lemire,
+	its table cut down to powers of ten from 1e-64 to 1e63), or,
+	if the digits and the power of ten are both exact as
+	DOUBLE, with one floating-point operation. The rest, and
+	any that convert to exactly half-way between two SINGLEs,
+	are passed to the C library.
+
+	Writing uses the shortest-digits method of Ryu (Adams,
+	2018), done in exact integer arithmetic rather than from
+	tables: for |x| from about 1e-10 to 1e17 (DOUBLE), or 1e-18
+	to 1e9 (SINGLE), x is scaled to an integer of 18 (10) digits
+	or so, the bounds of the interval that rounds to x are
+	scaled with it, and digits are dropped until dropping
+	another would leave the interval. Values outside those
+	ranges, and subnormals, are printed by the C library at
+	increasing precision until one reads back.
+
+	Where a Precision is set on the node (or the log), it is
+	used, as printf's %.<precision>g, in place of the above.
+*/
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <limits>
+#include <string>
+
+//	digits are read eight at a time, and base64 elements are stored
+//	without swapping bytes, where the machine is little-endian
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define BRAHMS_NUMTEXT_NO_SWAR
+#define BRAHMS_NUMTEXT_SWAP_BYTES
+#endif
+
+namespace brahms
+{
+	namespace numtext
+	{
+		//	most characters written by formatNumber() for one number
+		const UINT32 MAX_NUMBER_CHARS = 32;
+
+
+
+	////////////////	TYPE TRAITS
+
+		template <class T> struct FloatTraits;
+
+		template <> struct FloatTraits<DOUBLE>
+		{
+			typedef UINT64 Bits;
+			enum
+			{
+				mantissaBits = 52,
+				exponentBits = 11,
+				exponentBias = 1023,
+				digits = 17,			//	always enough to read back
+				uniqueDigits = 15		//	never too many to read back
+			};
+		};
+
+		template <> struct FloatTraits<SINGLE>
+		{
+			typedef UINT32 Bits;
+			enum
+			{
+				mantissaBits = 23,
+				exponentBits = 8,
+				exponentBias = 127,
+				digits = 9,
+				uniqueDigits = 6
+			};
+		};
+
+		template <class T> inline bool isFinite(T x)
+		{
+			if (!std::numeric_limits<T>::has_infinity) return true;
+			return x == x && x != std::numeric_limits<T>::infinity() && x != -std::numeric_limits<T>::infinity();
+		}
+
+
+
+	////////////////	TABLES
+
+		inline const UINT64* powersOfFive()
+		{
+			//	5^0 to 5^27 (the last that fits in 64 bits)
+			static const UINT64 table[28] =
+			{
+				1ULL, 5ULL, 25ULL, 125ULL,
+				625ULL, 3125ULL, 15625ULL, 78125ULL,
+				390625ULL, 1953125ULL, 9765625ULL, 48828125ULL,
+				244140625ULL, 1220703125ULL, 6103515625ULL, 30517578125ULL,
+				152587890625ULL, 762939453125ULL, 3814697265625ULL, 19073486328125ULL,
+				95367431640625ULL, 476837158203125ULL, 2384185791015625ULL, 11920928955078125ULL,
+				59604644775390625ULL, 298023223876953125ULL, 1490116119384765625ULL, 7450580596923828125ULL
+			};
+			return table;
+		}
+
+		inline const DOUBLE* powersOfTen()
+		{
+			//	10^0 to 10^22 (the last that a DOUBLE holds exactly)
+			static const DOUBLE table[23] =
+			{
+				1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+				1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+			};
+			return table;
+		}
+
+
+
+		//	powers of five from 5^POWERS_OF_FIVE_128_FIRST, each as its leading 128 bits (hi, lo), the
+		//	negative powers rounded up (the table of Eisel-Lemire, cut down to the powers that DataML
+		//	usually needs; numbers with exponents outside it are read by the C library)
+		const INT32 POWERS_OF_FIVE_128_FIRST = -64;
+		const INT32 POWERS_OF_FIVE_128_LAST = 63;
+
+		inline const UINT64* powersOfFive128()
+		{
+			static const UINT64 table[2 * (POWERS_OF_FIVE_128_LAST - POWERS_OF_FIVE_128_FIRST + 1)] =
+			{
+				0xA87FEA27A539E9A5ULL, 0x3F2398D747B36224ULL,	//	5^-64
+				0xD29FE4B18E88640EULL, 0x8EEC7F0D19A03AADULL,	//	5^-63
+				0x83A3EEEEF9153E89ULL, 0x1953CF68300424ACULL,	//	5^-62
+				0xA48CEAAAB75A8E2BULL, 0x5FA8C3423C052DD7ULL,	//	5^-61
+				0xCDB02555653131B6ULL, 0x3792F412CB06794DULL,	//	5^-60
+				0x808E17555F3EBF11ULL, 0xE2BBD88BBEE40BD0ULL,	//	5^-59
+				0xA0B19D2AB70E6ED6ULL, 0x5B6ACEAEAE9D0EC4ULL,	//	5^-58
+				0xC8DE047564D20A8BULL, 0xF245825A5A445275ULL,	//	5^-57
+				0xFB158592BE068D2EULL, 0xEED6E2F0F0D56712ULL,	//	5^-56
+				0x9CED737BB6C4183DULL, 0x55464DD69685606BULL,	//	5^-55
+				0xC428D05AA4751E4CULL, 0xAA97E14C3C26B886ULL,	//	5^-54
+				0xF53304714D9265DFULL, 0xD53DD99F4B3066A8ULL,	//	5^-53
+				0x993FE2C6D07B7FABULL, 0xE546A8038EFE4029ULL,	//	5^-52
+				0xBF8FDB78849A5F96ULL, 0xDE98520472BDD033ULL,	//	5^-51
+				0xEF73D256A5C0F77CULL, 0x963E66858F6D4440ULL,	//	5^-50
+				0x95A8637627989AADULL, 0xDDE7001379A44AA8ULL,	//	5^-49
+				0xBB127C53B17EC159ULL, 0x5560C018580D5D52ULL,	//	5^-48
+				0xE9D71B689DDE71AFULL, 0xAAB8F01E6E10B4A6ULL,	//	5^-47
+				0x9226712162AB070DULL, 0xCAB3961304CA70E8ULL,	//	5^-46
+				0xB6B00D69BB55C8D1ULL, 0x3D607B97C5FD0D22ULL,	//	5^-45
+				0xE45C10C42A2B3B05ULL, 0x8CB89A7DB77C506AULL,	//	5^-44
+				0x8EB98A7A9A5B04E3ULL, 0x77F3608E92ADB242ULL,	//	5^-43
+				0xB267ED1940F1C61CULL, 0x55F038B237591ED3ULL,	//	5^-42
+				0xDF01E85F912E37A3ULL, 0x6B6C46DEC52F6688ULL,	//	5^-41
+				0x8B61313BBABCE2C6ULL, 0x2323AC4B3B3DA015ULL,	//	5^-40
+				0xAE397D8AA96C1B77ULL, 0xABEC975E0A0D081AULL,	//	5^-39
+				0xD9C7DCED53C72255ULL, 0x96E7BD358C904A21ULL,	//	5^-38
+				0x881CEA14545C7575ULL, 0x7E50D64177DA2E54ULL,	//	5^-37
+				0xAA242499697392D2ULL, 0xDDE50BD1D5D0B9E9ULL,	//	5^-36
+				0xD4AD2DBFC3D07787ULL, 0x955E4EC64B44E864ULL,	//	5^-35
+				0x84EC3C97DA624AB4ULL, 0xBD5AF13BEF0B113EULL,	//	5^-34
+				0xA6274BBDD0FADD61ULL, 0xECB1AD8AEACDD58EULL,	//	5^-33
+				0xCFB11EAD453994BAULL, 0x67DE18EDA5814AF2ULL,	//	5^-32
+				0x81CEB32C4B43FCF4ULL, 0x80EACF948770CED7ULL,	//	5^-31
+				0xA2425FF75E14FC31ULL, 0xA1258379A94D028DULL,	//	5^-30
+				0xCAD2F7F5359A3B3EULL, 0x096EE45813A04330ULL,	//	5^-29
+				0xFD87B5F28300CA0DULL, 0x8BCA9D6E188853FCULL,	//	5^-28
+				0x9E74D1B791E07E48ULL, 0x775EA264CF55347EULL,	//	5^-27
+				0xC612062576589DDAULL, 0x95364AFE032A819EULL,	//	5^-26
+				0xF79687AED3EEC551ULL, 0x3A83DDBD83F52205ULL,	//	5^-25
+				0x9ABE14CD44753B52ULL, 0xC4926A9672793543ULL,	//	5^-24
+				0xC16D9A0095928A27ULL, 0x75B7053C0F178294ULL,	//	5^-23
+				0xF1C90080BAF72CB1ULL, 0x5324C68B12DD6339ULL,	//	5^-22
+				0x971DA05074DA7BEEULL, 0xD3F6FC16EBCA5E04ULL,	//	5^-21
+				0xBCE5086492111AEAULL, 0x88F4BB1CA6BCF585ULL,	//	5^-20
+				0xEC1E4A7DB69561A5ULL, 0x2B31E9E3D06C32E6ULL,	//	5^-19
+				0x9392EE8E921D5D07ULL, 0x3AFF322E62439FD0ULL,	//	5^-18
+				0xB877AA3236A4B449ULL, 0x09BEFEB9FAD487C3ULL,	//	5^-17
+				0xE69594BEC44DE15BULL, 0x4C2EBE687989A9B4ULL,	//	5^-16
+				0x901D7CF73AB0ACD9ULL, 0x0F9D37014BF60A11ULL,	//	5^-15
+				0xB424DC35095CD80FULL, 0x538484C19EF38C95ULL,	//	5^-14
+				0xE12E13424BB40E13ULL, 0x2865A5F206B06FBAULL,	//	5^-13
+				0x8CBCCC096F5088CBULL, 0xF93F87B7442E45D4ULL,	//	5^-12
+				0xAFEBFF0BCB24AAFEULL, 0xF78F69A51539D749ULL,	//	5^-11
+				0xDBE6FECEBDEDD5BEULL, 0xB573440E5A884D1CULL,	//	5^-10
+				0x89705F4136B4A597ULL, 0x31680A88F8953031ULL,	//	5^-9
+				0xABCC77118461CEFCULL, 0xFDC20D2B36BA7C3EULL,	//	5^-8
+				0xD6BF94D5E57A42BCULL, 0x3D32907604691B4DULL,	//	5^-7
+				0x8637BD05AF6C69B5ULL, 0xA63F9A49C2C1B110ULL,	//	5^-6
+				0xA7C5AC471B478423ULL, 0x0FCF80DC33721D54ULL,	//	5^-5
+				0xD1B71758E219652BULL, 0xD3C36113404EA4A9ULL,	//	5^-4
+				0x83126E978D4FDF3BULL, 0x645A1CAC083126EAULL,	//	5^-3
+				0xA3D70A3D70A3D70AULL, 0x3D70A3D70A3D70A4ULL,	//	5^-2
+				0xCCCCCCCCCCCCCCCCULL, 0xCCCCCCCCCCCCCCCDULL,	//	5^-1
+				0x8000000000000000ULL, 0x0000000000000000ULL,	//	5^0
+				0xA000000000000000ULL, 0x0000000000000000ULL,	//	5^1
+				0xC800000000000000ULL, 0x0000000000000000ULL,	//	5^2
+				0xFA00000000000000ULL, 0x0000000000000000ULL,	//	5^3
+				0x9C40000000000000ULL, 0x0000000000000000ULL,	//	5^4
+				0xC350000000000000ULL, 0x0000000000000000ULL,	//	5^5
+				0xF424000000000000ULL, 0x0000000000000000ULL,	//	5^6
+				0x9896800000000000ULL, 0x0000000000000000ULL,	//	5^7
+				0xBEBC200000000000ULL, 0x0000000000000000ULL,	//	5^8
+				0xEE6B280000000000ULL, 0x0000000000000000ULL,	//	5^9
+				0x9502F90000000000ULL, 0x0000000000000000ULL,	//	5^10
+				0xBA43B74000000000ULL, 0x0000000000000000ULL,	//	5^11
+				0xE8D4A51000000000ULL, 0x0000000000000000ULL,	//	5^12
+				0x9184E72A00000000ULL, 0x0000000000000000ULL,	//	5^13
+				0xB5E620F480000000ULL, 0x0000000000000000ULL,	//	5^14
+				0xE35FA931A0000000ULL, 0x0000000000000000ULL,	//	5^15
+				0x8E1BC9BF04000000ULL, 0x0000000000000000ULL,	//	5^16
+				0xB1A2BC2EC5000000ULL, 0x0000000000000000ULL,	//	5^17
+				0xDE0B6B3A76400000ULL, 0x0000000000000000ULL,	//	5^18
+				0x8AC7230489E80000ULL, 0x0000000000000000ULL,	//	5^19
+				0xAD78EBC5AC620000ULL, 0x0000000000000000ULL,	//	5^20
+				0xD8D726B7177A8000ULL, 0x0000000000000000ULL,	//	5^21
+				0x878678326EAC9000ULL, 0x0000000000000000ULL,	//	5^22
+				0xA968163F0A57B400ULL, 0x0000000000000000ULL,	//	5^23
+				0xD3C21BCECCEDA100ULL, 0x0000000000000000ULL,	//	5^24
+				0x84595161401484A0ULL, 0x0000000000000000ULL,	//	5^25
+				0xA56FA5B99019A5C8ULL, 0x0000000000000000ULL,	//	5^26
+				0xCECB8F27F4200F3AULL, 0x0000000000000000ULL,	//	5^27
+				0x813F3978F8940984ULL, 0x4000000000000000ULL,	//	5^28
+				0xA18F07D736B90BE5ULL, 0x5000000000000000ULL,	//	5^29
+				0xC9F2C9CD04674EDEULL, 0xA400000000000000ULL,	//	5^30
+				0xFC6F7C4045812296ULL, 0x4D00000000000000ULL,	//	5^31
+				0x9DC5ADA82B70B59DULL, 0xF020000000000000ULL,	//	5^32
+				0xC5371912364CE305ULL, 0x6C28000000000000ULL,	//	5^33
+				0xF684DF56C3E01BC6ULL, 0xC732000000000000ULL,	//	5^34
+				0x9A130B963A6C115CULL, 0x3C7F400000000000ULL,	//	5^35
+				0xC097CE7BC90715B3ULL, 0x4B9F100000000000ULL,	//	5^36
+				0xF0BDC21ABB48DB20ULL, 0x1E86D40000000000ULL,	//	5^37
+				0x96769950B50D88F4ULL, 0x1314448000000000ULL,	//	5^38
+				0xBC143FA4E250EB31ULL, 0x17D955A000000000ULL,	//	5^39
+				0xEB194F8E1AE525FDULL, 0x5DCFAB0800000000ULL,	//	5^40
+				0x92EFD1B8D0CF37BEULL, 0x5AA1CAE500000000ULL,	//	5^41
+				0xB7ABC627050305ADULL, 0xF14A3D9E40000000ULL,	//	5^42
+				0xE596B7B0C643C719ULL, 0x6D9CCD05D0000000ULL,	//	5^43
+				0x8F7E32CE7BEA5C6FULL, 0xE4820023A2000000ULL,	//	5^44
+				0xB35DBF821AE4F38BULL, 0xDDA2802C8A800000ULL,	//	5^45
+				0xE0352F62A19E306EULL, 0xD50B2037AD200000ULL,	//	5^46
+				0x8C213D9DA502DE45ULL, 0x4526F422CC340000ULL,	//	5^47
+				0xAF298D050E4395D6ULL, 0x9670B12B7F410000ULL,	//	5^48
+				0xDAF3F04651D47B4CULL, 0x3C0CDD765F114000ULL,	//	5^49
+				0x88D8762BF324CD0FULL, 0xA5880A69FB6AC800ULL,	//	5^50
+				0xAB0E93B6EFEE0053ULL, 0x8EEA0D047A457A00ULL,	//	5^51
+				0xD5D238A4ABE98068ULL, 0x72A4904598D6D880ULL,	//	5^52
+				0x85A36366EB71F041ULL, 0x47A6DA2B7F864750ULL,	//	5^53
+				0xA70C3C40A64E6C51ULL, 0x999090B65F67D924ULL,	//	5^54
+				0xD0CF4B50CFE20765ULL, 0xFFF4B4E3F741CF6DULL,	//	5^55
+				0x82818F1281ED449FULL, 0xBFF8F10E7A8921A4ULL,	//	5^56
+				0xA321F2D7226895C7ULL, 0xAFF72D52192B6A0DULL,	//	5^57
+				0xCBEA6F8CEB02BB39ULL, 0x9BF4F8A69F764490ULL,	//	5^58
+				0xFEE50B7025C36A08ULL, 0x02F236D04753D5B4ULL,	//	5^59
+				0x9F4F2726179A2245ULL, 0x01D762422C946590ULL,	//	5^60
+				0xC722F0EF9D80AAD6ULL, 0x424D3AD2B7B97EF5ULL,	//	5^61
+				0xF8EBAD2B84E0D58BULL, 0xD2E0898765A7DEB2ULL,	//	5^62
+				0x9B934C3B330C8577ULL, 0x63CC55F49F88EB2FULL,	//	5^63
+			};
+			return table;
+		}
+
+
+
+	////////////////	ARITHMETIC
+
+		//	128-bit product of two 64-bit numbers
+		inline void multiply128(UINT64 a, UINT64 b, UINT64& hi, UINT64& lo)
+		{
+#ifdef __SIZEOF_INT128__
+			__extension__ typedef unsigned __int128 UINT128;
+			UINT128 r = (UINT128)a * b;
+			hi = (UINT64)(r >> 64);
+			lo = (UINT64)r;
+#else
+			//	in 32-bit pieces
+			UINT64 a0 = a & 0xFFFFFFFF, a1 = a >> 32;
+			UINT64 b0 = b & 0xFFFFFFFF, b1 = b >> 32;
+			UINT64 p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+			UINT64 mid = (p00 >> 32) + (p01 & 0xFFFFFFFF) + (p10 & 0xFFFFFFFF);
+			lo = (mid << 32) | (p00 & 0xFFFFFFFF);
+			hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+#endif
+		}
+
+		inline UINT32 leadingZeros(UINT64 x)
+		{
+#ifdef __GNUC__
+			return __builtin_clzll(x);
+#else
+			UINT32 n = 0;
+			while (!(x & 0x8000000000000000ULL))
+			{
+				x <<= 1;
+				n++;
+			}
+			return n;
+#endif
+		}
+
+
+
+	////////////////	FORMAT
+
+		//	floor(m * 5^k * 2^t) into "out" (false if it won't fit), and whether that was exact
+		inline bool scaleExact(UINT64 m, INT32 k, INT32 t, UINT64& out, bool& exact)
+		{
+			UINT64 hi, lo;
+			multiply128(m, powersOfFive()[k], hi, lo);
+
+			if (t >= 0)
+			{
+				if (hi || t >= 64 || (t && (lo >> (64 - t)))) return false;
+				out = lo << t;
+				exact = true;
+				return true;
+			}
+
+			UINT32 s = -t;
+			if (s >= 128) return false;
+			if (s >= 64)
+			{
+				UINT32 r = s - 64;
+				out = hi >> r;
+				exact = !lo && !(r && (hi << (64 - r)));
+				return true;
+			}
+
+			if (hi >> s) return false;
+			out = (lo >> s) | (hi << (64 - s));
+			exact = !(lo << (64 - s));
+			return true;
+		}
+
+		//	decimal digits of "v", written so as to end at "end", two at a time; returns how many
+		inline INT32 formatDigits(char* end, UINT64 v)
+		{
+			static const char pairs[201] =
+				"0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+				"5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+			char* p = end;
+			while (v >= 100)
+			{
+				UINT32 pair = (UINT32)(v % 100);
+				v /= 100;
+				p -= 2;
+				p[0] = pairs[2 * pair];
+				p[1] = pairs[2 * pair + 1];
+			}
+			if (v >= 10)
+			{
+				p -= 2;
+				p[0] = pairs[2 * v];
+				p[1] = pairs[2 * v + 1];
+			}
+			else *--p = (char)('0' + v);
+			return (INT32)(end - p);
+		}
+
+		//	write "digits" x 10^"exponent" as printf's %g would at precision "precision"
+		inline char* formatDecimal(char* p, bool negative, UINT64 digits, INT32 exponent, INT32 precision)
+		{
+			char text[20];
+			INT32 n = formatDigits(text + 20, digits);
+			const char* d = text + 20 - n;
+
+			//	exponent of first digit
+			INT32 e = exponent + n - 1;
+
+			if (negative) *p++ = '-';
+
+			//	scientific
+			if (e < -4 || e >= precision)
+			{
+				*p++ = d[0];
+				if (n > 1)
+				{
+					*p++ = '.';
+					memcpy(p, d + 1, n - 1);
+					p += n - 1;
+				}
+				*p++ = 'e';
+				*p++ = e < 0 ? '-' : '+';
+				if (e < 0) e = -e;
+				if (e >= 100) *p++ = (char)('0' + e / 100);
+				*p++ = (char)('0' + (e / 10) % 10);
+				*p++ = (char)('0' + e % 10);
+				return p;
+			}
+
+			//	fixed, all digits before the point
+			if (e >= n - 1)
+			{
+				memcpy(p, d, n);
+				p += n;
+				for (INT32 i=n-1; i<e; i++) *p++ = '0';
+				return p;
+			}
+
+			//	fixed, some digits before the point
+			if (e >= 0)
+			{
+				memcpy(p, d, e + 1);
+				p += e + 1;
+				*p++ = '.';
+				memcpy(p, d + e + 1, n - e - 1);
+				return p + n - e - 1;
+			}
+
+			//	fixed, no digits before the point
+			*p++ = '0';
+			*p++ = '.';
+			for (INT32 i=-1; i>e; i--) *p++ = '0';
+			memcpy(p, d, n);
+			return p + n;
+		}
+
+		inline bool readsBackAs(const char* text, DOUBLE x)
+		{
+			return strtod(text, NULL) == x;
+		}
+
+		inline bool readsBackAs(const char* text, SINGLE x)
+		{
+			return strtof(text, NULL) == x;
+		}
+
+		//	shortest digits by asking printf for more until they read back (subnormals
+		//	have fewer bits, so any number of digits might be the first to do so)
+		template <class T> char* formatFloatSlow(char* p, T x, bool subnormal)
+		{
+			char text[64];
+			for (INT32 precision=subnormal ? 1 : FloatTraits<T>::uniqueDigits; ; precision++)
+			{
+#ifdef _MSC_VER
+				sprintf_s(text, sizeof(text), "%.*e", precision - 1, (DOUBLE)x);
+#else
+				sprintf(text, "%.*e", precision - 1, (DOUBLE)x);
+#endif
+				if (precision < FloatTraits<T>::digits && !readsBackAs(text, x)) continue;
+
+				//	collect digits and exponent from "[-]d.ddde[+-]dd"
+				const char* t = text;
+				bool negative = *t == '-';
+				if (negative) t++;
+				UINT64 digits = 0;
+				INT32 n = 0;
+				for (; *t != 'e'; t++)
+				{
+					if (*t == '.') continue;
+					digits = digits * 10 + (*t - '0');
+					n++;
+				}
+				INT32 exponent = atoi(t + 1) - (n - 1);
+				while (digits && !(digits % 10))
+				{
+					digits /= 10;
+					exponent++;
+				}
+
+				return formatDecimal(p, negative, digits, exponent, FloatTraits<T>::digits);
+			}
+		}
+
+		template <class T> char* formatFloat(char* p, T x)
+		{
+			typedef FloatTraits<T> Traits;
+			typedef typename Traits::Bits Bits;
+
+			//	pick apart
+			Bits bits;
+			memcpy(&bits, &x, sizeof(x));
+			const UINT32 exponentMask = (1 << Traits::exponentBits) - 1;
+			bool negative = (bits >> (sizeof(Bits) * 8 - 1)) != 0;
+			UINT32 ieeeExponent = (UINT32)((bits >> Traits::mantissaBits) & exponentMask);
+			UINT64 ieeeMantissa = bits & (((Bits)1 << Traits::mantissaBits) - 1);
+
+			//	special values
+			if (ieeeExponent == exponentMask)
+			{
+				const char* s = ieeeMantissa ? "NaN" : (negative ? "-Inf" : "Inf");
+				while (*s) *p++ = *s++;
+				return p;
+			}
+			if (!ieeeExponent && !ieeeMantissa)
+			{
+				if (negative) *p++ = '-';
+				*p++ = '0';
+				return p;
+			}
+			if (!ieeeExponent) return formatFloatSlow(p, x, true);
+
+			//	scale so that x becomes an integer of "digits" digits or one more (floor(log10(x)) is
+			//	floor(log10(2^binaryExponent)) or one more), as long as 10^k is in the table (if it
+			//	isn't, do it the slow way)
+			INT32 binaryExponent = (INT32)ieeeExponent - Traits::exponentBias;
+			INT32 e10 = binaryExponent >= 0 ? (binaryExponent * 78913) >> 18 : -((-binaryExponent * 78913 + 262143) >> 18);
+			INT32 k = Traits::digits - e10;
+			if (k < 0 || k > 27) return formatFloatSlow(p, x, false);
+
+			//	x, and the bounds of the interval that rounds to it, in units of 2^e2
+			INT32 e2 = binaryExponent - Traits::mantissaBits - 2;
+			UINT64 m2 = ieeeMantissa | ((UINT64)1 << Traits::mantissaBits);
+			UINT64 mv = 4 * m2;
+			UINT64 mp = mv + 2;
+			UINT64 mm = mv - 1 - (ieeeMantissa || ieeeExponent <= 1 ? 1 : 0);
+			bool acceptBounds = !(m2 & 1);
+
+			//	all three, scaled, and whether the scaling was exact
+			UINT64 vr, vp, vm;
+			bool vrExact, vpExact, vmExact;
+			if (!scaleExact(mv, k, e2 + k, vr, vrExact)
+				|| !scaleExact(mp, k, e2 + k, vp, vpExact)
+				|| !scaleExact(mm, k, e2 + k, vm, vmExact))
+				return formatFloatSlow(p, x, false);
+
+			//	bounds are in the interval only if the mantissa is even (round-half-even reads back to it)
+			bool vmIsTrailingZeros = acceptBounds && vmExact;
+			bool vrIsTrailingZeros = vrExact;
+			if (!acceptBounds && vpExact) vp--;
+
+			//	drop digits while that leaves a number within the interval
+			INT32 removed = 0;
+			UINT64 output;
+			if (!vmIsTrailingZeros && !vrIsTrailingZeros)
+			{
+				//	usual case, no ties to worry about, so two at a time where we can
+				bool roundUp = false;
+				while (vp / 100 > vm / 100)
+				{
+					roundUp = vr % 100 >= 50;
+					vr /= 100;
+					vp /= 100;
+					vm /= 100;
+					removed += 2;
+				}
+				if (vp / 10 > vm / 10)
+				{
+					roundUp = vr % 10 >= 5;
+					vr /= 10;
+					vp /= 10;
+					vm /= 10;
+					removed++;
+				}
+				output = vr + ((vr == vm || roundUp) ? 1 : 0);
+			}
+			else
+			{
+				UINT32 lastRemovedDigit = 0;
+				while (vp / 10 > vm / 10)
+				{
+					vmIsTrailingZeros &= !(vm % 10);
+					vrIsTrailingZeros &= !lastRemovedDigit;
+					lastRemovedDigit = (UINT32)(vr % 10);
+					vr /= 10;
+					vp /= 10;
+					vm /= 10;
+					removed++;
+				}
+				if (vmIsTrailingZeros)
+				{
+					while (!(vm % 10))
+					{
+						vrIsTrailingZeros &= !lastRemovedDigit;
+						lastRemovedDigit = (UINT32)(vr % 10);
+						vr /= 10;
+						vp /= 10;
+						vm /= 10;
+						removed++;
+					}
+				}
+
+				//	round what's left to nearest (half to even), staying inside the interval
+				if (vrIsTrailingZeros && lastRemovedDigit == 5 && !(vr % 2)) lastRemovedDigit = 4;
+				output = vr + (((vr == vm && !vmIsTrailingZeros) || lastRemovedDigit >= 5) ? 1 : 0);
+			}
+
+			return formatDecimal(p, negative, output, removed - k, Traits::digits);
+		}
+
+		template <class T> char* formatInteger(char* p, T x)
+		{
+			//	magnitude (the cast avoids comparing an unsigned with zero)
+			bool negative = std::numeric_limits<T>::is_signed && (INT64)x < 0;
+			UINT64 v = negative ? 0 - (UINT64)(INT64)x : (UINT64)x;
+
+			char text[20];
+			INT32 n = formatDigits(text + 20, v);
+
+			if (negative) *p++ = '-';
+			memcpy(p, text + 20 - n, n);
+			return p + n;
+		}
+
+		//	write x at "p" (no terminator), returning the end of what was written
+		inline char* formatNumber(char* p, DOUBLE x)
+		{
+			return formatFloat(p, x);
+		}
+
+		inline char* formatNumber(char* p, SINGLE x)
+		{
+			return formatFloat(p, x);
+		}
+
+		template <class T> char* formatNumber(char* p, T x)
+		{
+			return formatInteger(p, x);
+		}
+
+
+
+	////////////////	PARSE
+
+		enum DecimalKind
+		{
+			DECIMAL_FINITE,
+			DECIMAL_INF,
+			DECIMAL_NAN
+		};
+
+		//	a number as scanned from text, mantissa x 10^exponent
+		struct Decimal
+		{
+			const char* text;		//	where it started
+			bool negative;
+			DecimalKind kind;
+			UINT64 mantissa;		//	significant digits
+			INT32 exponent;
+			bool inexact;			//	non-zero digits were dropped because "mantissa" was full
+		};
+
+		inline bool isDigit(char c)
+		{
+			return (unsigned char)(c - '0') < 10;
+		}
+
+		//	eight digits at "p" (SWAR: all eight are tested, then converted, in a few 64-bit operations)
+		inline bool isEightDigits(const char* p)
+		{
+			UINT64 v;
+			memcpy(&v, p, 8);
+			return !(((v & 0xF0F0F0F0F0F0F0F0ULL) | (((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ^ 0x3333333333333333ULL);
+		}
+
+		inline UINT32 eightDigits(const char* p)
+		{
+			UINT64 v;
+			memcpy(&v, p, 8);
+			v -= 0x3030303030303030ULL;
+			v = v * 10 + (v >> 8);
+			v = (((v & 0x000000FF000000FFULL) * 0x000F424000000064ULL) + (((v >> 16) & 0x000000FF000000FFULL) * 0x0000271000000001ULL)) >> 32;
+			return (UINT32) v;
+		}
+
+		//	accumulate the digits at "p" into "mantissa", leaving "p" after them ("end" is the end of the text)
+		inline void scanDigits(const char*& p, const char* end, UINT64& mantissa)
+		{
+#ifndef BRAHMS_NUMTEXT_NO_SWAR
+			while (end - p >= 8 && isEightDigits(p))
+			{
+				mantissa = mantissa * 100000000 + eightDigits(p);
+				p += 8;
+			}
+#endif
+			while (isDigit(*p)) mantissa = mantissa * 10 + (*p++ - '0');
+		}
+
+		//	integer and fraction at "p", as many significant digits as "mantissa" holds, and the
+		//	rest only scaling it (and making it inexact, if they aren't zeros)
+		inline void scanDigitsCarefully(const char* p, Decimal& d)
+		{
+			const UINT64 TENTH_MAX = 1844674407370955161ULL;
+			d.mantissa = 0;
+			d.exponent = 0;
+
+			while (isDigit(*p))
+			{
+				UINT32 digit = *p++ - '0';
+				if (d.mantissa < TENTH_MAX || (d.mantissa == TENTH_MAX && digit <= 5))
+					d.mantissa = d.mantissa * 10 + digit;
+				else
+				{
+					d.exponent++;
+					if (digit) d.inexact = true;
+				}
+			}
+
+			if (*p == '.')
+			{
+				p++;
+				while (isDigit(*p))
+				{
+					UINT32 digit = *p++ - '0';
+					if (d.mantissa < TENTH_MAX || (d.mantissa == TENTH_MAX && digit <= 5))
+					{
+						d.mantissa = d.mantissa * 10 + digit;
+						d.exponent--;
+					}
+					else if (digit) d.inexact = true;
+				}
+			}
+		}
+
+		//	scan a number at "p", leaving "p" just after it ("end" is the end of the text, where there
+		//	must be a NULL); returns NULL, or the part of the number that was malformed
+		inline const char* scanDecimal(const char*& p, const char* end, Decimal& d)
+		{
+			d.text = p;
+			d.negative = false;
+			d.kind = DECIMAL_FINITE;
+			d.mantissa = 0;
+			d.exponent = 0;
+			d.inexact = false;
+
+			//	sign
+			if (*p == '-')
+			{
+				d.negative = true;
+				p++;
+			}
+			else if (*p == '+') p++;
+
+			//	Inf
+			if (*p == 'I')
+			{
+				if (p[1] != 'n' || p[2] != 'f') return "Inf";
+				p += 3;
+				d.kind = DECIMAL_INF;
+				return NULL;
+			}
+
+			//	NaN
+			if (*p == 'N')
+			{
+				if (p[1] != 'a' || p[2] != 'N') return "NaN";
+				p += 3;
+				d.kind = DECIMAL_NAN;
+				return NULL;
+			}
+
+			//	integer and fraction, accumulated without a care for overflow
+			const char* digits = p;
+			UINT64 mantissa = 0;
+			scanDigits(p, end, mantissa);
+			INT32 fractionDigits = 0;
+			if (*p == '.')
+			{
+				p++;
+				if (!isDigit(*p)) return "fraction";
+				const char* fraction = p;
+				scanDigits(p, end, mantissa);
+				fractionDigits = (INT32)(p - fraction);
+			}
+			d.mantissa = mantissa;
+			d.exponent = -fractionDigits;
+
+			//	which is fine for up to 19 significant digits (leading zeros aren't); if
+			//	there were more, go over them again, with a care
+			if (p - digits > 19)
+			{
+				const char* q = digits;
+				while (*q == '0' || *q == '.') q++;
+				INT32 significant = (INT32)(p - q);
+				if (fractionDigits && q < p - fractionDigits) significant--;
+				if (significant > 19) scanDigitsCarefully(digits, d);
+			}
+
+			//	exponent (saturating, well beyond anything that isn't zero or Inf anyway)
+			if (*p == 'E' || *p == 'e')
+			{
+				p++;
+				bool negative = false;
+				if (*p == '-')
+				{
+					negative = true;
+					p++;
+				}
+				else if (*p == '+') p++;
+
+				if (!isDigit(*p)) return "exponent";
+				INT32 e = 0;
+				while (isDigit(*p))
+				{
+					if (e < 100000) e = e * 10 + (*p - '0');
+					p++;
+				}
+				d.exponent += negative ? -e : e;
+			}
+
+			return NULL;
+		}
+
+		//	mantissa x 10^exponent, rounded correctly, by Eisel-Lemire (false if it can't be sure)
+		inline bool decimalToDoubleEiselLemire(UINT64 mantissa, INT32 exponent, bool negative, DOUBLE& x)
+		{
+			if (exponent < POWERS_OF_FIVE_128_FIRST || exponent > POWERS_OF_FIVE_128_LAST) return false;
+			const UINT64* power = powersOfFive128() + 2 * (exponent - POWERS_OF_FIVE_128_FIRST);
+
+			//	normalise mantissa, and multiply by the leading 64 bits of 5^exponent, or all 128 if
+			//	the bits below those that make the result (55 of them) might carry into them
+			UINT32 lz = leadingZeros(mantissa);
+			mantissa <<= lz;
+			UINT64 hi, lo;
+			multiply128(mantissa, power[0], hi, lo);
+			if ((hi & 0x1FF) == 0x1FF)
+			{
+				UINT64 hi2, lo2;
+				multiply128(mantissa, power[1], hi2, lo2);
+				lo += hi2;
+				if (hi2 > lo) hi++;
+				if (lo == 0xFFFFFFFFFFFFFFFFULL && (exponent < -27 || exponent > 55)) return false;
+			}
+
+			//	54 bits, one more than we keep, for rounding
+			UINT32 upperBit = (UINT32)(hi >> 63);
+			UINT32 shift = upperBit + 9;
+			UINT64 m = hi >> shift;
+			INT32 power2 = (((152170 + 65536) * exponent) >> 16) + 63 + upperBit - lz + 1023;
+
+			//	subnormal, or Inf, is for the C library
+			if (power2 <= 0 || power2 >= 0x7FF) return false;
+
+			//	round half up, except half-way exactly, which rounds to even
+			if (lo <= 1 && exponent >= -4 && exponent <= 23 && (m & 3) == 1 && (m << shift) == hi) m &= ~(UINT64)1;
+			m += m & 1;
+			m >>= 1;
+			if (m >= ((UINT64)2 << 52))
+			{
+				m = (UINT64)1 << 52;
+				power2++;
+				if (power2 >= 0x7FF) return false;
+			}
+
+			UINT64 bits = (m & (((UINT64)1 << 52) - 1)) | ((UINT64)power2 << 52) | ((UINT64)(negative ? 1 : 0) << 63);
+			memcpy(&x, &bits, sizeof(x));
+			return true;
+		}
+
+		//	mantissa x 10^exponent as DOUBLE, rounded correctly, without the C library (false if not)
+		inline bool decimalToDoubleFast(const Decimal& d, DOUBLE& x)
+		{
+			if (d.inexact) return false;
+
+			//	mantissa and power of ten both exact as DOUBLE, so one correctly rounded operation does it
+			const UINT64 MAX_EXACT = (UINT64)1 << 53;
+			if (d.mantissa <= MAX_EXACT)
+			{
+				//	if the power is too large, move some of it into the mantissa, if there's room
+				UINT64 mantissa = d.mantissa;
+				INT32 exponent = d.exponent;
+				while (exponent > 22 && mantissa <= MAX_EXACT / 10)
+				{
+					mantissa *= 10;
+					exponent--;
+				}
+
+				if (exponent >= -22 && exponent <= 22)
+				{
+					x = (DOUBLE) mantissa;
+					if (exponent < 0) x /= powersOfTen()[-exponent];
+					else x *= powersOfTen()[exponent];
+					if (d.negative) x = -x;
+					return true;
+				}
+			}
+
+			//	otherwise, in integer arithmetic
+			return decimalToDoubleEiselLemire(d.mantissa, d.exponent, d.negative, x);
+		}
+
+		inline void decimalToNumber(const Decimal& d, DOUBLE& x)
+		{
+			if (d.kind == DECIMAL_INF)
+				x = d.negative ? -std::numeric_limits<DOUBLE>::infinity() : std::numeric_limits<DOUBLE>::infinity();
+			else if (d.kind == DECIMAL_NAN)
+				x = d.negative ? -std::numeric_limits<DOUBLE>::quiet_NaN() : std::numeric_limits<DOUBLE>::quiet_NaN();
+			else if (!d.mantissa)
+				x = d.negative ? -0.0 : 0.0;
+			else if (!decimalToDoubleFast(d, x))
+				x = strtod(d.text, NULL);
+		}
+
+		inline void decimalToNumber(const Decimal& d, SINGLE& x)
+		{
+			//	Inf, NaN and zero carry over
+			if (d.kind != DECIMAL_FINITE || !d.mantissa)
+			{
+				DOUBLE y;
+				decimalToNumber(d, y);
+				x = (SINGLE) y;
+				return;
+			}
+
+			//	rounding to DOUBLE and then to SINGLE gives the same as rounding straight
+			//	to SINGLE, unless the first rounding landed exactly half-way between two
+			DOUBLE y;
+			if (decimalToDoubleFast(d, y))
+			{
+				UINT64 bits;
+				memcpy(&bits, &y, sizeof(y));
+				DOUBLE a = std::fabs(y);
+				if ((bits & 0x1FFFFFFF) != 0x10000000
+					&& a >= std::numeric_limits<SINGLE>::min() && a <= std::numeric_limits<SINGLE>::max())
+				{
+					x = (SINGLE) y;
+					return;
+				}
+			}
+
+			x = strtof(d.text, NULL);
+		}
+
+		template <class T> void decimalToNumber(const Decimal& d, T& x)
+		{
+			//	integers have no Inf or NaN
+			if (d.kind != DECIMAL_FINITE)
+			{
+				x = 0;
+				return;
+			}
+
+			//	plain integer, exactly (all 64 bits of it)
+			if (!d.inexact && !d.exponent)
+			{
+				x = d.negative ? (T)(0 - d.mantissa) : (T)d.mantissa;
+				return;
+			}
+
+			//	anything else via DOUBLE (so truncated toward zero)
+			DOUBLE y;
+			decimalToNumber(d, y);
+			x = (T) y;
+		}
+
+
+	////////////////	BASE64
+
+		//	base64 (RFC 4648) text of the bytes of numeric elements, stored
+		//	little-endian whatever the machine (see DATAML_BINARY)
+
+		inline const char* base64Alphabet()
+		{
+			return "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		}
+
+		//	value of each character (64, if it is not in the alphabet)
+		inline const UINT8* base64Values()
+		{
+			static const UINT8 table[256] =
+			{
+				64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+				64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+				64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 62, 64, 64, 64, 63,
+				52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 64, 64, 64, 64, 64, 64,
+				64, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+				15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 64, 64, 64, 64, 64,
+				64, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+				41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 64, 64, 64, 64, 64,
+				64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+				64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+				64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+				64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+				64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+				64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+				64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+				64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+			};
+			return table;
+		}
+
+		inline bool isSpace(char c)
+		{
+			return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+		}
+
+		//	reverse the bytes of each element
+		inline void swapElements(UINT8* p, UINT64 bytes, UINT32 elementBytes)
+		{
+			for (UINT64 e=0; e+elementBytes<=bytes; e+=elementBytes)
+			{
+				for (UINT32 i=0; i<elementBytes/2; i++)
+				{
+					UINT8 t = p[e+i];
+					p[e+i] = p[e+elementBytes-1-i];
+					p[e+elementBytes-1-i] = t;
+				}
+			}
+		}
+
+		class Base64Writer
+		{
+
+		public:
+
+			Base64Writer(std::string& p_out) : out(p_out)
+			{
+				pending = 0;
+			}
+
+			//	append "bytes" of elements of "elementBytes" each (successive
+			//	calls run on as one stream, as if their data were contiguous)
+			void write(const UINT8* data, UINT64 bytes, UINT32 elementBytes)
+			{
+#ifdef BRAHMS_NUMTEXT_SWAP_BYTES
+				if (elementBytes > 1)
+				{
+					//	through a buffer that holds whole elements of any width (and,
+					//	being a multiple of 3 bytes, ends each pass on a whole group)
+					UINT8 swapped[3072];
+					while (bytes)
+					{
+						UINT32 n = bytes < sizeof(swapped) ? (UINT32)bytes : (UINT32)sizeof(swapped);
+						memcpy(swapped, data, n);
+						swapElements(swapped, n, elementBytes);
+						writeBytes(swapped, n);
+						data += n;
+						bytes -= n;
+					}
+					return;
+				}
+#else
+				(void)elementBytes;
+#endif
+				writeBytes(data, bytes);
+			}
+
+			//	write out the last group, padded
+			void finish()
+			{
+				const char* alphabet = base64Alphabet();
+				if (!pending) return;
+
+				UINT32 v = held[0] << 16;
+				if (pending == 2) v |= held[1] << 8;
+				char group[4];
+				group[0] = alphabet[(v >> 18) & 0x3F];
+				group[1] = alphabet[(v >> 12) & 0x3F];
+				group[2] = pending == 2 ? alphabet[(v >> 6) & 0x3F] : '=';
+				group[3] = '=';
+				out.append(group, 4);
+				pending = 0;
+			}
+
+		private:
+
+			void writeBytes(const UINT8* data, UINT64 bytes)
+			{
+				const char* alphabet = base64Alphabet();
+
+				//	complete a group held over from the last call
+				while (pending && pending < 3 && bytes)
+				{
+					held[pending++] = *data++;
+					bytes--;
+				}
+				if (pending == 3)
+				{
+					pending = 0;
+					writeGroups(held, 3, alphabet);
+				}
+
+				//	whole groups, then hold what's left
+				UINT64 whole = bytes - bytes % 3;
+				writeGroups(data, whole, alphabet);
+				data += whole;
+				bytes -= whole;
+				while (bytes--) held[pending++] = *data++;
+			}
+
+			void writeGroups(const UINT8* data, UINT64 bytes, const char* alphabet)
+			{
+				char buffer[4096];
+				char* p = buffer;
+				for (UINT64 b=0; b<bytes; b+=3)
+				{
+					UINT32 v = (data[b] << 16) | (data[b+1] << 8) | data[b+2];
+					p[0] = alphabet[v >> 18];
+					p[1] = alphabet[(v >> 12) & 0x3F];
+					p[2] = alphabet[(v >> 6) & 0x3F];
+					p[3] = alphabet[v & 0x3F];
+					p += 4;
+					if (p == buffer + sizeof(buffer))
+					{
+						out.append(buffer, sizeof(buffer));
+						p = buffer;
+					}
+				}
+				out.append(buffer, p - buffer);
+			}
+
+			std::string& out;
+			UINT8 held[3];
+			UINT32 pending;
+		};
+
+		class Base64Reader
+		{
+
+		public:
+
+			Base64Reader(const char* p_text)
+			{
+				p = p_text;
+				bits = 0;
+				nbits = 0;
+			}
+
+			//	read "bytes" of elements of "elementBytes" each (error, or NULL)
+			const char* read(UINT8* data, UINT64 bytes, UINT32 elementBytes)
+			{
+				const UINT8* values = base64Values();
+				UINT8* dst = data;
+				UINT64 n = bytes;
+
+				while (n)
+				{
+					//	four characters to three bytes, while on a group boundary
+					//	and the characters run on unbroken
+					if (!nbits)
+					{
+						while (n >= 3)
+						{
+							UINT32 a = values[(UINT8)p[0]];
+							if (a > 63) break;
+							UINT32 b = values[(UINT8)p[1]];
+							if (b > 63) break;
+							UINT32 c = values[(UINT8)p[2]];
+							if (c > 63) break;
+							UINT32 d = values[(UINT8)p[3]];
+							if (d > 63) break;
+
+							UINT32 v = (a << 18) | (b << 12) | (c << 6) | d;
+							dst[0] = (UINT8)(v >> 16);
+							dst[1] = (UINT8)(v >> 8);
+							dst[2] = (UINT8)v;
+							dst += 3;
+							p += 4;
+							n -= 3;
+						}
+						if (!n) break;
+					}
+
+					//	otherwise one character at a time
+					char ch = *p;
+					if (!ch || ch == '=') return "data ends early";
+					p++;
+					if (isSpace(ch)) continue;
+					UINT32 v = values[(UINT8)ch];
+					if (v > 63) return "malformed base64";
+
+					bits = (bits << 6) | v;
+					nbits += 6;
+					if (nbits >= 8)
+					{
+						nbits -= 8;
+						*dst++ = (UINT8)(bits >> nbits);
+						bits &= (1 << nbits) - 1;
+						n--;
+					}
+				}
+
+#ifdef BRAHMS_NUMTEXT_SWAP_BYTES
+				swapElements(data, bytes, elementBytes);
+#else
+				(void)elementBytes;
+#endif
+				return NULL;
+			}
+
+			//	check that nothing but padding follows (error, or NULL)
+			const char* finish()
+			{
+				while (*p)
+				{
+					if (*p != '=' && !isSpace(*p)) return "data runs on past end of array";
+					p++;
+				}
+				return NULL;
+			}
+
+		private:
+
+			const char* p;
+			UINT32 bits;
+			UINT32 nbits;
+		};
+	}
+}
+
+#endif // INCLUDED_BRAHMS_NUMTEXT